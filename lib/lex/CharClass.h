@@ -0,0 +1,95 @@
+//
+//  CharClass.h
+//  yo
+//
+
+#pragma once
+
+#include "TokenKind.h"
+
+#include <array>
+#include <cstdint>
+
+namespace yo::lex::charclass {
+
+enum CharClass : uint8_t {
+    kNone        = 0,
+    kIdentStart  = 1 << 0, // letters and underscore
+    kDigit       = 1 << 1,
+    kIdentOther  = 1 << 2, // other characters allowed in identifiers, after the first one
+    kPunctuation = 1 << 3, // characters forming single-character tokens
+    kWhitespace  = 1 << 4,
+    kNewline     = 1 << 5,
+    
+    kIdent = kIdentStart | kDigit | kIdentOther
+};
+
+
+namespace detail {
+struct Tables {
+    std::array<uint8_t, 256> classes{};
+    std::array<TokenKind, 256> punctuationKinds{};
+};
+
+constexpr Tables makeTables() {
+    Tables T;
+    for (auto &kind : T.punctuationKinds) kind = TokenKind::Unknown;
+    
+    for (int c = 'a'; c <= 'z'; c++) T.classes[c] |= kIdentStart;
+    for (int c = 'A'; c <= 'Z'; c++) T.classes[c] |= kIdentStart;
+    for (int c = '0'; c <= '9'; c++) T.classes[c] |= kDigit;
+    T.classes['_'] |= kIdentStart;
+    T.classes['\''] |= kIdentOther;
+    T.classes[' '] |= kWhitespace; // TODO there are other kinds of whitespace
+    T.classes['\n'] |= kNewline;
+    
+    constexpr std::pair<char, TokenKind> punctuation[] = {
+        { '(', TokenKind::OpeningParens },
+        { ')', TokenKind::ClosingParens },
+        { '{', TokenKind::OpeningCurlyBraces },
+        { '}', TokenKind::ClosingCurlyBraces },
+        { '[', TokenKind::OpeningSquareBrackets },
+        { ']', TokenKind::ClosingSquareBrackets },
+        
+        { ',', TokenKind::Comma },
+        { '!', TokenKind::ExclamationMark },
+        { ':', TokenKind::Colon },
+        { ';', TokenKind::Semicolon },
+        { '=', TokenKind::EqualsSign },
+        { '.', TokenKind::Period },
+        { '#', TokenKind::Hashtag },
+        
+        { '*', TokenKind::Asterisk },
+        { '+', TokenKind::Plus },
+        { '-', TokenKind::Minus },
+        { '/', TokenKind::ForwardSlash },
+        { '%', TokenKind::PercentageSign },
+        { '~', TokenKind::Tilde },
+        
+        { '&', TokenKind::Ampersand },
+        { '|', TokenKind::Pipe },
+        { '^', TokenKind::Circumflex },
+        
+        { '<', TokenKind::OpeningAngledBracket },
+        { '>', TokenKind::ClosingAngledBracket },
+    };
+    for (auto [c, kind] : punctuation) {
+        T.classes[static_cast<uint8_t>(c)] |= kPunctuation;
+        T.punctuationKinds[static_cast<uint8_t>(c)] = kind;
+    }
+    return T;
+}
+
+inline constexpr Tables tables = makeTables();
+} // ns detail
+
+
+constexpr bool is(char c, uint8_t mask) {
+    return detail::tables.classes[static_cast<uint8_t>(c)] & mask;
+}
+
+constexpr TokenKind getPunctuationKind(char c) {
+    return detail::tables.punctuationKinds[static_cast<uint8_t>(c)];
+}
+
+} // ns yo::lex::charclass
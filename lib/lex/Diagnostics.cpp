@@ -7,27 +7,63 @@
 //
 
 #include "Diagnostics.h"
-#include "util/Format.h"
+#include "SourceManager.h"
+
+#include <iostream>
+#include <mutex>
+#include <sstream>
 
 using namespace yo;
 
 
-void diagnostics::emit(std::string_view category, std::string_view msg) {
-    std::cout << category << ": " << msg << std::endl;
-}
+// Diagnostics may be emitted from multiple threads (ie, when parsing modules in parallel).
+// Errors keep the mutex locked until the process exits, so that only the first error is printed
+static std::mutex diagnosticsMutex;
+
+static thread_local bool shouldDeferErrors = false;
 
-void diagnostics::emit(std::string_view category, const lex::SourceLocation &loc, std::string_view msg) {
-    if (loc.isEmpty()) return emit(category, msg);
+
+static void print(std::ostream &OS, std::string_view category, const lex::SourceManager *SM, const lex::SourceLocation &loc, std::string_view msg) {
+    if (!SM || loc.isEmpty()) {
+        OS << category << ": " << msg << std::endl;
+        return;
+    }
     
-    util::fmt::print("{}:{}:{}: {}: {}", loc.getFilepath(), loc.getLine(), loc.getColumn(), category, msg);
+    auto [line, column] = SM->getLineAndColumn(loc);
+    OS << SM->getFilepath(loc) << ":" << line << ":" << column << ": " << category << ": " << msg << std::endl;
     
-    if (util::fs::file_exists(loc.getFilepath())) {
-        std::cout << util::fs::read_specific_line(loc.getFilepath(), loc.getLine() - 1) << std::endl;
-        for (uint64_t i = 0; i < loc.getColumn() - 1; i++) {
-            std::cout << ' ';
-        }
-        std::cout << "^" << std::endl;
+    OS << SM->getLineContents(loc.getFileId(), line) << std::endl;
+    for (uint64_t i = 0; i < column - 1; i++) {
+        OS << ' ';
     }
+    OS << "^" << std::endl;
+}
+
+
+static void emit_imp(std::string_view category, const lex::SourceManager *SM, const lex::SourceLocation &loc, std::string_view msg) {
+    std::lock_guard lock(diagnosticsMutex);
+    print(std::cout, category, SM, loc, msg);
+}
+
+[[noreturn]]
+static void emitError_imp(const lex::SourceManager *SM, const lex::SourceLocation &loc, std::string_view msg) {
+    if (shouldDeferErrors) {
+        std::ostringstream OS;
+        print(OS, "error", SM, loc, msg);
+        throw diagnostics::DeferredError{ OS.str() };
+    }
+    diagnosticsMutex.lock();
+    print(std::cout, "error", SM, loc, msg);
+    util::exitOrAbort();
+}
+
+
+void diagnostics::emit(std::string_view category, std::string_view msg) {
+    emit_imp(category, nullptr, lex::SourceLocation(), msg);
+}
+
+void diagnostics::emit(std::string_view category, const lex::SourceManager &SM, const lex::SourceLocation &loc, std::string_view msg) {
+    emit_imp(category, &SM, loc, msg);
 }
 
 
@@ -35,17 +71,33 @@ void diagnostics::emitNote(std::string_view msg) {
     emit("note", msg);
 }
 
-void diagnostics::emitNote(const lex::SourceLocation &loc, std::string_view msg) {
-    emit("note", loc, msg);
+void diagnostics::emitNote(const lex::SourceManager &SM, const lex::SourceLocation &loc, std::string_view msg) {
+    emit("note", SM, loc, msg);
 }
 
 
 void diagnostics::emitError(std::string_view msg) {
-    emit("error", msg);
-    util::exitOrAbort();
+    emitError_imp(nullptr, lex::SourceLocation(), msg);
+}
+
+void diagnostics::emitError(const lex::SourceManager &SM, const lex::SourceLocation &loc, std::string_view msg) {
+    emitError_imp(&SM, loc, msg);
+}
+
+
+
+#pragma mark - Deferred Errors
+
+diagnostics::DeferErrorsScope::DeferErrorsScope() : prevValue(shouldDeferErrors) {
+    shouldDeferErrors = true;
+}
+
+diagnostics::DeferErrorsScope::~DeferErrorsScope() {
+    shouldDeferErrors = prevValue;
 }
 
-void diagnostics::emitError(const lex::SourceLocation &loc, std::string_view msg) {
-    emit("error", loc, msg);
+void diagnostics::emitDeferredError(const DeferredError &error) {
+    diagnosticsMutex.lock();
+    std::cout << error.text << std::flush;
     util::exitOrAbort();
 }
@@ -13,18 +13,43 @@
 
 #include <string>
 
+namespace yo::lex {
+class SourceManager;
+}
+
 namespace yo::diagnostics {
 
+// Diagnostics w/ a location take the source manager the location's file is registered with
+
 void emit(std::string_view category, std::string_view msg);
-void emit(std::string_view category, const lex::SourceLocation&, std::string_view msg);
+void emit(std::string_view category, const lex::SourceManager&, const lex::SourceLocation&, std::string_view msg);
 
 void emitNote(std::string_view);
-void emitNote(const lex::SourceLocation&, std::string_view);
+void emitNote(const lex::SourceManager&, const lex::SourceLocation&, std::string_view);
 
 [[noreturn]]
 void emitError(std::string_view);
 
 [[noreturn]]
-void emitError(const lex::SourceLocation&, std::string_view);
+void emitError(const lex::SourceManager&, const lex::SourceLocation&, std::string_view);
+
+
+/// An error which was emitted while errors were being deferred
+struct DeferredError {
+    std::string text;
+};
+
+/// While an instance of this class is alive, errors emitted on the current thread are not printed.
+/// Instead, `emitError` throws a `DeferredError`, which can be emitted at a later point.
+/// This is used to report errors in a deterministic order when processing multiple modules in parallel
+class DeferErrorsScope {
+    bool prevValue;
+public:
+    DeferErrorsScope();
+    ~DeferErrorsScope();
+};
+
+[[noreturn]]
+void emitDeferredError(const DeferredError&);
 
 }
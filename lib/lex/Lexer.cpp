@@ -8,9 +8,15 @@
 
 #include "Lexer.h"
 #include "Diagnostics.h"
+#include "Scanning.h"
+#include "CharClass.h"
 #include "util/util.h"
+#include "util/Format.h"
 
-#include <map>
+#include "llvm/ADT/StringRef.h"
+
+#include <array>
+#include <cmath>
 
 using namespace yo;
 using namespace yo::lex;
@@ -22,14 +28,6 @@ inline bool charIsInInclusiveRange(char c, char start, char end) {
     return c >= start && c <= end;
 }
 
-inline bool charIsWhitespace(char c) {
-    return c == ' '; // TODO there are other kinds of whitespace
-}
-
-inline bool charIsNewline(char c) {
-    return c == '\n'; // TODO what about other kinds of newlines?
-}
-
 inline bool isBinaryDigitChar(char c) {
     return c == '0' || c == '1';
 }
@@ -42,128 +40,100 @@ inline bool isDecimalDigitChar(char c) {
     return charIsInInclusiveRange(c, '0', '9');
 }
 
-inline bool isHexDigitChar(char c) {
-    return charIsInInclusiveRange(c, '0', '9') || charIsInInclusiveRange(c, 'a', 'f');
+// The digit's value, or UINT8_MAX if the character isn't a digit in any of the bases up to 16
+inline uint8_t digitValue(char c) {
+    if (charIsInInclusiveRange(c, '0', '9')) return c - '0';
+    if (charIsInInclusiveRange(c, 'a', 'f')) return c - 'a' + 10;
+    if (charIsInInclusiveRange(c, 'A', 'F')) return c - 'A' + 10;
+    return UINT8_MAX;
 }
 
-inline bool isLetterChar(char c) {
-    return charIsInInclusiveRange(c, 'a', 'z') || charIsInInclusiveRange(c, 'A', 'Z');
+inline bool isHexDigitChar(char c) {
+    return digitValue(c) < 16;
 }
 
-inline bool isIdentStartChar(char c) {
-    return c == '_' || isLetterChar(c);
-}
 
-inline bool isIdentChar(char c) {
-    static std::string_view otherIdentChars = "'";
-    return isIdentStartChar(c) || isDecimalDigitChar(c) || util::string::contains(otherIdentChars, c);
+// Keywords (incl the bool literals) are looked up in a perfect hash table, indexed by a function of the length and the first and last character.
+// The factors are chosen so that there are no collisions between keywords, which is checked at compile time.
+
+namespace {
+struct Keyword {
+    std::string_view spelling;
+    TokenKind kind;
+};
+
+constexpr Keyword keywords[] = {
+    { "fn",       TokenKind::Fn          },
+    { "return",   TokenKind::Return      },
+    { "let",      TokenKind::Let         },
+    { "if",       TokenKind::If          },
+    { "else",     TokenKind::Else        },
+    { "struct",   TokenKind::Struct      },
+    { "variant",  TokenKind::Variant     },
+    { "impl",     TokenKind::Impl        },
+    { "use",      TokenKind::Use         },
+    { "while",    TokenKind::While       },
+    { "for",      TokenKind::For         },
+    { "in",       TokenKind::In          },
+    { "match",    TokenKind::Match       },
+    { "decltype", TokenKind::Decltype    },
+    { "break",    TokenKind::Break       },
+    { "continue", TokenKind::Continue    },
+    { "true",     TokenKind::BoolLiteral },
+    { "false",    TokenKind::BoolLiteral },
+};
+
+constexpr size_t kKeywordTableSize = 64;
+
+constexpr size_t keywordHash(std::string_view str) {
+    return (str.size() + 3 * static_cast<uint8_t>(str.front()) + 17 * static_cast<uint8_t>(str.back())) % kKeywordTableSize;
 }
 
-inline bool isSingleCharToken(char c) {
-    static std::string_view singleCharTokens = ".,+-*/;:=<>%!&^#|~(){}[]@";
-    return util::string::contains(singleCharTokens, c);
+constexpr std::array<Keyword, kKeywordTableSize> makeKeywordTable() {
+    std::array<Keyword, kKeywordTableSize> table{};
+    for (auto keyword : keywords) {
+        auto &entry = table[keywordHash(keyword.spelling)];
+        if (!entry.spelling.empty()) {
+            throw "keyword hash collision"; // not a constant expression, so this fails the build
+        }
+        entry = keyword;
+    }
+    return table;
 }
 
+constexpr auto keywordTable = makeKeywordTable();
+} // namespace
 
 
-// TODO no idea if/how this would work, but it'd be cool to have a compile-time assertion that the mapping below is complete
-static const std::map<std::string, TokenKind> tokenKindMappings = {
-    { "(" , TokenKind::OpeningParens },
-    { ")" , TokenKind::ClosingParens },
-    { "{" , TokenKind::OpeningCurlyBraces },
-    { "}" , TokenKind::ClosingCurlyBraces },
-    { "[" , TokenKind::OpeningSquareBrackets },
-    { "]" , TokenKind::ClosingSquareBrackets },
-    
-    { "," , TokenKind::Comma },
-    { "!" , TokenKind::ExclamationMark },
-    { "?" , TokenKind::QuestionMark },
-    { ":" , TokenKind::Colon },
-    { ";" , TokenKind::Semicolon },
-    { "=" , TokenKind::EqualsSign },
-    { "." , TokenKind::Period },
-    { "#" , TokenKind::Hashtag },
-    
-    { "*" , TokenKind::Asterisk },
-    { "+" , TokenKind::Plus },
-    { "-" , TokenKind::Minus },
-    { "/" , TokenKind::ForwardSlash },
-    { "%" , TokenKind::PercentageSign },
-    { "~" , TokenKind::Tilde },
-    
-    { "&" , TokenKind::Ampersand },
-    { "|" , TokenKind::Pipe },
-    { "^" , TokenKind::Circumflex },
-    
-    { "<" , TokenKind::OpeningAngledBracket },
-    { ">" , TokenKind::ClosingAngledBracket },
-    
-    // Keywords
-    { "fn",       TokenKind::Fn       },
-    { "return",   TokenKind::Return   },
-    { "let",      TokenKind::Let      },
-    { "if",       TokenKind::If       },
-    { "else",     TokenKind::Else     },
-    { "struct",   TokenKind::Struct   },
-    { "variant",  TokenKind::Variant  },
-    { "impl",     TokenKind::Impl     },
-    { "use",      TokenKind::Use      },
-    { "while",    TokenKind::While    },
-    { "for",      TokenKind::For      },
-    { "in",       TokenKind::In       },
-    { "match",    TokenKind::Match    },
-    { "decltype", TokenKind::Decltype },
-    { "break",    TokenKind::Break    },
-    { "continue", TokenKind::Continue },
-};
+/// Returns the token kind of the identifier-like string, which is either a keyword, a bool literal, or an identifier
+static TokenKind classifyIdent(std::string_view ident) {
+    const auto &entry = keywordTable[keywordHash(ident)];
+    return entry.spelling == ident ? entry.kind : TokenKind::Ident;
+}
+
 
 
-// this might seems stupid, but it does in fact save 2 string comparisons per identifier parsed
-uint8_t isBoolLiteral(std::string_view str) {
-    if (str == "false") return 1;
-    else if (str == "true") return 2;
-    else return 0;
+uint32_t Lexer::addNumericLiteral(uint64_t value) {
+    tokenList.numericLiterals.push_back(value);
+    return tokenList.numericLiterals.size() - 1;
 }
 
 
-SourceLocation Lexer::getSourceLoc(int64_t offsetBy, uint64_t length) const {
-    int64_t column = static_cast<int64_t>(offset + 2 - lineStart - length) + offsetBy;
-    LKAssert(column > 0);
-    return SourceLocation(filepath, line + 1, column, length);
+uint32_t Lexer::addStringLiteral(std::string value) {
+    tokenList.stringLiterals.push_back(std::move(value));
+    return tokenList.stringLiterals.size() - 1;
 }
 
 
-Token& Lexer::addToken(TokenKind tokenKind, const std::string &tokenSourceText) {
-    Token token;
-    
-    if (tokenKind != TokenKind::Unknown) {
-        token = Token(tokenKind, tokenSourceText);
-    }
-    else if (auto it = tokenKindMappings.find(tokenSourceText); it != tokenKindMappings.end()) {
-        token = Token(it->second, tokenSourceText);
-    }
-    else if (isIdentStartChar(tokenSourceText[0]) && util::string::allCharsMatch(tokenSourceText.substr(1), isIdentChar)) {
-        if (auto val = isBoolLiteral(tokenSourceText); val != 0) {
-            token = Token(TokenKind::BoolLiteral, tokenSourceText);
-            token.setData<bool>(val - 1);
-        } else {
-            token = Token(TokenKind::Ident, tokenSourceText);
-            token.setData(tokenSourceText);
-        }
-    }
-    else {
-        LKFatalError("didn't initialize token for '%s'", tokenSourceText.c_str());
-    }
-    
-    token.setSourceLocation(getSourceLoc(0, tokenSourceText.length()));
-    tokens.push_back(token);
-    return tokens.back();
+Token& Lexer::addToken(TokenKind tokenKind, uint64_t startOffset, uint64_t length, uint32_t dataIndex) {
+    tokenList.tokens.emplace_back(tokenKind, tokenList.getFileId(), startOffset, length, dataIndex);
+    return tokenList.tokens.back();
 }
 
 
 
-std::vector<Token> Lexer::lex() {
-    if (!tokens.empty()) {
+TokenList Lexer::lex() {
+    if (!tokenList.getTokens().empty()) {
         LKFatalError("don;t reuse a lexer instance");
     }
     
@@ -173,27 +143,28 @@ std::vector<Token> Lexer::lex() {
     
     while (offset < sourceText.size()) {
         if (prevOffset == offset) {
-            std::cout << getSourceLoc(0, 1) << std::endl;
-            LKFatalError("'%c'", sourceText[offset]);
+            auto [line, column] = sourceManager.getLineAndColumn(tokenList.getFileId(), offset);
+            LKFatalError("%s:%u:%u: '%c'", sourceManager.getFilepath(tokenList.getFileId()).c_str(), line, column, sourceText[offset]);
         } else {
             prevOffset = offset;
         }
         
         auto c = sourceText[offset];
         
-        if (charIsWhitespace(c)) {
-            consume();
+        if (charclass::is(c, charclass::kWhitespace) || (charclass::is(c, charclass::kNewline) && !shouldPreserveFullInput)) {
+            // Newlines only need special handling if we have to emit tokens for them
+            offset = scan::skipWhitespace(sourceText, offset, !shouldPreserveFullInput);
             continue;
         
-        } else if (charIsNewline(c)) {
+        } else if (charclass::is(c, charclass::kNewline)) {
             handleNewline();
             continue;
         
-        } else if (c == '/' && sourceText[offset + 1] == '/') {
+        } else if (c == '/' && peek() == '/') {
             lexLineComment();
             continue;
         
-        } else if (c == '/' && sourceText[offset + 1] == '*') {
+        } else if (c == '/' && peek() == '*') {
             lexBlockComment();
             continue;
         
@@ -205,13 +176,13 @@ std::vector<Token> Lexer::lex() {
             lexStringLiteral(/*isByteString*/ false, /*isRawString*/ false);
             continue;
         
-        } else if (isIdentStartChar(c)) {
+        } else if (charclass::is(c, charclass::kIdentStart)) {
             if (c == 'b') {
-                if (sourceText[offset + 1] == '"') {
+                if (peek() == '"') {
                     consume();
                     lexStringLiteral(/*isByteString*/ true, /*isRawString*/ false);
                     continue;
-                } else if (sourceText[offset + 1] == 'r' && sourceText[offset + 2] == '"') {
+                } else if (peek() == 'r' && peek(2) == '"') {
                     consume(2);
                     lexStringLiteral(/*isByteString*/ true, /*isRawString*/ true);
                     continue;
@@ -220,17 +191,12 @@ std::vector<Token> Lexer::lex() {
             lexIdent();
             continue;
         
-        } else if (isSingleCharToken(c)) {
-            std::string str(1, c);
-            addToken(TokenKind::Unknown, str);
+        } else if (charclass::is(c, charclass::kPunctuation)) {
+            addToken(charclass::getPunctuationKind(c), offset, 1);
             offset++;
             continue;
         
-        } else if (isIdentStartChar(c)) {
-            lexIdent();
-            continue;
-        
-        } else if (isDecimalDigitChar(c)) {
+        } else if (charclass::is(c, charclass::kDigit)) {
             lexNumberLiteral();
             continue;
         
@@ -239,12 +205,12 @@ std::vector<Token> Lexer::lex() {
             
         
         } else {
-//            LKFatalError("char not handled");
+            diagnostics::emitError(sourceManager, getSourceLoc(offset, 1), util::fmt::format("unexpected character '{}'", c));
         }
     }
     
-    addToken(TokenKind::EOF_, "");
-    return tokens;
+    addToken(TokenKind::EOF_, offset, 0);
+    return std::move(tokenList);
 }
 
 
@@ -252,14 +218,15 @@ std::vector<Token> Lexer::lex() {
 void Lexer::lexLineComment() {
     // Start of line comment
     uint64_t pos_prev = offset;
-    while (sourceText[++offset] != '\n');
+    offset = scan::find(sourceText, offset, '\n');
     
     if (shouldPreserveFullInput) {
-        auto commentText = std::string(sourceText.substr(pos_prev, offset - pos_prev));
-        addToken(TokenKind::LineComment, commentText);
+        addToken(TokenKind::LineComment, pos_prev, offset - pos_prev);
     }
     
-    handleNewline();
+    if (offset < sourceText.size()) {
+        handleNewline();
+    }
 }
 
 
@@ -268,57 +235,58 @@ void Lexer::lexBlockComment() {
     // Note that we deliberately don't check whether a comment's end is within a string literal
     uint64_t startPos = offset;
     offset += 2;
-    while (!(sourceText[offset++] == '*' && sourceText[offset] == '/')) {
-        if (sourceText[offset] == '\n') {
-            handleNewline(true);
+    while (true) {
+        offset = scan::find(sourceText, offset, '*');
+        if (offset + 1 >= sourceText.size()) {
+            diagnostics::emitError(sourceManager, getSourceLoc(startPos, 2), "unterminated block comment");
         }
+        if (peek() == '/') {
+            offset += 2;
+            break;
+        }
+        offset++;
     }
     
     if (shouldPreserveFullInput) {
-        auto commentSourceText = std::string(sourceText.substr(startPos, offset - startPos + 1));
-        addToken(TokenKind::BlockComment, commentSourceText);
+        addToken(TokenKind::BlockComment, startPos, offset - startPos);
     }
-    
-    offset++;
 }
 
 // Offset after returning is the character after the end of the escaped character
 // For example, if we're parsing `'\123x`, the offset after returhing would "point" to the x
 char Lexer::readEscapedChar() {
     LKAssert(sourceText[offset] == '\\');
-    if (sourceText[offset + 1] == '\\') {
+    if (peek() == '\\') {
         // Escaped backslash
-        offset++;
+        offset += 2;
         return '\\';
     }
     
+    uint64_t escapeOffset = offset;
     auto x = sourceText[++offset];
     // Offset at this point is now the character after the backslash
     if (x == 'x' || isOctalDigitChar(x)) { // Hex or octal value
         // TODO why does this allow octal values? what are the rules here?
+        // \xHH is exactly two hex digits, octal escapes are up to three digits
         auto isHex = x == 'x';
-        std::string rawValue;
+        uint8_t base = isHex ? 16 : 8;
+        uint64_t maxDigits = isHex ? 2 : 3;
+        if (isHex) offset++;
         
-        if (isHex) {
-            rawValue.push_back(sourceText[++offset]);
-            rawValue.push_back(sourceText[++offset]);
+        uint64_t value = 0;
+        uint64_t numDigits = 0;
+        for (; numDigits < maxDigits && digitValue(peek(0)) < base; numDigits++) {
+            value = value * base + digitValue(peek(0));
             offset++;
-        } else {
-            while (isOctalDigitChar(sourceText[offset]) && rawValue.length() < 3) {
-                rawValue.push_back(sourceText[offset++]);
-            }
         }
         
-        std::size_t length;
-        char value;
-        try {
-            value = std::stoi(rawValue, &length, isHex ? 16 : 8);
-        } catch (...) {
-            throw;
+        if (isHex && numDigits != 2) {
+            diagnostics::emitError(sourceManager, getSourceLoc(escapeOffset, offset - escapeOffset), "Expected two hex digits in escape sequence");
         }
-        
-        LKAssert(length == rawValue.length());
-        return value;
+        if (value > UINT8_MAX) {
+            diagnostics::emitError(sourceManager, getSourceLoc(escapeOffset, offset - escapeOffset), "Escape sequence out of range");
+        }
+        return static_cast<char>(value);
     }
     
     switch (x) {
@@ -326,20 +294,24 @@ char Lexer::readEscapedChar() {
         case 't': offset++; return '\t';
         default: break;
     }
-    LKFatalError("Unable to parse escaped character");
+    diagnostics::emitError(sourceManager, getSourceLoc(escapeOffset, 2), "Invalid escape sequence");
 }
 
 
 void Lexer::lexIdent() {
-    std::string ident;
-    char c = sourceText[offset];
-    do {
-        ident.push_back(c);
-        c = sourceText[++offset];
-    } while (isIdentChar(c));
-    offset--;
-    addToken(TokenKind::Unknown, ident);
-    offset++; // TODO is decrementing and re-incrementing the offset really necessary?
+    uint64_t startOffset = offset;
+    offset = scan::findIdentEnd(sourceText, offset + 1);
+    
+    auto text = sourceText.substr(startOffset, offset - startOffset);
+    auto kind = classifyIdent(text);
+    if (kind == TokenKind::BoolLiteral) {
+        addToken(kind, startOffset, offset - startOffset, addNumericLiteral(sourceText[startOffset] == 't'));
+    } else if (kind == TokenKind::Ident) {
+        tokenList.identifiers.emplace_back(text);
+        addToken(kind, startOffset, offset - startOffset, tokenList.identifiers.size() - 1);
+    } else {
+        addToken(kind, startOffset, offset - startOffset);
+    }
 }
 
 
@@ -359,10 +331,7 @@ void Lexer::lexCharLiteral() {
     LKAssert(sourceText[offset] == '\'');
     offset++;
     
-    auto rawSourceText = std::string(sourceText.substr(initialOffset, offset - initialOffset + 1));
-    //handleRawToken(rawSourceText, TokenKind::CharLiteral).setData(content);
-    auto &token = addToken(TokenKind::CharLiteral, rawSourceText);
-    token.setData(content);
+    addToken(TokenKind::CharLiteral, initialOffset, offset - initialOffset, addNumericLiteral(content));
 }
 
 
@@ -372,37 +341,32 @@ void Lexer::lexStringLiteral(bool isByteString, bool isRawString) {
     std::string content;
     offset++;
     // Offset is at first char after opening quotes
-    if (isRawString) {
-        for (auto c = sourceText[offset]; c != DOUBLE_QUOTE; c = sourceText[++offset]) {
-            content.push_back(c);
-            if (c == '\n') handleNewline(true);
+    while (true) {
+        // Copy everything up to the next quote (or, for non-raw strings, the next escape sequence) in one go
+        auto end = isRawString ? scan::find(sourceText, offset, DOUBLE_QUOTE) : scan::findEither(sourceText, offset, DOUBLE_QUOTE, '\\');
+        if (end == sourceText.size()) {
+            diagnostics::emitError(sourceManager, getSourceLoc(startOffset, 1), "unterminated string literal");
         }
-    } else {
-        for (auto c = sourceText[offset]; c != DOUBLE_QUOTE; c = sourceText[offset]) {
-            if (c == '\\') {
-                content.push_back(readEscapedChar());
-            } else {
-                if (c == '\n') handleNewline(true);
-                content.push_back(c);
-                offset++;
-            }
+        content.append(sourceText.substr(offset, end - offset));
+        offset = end;
+        if (sourceText[offset] == DOUBLE_QUOTE) {
+            break;
         }
+        content.push_back(readEscapedChar());
     }
-    LKAssert(sourceText[offset] == DOUBLE_QUOTE);
     offset++;
     
-    auto rawSourceText = std::string(sourceText.substr(startOffset, offset - startOffset + 1));
-    auto &token = addToken(isByteString ? TokenKind::ByteStringLiteral : TokenKind::StringLiteral, rawSourceText);
-    token.setData(content);
+    auto kind = isByteString ? TokenKind::ByteStringLiteral : TokenKind::StringLiteral;
+    addToken(kind, startOffset, offset - startOffset, addStringLiteral(std::move(content)));
 }
 
 
 
 
 void Lexer::lexNumberLiteral() {
+    uint64_t startOffset = offset;
     uint8_t base = 10;
-    std::string rawValue;
-    auto next = sourceText[offset + 1];
+    auto next = peek();
     bool isFloat = false;
     
     if (sourceText[offset] == '0') { // binary/octal/decimal/hex ?
@@ -415,21 +379,26 @@ void Lexer::lexNumberLiteral() {
         } else if (next == 'x') {
             offset += 2;
             base = 16;
-        } else {
-            // A single 0, not followed by another numeric digit
-            LKAssert(!isHexDigitChar(next));
+        } else if (isHexDigitChar(next)) {
+            // A single 0 must not be followed by another numeric digit
+            diagnostics::emitError(sourceManager, getSourceLoc(offset + 1, 1), "Invalid character in number literal");
+        }
+        
+        if (base != 10 && !isHexDigitChar(peek(0))) {
+            diagnostics::emitError(sourceManager, getSourceLoc(startOffset, 2), "Expected digits after base prefix");
         }
     }
     
+    uint64_t digitsOffset = offset;
+    
     while (true) {
         // TODO allow non-base-10 floating point literals?
         // ie: 0b101.11 = 5.75
         // also support some of these: https://en.cppreference.com/w/cpp/language/floating_literal ?
-        rawValue.push_back(sourceText[offset]);
-        
-        auto nextChar = sourceText[++offset];
+        auto nextChar = peek();
+        offset++;
         // The hex digits charset contains all other digits as well, so it makes most sense to use that.
-        // Invalid characters will be detected by `std::{stoll|stod}` below
+        // Invalid characters will be detected below
         
         if (isFloat && isDecimalDigitChar(nextChar)) {
             // if isFloat is true, the next digits that still belong to the number can only be base-10
@@ -443,7 +412,7 @@ void Lexer::lexNumberLiteral() {
         // 1.x
         // 1.7.x
         if (nextChar == '.') {
-            if (!isDecimalDigitChar(sourceText[offset + 1])) { // next next char
+            if (!isDecimalDigitChar(peek())) { // next next char
                 break;
             }
             if (isFloat || base != 10) {
@@ -457,34 +426,35 @@ void Lexer::lexNumberLiteral() {
     }
     
     
-    double value_f64;
-    uint64_t value_i64;
-    std::size_t length;
-    
-    try {
-        if (isFloat) {
-            value_f64 = std::stod(rawValue, &length);
-        } else {
-            value_i64 = std::stoll(rawValue, &length, base);
-        }
-    } catch (const std::exception &e) { // TODO can we do this w/out an the exception handling?
-        std::cout << e.what() << std::endl;
-        throw;
-    }
-    
-    offset--; // unavoidable :/
-    
-    if (length != rawValue.length()) {
-        auto loc = getSourceLoc(length, rawValue.length());
-        diagnostics::emitError(loc, "Invalid character in number literal");
-    }
+    auto digits = sourceText.substr(digitsOffset, offset - digitsOffset);
+    uint64_t value = 0;
     
-    auto &token = addToken(isFloat ? TokenKind::DoubleLiteral : TokenKind::IntegerLiteral, rawValue);
     if (isFloat) {
-        token.setData(value_f64);
+        // The loop above accepts hex digits before the period (since it doesn't know yet that this is a float literal)
+        for (uint64_t i = 0; i < digits.size(); i++) {
+            if (digits[i] != '.' && !isDecimalDigitChar(digits[i])) {
+                diagnostics::emitError(sourceManager, getSourceLoc(digitsOffset + i, 1), "Invalid character in number literal");
+            }
+        }
+        // getAsDouble accepts literals that are too large, and rounds them to infinity
+        double value_f64;
+        if (llvm::StringRef(digits.data(), digits.size()).getAsDouble(value_f64) || !std::isfinite(value_f64)) {
+            diagnostics::emitError(sourceManager, getSourceLoc(startOffset, offset - startOffset), "Floating point literal is out of range");
+        }
+        value = util::bitcast<uint64_t>(value_f64);
     } else {
-        token.setData(value_i64);
+        for (uint64_t i = 0; i < digits.size(); i++) {
+            auto digit = digitValue(digits[i]);
+            if (digit >= base) {
+                diagnostics::emitError(sourceManager, getSourceLoc(digitsOffset + i, 1), "Invalid character in number literal");
+            }
+            if (__builtin_mul_overflow(value, base, &value) || __builtin_add_overflow(value, digit, &value)) {
+                diagnostics::emitError(sourceManager, getSourceLoc(startOffset, offset - startOffset), "Integer literal is too large");
+            }
+        }
     }
-    offset++; // TODO again, do we really need the decrement above?
+    
+    auto kind = isFloat ? TokenKind::DoubleLiteral : TokenKind::IntegerLiteral;
+    addToken(kind, startOffset, offset - startOffset, addNumericLiteral(value));
 }
 
@@ -10,6 +10,7 @@
 
 #include "SourceLocation.h"
 #include "Token.h"
+#include "SourceManager.h"
 
 #include <string>
 #include <vector>
@@ -18,32 +19,35 @@ namespace yo::lex {
 
 
 class Lexer {
+    const SourceManager &sourceManager;
     std::string_view sourceText;
-    const std::string &filepath;
+    TokenList tokenList;
     
     uint64_t offset = 0;
-    uint64_t line = 0;
-    uint64_t lineStart = 0;
-    std::vector<Token> tokens;
     
 public:
     bool shouldPreserveFullInput = false;
     
-    Lexer(std::string_view sourceText, const std::string &filepath) : sourceText(sourceText), filepath(filepath) {}
+    Lexer(const SourceManager &sourceManager, FileID fileId)
+    : sourceManager(sourceManager), sourceText(sourceManager.getContents(fileId)), tokenList(fileId, sourceText) {}
     
-    std::vector<Token> lex();
+    TokenList lex();
     
 private:
     void consume(uint64_t count = 1) {
         offset += count;
     }
     
-    void handleNewline(bool ignorePreserveFullInput = false) {
-        if (shouldPreserveFullInput && !ignorePreserveFullInput) {
-            addToken(TokenKind::Whitespace, "\n"); // TODO what is this used for?
+    /// Returns the character `n` positions after the current one.
+    /// Reading one past the end of the source text is fine, since the source manager guarantees the contents to be followed by a NUL byte
+    char peek(uint64_t n = 1) const {
+        return sourceText.data()[offset + n];
+    }
+    
+    void handleNewline() {
+        if (shouldPreserveFullInput) {
+            addToken(TokenKind::Whitespace, offset, 1); // TODO what is this used for?
         }
-        line += 1;
-        lineStart = offset + 1;
         consume();
     }
     
@@ -55,9 +59,13 @@ private:
     void lexCharLiteral();
     void lexStringLiteral(bool isByteString, bool isRawString);
     
-    SourceLocation getSourceLoc(int64_t offsetBy, uint64_t length) const;
+    SourceLocation getSourceLoc(uint64_t startOffset, uint64_t length) const {
+        return SourceLocation(tokenList.getFileId(), startOffset, length);
+    }
     
-    Token& addToken(TokenKind tokenKind, const std::string& tokenSourceText);
+    Token& addToken(TokenKind tokenKind, uint64_t startOffset, uint64_t length, uint32_t dataIndex = Token::kNoData);
+    uint32_t addNumericLiteral(uint64_t value);
+    uint32_t addStringLiteral(std::string value);
     
     char readEscapedChar();
 };
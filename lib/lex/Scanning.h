@@ -0,0 +1,141 @@
+//
+//  Scanning.h
+//  yo
+//
+
+#pragma once
+
+#include "CharClass.h"
+
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define YO_LEX_SCAN_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define YO_LEX_SCAN_SSE2 1
+#endif
+
+
+// Helpers for skipping over runs of "uninteresting" bytes in the lexer.
+// On x86 these classify 16 (SSE2) or 32 (AVX2) bytes at a time, the remaining bytes at the end of the input are handled by the scalar implementation.
+// All functions return the offset of the first byte not skipped, or `text.size()` if the end of the input was reached.
+
+namespace yo::lex::scan {
+
+namespace scalar {
+
+inline uint64_t skipWhitespace(std::string_view text, uint64_t pos, bool skipNewlines) {
+    auto mask = charclass::kWhitespace | (skipNewlines ? charclass::kNewline : 0);
+    while (pos < text.size() && charclass::is(text[pos], mask)) pos++;
+    return pos;
+}
+
+inline uint64_t findIdentEnd(std::string_view text, uint64_t pos) {
+    while (pos < text.size() && charclass::is(text[pos], charclass::kIdent)) pos++;
+    return pos;
+}
+
+inline uint64_t findEither(std::string_view text, uint64_t pos, char a, char b) {
+    while (pos < text.size() && text[pos] != a && text[pos] != b) pos++;
+    return pos;
+}
+
+} // ns scalar
+
+
+
+#if defined(YO_LEX_SCAN_AVX2) || defined(YO_LEX_SCAN_SSE2)
+
+namespace simd {
+
+#if defined(YO_LEX_SCAN_AVX2)
+using Vec = __m256i;
+inline constexpr uint64_t kWidth = 32;
+inline Vec load(const char *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+inline Vec splat(char c) { return _mm256_set1_epi8(c); }
+inline Vec eq(Vec v, char c) { return _mm256_cmpeq_epi8(v, splat(c)); }
+inline Vec gt(Vec v, char c) { return _mm256_cmpgt_epi8(v, splat(c)); }
+inline Vec lt(Vec v, char c) { return _mm256_cmpgt_epi8(splat(c), v); }
+inline Vec vor(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+inline Vec vand(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+inline uint32_t mask(Vec v) { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+#else
+using Vec = __m128i;
+inline constexpr uint64_t kWidth = 16;
+inline Vec load(const char *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+inline Vec splat(char c) { return _mm_set1_epi8(c); }
+inline Vec eq(Vec v, char c) { return _mm_cmpeq_epi8(v, splat(c)); }
+inline Vec gt(Vec v, char c) { return _mm_cmpgt_epi8(v, splat(c)); }
+inline Vec lt(Vec v, char c) { return _mm_cmpgt_epi8(splat(c), v); }
+inline Vec vor(Vec a, Vec b) { return _mm_or_si128(a, b); }
+inline Vec vand(Vec a, Vec b) { return _mm_and_si128(a, b); }
+inline uint32_t mask(Vec v) { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+#endif
+
+// Bytes in [lo, hi]. Note that the comparisons are signed, which is fine since we only ever check for ASCII ranges (non-ASCII bytes are negative)
+inline Vec inRange(Vec v, char lo, char hi) {
+    return vand(gt(v, lo - 1), lt(v, hi + 1));
+}
+
+// Advances `pos` until `stopMask` has a bit set for one of the bytes in the current block
+template <typename F>
+inline uint64_t findFirst(std::string_view text, uint64_t pos, F &&stopMask) {
+    const char *data = text.data();
+    while (pos + kWidth <= text.size()) {
+        if (uint32_t m = stopMask(load(data + pos))) {
+            return pos + __builtin_ctz(m);
+        }
+        pos += kWidth;
+    }
+    return pos;
+}
+
+} // ns simd
+
+
+inline uint64_t skipWhitespace(std::string_view text, uint64_t pos, bool skipNewlines) {
+    pos = simd::findFirst(text, pos, [skipNewlines](simd::Vec v) {
+        auto ws = simd::eq(v, ' ');
+        if (skipNewlines) ws = simd::vor(ws, simd::eq(v, '\n'));
+        return ~simd::mask(ws) & ((1ull << simd::kWidth) - 1);
+    });
+    return scalar::skipWhitespace(text, pos, skipNewlines);
+}
+
+inline uint64_t findIdentEnd(std::string_view text, uint64_t pos) {
+    pos = simd::findFirst(text, pos, [](simd::Vec v) {
+        auto isIdent = simd::vor(simd::vor(simd::inRange(v, 'a', 'z'), simd::inRange(v, 'A', 'Z')),
+                                 simd::vor(simd::inRange(v, '0', '9'), simd::vor(simd::eq(v, '_'), simd::eq(v, '\''))));
+        return ~simd::mask(isIdent) & ((1ull << simd::kWidth) - 1);
+    });
+    return scalar::findIdentEnd(text, pos);
+}
+
+inline uint64_t findEither(std::string_view text, uint64_t pos, char a, char b) {
+    pos = simd::findFirst(text, pos, [a, b](simd::Vec v) {
+        return simd::mask(simd::vor(simd::eq(v, a), simd::eq(v, b)));
+    });
+    return scalar::findEither(text, pos, a, b);
+}
+
+#else
+
+using scalar::skipWhitespace;
+using scalar::findIdentEnd;
+using scalar::findEither;
+
+#endif
+
+
+inline uint64_t find(std::string_view text, uint64_t pos, char c) {
+    // memchr already is vectorized in all relevant libcs
+    if (pos >= text.size()) return text.size();
+    auto p = static_cast<const char *>(std::memchr(text.data() + pos, c, text.size() - pos));
+    return p ? p - text.data() : text.size();
+}
+
+} // ns yo::lex::scan
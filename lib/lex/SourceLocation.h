@@ -8,34 +8,34 @@
 
 #pragma once
 
-#include <string>
 #include <cstdint>
-#include <iostream>
 
 
 namespace yo::lex {
 
+using FileID = uint32_t;
+
+
+/// A location in one of the source files registered w/ the `SourceManager`.
+/// Locations only store the file's id, use the source manager to get the file's path and the location's line and column
 class SourceLocation {
-    std::string filepath;
-    uint64_t line;
-    uint64_t column;
-    uint64_t length;
+    static inline constexpr FileID kInvalidFileID = UINT32_MAX;
     
-public:
-    SourceLocation() : filepath{}, line(0), column(0), length(0) {}
-    SourceLocation(const std::string &filepath, uint64_t line, uint64_t column, uint64_t length)
-    : filepath(filepath), line(line), column(column), length(length) {}
+    FileID fileId;
+    uint32_t offset;
+    uint32_t length;
     
-    const std::string& getFilepath() const {
-        return filepath;
-    }
+public:
+    SourceLocation() : fileId(kInvalidFileID), offset(0), length(0) {}
+    SourceLocation(FileID fileId, uint32_t offset, uint32_t length)
+    : fileId(fileId), offset(offset), length(length) {}
     
-    uint64_t getLine() const {
-        return line;
+    FileID getFileId() const {
+        return fileId;
     }
     
-    uint64_t getColumn() const {
-        return column;
+    uint32_t getOffset() const {
+        return offset;
     }
     
     uint64_t getLength() const {
@@ -43,12 +43,8 @@ public:
     }
     
     bool isEmpty() const {
-        return filepath.empty() && line == 0 && column == 0 && length == 0;
+        return fileId == kInvalidFileID;
     }
 };
 
-inline std::ostream& operator<<(std::ostream &OS, const SourceLocation &loc) {
-    return OS << loc.getFilepath() << ":" << loc.getLine() << ":" << loc.getColumn();
-}
-
 } // ns yo::lex
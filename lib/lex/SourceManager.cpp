@@ -0,0 +1,102 @@
+//
+//  SourceManager.cpp
+//  yo
+//
+
+#include "SourceManager.h"
+#include "util/util.h"
+
+#include <algorithm>
+
+using namespace yo;
+using namespace yo::lex;
+
+
+std::optional<FileID> SourceManager::loadFile(const std::string &filepath) {
+    // Files are opened read-only, and we request the buffer to be NUL-terminated
+    auto buffer = llvm::MemoryBuffer::getFile(filepath, /*IsText*/ false, /*RequiresNullTerminator*/ true);
+    if (!buffer) {
+        return std::nullopt;
+    }
+    std::lock_guard lock(mutex);
+    auto &file = files.emplace_back(filepath);
+    file.buffer = std::move(*buffer);
+    file.contents = file.buffer->getBuffer();
+    return files.size() - 1;
+}
+
+
+FileID SourceManager::addFile(std::string filepath, std::string contents) {
+    std::lock_guard lock(mutex);
+    auto &file = files.emplace_back(std::move(filepath));
+    file.ownedContents = std::move(contents);
+    file.contents = file.ownedContents;
+    return files.size() - 1;
+}
+
+
+FileID SourceManager::addFileWithStaticContents(std::string filepath, std::string_view contents) {
+    LKAssert(contents.data()[contents.size()] == '\0');
+    std::lock_guard lock(mutex);
+    auto &file = files.emplace_back(std::move(filepath));
+    file.contents = contents;
+    return files.size() - 1;
+}
+
+
+const SourceManager::File& SourceManager::getFile(FileID fileId) const {
+    std::lock_guard lock(mutex);
+    LKAssert(fileId < files.size());
+    return files[fileId];
+}
+
+
+const std::vector<uint32_t>& SourceManager::getLineStartOffsets(const File &file) const {
+    std::lock_guard lock(mutex);
+    auto &offsets = file.lineStartOffsets;
+    if (!offsets.empty()) return offsets;
+    
+    offsets.push_back(0);
+    for (uint32_t offset = 0; offset < file.contents.size(); offset++) {
+        if (file.contents[offset] == '\n') {
+            offsets.push_back(offset + 1);
+        }
+    }
+    return offsets;
+}
+
+
+std::pair<uint32_t, uint32_t> SourceManager::getLineAndColumn(FileID fileId, uint32_t offset) const {
+    auto &offsets = getLineStartOffsets(getFile(fileId));
+    // index of the first line starting after the offset, which is the one-based number of the line containing the offset
+    auto it = std::upper_bound(offsets.begin(), offsets.end(), offset);
+    uint32_t line = it - offsets.begin();
+    return { line, offset - offsets[line - 1] + 1 };
+}
+
+
+std::string_view SourceManager::getLineContents(FileID fileId, uint32_t line) const {
+    auto &file = getFile(fileId);
+    auto &offsets = getLineStartOffsets(file);
+    LKAssert(line > 0 && line <= offsets.size());
+    
+    auto start = offsets[line - 1];
+    auto end = line < offsets.size() ? offsets[line] - 1 : file.contents.size();
+    return file.contents.substr(start, end - start);
+}
+
+
+
+
+const std::string& SourceManager::getFilepath(const SourceLocation &loc) const {
+    static const std::string empty;
+    return loc.isEmpty() ? empty : getFilepath(loc.getFileId());
+}
+
+
+std::pair<uint32_t, uint32_t> SourceManager::getLineAndColumn(const SourceLocation &loc) const {
+    if (loc.isEmpty()) {
+        return { 0, 0 };
+    }
+    return getLineAndColumn(loc.getFileId(), loc.getOffset());
+}
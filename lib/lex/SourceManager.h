@@ -0,0 +1,96 @@
+//
+//  SourceManager.h
+//  yo
+//
+
+#pragma once
+
+#include "SourceLocation.h"
+
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <mutex>
+#include <cstdint>
+
+namespace yo::lex {
+
+
+/// Owns the contents of all source files that are part of a compilation.
+/// Source locations refer to files via their id, line and column numbers are computed on demand.
+/// The source manager is created by the driver, and has to outlive everything referencing the files' contents (ie, tokens and diagnostics).
+///
+/// The contents of every file are followed by (at least) one NUL byte, which is not part of the file's contents.
+/// The lexer relies on this sentinel, which allows it to look ahead one character w/out having to check whether it reached the end of the input.
+class SourceManager {
+    struct File {
+        std::string filepath;
+        std::unique_ptr<llvm::MemoryBuffer> buffer;
+        std::string ownedContents;
+        std::string_view contents;
+        
+        // Offsets of the first character of every line. Computed lazily, empty until then
+        mutable std::vector<uint32_t> lineStartOffsets;
+        
+        File(std::string filepath) : filepath(filepath) {}
+    };
+    
+    // deque bc we hand out references to the file contents
+    std::deque<File> files;
+    // Files may be added and queried concurrently (the parser processes imported modules in parallel)
+    mutable std::mutex mutex;
+    
+public:
+    SourceManager() = default;
+    SourceManager(const SourceManager&) = delete;
+    SourceManager& operator=(const SourceManager&) = delete;
+    
+    /// Reads the file at the specified path (memory-mapping it, if it is large enough).
+    /// Returns nullopt if the file couldn't be read
+    std::optional<FileID> loadFile(const std::string &filepath);
+    
+    /// Adds a file to the source manager, which takes ownership of the contents
+    FileID addFile(std::string filepath, std::string contents);
+    
+    /// Adds a file whose contents are kept alive elsewhere (ie, the embedded stdlib modules).
+    /// The caller is responsible for ensuring that the contents are followed by a NUL byte
+    FileID addFileWithStaticContents(std::string filepath, std::string_view contents);
+    
+    const std::string& getFilepath(FileID fileId) const {
+        return getFile(fileId).filepath;
+    }
+    
+    std::string_view getContents(FileID fileId) const {
+        return getFile(fileId).contents;
+    }
+    
+    /// One-based line and column of the character at the specified offset
+    std::pair<uint32_t, uint32_t> getLineAndColumn(FileID fileId, uint32_t offset) const;
+    
+    // The following also accept empty locations, which have an empty path, and line and column 0
+    const std::string& getFilepath(const SourceLocation&) const;
+    std::pair<uint32_t, uint32_t> getLineAndColumn(const SourceLocation&) const;
+    
+    uint32_t getLine(const SourceLocation &loc) const {
+        return getLineAndColumn(loc).first;
+    }
+    
+    uint32_t getColumn(const SourceLocation &loc) const {
+        return getLineAndColumn(loc).second;
+    }
+    
+    /// Contents of the specified (one-based) line, w/out the trailing newline
+    std::string_view getLineContents(FileID fileId, uint32_t line) const;
+    
+private:
+    const File& getFile(FileID fileId) const;
+    const std::vector<uint32_t>& getLineStartOffsets(const File&) const;
+};
+
+
+} // ns yo::lex
@@ -10,60 +10,109 @@
 
 #include "TokenKind.h"
 #include "SourceLocation.h"
+#include "util/Symbol.h"
 
 #include <string>
-#include <variant>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
 
 namespace yo::lex {
 
-
+/// A token is a plain record which refers back into the source buffer it was lexed from.
+/// The text of a token is obtained via the `TokenList` it belongs to, as are the decoded values of literals.
 class Token {
+public:
+    static inline constexpr uint32_t kNoData = UINT32_MAX;
+    
+private:
     TokenKind kind;
-    std::string sourceText;
-    SourceLocation sourceLoc;
-    std::variant<
-        bool,
-        char,
-        double,
-        uint64_t,
-        std::string
-    > data;
+    FileID fileId;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t dataIndex; // index into one of the owning TokenList's identifier or literal tables, or kNoData
     
 public:
-    Token() : kind(TokenKind::Unknown) {}
-    Token(TokenKind kind, std::string sourceText) : kind(kind), sourceText(sourceText) {}
-    
-    template <typename T>
-    Token(TokenKind kind, std::string sourceText, const T &data) : kind(kind), sourceText(sourceText), data(data) {}
+    Token() : kind(TokenKind::Unknown), fileId(0), offset(0), length(0), dataIndex(kNoData) {}
     
+    Token(TokenKind kind, FileID fileId, uint32_t offset, uint32_t length, uint32_t dataIndex = kNoData)
+    : kind(kind), fileId(fileId), offset(offset), length(length), dataIndex(dataIndex) {}
     
     TokenKind getKind() const {
         return kind;
     }
     
-    const SourceLocation& getSourceLocation() const {
-        return sourceLoc;
+    FileID getFileId() const {
+        return fileId;
+    }
+    
+    uint32_t getOffset() const {
+        return offset;
+    }
+    
+    uint32_t getLength() const {
+        return length;
+    }
+    
+    uint32_t getDataIndex() const {
+        return dataIndex;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<Token>);
+
+
+
+/// The tokens of a single source file, along with the interned identifiers and decoded values of its literals
+class TokenList {
+    friend class Lexer;
+    
+    FileID fileId;
+    std::string_view sourceText;
+    std::vector<Token> tokens;
+    
+    std::vector<util::Symbol> identifiers;
+    // Integer, double (stored bitcast), character and bool literals
+    std::vector<uint64_t> numericLiterals;
+    // String and byte string literals, with all escape sequences resolved
+    std::vector<std::string> stringLiterals;
+    
+public:
+    TokenList(FileID fileId, std::string_view sourceText) : fileId(fileId), sourceText(sourceText) {}
+    
+    FileID getFileId() const {
+        return fileId;
+    }
+    
+    const std::vector<Token>& getTokens() const {
+        return tokens;
     }
-    void setSourceLocation(SourceLocation loc) {
-        sourceLoc = loc; // TODO set this via the constructor?
+    
+    std::vector<Token>& getTokens() {
+        return tokens;
     }
     
-    const std::string& getSourceText() const {
-        return sourceText;
+    std::string_view getSourceText(const Token &token) const {
+        return sourceText.substr(token.getOffset(), token.getLength());
     }
     
-    template <typename T>
-    const T& getData() const {
-        return std::get<T>(data);
+    util::Symbol getIdentifier(const Token &token) const {
+        return identifiers.at(token.getDataIndex());
     }
     
-    template <typename T>
-    void setData(const T &newValue) {
-        data = newValue;
+    uint64_t getNumericValue(const Token &token) const {
+        return numericLiterals.at(token.getDataIndex());
     }
     
+    const std::string& getStringValue(const Token &token) const {
+        return stringLiterals.at(token.getDataIndex());
+    }
+    
+    SourceLocation getSourceLocation(const Token &token) const {
+        return SourceLocation(fileId, token.getOffset(), token.getLength());
+    }
 };
 
 
-
 } // ns yo::lex
@@ -36,7 +36,7 @@ bool FunctionDecl::isOperatorOverloadFor(Operator op) const {
     return name == mangling::encodeOperator(op);
 }
 
-const std::string& VarDecl::getName() const {
+util::Symbol VarDecl::getName() const {
     return ident->value;
 }
 
@@ -44,8 +44,8 @@ const std::string& VarDecl::getName() const {
 #pragma mark - AST Printing
 
 template <>
-struct util::fmt::formatter<std::shared_ptr<ast::Ident>> {
-    static void format(std::ostream &OS, std::string_view flags, const std::shared_ptr<ast::Ident> &ident) {
+struct util::fmt::formatter<ast::Ident *> {
+    static void format(std::ostream &OS, std::string_view flags, ast::Ident *ident) {
         OS << ident->value;
     }
 };
@@ -236,9 +236,7 @@ std::string ast_vec_desc(const std::vector<T> &vec, std::string(U::*desc_fn_ptr)
             }
         }
         
-        if constexpr(util::typeinfo::is_shared_ptr_v<T>) {
-            it_desc = ((*it).get()->*desc_fn_ptr)();
-        } else if constexpr(std::is_pointer_v<T>) {
+        if constexpr(std::is_pointer_v<T>) {
             it_desc = ((*it)->*desc_fn_ptr)();
         } else {
             it_desc = ((*it).*desc_fn_ptr)();
@@ -268,7 +266,7 @@ std::string ast::description(const AST& ast) {
 
 template <typename T>
 std::string to_string(T arg) {
-    if constexpr(std::is_pointer_v<std::remove_cv_t<T>> || util::typeinfo::is_shared_ptr_v<T>) {
+    if constexpr(std::is_pointer_v<std::remove_cv_t<T>>) {
         if (!arg) return "<nullptr>";
     }
     
@@ -278,10 +276,13 @@ std::string to_string(T arg) {
     } else if constexpr(std::is_base_of_v<std::string, T>) {
         return arg;
     
+    } else if constexpr(std::is_same_v<T, util::Symbol>) {
+        return arg.str();
+    
     } else if constexpr(std::is_integral_v<T>) {
         return std::to_string(arg);
     
-    } else if constexpr(std::is_same_v<T, TypeDesc*> || std::is_convertible_v<T, std::shared_ptr<TypeDesc>>) {
+    } else if constexpr(std::is_convertible_v<T, TypeDesc *>) {
         return arg->str();
         
     } else if constexpr(std::is_base_of_v<irgen::Type, typename std::remove_pointer_t<T>>) {
@@ -305,16 +306,16 @@ std::string to_string(T arg) {
     } else if constexpr(std::is_same_v<T, ast::Operator>) {
         return operatorToString(arg);
     
-    } else if constexpr(std::is_convertible_v<T, std::shared_ptr<Node>> || (std::is_pointer_v<T> && std::is_base_of_v<Node, typename std::remove_pointer_t<T>>)) {
+    } else if constexpr(std::is_pointer_v<T> && std::is_base_of_v<Node, typename std::remove_pointer_t<T>>) {
         return arg->description();
         
     } else if constexpr(std::is_convertible_v<T, const Node&>) {
         return arg.description();
         
-    } else if constexpr(util::typeinfo::is_vector_of_convertible_v<T, std::shared_ptr<Node>>) {
+    } else if constexpr(util::typeinfo::is_vector_of_convertible_v<T, Node *>) {
         return ast_vec_desc(arg, &Node::description);
     
-    } else if constexpr(util::typeinfo::is_vector_of_convertible_v<T, std::shared_ptr<TypeDesc>>) {
+    } else if constexpr(util::typeinfo::is_vector_of_convertible_v<T, TypeDesc *>) {
         return ast_vec_desc(arg, &TypeDesc::str);
         
     } else if constexpr(util::typeinfo::is_vector_v<T> && std::is_base_of_v<Node, typename T::value_type>) {
@@ -548,7 +549,7 @@ Mirror Reflect(const ast::BinOp *binop) {
 
 Mirror Reflect(const ast::RawLLVMValueExpr *rawLLVMExpr) {
     return {
-        { "type", ast::TypeDesc::makeResolved(rawLLVMExpr->type) },
+        { "type", rawLLVMExpr->type->str_desc() },
         { "value", "" }
     };
 }
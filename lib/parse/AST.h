@@ -9,9 +9,11 @@
 #pragma once
 
 #include "lex/SourceLocation.h"
+#include "ASTContext.h"
 #include "TypeDesc.h"
 #include "Attributes.h"
 #include "util/util.h"
+#include "util/Symbol.h"
 
 #include <memory>
 #include <iostream>
@@ -19,6 +21,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <functional>
+#include <mutex>
 
 
 namespace llvm {
@@ -35,7 +39,7 @@ namespace yo::ast {
 
 
 class TopLevelStmt;
-using AST = std::vector<std::shared_ptr<TopLevelStmt>>;
+using AST = std::vector<TopLevelStmt *>;
 using lex::SourceLocation;
 
 std::string description(const AST&);
@@ -83,6 +87,7 @@ class VarDecl;
 class CompoundStmt;
 
 
+/// Base class of all AST nodes. Nodes are owned by the ASTContext, and should be created via `ast::make`
 class Node {
 public:
     enum class Kind {
@@ -156,10 +161,11 @@ public:
 
 class Ident : public Expr {
 public:
-    const std::string value;
+    const util::Symbol value;
     
     CLASSOF_IMP(Node::Kind::Ident)
-    explicit Ident(std::string value) : Expr(Node::Kind::Ident), value(value) {}
+    explicit Ident(util::Symbol value) : Expr(Node::Kind::Ident), value(value) {}
+    explicit Ident(std::string_view value) : Expr(Node::Kind::Ident), value(value) {}
 };
 
 
@@ -179,10 +185,10 @@ enum class FunctionKind {
 class TemplateParamDeclList : public Node {
 public:
     struct Param {
-        std::shared_ptr<Ident> name;
-        std::shared_ptr<ast::TypeDesc> defaultType;
+        Ident *name = nullptr;
+        ast::TypeDesc *defaultType = nullptr;
         
-        explicit Param(std::shared_ptr<Ident> name, std::shared_ptr<ast::TypeDesc> defaultType = nullptr) : name(name), defaultType(defaultType) {}
+        explicit Param(Ident *name, ast::TypeDesc *defaultType = nullptr) : name(name), defaultType(defaultType) {}
     };
     
 private:
@@ -213,7 +219,7 @@ public:
 
 class TemplateParamArgList : public Node {
 public:
-    std::vector<std::shared_ptr<ast::TypeDesc>> elements;
+    std::vector<ast::TypeDesc *> elements;
     
     CLASSOF_IMP(Node::Kind::TemplateParamArgList)
     TemplateParamArgList() : Node(Node::Kind::TemplateParamArgList) {}
@@ -226,7 +232,7 @@ public:
         return size() == 0;
     }
     
-    std::shared_ptr<ast::TypeDesc> at(uint64_t idx) const {
+    ast::TypeDesc *at(uint64_t idx) const {
         return elements.at(idx);
     }
 };
@@ -237,7 +243,7 @@ public:
 // Helper class used for implementing functionality common to all declarations which can be templates
 class TemplateDecl {
 public:
-    std::shared_ptr<TemplateParamDeclList> templateParamsDecl;
+    TemplateParamDeclList *templateParamsDecl = nullptr;
     std::vector<irgen::Type *> templateInstantiationArguments;
     
     bool isTemplateDecl() const {
@@ -263,8 +269,8 @@ public:
 
 class FunctionSignature : public Node, public TemplateDecl {
 public:
-    std::shared_ptr<TypeDesc> returnType;
-    std::vector<std::shared_ptr<TypeDesc>> paramTypes;
+    TypeDesc *returnType = nullptr;
+    std::vector<TypeDesc *> paramTypes;
     bool isVariadic = false;
 
     CLASSOF_IMP(Node::Kind::FunctionSignature)
@@ -284,14 +290,19 @@ std::ostream& operator<<(std::ostream&, const ast::FunctionSignature&);
 
 /// A Function Declaration
 class FunctionDecl : public TopLevelStmt {
+    mutable ast::CompoundStmt *body = nullptr;
+    // Parses the function's body. Set if the body's parsing was deferred until it is first accessed
+    mutable std::function<ast::CompoundStmt *()> bodyParser;
+    // Guards `body` and `bodyParser`, since the first access to a lazily parsed body may happen concurrently
+    mutable std::mutex bodyMutex;
+    
 public:
     FunctionSignature signature;
-    std::vector<std::shared_ptr<ast::Ident>> paramNames;
-    std::shared_ptr<ast::CompoundStmt> body;
+    std::vector<ast::Ident *> paramNames;
     attributes::FunctionAttributes attributes;
     
     FunctionKind funcKind;
-    std::string name;
+    util::Symbol name;
     
     /// whether the function was declared as part of a templated impl block, and, as such, had additional parameters inserted into its template parameter list
     bool hasInsertedImplBlockTemplateParams = false;
@@ -302,25 +313,48 @@ public:
     
 public:
     CLASSOF_IMP(Node::Kind::FunctionDecl)
-    FunctionDecl(FunctionKind kind, std::string name, FunctionSignature sig, attributes::FunctionAttributes attr)
-    : TopLevelStmt(Node::Kind::FunctionDecl), signature(sig), body(std::make_shared<CompoundStmt>()), attributes(attr), funcKind(kind), name(name) {}
+    FunctionDecl(FunctionKind kind, util::Symbol name, FunctionSignature sig, attributes::FunctionAttributes attr, CompoundStmt *body)
+    : TopLevelStmt(Node::Kind::FunctionDecl), body(body), signature(sig), attributes(attr), funcKind(kind), name(name) {}
     
     FunctionKind getFunctionKind() const { return funcKind; }
     void setFunctionKind(FunctionKind kind) { funcKind = kind; }
     
-    const std::string& getName() const { return name; }
+    util::Symbol getName() const { return name; }
     
     FunctionSignature& getSignature() { return signature; }
     const FunctionSignature& getSignature() const { return signature; }
     
-    const std::vector<std::shared_ptr<Ident>>& getParamNames() const { return paramNames; }
-    void setParamNames(std::vector<std::shared_ptr<Ident>> names) { paramNames = names; }
+    const std::vector<Ident *>& getParamNames() const { return paramNames; }
+    void setParamNames(std::vector<Ident *> names) { paramNames = names; }
     
     attributes::FunctionAttributes& getAttributes() { return attributes; }
     const attributes::FunctionAttributes& getAttributes() const { return attributes; }
     
-    const std::shared_ptr<ast::CompoundStmt>& getBody() const { return body; }
-    void setBody(std::shared_ptr<ast::CompoundStmt> B) { body = B; }
+    ast::CompoundStmt *getBody() const {
+        std::lock_guard lock(bodyMutex);
+        if (bodyParser) {
+            body = bodyParser();
+            bodyParser = nullptr;
+        }
+        return body;
+    }
+    
+    void setBody(ast::CompoundStmt *B) {
+        std::lock_guard lock(bodyMutex);
+        body = B;
+        bodyParser = nullptr;
+    }
+    
+    /// Defers parsing the function's body until it is first accessed via `getBody`
+    void setBodyParser(std::function<ast::CompoundStmt *()> F) {
+        std::lock_guard lock(bodyMutex);
+        bodyParser = std::move(F);
+    }
+    
+    bool hasUnparsedBody() const {
+        std::lock_guard lock(bodyMutex);
+        return static_cast<bool>(bodyParser);
+    }
     
     bool isOfFunctionKind(FunctionKind kind) const {
         return funcKind == kind;
@@ -354,8 +388,8 @@ public:
 
 class StructDecl : public TopLevelStmt, public TemplateDecl {
 public:
-    std::string name;
-    std::vector<std::shared_ptr<VarDecl>> members;
+    util::Symbol name;
+    std::vector<VarDecl *> members;
     attributes::StructAttributes attributes;
     
     irgen::StructType *type = nullptr; // the irgen type for this struct decl
@@ -363,7 +397,7 @@ public:
     CLASSOF_IMP(Node::Kind::StructDecl)
     StructDecl() : TopLevelStmt(Node::Kind::StructDecl) {}
     
-    const std::string& getName() const { return name; }
+    util::Symbol getName() const { return name; }
 };
 
 
@@ -371,12 +405,12 @@ public:
 
 class ImplBlock : public TopLevelStmt, public TemplateDecl {
 public:
-    std::shared_ptr<ast::TypeDesc> typeDesc;
-    std::vector<std::shared_ptr<FunctionDecl>> methods;
+    ast::TypeDesc *typeDesc = nullptr;
+    std::vector<FunctionDecl *> methods;
     bool isNominalTemplateType = false;
 
     CLASSOF_IMP(Node::Kind::ImplBlock)
-    ImplBlock(std::shared_ptr<ast::TypeDesc> typeDesc) : TopLevelStmt(Node::Kind::ImplBlock), typeDesc(typeDesc) {}
+    ImplBlock(ast::TypeDesc *typeDesc) : TopLevelStmt(Node::Kind::ImplBlock), typeDesc(typeDesc) {}
 };
 
 
@@ -385,11 +419,11 @@ public:
 
 class TypealiasDecl : public TopLevelStmt {
 public:
-    std::string name;
-    std::shared_ptr<TypeDesc> type;
+    util::Symbol name;
+    TypeDesc *type = nullptr;
     
     CLASSOF_IMP(Node::Kind::TypealiasDecl)
-    TypealiasDecl(std::string name, std::shared_ptr<TypeDesc> type) : TopLevelStmt(Node::Kind::TypealiasDecl), name(name), type(type) {}
+    TypealiasDecl(util::Symbol name, TypeDesc *type) : TopLevelStmt(Node::Kind::TypealiasDecl), name(name), type(type) {}
 };
 
 
@@ -398,20 +432,20 @@ public:
 class VariantDecl : public TopLevelStmt, public TemplateDecl {
 public:
     struct MemberDecl {
-        std::shared_ptr<Ident> name;
-        std::shared_ptr<TypeDesc> params; // Should be a tuple type (TODO!)
+        Ident *name = nullptr;
+        TypeDesc *params = nullptr; // Should be a tuple type (TODO!)
         
-        MemberDecl(std::shared_ptr<Ident> N, std::shared_ptr<TypeDesc> P) : name(N), params(P) {}
+        MemberDecl(Ident *N, TypeDesc *P) : name(N), params(P) {}
     };
     
-    std::shared_ptr<Ident> name;
-//    std::shared_ptr<TemplateParamDeclList> templateParams;
+    Ident *name = nullptr;
+//    TemplateParamDeclList *templateParams = nullptr;
     std::vector<MemberDecl> members;
     
     CLASSOF_IMP(Node::Kind::VariantDecl)
-    VariantDecl(std::shared_ptr<Ident> N) : TopLevelStmt(Node::Kind::VariantDecl), name(N) {}
+    VariantDecl(Ident *N) : TopLevelStmt(Node::Kind::VariantDecl), name(N) {}
     
-    const std::string& getName() const {
+    util::Symbol getName() const {
         return name->value;
     }
 };
@@ -424,11 +458,11 @@ public:
 // TOOD rename to CompoundStmt?
 class CompoundStmt : public LocalStmt {
 public:
-    std::vector<std::shared_ptr<LocalStmt>> statements;
+    std::vector<LocalStmt *> statements;
     
     CLASSOF_IMP(Node::Kind::CompoundStmt)
     CompoundStmt() : LocalStmt(Node::Kind::CompoundStmt) {}
-    CompoundStmt(std::vector<std::shared_ptr<LocalStmt>> statements) : LocalStmt(Node::Kind::CompoundStmt), statements(statements) {}
+    CompoundStmt(std::vector<LocalStmt *> statements) : LocalStmt(Node::Kind::CompoundStmt), statements(statements) {}
     
     bool isEmpty() const {
         return statements.empty();
@@ -438,10 +472,10 @@ public:
 
 class ReturnStmt : public LocalStmt {
 public:
-    std::shared_ptr<Expr> expr;
+    Expr *expr = nullptr;
     
     CLASSOF_IMP(Node::Kind::ReturnStmt)
-    explicit ReturnStmt(std::shared_ptr<Expr> expr) : LocalStmt(Node::Kind::ReturnStmt), expr(expr) {}
+    explicit ReturnStmt(Expr *expr) : LocalStmt(Node::Kind::ReturnStmt), expr(expr) {}
 };
 
 
@@ -449,32 +483,32 @@ public:
 // TODO rename to VarDecl?
 class VarDecl : public LocalStmt {
 public:
-    std::shared_ptr<Ident> ident;
-    std::shared_ptr<TypeDesc> type;
-    std::shared_ptr<Expr> initialValue;
+    Ident *ident = nullptr;
+    TypeDesc *type = nullptr;
+    Expr *initialValue = nullptr;
     
     // eg `let &x = y;`
     // Requires `type` to be nil
     bool declaresUntypedReference = false;
     
     CLASSOF_IMP(Node::Kind::VarDecl)
-    VarDecl(std::shared_ptr<Ident> ident, std::shared_ptr<TypeDesc> type, std::shared_ptr<Expr> initialValue = nullptr)
+    VarDecl(Ident *ident, TypeDesc *type, Expr *initialValue = nullptr)
     : LocalStmt(Node::Kind::VarDecl), ident(ident), type(type), initialValue(initialValue) {}
     
-    const std::string& getName() const;
+    util::Symbol getName() const;
 };
 
 
 class Assignment : public LocalStmt {
 public:
-    std::shared_ptr<Expr> target;
-    std::shared_ptr<Expr> value;
+    Expr *target = nullptr;
+    Expr *value = nullptr;
     
     bool shouldDestructOldValue = true;
     bool overwriteReferences = false;
     
     CLASSOF_IMP(Node::Kind::Assignment)
-    Assignment(std::shared_ptr<Expr> target, std::shared_ptr<Expr> value) : LocalStmt(Node::Kind::Assignment), target(target), value(value) {}
+    Assignment(Expr *target, Expr *value) : LocalStmt(Node::Kind::Assignment), target(target), value(value) {}
 };
 
 
@@ -488,40 +522,40 @@ public:
         };
         
         BranchKind kind;
-        std::shared_ptr<Expr> condition; // nullptr if Kind == BranchKind::Else
-        std::shared_ptr<CompoundStmt> body;
+        Expr *condition = nullptr; // nullptr if Kind == BranchKind::Else
+        CompoundStmt *body = nullptr;
         
         CLASSOF_IMP(Node::Kind::IfStmtBranch)
-        Branch(BranchKind kind, std::shared_ptr<Expr> condition, std::shared_ptr<CompoundStmt> body)
+        Branch(BranchKind kind, Expr *condition, CompoundStmt *body)
         : Node(Node::Kind::IfStmtBranch), kind(kind), condition(condition), body(body) {}
     };
     
-    std::vector<std::shared_ptr<Branch>> branches;
+    std::vector<Branch *> branches;
     
     CLASSOF_IMP(Node::Kind::IfStmt)
-    IfStmt(std::vector<std::shared_ptr<Branch>> branches) : LocalStmt(Node::Kind::IfStmt), branches(branches) {}
+    IfStmt(std::vector<Branch *> branches) : LocalStmt(Node::Kind::IfStmt), branches(branches) {}
 };
 
 
 class WhileStmt : public LocalStmt {
 public:
-    std::shared_ptr<ast::Expr> condition;
-    std::shared_ptr<ast::CompoundStmt> body;
+    ast::Expr *condition = nullptr;
+    ast::CompoundStmt *body = nullptr;
     
     CLASSOF_IMP(Node::Kind::WhileStmt)
-    WhileStmt(std::shared_ptr<Expr> condition, std::shared_ptr<CompoundStmt> body) : LocalStmt(Node::Kind::WhileStmt), condition(condition), body(body) {}
+    WhileStmt(Expr *condition, CompoundStmt *body) : LocalStmt(Node::Kind::WhileStmt), condition(condition), body(body) {}
 };
 
 
 class ForLoop : public LocalStmt {
 public:
     bool capturesByReference = false;
-    std::shared_ptr<ast::Ident> ident;
-    std::shared_ptr<ast::Expr> expr;
-    std::shared_ptr<ast::CompoundStmt> body;
+    ast::Ident *ident = nullptr;
+    ast::Expr *expr = nullptr;
+    ast::CompoundStmt *body = nullptr;
     
     CLASSOF_IMP(Node::Kind::ForLoop)
-    ForLoop(std::shared_ptr<ast::Ident> ident, std::shared_ptr<ast::Expr> expr, std::shared_ptr<ast::CompoundStmt> body)
+    ForLoop(ast::Ident *ident, ast::Expr *expr, ast::CompoundStmt *body)
     : LocalStmt(Node::Kind::ForLoop), ident(ident), expr(expr), body(body) {}
 };
 
@@ -569,8 +603,8 @@ public:
     CLASSOF_IMP(Node::Kind::NumberLiteral)
     explicit NumberLiteral(uint64_t value, NumberType type) : Expr(Node::Kind::NumberLiteral), value(value), type(type) {}
     
-    static std::shared_ptr<NumberLiteral> integer(uint64_t value) {
-        return std::make_shared<NumberLiteral>(value, NumberType::Integer);
+    static NumberLiteral *integer(ASTContext &context, uint64_t value) {
+        return make<NumberLiteral>(context, value, NumberType::Integer);
     }
 };
 
@@ -594,20 +628,20 @@ public:
 
 class ExprStmt : public LocalStmt {
 public:
-    std::shared_ptr<ast::Expr> expr;
+    ast::Expr *expr = nullptr;
     
     CLASSOF_IMP(Node::Kind::ExprStmt)
-    explicit ExprStmt(std::shared_ptr<ast::Expr> expr) : LocalStmt(Node::Kind::ExprStmt), expr(expr) {}
+    explicit ExprStmt(ast::Expr *expr) : LocalStmt(Node::Kind::ExprStmt), expr(expr) {}
 };
 
 
 
 class TupleExpr : public Expr {
 public:
-    std::vector<std::shared_ptr<Expr>> elements;
+    std::vector<Expr *> elements;
     
     CLASSOF_IMP(Node::Kind::TupleExpr)
-    TupleExpr(std::vector<std::shared_ptr<Expr>> E) : Expr(Node::Kind::TupleExpr), elements(E) {}
+    TupleExpr(std::vector<Expr *> E) : Expr(Node::Kind::TupleExpr), elements(E) {}
     
     size_t numberOfElements() const {
         return elements.size();
@@ -618,11 +652,11 @@ public:
 // A reference to a static member of a type (for example a static method or an enum value)
 class StaticDeclRefExpr : public Expr {
 public:
-    std::shared_ptr<TypeDesc> typeDesc;
-    std::string memberName;
+    TypeDesc *typeDesc = nullptr;
+    util::Symbol memberName;
     
     CLASSOF_IMP(Node::Kind::StaticDeclRefExpr)
-    StaticDeclRefExpr(std::shared_ptr<TypeDesc> typeDesc, const std::string &memberName)
+    StaticDeclRefExpr(TypeDesc *typeDesc, util::Symbol memberName)
     : Expr(Node::Kind::StaticDeclRefExpr), typeDesc(typeDesc), memberName(memberName) {}
 };
 
@@ -632,12 +666,12 @@ public:
 // <expr>(<expr>*)
 class CallExpr : public Expr {
 public:
-    std::shared_ptr<Expr> target;
-    std::vector<std::shared_ptr<Expr>> arguments;
-    std::shared_ptr<ast::TemplateParamArgList> explicitTemplateArgs;
+    Expr *target = nullptr;
+    std::vector<Expr *> arguments;
+    ast::TemplateParamArgList *explicitTemplateArgs = nullptr;
     
     CLASSOF_IMP(Node::Kind::CallExpr)
-    CallExpr(std::shared_ptr<Expr> target, std::vector<std::shared_ptr<Expr>> arguments = {})
+    CallExpr(Expr *target, std::vector<Expr *> arguments = {})
     : Expr(Node::Kind::CallExpr), target(target), arguments(arguments) {}
     
     /// Whether the call has specifies explicit template arguments
@@ -657,11 +691,11 @@ public:
 // A member expression's source location should point to the first token after the target expression
 class MemberExpr : public Expr {
 public:
-    std::shared_ptr<Expr> target;
-    std::string memberName;
+    Expr *target = nullptr;
+    util::Symbol memberName;
     
     CLASSOF_IMP(Node::Kind::MemberExpr)
-    MemberExpr(std::shared_ptr<Expr> target, std::string memberName) : Expr(Node::Kind::MemberExpr), target(target), memberName(memberName) {}
+    MemberExpr(Expr *target, util::Symbol memberName) : Expr(Node::Kind::MemberExpr), target(target), memberName(memberName) {}
 };
 
 
@@ -669,11 +703,11 @@ public:
 // SourceLoc should point to the `[` character
 class SubscriptExpr : public Expr {
 public:
-    std::shared_ptr<ast::Expr> target;
-    std::vector<std::shared_ptr<ast::Expr>> args;
+    ast::Expr *target = nullptr;
+    std::vector<ast::Expr *> args;
     
     CLASSOF_IMP(Node::Kind::SubscriptExpr)
-    SubscriptExpr(std::shared_ptr<ast::Expr> target, std::vector<std::shared_ptr<ast::Expr>> args)
+    SubscriptExpr(ast::Expr *target, std::vector<ast::Expr *> args)
     : Expr(Node::Kind::SubscriptExpr), target(target), args(args) {}
 };
 
@@ -688,12 +722,12 @@ public:
     enum class CastKind {
         StaticCast, Bitcast
     };
-    std::shared_ptr<Expr> expr;
-    std::shared_ptr<TypeDesc> destType;
+    Expr *expr = nullptr;
+    TypeDesc *destType = nullptr;
     CastKind kind;
     
     CLASSOF_IMP(Node::Kind::CastExpr)
-    CastExpr(std::shared_ptr<Expr> expr, std::shared_ptr<TypeDesc> destType, CastKind kind)
+    CastExpr(Expr *expr, TypeDesc *destType, CastKind kind)
     : Expr(Node::Kind::CastExpr), expr(expr), destType(destType), kind(kind) {
         setSourceLocation(expr->getSourceLocation());
     }
@@ -703,13 +737,13 @@ public:
 
 class MatchExprPattern : public Node {
 public:
-    std::shared_ptr<ast::Expr> expr;
-    std::shared_ptr<ast::Expr> cond;
+    ast::Expr *expr = nullptr;
+    ast::Expr *cond = nullptr;
     
     MatchExprPattern() : Node(Kind::MatchExprPattern) {}
     
     CLASSOF_IMP(Node::Kind::MatchExprPattern)
-    MatchExprPattern(std::shared_ptr<ast::Expr> PE, std::shared_ptr<ast::Expr> CE)
+    MatchExprPattern(ast::Expr *PE, ast::Expr *CE)
     : Node(Kind::MatchExprPattern), expr(PE), cond(CE) {}
     
     bool hasCondition() const {
@@ -723,12 +757,12 @@ public:
 class MatchExprBranch : public Node {
 public:
     std::vector<MatchExprPattern> patterns;
-    std::shared_ptr<Expr> expr;
+    Expr *expr = nullptr;
     
     MatchExprBranch() : Node(Node::Kind::MatchExprBranch) {}
     
     CLASSOF_IMP(Node::Kind::MatchExprBranch)
-    MatchExprBranch(std::vector<MatchExprPattern> patterns, std::shared_ptr<Expr> expr)
+    MatchExprBranch(std::vector<MatchExprPattern> patterns, Expr *expr)
     : Node(Node::Kind::MatchExprBranch), patterns(patterns), expr(expr) {}
 };
 
@@ -738,11 +772,11 @@ public:
 class MatchExpr : public Expr {
 public:
     
-    std::shared_ptr<Expr> target;
+    Expr *target = nullptr;
     std::vector<MatchExprBranch> branches;
     
     CLASSOF_IMP(Node::Kind::MatchExpr)
-    MatchExpr(std::shared_ptr<Expr> target, std::vector<MatchExprBranch> branches) : Expr(Node::Kind::MatchExpr), target(target), branches(branches) {}
+    MatchExpr(Expr *target, std::vector<MatchExprBranch> branches) : Expr(Node::Kind::MatchExpr), target(target), branches(branches) {}
 };
 
 
@@ -751,21 +785,21 @@ public:
 class BinOp : public Expr {
 public:
     Operator op;
-    std::shared_ptr<Expr> lhs;
-    std::shared_ptr<Expr> rhs;
+    Expr *lhs = nullptr;
+    Expr *rhs = nullptr;
     bool _isInPlaceBinop = false;
     
     CLASSOF_IMP(Node::Kind::BinOp)
-    BinOp(Operator op, std::shared_ptr<Expr> lhs, std::shared_ptr<Expr> rhs)
+    BinOp(Operator op, Expr *lhs, Expr *rhs)
     : Expr(Node::Kind::BinOp), op(op), lhs(lhs), rhs(rhs) {}
     
     Operator getOperator() {
         return op;
     }
-    std::shared_ptr<Expr>& getLhs() {
+    Expr *&getLhs() {
         return lhs;
     }
-    std::shared_ptr<Expr>& getRhs() {
+    Expr *&getRhs() {
         return rhs;
     }
     bool isInPlaceBinop() {
@@ -789,10 +823,10 @@ public:
     };
     
     Operation op;
-    std::shared_ptr<ast::Expr> expr;
+    ast::Expr *expr = nullptr;
     
     CLASSOF_IMP(Node::Kind::UnaryExpr)
-    UnaryExpr(Operation op, std::shared_ptr<ast::Expr> expr) : Expr(Node::Kind::UnaryExpr), op(op), expr(expr) {}
+    UnaryExpr(Operation op, ast::Expr *expr) : Expr(Node::Kind::UnaryExpr), op(op), expr(expr) {}
 };
 
 
@@ -808,14 +842,14 @@ public:
     /// - `&x = <expr>` captures an expression by reference
     struct CaptureListElement {
         bool isReference = false; // TODO rename to capturesByReference or hasReferenceSemantics
-        std::shared_ptr<Ident> ident;
-        std::shared_ptr<Expr> expr;
+        Ident *ident = nullptr;
+        Expr *expr = nullptr;
     };
     
     std::vector<CaptureListElement> captureList;
     FunctionSignature signature;
-    std::vector<std::shared_ptr<Ident>> paramNames;
-    std::shared_ptr<CompoundStmt> body;
+    std::vector<Ident *> paramNames;
+    CompoundStmt *body = nullptr;
     
     // the struct generated for this lambda expression
     irgen::StructType *_structType = nullptr;
@@ -828,10 +862,10 @@ public:
 
 class ArrayLiteralExpr : public Expr {
 public:
-    std::vector<std::shared_ptr<Expr>> elements;
+    std::vector<Expr *> elements;
     
     CLASSOF_IMP(Node::Kind::ArrayLiteralExpr)
-    explicit ArrayLiteralExpr(std::vector<std::shared_ptr<Expr>> elements)
+    explicit ArrayLiteralExpr(std::vector<Expr *> elements)
     : Expr(Node::Kind::ArrayLiteralExpr), elements(elements) {}
 };
 
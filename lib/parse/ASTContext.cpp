@@ -0,0 +1,44 @@
+//
+//  ASTContext.cpp
+//  yo
+//
+
+#include "ASTContext.h"
+
+#include <atomic>
+
+using namespace yo;
+using namespace yo::ast;
+
+
+static std::atomic<uint64_t> nextContextId = 0;
+
+
+ASTContext::ASTContext() : id(nextContextId++) {}
+
+
+ASTContext::~ASTContext() {
+    for (auto &[threadId, arena] : arenas) {
+        for (auto it = arena->destructors.rbegin(); it != arena->destructors.rend(); it++) {
+            it->second(it->first);
+        }
+    }
+}
+
+
+ASTContext::Arena& ASTContext::getArenaForCurrentThread() {
+    // Most allocations come from the same thread as the previous one, so we cache the last arena (and the context it belongs to)
+    // to avoid taking the lock every time
+    thread_local uint64_t cachedContextId = UINT64_MAX;
+    thread_local Arena *cachedArena = nullptr;
+    if (cachedContextId != id) {
+        std::lock_guard lock(mutex);
+        auto &arena = arenas[std::this_thread::get_id()];
+        if (!arena) {
+            arena = std::make_unique<Arena>();
+        }
+        cachedContextId = id;
+        cachedArena = arena.get();
+    }
+    return *cachedArena;
+}
@@ -0,0 +1,67 @@
+//
+//  ASTContext.h
+//  yo
+//
+
+#pragma once
+
+#include "llvm/Support/Allocator.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace yo::ast {
+
+
+/// Owns all AST nodes (and type descs) created during a compilation.
+///
+/// Nodes are bump-allocated and only deallocated (all at once) when the context is destroyed, which means that they can
+/// be referenced via plain pointers. Since the parser creates nodes on multiple threads, every thread allocates from its own arena.
+/// The context is created by the driver and has to outlive everything referencing the AST (ie, the parser and irgen).
+class ASTContext {
+    struct Arena {
+        llvm::BumpPtrAllocator allocator;
+        // Objects w/ non-trivial destructors, in allocation order
+        std::vector<std::pair<void *, void(*)(void *)>> destructors;
+    };
+    
+    // Identifies the context in the per-thread arena cache. Unlike the context's address, this is never reused
+    const uint64_t id;
+    
+    std::mutex mutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<Arena>> arenas;
+    
+    Arena& getArenaForCurrentThread();
+    
+public:
+    ASTContext();
+    ASTContext(const ASTContext&) = delete;
+    ASTContext& operator=(const ASTContext&) = delete;
+    ~ASTContext();
+    
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        auto &arena = getArenaForCurrentThread();
+        auto object = new (arena.allocator.Allocate<T>()) T(std::forward<Args>(args)...);
+        if constexpr(!std::is_trivially_destructible_v<T>) {
+            arena.destructors.emplace_back(object, [](void *ptr) { static_cast<T *>(ptr)->~T(); });
+        }
+        return object;
+    }
+};
+
+
+/// Allocates a new node in the AST context
+template <typename T, typename... Args>
+T* make(ASTContext &context, Args&&... args) {
+    return context.make<T>(std::forward<Args>(args)...);
+}
+
+
+} // ns yo::ast
@@ -7,7 +7,7 @@
 //
 
 #include "ASTVisitor.h"
-#include "util/llvm_casting.h"
+#include "llvm/Support/Casting.h"
 
 
 namespace yo {
@@ -46,13 +46,13 @@ public:
     }
     
     
-    bool traverse(std::shared_ptr<ast::Node> node) {
-        if (auto TLS = std::dynamic_pointer_cast<TopLevelStmt>(node)) {
+    bool traverse(ast::Node *node) {
+        if (auto TLS = llvm::dyn_cast<TopLevelStmt>(node)) {
             return traverseTopLevelStmt(TLS);
-        } else if (auto localStmt = std::dynamic_pointer_cast<LocalStmt>(node)) {
+        } else if (auto localStmt = llvm::dyn_cast<LocalStmt>(node)) {
             LKFatalError("TODO");
             //return traverseLocalStmt(localStmt);
-        } else if (auto expr = std::dynamic_pointer_cast<Expr>(node)) {
+        } else if (auto expr = llvm::dyn_cast<Expr>(node)) {
             return traverseExpr(expr);
         } else {
             LKFatalError("unexpected node");
@@ -62,7 +62,7 @@ public:
     
     // MARK: TopLevelStmt traversal
     
-    bool traverseTopLevelStmt(std::shared_ptr<TopLevelStmt> TLS) {
+    bool traverseTopLevelStmt(TopLevelStmt *TLS) {
         switch (TLS->getKind()) {
             case NK::TypealiasDecl:
                 return traverseTypealiasDecl(llvm::cast<TypealiasDecl>(TLS));
@@ -79,25 +79,25 @@ public:
     }
     
     
-    bool traverseTypealiasDecl(std::shared_ptr<TypealiasDecl> TD) {
+    bool traverseTypealiasDecl(TypealiasDecl *TD) {
         TRY(visitTypealiasDecl(TD));
         TRY(traverseTypeDesc(TD->type));
         return true;
     }
     
-    bool traverseFunctionDecl(std::shared_ptr<ast::FunctionDecl> FD) {
+    bool traverseFunctionDecl(ast::FunctionDecl *FD) {
         TRY(visitFunctionDecl(FD));
         TRY(traverseFunctionSignature(FD->getSignature()));
         return true;
     }
     
-    bool traverseStructDecl(std::shared_ptr<StructDecl> decl) {
+    bool traverseStructDecl(StructDecl *decl) {
         TRY(visitStructDecl(decl));
         // TODO
         return true;
     }
     
-    bool traverseVariantDecl(std::shared_ptr<VariantDecl> decl) {
+    bool traverseVariantDecl(VariantDecl *decl) {
         TRY(visitVariantDecl(decl));
         // TODO
         return true;
@@ -114,7 +114,7 @@ public:
     }
     
     
-    bool traverseTypeDesc(std::shared_ptr<TypeDesc> typeDesc) {
+    bool traverseTypeDesc(TypeDesc *typeDesc) {
         TRY(visitTypeDesc(typeDesc));
         switch (typeDesc->getKind()) {
             case TypeDesc::Kind::Nominal:
@@ -160,7 +160,7 @@ public:
     }
     
     
-    bool traverseExpr(std::shared_ptr<Expr> expr) {
+    bool traverseExpr(Expr *expr) {
         TRY(visitExpr(expr));
         // TODO
         return true;
@@ -170,10 +170,10 @@ public:
     
     
 #define DEF_VISIT_FN(T) \
-bool visit##T(std::shared_ptr<T>) { return true; }
+bool visit##T(T *) { return true; }
     
 #define DEF_VISIT_FN_N(N, T) \
-bool visit##N(std::shared_ptr<T>) { return true; }
+bool visit##N(T *) { return true; }
 
 #define DEF_VISIT_FN_T(N, T) \
 bool visit##N(T) { return true; }
@@ -12,7 +12,7 @@
 #include "lex/Diagnostics.h"
 #include "yo/Mangling.h"
 #include "util/Format.h"
-#include "util/llvm_casting.h"
+#include "llvm/Support/Casting.h"
 #include "util/VectorUtils.h"
 
 #include <string>
@@ -93,23 +93,138 @@ static const MappedTokenSet<ast::UnaryExpr::Operation> unaryOperators = {
 // For example, if we parse an identifier, after returning from `ParseIdentifier`, Position would point to the token after that identifier
 
 
-std::vector<Token> lexFile(const std::string &path) {
-    auto contents = util::fs::read_file(path);
-    return Lexer(contents, path).lex();
+AST Parser::parse(const std::string &filepath) {
+    threadPool = std::make_unique<llvm::ThreadPool>(llvm::hardware_concurrency());
+    
+    {
+        std::unique_lock lock(modulesMutex);
+        addModule(filepath, lex::SourceLocation());
+        modulesCondition.wait(lock, [this] { return numPendingModules == 0; });
+    }
+    threadPool.reset();
+    
+    AST ast;
+    std::unordered_set<const Module *> visitedModules;
+    appendModuleDecls(*modules.at(filepath), ast, visitedModules);
+    return ast;
 }
 
 
-AST Parser::parse(const std::string &filepath) {
-    this->position = 0;
-    this->tokens = lexFile(filepath);
-    importedFiles.push_back(filepath);
+// Appends the module's declarations to the AST, w/ the declarations of imported modules taking the place of their (first) import.
+// This is the order in which a serial parser would encounter the declarations (and errors)
+void Parser::appendModuleDecls(const Module &module, AST &ast, std::unordered_set<const Module *> &visitedModules) const {
+    visitedModules.insert(&module);
+    if (module.loadError) {
+        diagnostics::emitDeferredError(*module.loadError);
+    }
     
-    AST ast;
-    while (position < tokens.size() && currentTokenKind() != TK::EOF_) {
-        ast.push_back(parseTopLevelStmt());
+    for (auto &item : module.items) {
+        if (auto stmt = std::get_if<TopLevelStmt *>(&item)) {
+            ast.push_back(*stmt);
+        } else if (auto &imported = *modules.at(std::get<std::string>(item)); !visitedModules.count(&imported)) {
+            appendModuleDecls(imported, ast, visitedModules);
+        }
     }
     
-    return ast;
+    if (module.parseError) {
+        diagnostics::emitDeferredError(*module.parseError);
+    }
+}
+
+
+// Must be called w/ the modules mutex locked
+void Parser::addModule(const std::string &name, const lex::SourceLocation &importLoc) {
+    auto &module = modules[name];
+    if (module) return;
+    
+    module = std::make_unique<Module>(name, importLoc);
+    numPendingModules++;
+    threadPool->async([this, module = module.get()] {
+        loadModule(*module);
+        std::lock_guard lock(modulesMutex);
+        if (--numPendingModules == 0) {
+            modulesCondition.notify_all();
+        }
+    });
+}
+
+
+// Lexes the module, schedules all modules imported by it, and then parses it.
+// Called on one of the thread pool's threads
+void Parser::loadModule(Module &module) {
+    diagnostics::DeferErrorsScope deferErrors;
+    
+    try {
+        lex::FileID fileId;
+        if (module.name[0] == ':') {
+            // Embedded stdlib module, these were already resolved when processing the import
+            fileId = sourceManager.addFileWithStaticContents(module.name, stdlib_resolution::getContentsOfModuleWithName(module.name).value());
+        } else if (auto id = sourceManager.loadFile(module.name)) {
+            fileId = *id;
+        } else {
+            diagnostics::emitError(sourceManager, module.importLoc, util::fmt::format("unable to read file '{}'", module.name));
+        }
+        module.tokenList = std::make_shared<lex::TokenList>(Lexer(sourceManager, fileId).lex());
+    } catch (const diagnostics::DeferredError &error) {
+        module.loadError = error;
+        return;
+    }
+    
+    // Find the module's imports before parsing it, so that the imported modules can already be processed in parallel
+    auto &tokenList = *module.tokenList;
+    auto &tokens = tokenList.getTokens();
+    for (int64_t i = 0; i + 1 < static_cast<int64_t>(tokens.size()); i++) {
+        if (tokens[i].getKind() != TK::Use || tokens[i + 1].getKind() != TK::StringLiteral) {
+            continue;
+        }
+        auto &import = module.imports.emplace_back(Import{ i, "", std::nullopt });
+        try {
+            import.moduleName = resolveImport(tokenList.getSourceLocation(tokens[i + 1]), tokenList.getStringValue(tokens[i + 1]),
+                                              sourceManager.getFilepath(tokenList.getFileId()));
+        } catch (const diagnostics::DeferredError &error) {
+            import.error = error;
+        }
+    }
+    
+    {
+        std::lock_guard lock(modulesMutex);
+        for (auto &import : module.imports) {
+            if (!import.error) {
+                addModule(import.moduleName, tokenList.getSourceLocation(tokens[import.tokenIndex + 1]));
+            }
+        }
+    }
+    
+    try {
+        Parser parser(astContext, sourceManager);
+        parser.tokenList = module.tokenList;
+        // Most of the stdlib isn't used by any given program, so we only parse the function bodies that are actually needed.
+        // The downside is that syntax errors in unused functions go unreported, which is why this isn't done for non-stdlib modules
+        parser.shouldParseFunctionBodiesLazily = module.name[0] == ':' || (customStdlibRoot && util::string::has_prefix(module.name, *customStdlibRoot));
+        parser.parseModule(module);
+    } catch (const diagnostics::DeferredError &error) {
+        module.parseError = error;
+    }
+}
+
+
+void Parser::parseModule(Module &module) {
+    uint64_t importIndex = 0;
+    
+    while (currentTokenKind() != TK::EOF_) {
+        if (currentTokenKind() == TK::Use && peekKind() == TK::StringLiteral) {
+            const auto &import = module.imports.at(importIndex++);
+            LKAssert(import.tokenIndex == position);
+            if (import.error) {
+                throw *import.error;
+            }
+            consume(2);
+            assertTkAndConsume(TK::Semicolon);
+            module.items.emplace_back(import.moduleName);
+        } else {
+            module.items.emplace_back(parseTopLevelStmt());
+        }
+    }
 }
 
 
@@ -117,14 +232,14 @@ AST Parser::parse(const std::string &filepath) {
 void Parser::unhandledToken(const Token &token) {
     std::ostringstream OS;
     OS << "Unhandled token: '" << token.getKind() << "'.";
-    diagnostics::emitError(token.getSourceLocation(), OS.str());
+    diagnostics::emitError(sourceManager, getSourceLocation(token), OS.str());
 }
 
 void Parser::assertTk(TK expected) {
     if (currentTokenKind() != expected) {
         std::ostringstream OS;
         OS << "Invalid token in source code. Expected: '" << expected << "'.";
-        diagnostics::emitError(getCurrentSourceLocation(), OS.str());
+        diagnostics::emitError(sourceManager, getCurrentSourceLocation(), OS.str());
     }
 }
 
@@ -142,44 +257,29 @@ std::string Parser::resolveImportPathRelativeToBaseDirectory(const lex::SourceLo
         return path;
     }
     
-    diagnostics::emitError(loc, util::fmt::format("Unable to resolve import of '{}' relative to '{}'", moduleName, baseDirectory));
+    diagnostics::emitError(sourceManager, loc, util::fmt::format("Unable to resolve import of '{}' relative to '{}'", moduleName, baseDirectory));
 }
 
 
 
-void Parser::resolveImport() {
-    auto baseDirectory = util::string::excludingLastPathComponent(currentToken().getSourceLocation().getFilepath());
-    assertTkAndConsume(TK::Use);
-    
-    auto importLoc = getCurrentSourceLocation();
-    auto moduleName = parseStringLiteral()->value;
-    assertTkAndConsume(TK::Semicolon);
-    
-    std::vector<Token> newTokens;
+// Returns the name of the module imported by a `use` directive in the file at `importingFilepath`.
+// This is either the imported file's path, or the name of an embedded stdlib module
+std::string Parser::resolveImport(const lex::SourceLocation &importLoc, std::string moduleName, const std::string &importingFilepath) {
+    auto baseDirectory = util::string::excludingLastPathComponent(importingFilepath);
     
     auto isStdlibImport = moduleName[0] == ':';
-    if (isStdlibImport && util::vector::contains(importedFiles, moduleName)) {
-        return;
-    } else if (isStdlibImport && !customStdlibRoot.has_value()) {
-        importedFiles.push_back(moduleName);
-        if (auto contents = stdlib_resolution::getContentsOfModuleWithName(moduleName)) {
-            newTokens = Lexer(*contents, moduleName).lex();
-        } else {
-            diagnostics::emitError(importLoc, util::fmt::format("unable to resolve stdlib module '{}'", moduleName));
-        }
-    } else {
-        if (isStdlibImport) {
-            importedFiles.push_back(moduleName);
-            moduleName.erase(moduleName.begin());
-            baseDirectory = customStdlibRoot.value();
+    if (isStdlibImport && !customStdlibRoot.has_value()) {
+        if (!stdlib_resolution::getContentsOfModuleWithName(moduleName)) {
+            diagnostics::emitError(sourceManager, importLoc, util::fmt::format("unable to resolve stdlib module '{}'", moduleName));
         }
-        auto path = resolveImportPathRelativeToBaseDirectory(importLoc, moduleName, baseDirectory);
-        if (util::vector::contains(importedFiles, path)) return;
-        importedFiles.push_back(path);
-        newTokens = lexFile(path);
+        return moduleName;
     }
     
-    tokens.insert(tokens.begin() + position, newTokens.begin(), newTokens.end() - 1); // exclude EOF_
+    if (isStdlibImport) {
+        moduleName.erase(moduleName.begin());
+        baseDirectory = customStdlibRoot.value();
+    }
+    return resolveImportPathRelativeToBaseDirectory(importLoc, moduleName, baseDirectory);
 }
 
 
@@ -213,7 +313,7 @@ ast::CallingConvention extractCallingConventionAttribute(const std::vector<attri
 // - A pointer
 // - A function type
 // - A structural type (TODO!?)
-std::shared_ptr<TypeDesc> Parser::parseType() {
+TypeDesc *Parser::parseType() {
     // TODO add source location to type statements?
     auto SL = getCurrentSourceLocation();
     auto attributes = parseAttributes();
@@ -224,16 +324,16 @@ std::shared_ptr<TypeDesc> Parser::parseType() {
             assertTkAndConsume(TK::OpeningParens);
             auto expr = parseExpression();
             assertTkAndConsume(TK::ClosingParens);
-            return TypeDesc::makeDecltype(expr, SL);
+            return TypeDesc::makeDecltype(astContext, expr, SL);
         }
             
         case TK::Ampersand: {
             consume();
-            return TypeDesc::makeReference(parseType(), SL);
+            return TypeDesc::makeReference(astContext, parseType(), SL);
         }
         case TK::Asterisk: {
             consume();
-            return TypeDesc::makePointer(parseType(), SL);
+            return TypeDesc::makePointer(astContext, parseType(), SL);
         }
         case TK::Ident: {
             // Issue: we have to be careful here. consider the following code:
@@ -244,13 +344,13 @@ std::shared_ptr<TypeDesc> Parser::parseType() {
             
             save_pos(fallback);
             
-            auto name = parseIdentAsString();
+            auto name = parseIdentAsSymbol();
             if (currentTokenKind() == TK::Colon) {
                 LKFatalError("TODO implement?");
             
             } else if (currentTokenKind() == TK::OpeningAngledBracket) {
                 consume();
-                std::vector<std::shared_ptr<TypeDesc>> paramTys;
+                std::vector<TypeDesc *> paramTys;
                 while (auto ty = parseType()) {
                     paramTys.push_back(ty);
                     if (currentTokenKind() == TK::Comma) {
@@ -270,18 +370,18 @@ std::shared_ptr<TypeDesc> Parser::parseType() {
                     return nullptr;
                 }
                 
-                return TypeDesc::makeNominalTemplated(name, paramTys, SL);
+                return TypeDesc::makeNominalTemplated(astContext, name, paramTys, SL);
             }
             
-            return TypeDesc::makeNominal(name, SL);
+            return TypeDesc::makeNominal(astContext, name, SL);
         }
         case TK::OpeningParens: {
             consume();
-            std::vector<std::shared_ptr<TypeDesc>> types;
+            std::vector<TypeDesc *> types;
             while (currentTokenKind() != TK::ClosingParens) {
                 auto ty = parseType();
                 if (!ty) {
-                    diagnostics::emitError(getCurrentSourceLocation(), "unable to parse type");
+                    diagnostics::emitError(sourceManager, getCurrentSourceLocation(), "unable to parse type");
                 }
                 types.push_back(ty);
                 if (currentTokenKind() == TK::Comma) {
@@ -295,13 +395,13 @@ std::shared_ptr<TypeDesc> Parser::parseType() {
                 consume(2);
                 auto cc = extractCallingConventionAttribute(attributes);
                 auto returnType = parseType();
-                return TypeDesc::makeFunction(cc, returnType, types, SL);
+                return TypeDesc::makeFunction(astContext, cc, returnType, types, SL);
             } else {
                 // Tuple type
                 //if (types.size() == 1) {
                 //    return types[0];
                 //}
-                return TypeDesc::makeTuple(types, SL);
+                return TypeDesc::makeTuple(astContext, types, SL);
             }
         }
         case TK::OpeningSquareBrackets: { // `[T]` := `Array<T>`
@@ -309,7 +409,7 @@ std::shared_ptr<TypeDesc> Parser::parseType() {
             consume();
             auto elementType = parseType();
             assertTkAndConsume(TK::ClosingSquareBrackets);
-            return TypeDesc::makeNominalTemplated("Array", { elementType }, loc);
+            return TypeDesc::makeNominalTemplated(astContext, util::Symbol("Array"), { elementType }, loc);
         }
         default:
             return nullptr;
@@ -324,10 +424,10 @@ std::shared_ptr<TypeDesc> Parser::parseType() {
 #pragma mark - ast::TopLevelStmt
 
 
-std::shared_ptr<TopLevelStmt> Parser::parseTopLevelStmt() {
-    std::shared_ptr<TopLevelStmt> stmt;
+TopLevelStmt *Parser::parseTopLevelStmt() {
+    TopLevelStmt *stmt = nullptr;
     auto attributeList = parseAttributes();
-    auto startLocation = currentToken().getSourceLocation();
+    auto startLocation = getCurrentSourceLocation();
     
     switch (currentToken().getKind()) {
         case TK::Fn: {
@@ -344,8 +444,8 @@ std::shared_ptr<TopLevelStmt> Parser::parseTopLevelStmt() {
         }
         case TK::Use: {
             if (peekKind() == TK::StringLiteral) {
-                resolveImport();
-                return parseTopLevelStmt();
+                // Imports are handled by `parseModule`, so we only end up here if there are attributes before the import
+                diagnostics::emitError(sourceManager, startLocation, "imports cannot have attributes");
             } else if (peekKind() == TK::Ident) {
                 stmt = parseTypealias();
                 break;
@@ -366,17 +466,17 @@ std::shared_ptr<TopLevelStmt> Parser::parseTopLevelStmt() {
 
 
 
-std::shared_ptr<ast::TemplateParamDeclList> Parser::parseTemplateParamDeclList() {
+ast::TemplateParamDeclList *Parser::parseTemplateParamDeclList() {
     if (currentTokenKind() != TK::OpeningAngledBracket) return nullptr;
     
-    auto paramList = std::make_shared<ast::TemplateParamDeclList>();
+    auto paramList = ast::make<ast::TemplateParamDeclList>(astContext);
     paramList->setSourceLocation(getCurrentSourceLocation());
     consume();
     
     while (true) {
         assertTk(TK::Ident);
         auto name = parseIdent();
-        std::shared_ptr<TypeDesc> initialValue = nullptr;
+        TypeDesc *initialValue = nullptr;
         if (currentTokenKind() == TK::EqualsSign) {
             consume();
             initialValue = parseType();
@@ -389,12 +489,12 @@ std::shared_ptr<ast::TemplateParamDeclList> Parser::parseTemplateParamDeclList()
         } else if (currentTokenKind() == TK::ClosingAngledBracket) {
             break;
         } else {
-            diagnostics::emitError(getCurrentSourceLocation(), "expected either ',' or '>'");
+            diagnostics::emitError(sourceManager, getCurrentSourceLocation(), "expected either ',' or '>'");
         }
     }
     
     if (paramList->isEmpty()) {
-        diagnostics::emitError(paramList->getSourceLocation(), "template parameter list cannot be empty");
+        diagnostics::emitError(sourceManager, paramList->getSourceLocation(), "template parameter list cannot be empty");
     }
     
     assertTkAndConsume(TK::ClosingAngledBracket);
@@ -402,11 +502,11 @@ std::shared_ptr<ast::TemplateParamDeclList> Parser::parseTemplateParamDeclList()
 }
 
 
-std::shared_ptr<StructDecl> Parser::parseStructDecl(attributes::StructAttributes attributes) {
+StructDecl *Parser::parseStructDecl(attributes::StructAttributes attributes) {
     assertTkAndConsume(TK::Struct);
     
-    auto decl = std::make_shared<StructDecl>();
-    decl->name = parseIdentAsString();
+    auto decl = make<StructDecl>(astContext);
+    decl->name = parseIdentAsSymbol();
     decl->attributes = attributes;
     decl->templateParamsDecl = parseTemplateParamDeclList();
     
@@ -417,10 +517,10 @@ std::shared_ptr<StructDecl> Parser::parseStructDecl(attributes::StructAttributes
 }
 
 
-std::shared_ptr<ImplBlock> Parser::parseImplBlock() {
+ImplBlock *Parser::parseImplBlock() {
     assertTkAndConsume(TK::Impl);
     
-    std::shared_ptr<ast::TemplateParamDeclList> templateParamsDecl;
+    ast::TemplateParamDeclList *templateParamsDecl = nullptr;
     
     if (currentTokenKind() == TK::OpeningAngledBracket) {
         templateParamsDecl = parseTemplateParamDeclList();
@@ -429,7 +529,7 @@ std::shared_ptr<ImplBlock> Parser::parseImplBlock() {
     auto typeDesc = parseType();
     assertTkAndConsume(TK::OpeningCurlyBraces);
     
-    auto implBlock = std::make_shared<ImplBlock>(typeDesc);
+    auto implBlock = make<ImplBlock>(astContext, typeDesc);
     implBlock->templateParamsDecl = templateParamsDecl;
     
     while (currentTokenKind() == TK::Fn || currentTokenKind() == TK::Hashtag) {
@@ -481,7 +581,7 @@ std::vector<yo::attributes::Attribute> Parser::parseAttributes() {
                 consume();
                 if (auto value = parseStringLiteral()) {
                     if (value->kind != StringLiteral::StringLiteralKind::NormalString) {
-                        diagnostics::emitError(value->getSourceLocation(), "Attribute string value must be a regular string");
+                        diagnostics::emitError(sourceManager, value->getSourceLocation(), "Attribute string value must be a regular string");
                     }
                     attributes.push_back(yo::attributes::Attribute(key, value->value));
                 } else if (auto ident = parseIdent()) {
@@ -521,7 +621,7 @@ std::vector<yo::attributes::Attribute> Parser::parseAttributes() {
 
 
 
-std::shared_ptr<FunctionDecl> Parser::parseFunctionDecl(attributes::FunctionAttributes attributes) {
+FunctionDecl *Parser::parseFunctionDecl(attributes::FunctionAttributes attributes) {
     auto functionKind = FunctionKind::GlobalFunction; // initial assumption
     
     assertTk(TK::Fn);
@@ -530,20 +630,20 @@ std::shared_ptr<FunctionDecl> Parser::parseFunctionDecl(attributes::FunctionAttr
     
     FunctionSignature signature;
     signature.setSourceLocation(loc);
-    std::vector<std::shared_ptr<Ident>> paramNames;
+    std::vector<Ident *> paramNames;
     
-    auto name = parseIdentAsString();
+    auto name = parseIdentAsSymbol();
     if (name == "operator") {
         auto op = parseOperator(true);
         if (!op.has_value()) {
-            diagnostics::emitError(loc, "Unable to parse operator");
+            diagnostics::emitError(sourceManager, loc, "Unable to parse operator");
         }
         name = mangling::encodeOperator(op.value());
     }
     
     parseFunctionSignatureAndParamNames(signature, paramNames);
     
-    auto fnDecl = std::make_shared<FunctionDecl>(functionKind, name, signature, attributes);
+    auto fnDecl = make<FunctionDecl>(astContext, functionKind, name, signature, attributes, make<CompoundStmt>(astContext));
     fnDecl->setSourceLocation(loc);
     fnDecl->setParamNames(paramNames);
     
@@ -553,6 +653,22 @@ std::shared_ptr<FunctionDecl> Parser::parseFunctionDecl(attributes::FunctionAttr
         return fnDecl;
     }
     
+    if (shouldParseFunctionBodiesLazily && currentTokenKind() == TK::OpeningCurlyBraces) {
+        if (auto end = findMatchingClosingCurlyBraces()) {
+            fnDecl->setBodyParser([&astContext = astContext, &sourceManager = sourceManager, tokenList = tokenList, start = position, end = *end]() {
+                Parser parser(astContext, sourceManager);
+                parser.tokenList = tokenList;
+                parser.position = start;
+                auto body = parser.parseCompoundStmt();
+                LKAssert(parser.position == end + 1);
+                return body;
+            });
+            position = *end + 1;
+            return fnDecl;
+        }
+        // No matching closing braces, parse the body now so that we report a proper error
+    }
+    
     auto body = parseCompoundStmt();
     fnDecl->setBody(body);
     
@@ -560,20 +676,42 @@ std::shared_ptr<FunctionDecl> Parser::parseFunctionDecl(attributes::FunctionAttr
 }
 
 
+// Returns the index of the closing curly braces matching the opening curly braces at the current position, or nullopt if there are none
+std::optional<int64_t> Parser::findMatchingClosingCurlyBraces() {
+    LKAssert(currentTokenKind() == TK::OpeningCurlyBraces);
+    auto &tokens = tokenList->getTokens();
+    uint64_t depth = 0;
+    
+    for (int64_t i = position; i < static_cast<int64_t>(tokens.size()); i++) {
+        switch (tokens[i].getKind()) {
+            case TK::OpeningCurlyBraces:
+                depth++;
+                break;
+            case TK::ClosingCurlyBraces:
+                if (--depth == 0) return i;
+                break;
+            default:
+                break;
+        }
+    }
+    return std::nullopt;
+}
+
+
 
 
-std::shared_ptr<VariantDecl> Parser::parseVariantDecl() {
+VariantDecl *Parser::parseVariantDecl() {
     auto SL = getCurrentSourceLocation();
     assertTkAndConsume(TK::Variant);
     
-    auto decl = std::make_shared<VariantDecl>(parseIdent());
+    auto decl = make<VariantDecl>(astContext, parseIdent());
     decl->templateParamsDecl = parseTemplateParamDeclList();
     
     assertTkAndConsume(TK::OpeningCurlyBraces);
     
     while (true) {
         auto name = parseIdent();
-        std::shared_ptr<TypeDesc> type;
+        TypeDesc *type = nullptr;
         if (currentTokenKind() == TK::OpeningParens) {
             type = parseType();
             LKAssert(type && type->isTuple());
@@ -601,8 +739,8 @@ std::shared_ptr<VariantDecl> Parser::parseVariantDecl() {
 
 
 
-std::vector<std::shared_ptr<ast::VarDecl>> Parser::parseStructPropertyDeclList() {
-    std::vector<std::shared_ptr<ast::VarDecl>> decls;
+std::vector<ast::VarDecl *> Parser::parseStructPropertyDeclList() {
+    std::vector<ast::VarDecl *> decls;
     
     while (currentTokenKind() != TK::ClosingCurlyBraces) {
         // TODO
@@ -614,13 +752,13 @@ std::vector<std::shared_ptr<ast::VarDecl>> Parser::parseStructPropertyDeclList()
         assertTkAndConsume(TK::Colon);
         auto type = parseType();
         
-        auto decl = std::make_shared<ast::VarDecl>(ident, type);
+        auto decl = ast::make<ast::VarDecl>(astContext, ident, type);
         decl->setSourceLocation(loc);
         decls.push_back(decl);
         
         if (currentTokenKind() == TK::Comma) {
             if (peekKind() != TK::Ident) {
-                diagnostics::emitError(getCurrentSourceLocation(), "Expected property declaration");
+                diagnostics::emitError(sourceManager, getCurrentSourceLocation(), "Expected property declaration");
             }
             consume();
         }
@@ -640,7 +778,7 @@ static const TokenSet functionParameterInitialTokens = {
 
 
 /// Parses a functions signature, and its parameter names
-void Parser::parseFunctionSignatureAndParamNames(FunctionSignature &signature, std::vector<std::shared_ptr<ast::Ident>> &paramNames) {
+void Parser::parseFunctionSignatureAndParamNames(FunctionSignature &signature, std::vector<ast::Ident *> &paramNames) {
     constexpr auto delimiter = TK::ClosingParens;
     
     if (currentTokenKind() == TK::OpeningAngledBracket) {
@@ -653,8 +791,8 @@ void Parser::parseFunctionSignatureAndParamNames(FunctionSignature &signature, s
     for (uint64_t index = 0; currentTokenKind() != delimiter; index++) {
         LKAssert(pos_lastEntry != position); pos_lastEntry = position; // TODO do we ever end up here?
         
-        std::shared_ptr<Ident> ident;
-        std::shared_ptr<TypeDesc> type;
+        Ident *ident = nullptr;
+        TypeDesc *type = nullptr;
         
         if (currentTokenKind() == TK::Ident && peekKind(1) == TK::Colon && peekKind(2) != TK::Colon) {
             // <ident>: <type>
@@ -662,7 +800,7 @@ void Parser::parseFunctionSignatureAndParamNames(FunctionSignature &signature, s
             assertTkAndConsume(TK::Colon);
             type = parseType();
         } else {
-            ident = std::make_shared<Ident>(std::string("$").append(std::to_string(index)));
+            ident = make<Ident>(astContext, std::string("$").append(std::to_string(index)));
             ident->setSourceLocation(getCurrentSourceLocation());
             type = parseType();
         }
@@ -672,14 +810,14 @@ void Parser::parseFunctionSignatureAndParamNames(FunctionSignature &signature, s
             consume(3);
         }
         
-        if (!type) diagnostics::emitError(ident->getSourceLocation(), "Unable to parse type");
+        if (!type) diagnostics::emitError(sourceManager, ident->getSourceLocation(), "Unable to parse type");
         
         paramNames.push_back(ident);
         signature.paramTypes.push_back(type);
         
         if (currentTokenKind() == TK::Comma) {
             if (!functionParameterInitialTokens.contains(peekKind())) {
-                diagnostics::emitError(getCurrentSourceLocation(), "Expected parameter declaration");
+                diagnostics::emitError(sourceManager, getCurrentSourceLocation(), "Expected parameter declaration");
             }
             consume();
         }
@@ -692,23 +830,23 @@ void Parser::parseFunctionSignatureAndParamNames(FunctionSignature &signature, s
             consume(2);
             signature.returnType = parseType();
         } else {
-            diagnostics::emitError(getSourceLocation(1), "expected '->' following function signature");
+            diagnostics::emitError(sourceManager, getSourceLocation(1), "expected '->' following function signature");
         }
     } else {
-        signature.returnType = TypeDesc::makeNominal("void");
+        signature.returnType = TypeDesc::makeNominal(astContext, util::Symbol("void"));
     }
 }
 
 
 
-std::shared_ptr<ast::TypealiasDecl> Parser::parseTypealias() {
+ast::TypealiasDecl *Parser::parseTypealias() {
     auto sourceLoc = getCurrentSourceLocation();
     assertTkAndConsume(TK::Use);
-    auto name = parseIdentAsString();
+    auto name = parseIdentAsSymbol();
     assertTkAndConsume(TK::EqualsSign);
     auto type = parseType();
     assertTkAndConsume(TK::Semicolon);
-    auto decl = std::make_shared<ast::TypealiasDecl>(name, type);
+    auto decl = ast::make<ast::TypealiasDecl>(astContext, name, type);
     decl->setSourceLocation(sourceLoc);
     return decl;
 }
@@ -718,7 +856,7 @@ std::shared_ptr<ast::TypealiasDecl> Parser::parseTypealias() {
 #pragma mark - ast::LocalStmt
 
 
-std::shared_ptr<LocalStmt> Parser::parseLocalStmt() {
+LocalStmt *Parser::parseLocalStmt() {
     switch (currentTokenKind()) {
         case TK::Return:   return parseReturnStmt();
         case TK::Let:      return parseVariableDecl();
@@ -732,8 +870,8 @@ std::shared_ptr<LocalStmt> Parser::parseLocalStmt() {
     
     auto sourceLoc = getCurrentSourceLocation();
     
-    std::shared_ptr<LocalStmt> stmt;
-    std::shared_ptr<Expr> expr; // A partially-parsed part of a local statement
+    LocalStmt *stmt = nullptr;
+    Expr *expr = nullptr; // A partially-parsed part of a local statement
     
     expr = parseExpression();
     LKAssert(expr);
@@ -743,7 +881,7 @@ std::shared_ptr<LocalStmt> Parser::parseLocalStmt() {
         consume();
         auto value = parseExpression();
         assertTkAndConsume(TK::Semicolon);
-        auto assignment = std::make_shared<ast::Assignment>(expr, value);
+        auto assignment = ast::make<ast::Assignment>(astContext, expr, value);
         assignment->setSourceLocation(sourceLoc);
         return assignment;
     }
@@ -756,10 +894,10 @@ std::shared_ptr<LocalStmt> Parser::parseLocalStmt() {
                 consume();
                 // TODO make sure this does not evaluate lhs twice!!!!!
                 auto rhs = parseExpression();
-                auto binop = std::make_shared<BinOp>(*op, expr, rhs);
+                auto binop = make<BinOp>(astContext, *op, expr, rhs);
                 binop->setSourceLocation(SL_binop);
                 binop->setIsInPlaceBinop(true);
-                stmt = std::make_shared<Assignment>(expr, binop);
+                stmt = make<Assignment>(astContext, expr, binop);
                 stmt->setSourceLocation(SL_ass);
             } else {
                 unhandledToken(currentToken());
@@ -773,7 +911,7 @@ std::shared_ptr<LocalStmt> Parser::parseLocalStmt() {
     if (currentTokenKind() == TK::Semicolon) {
         consume();
         if (expr && !stmt) {
-            auto exprStmt = std::make_shared<ast::ExprStmt>(expr);
+            auto exprStmt = ast::make<ast::ExprStmt>(astContext, expr);
             exprStmt->setSourceLocation(sourceLoc);
             return exprStmt;
         } else if (stmt) {
@@ -785,11 +923,11 @@ std::shared_ptr<LocalStmt> Parser::parseLocalStmt() {
 }
 
 
-std::shared_ptr<CompoundStmt> Parser::parseCompoundStmt() {
+CompoundStmt *Parser::parseCompoundStmt() {
     auto sourceLoc = getCurrentSourceLocation();
     assertTkAndConsume(TK::OpeningCurlyBraces);
     
-    auto stmt = std::make_shared<CompoundStmt>();
+    auto stmt = make<CompoundStmt>(astContext);
     stmt->setSourceLocation(sourceLoc);
     while (currentTokenKind() != TK::ClosingCurlyBraces) {
         stmt->statements.push_back(parseLocalStmt());
@@ -800,25 +938,25 @@ std::shared_ptr<CompoundStmt> Parser::parseCompoundStmt() {
 }
 
 
-std::shared_ptr<ReturnStmt> Parser::parseReturnStmt() {
+ReturnStmt *Parser::parseReturnStmt() {
     auto sourceLoc = getCurrentSourceLocation();
     assertTkAndConsume(TK::Return);
     
     if (currentTokenKind() == TK::Semicolon) {
         consume();
-        return std::make_shared<ReturnStmt>(nullptr);
+        return make<ReturnStmt>(astContext, nullptr);
     }
     
     auto expr = parseExpression();
     assertTkAndConsume(TK::Semicolon);
-    auto retStmt = std::make_shared<ReturnStmt>(expr);
+    auto retStmt = make<ReturnStmt>(astContext, expr);
     retStmt->setSourceLocation(sourceLoc);
     return retStmt;
 }
 
 
 
-std::shared_ptr<VarDecl> Parser::parseVariableDecl() {
+VarDecl *Parser::parseVariableDecl() {
     auto sourceLoc = getCurrentSourceLocation();
     assertTkAndConsume(TK::Let);
     
@@ -829,12 +967,12 @@ std::shared_ptr<VarDecl> Parser::parseVariableDecl() {
     }
     
     auto ident = parseIdent();
-    std::shared_ptr<TypeDesc> type;
-    std::shared_ptr<Expr> initialValue;
+    TypeDesc *type = nullptr;
+    Expr *initialValue = nullptr;
     
     if (currentTokenKind() == TK::Colon) {
         if (declaresUntypedReference) {
-            diagnostics::emitError(getCurrentSourceLocation(), "cannot specify both a type and the reference operator"); // TODO better wording
+            diagnostics::emitError(sourceManager, getCurrentSourceLocation(), "cannot specify both a type and the reference operator"); // TODO better wording
         }
         consume();
         type = parseType();
@@ -844,17 +982,17 @@ std::shared_ptr<VarDecl> Parser::parseVariableDecl() {
         consume();
         initialValue = parseExpression();
         if (!initialValue) {
-            diagnostics::emitError(getCurrentSourceLocation(), "expected expression");
+            diagnostics::emitError(sourceManager, getCurrentSourceLocation(), "expected expression");
         }
     } else {
         initialValue = nullptr;
         // TOOD should this be a parse-time error?
-        //diagnostics::emitError(getCurrentSourceLocation(), "expected initial value");
+        //diagnostics::emitError(sourceManager, getCurrentSourceLocation(), "expected initial value");
     }
     
     assertTkAndConsume(TK::Semicolon);
     
-    auto decl = std::make_shared<VarDecl>(ident, type, initialValue);
+    auto decl = make<VarDecl>(astContext, ident, type, initialValue);
     decl->setSourceLocation(sourceLoc);
     decl->declaresUntypedReference = declaresUntypedReference;
     return decl;
@@ -862,33 +1000,33 @@ std::shared_ptr<VarDecl> Parser::parseVariableDecl() {
 
 
 
-std::shared_ptr<IfStmt> Parser::parseIfStmt() {
+IfStmt *Parser::parseIfStmt() {
     using Kind = ast::IfStmt::Branch::BranchKind;
     
     auto sourceLoc = getCurrentSourceLocation();
     assertTkAndConsume(TK::If);
     
-    std::vector<std::shared_ptr<IfStmt::Branch>> branches;
+    std::vector<IfStmt::Branch *> branches;
     
     auto mainExpr = parseExpression();
     assertTk(TK::OpeningCurlyBraces);
     
-    branches.push_back(std::make_shared<IfStmt::Branch>(Kind::If, mainExpr, parseCompoundStmt()));
+    branches.push_back(make<IfStmt::Branch>(astContext, Kind::If, mainExpr, parseCompoundStmt()));
     
     while (currentTokenKind() == TK::Else && peekKind() == TK::If) {
         consume(2);
         auto expr = parseExpression();
         assertTk(TK::OpeningCurlyBraces);
         auto body = parseCompoundStmt();
-        branches.push_back(std::make_shared<IfStmt::Branch>(Kind::ElseIf, expr, body));
+        branches.push_back(make<IfStmt::Branch>(astContext, Kind::ElseIf, expr, body));
     }
     
     if (currentTokenKind() == TK::Else && peekKind() == TK::OpeningCurlyBraces) {
         consume();
-        branches.push_back(std::make_shared<IfStmt::Branch>(Kind::Else, nullptr, parseCompoundStmt()));
+        branches.push_back(make<IfStmt::Branch>(astContext, Kind::Else, nullptr, parseCompoundStmt()));
     }
     
-    auto ifStmt = std::make_shared<ast::IfStmt>(branches);
+    auto ifStmt = ast::make<ast::IfStmt>(astContext, branches);
     ifStmt->setSourceLocation(sourceLoc);
     return ifStmt;
 }
@@ -896,21 +1034,21 @@ std::shared_ptr<IfStmt> Parser::parseIfStmt() {
 
 
 
-std::shared_ptr<ast::WhileStmt> Parser::parseWhileStmt() {
+ast::WhileStmt *Parser::parseWhileStmt() {
     auto sourceLoc = getCurrentSourceLocation();
     assertTkAndConsume(TK::While);
     
     auto condition = parseExpression();
     assertTk(TK::OpeningCurlyBraces);
     
-    auto stmt = std::make_shared<ast::WhileStmt>(condition, parseCompoundStmt());
+    auto stmt = ast::make<ast::WhileStmt>(astContext, condition, parseCompoundStmt());
     stmt->setSourceLocation(sourceLoc);
     return stmt;
 }
 
 
 
-std::shared_ptr<ForLoop> Parser::parseForLoop() {
+ForLoop *Parser::parseForLoop() {
     auto sourceLoc = getCurrentSourceLocation();
     assertTkAndConsume(TK::For);
     
@@ -928,7 +1066,7 @@ std::shared_ptr<ForLoop> Parser::parseForLoop() {
     assertTk(TK::OpeningCurlyBraces);
     auto body = parseCompoundStmt();
     
-    auto stmt = std::make_shared<ForLoop>(ident, expr, body);
+    auto stmt = make<ForLoop>(astContext, ident, expr, body);
     stmt->capturesByReference = capturesByReference;
     stmt->setSourceLocation(sourceLoc);
     return stmt;
@@ -936,7 +1074,7 @@ std::shared_ptr<ForLoop> Parser::parseForLoop() {
 
 
 
-std::shared_ptr<BreakContStmt> Parser::parseBreakOrContinueStmt() {
+BreakContStmt *Parser::parseBreakOrContinueStmt() {
     BreakContStmt::Kind K;
     auto SL = getCurrentSourceLocation();
     
@@ -948,7 +1086,7 @@ std::shared_ptr<BreakContStmt> Parser::parseBreakOrContinueStmt() {
     consume();
     assertTkAndConsume(TK::Semicolon);
     
-    auto stmt = std::make_shared<BreakContStmt>(K);
+    auto stmt = make<BreakContStmt>(astContext, K);
     stmt->setSourceLocation(SL);
     return stmt;
 }
@@ -962,10 +1100,10 @@ std::shared_ptr<BreakContStmt> Parser::parseBreakOrContinueStmt() {
 
 // Parses a (potentially empty) list of expressions separated by commas, until Delimiter is reached
 // The delimiter is not consumed
-std::vector<std::shared_ptr<Expr>> Parser::parseExpressionList(TK delimiter) {
+std::vector<Expr *> Parser::parseExpressionList(TK delimiter) {
     if (currentTokenKind() == delimiter) return {};
     
-    std::vector<std::shared_ptr<Expr>> expressions;
+    std::vector<Expr *> expressions;
     
     do {
         expressions.push_back(parseExpression());
@@ -980,30 +1118,30 @@ std::vector<std::shared_ptr<Expr>> Parser::parseExpressionList(TK delimiter) {
 }
 
 
-std::shared_ptr<TupleExpr> Parser::parseTupleExpr() {
+TupleExpr *Parser::parseTupleExpr() {
     auto SL = getCurrentSourceLocation();
     assertTkAndConsume(TK::OpeningParens);
     
     auto elements = parseExpressionList(TK::ClosingParens);
     assertTkAndConsume(TK::ClosingParens);
     
-    auto tupleExpr = std::make_shared<TupleExpr>(elements);
+    auto tupleExpr = make<TupleExpr>(astContext, elements);
     tupleExpr->setSourceLocation(SL);
     return tupleExpr;
 }
 
 
 
-std::string Parser::parseIdentAsString() {
+util::Symbol Parser::parseIdentAsSymbol() {
     assertTk(TK::Ident);
-    auto val = currentToken().getData<std::string>();
+    auto symbol = tokenList->getIdentifier(currentToken());
     consume();
-    return val;
+    return symbol;
 }
 
-std::shared_ptr<Ident> Parser::parseIdent() {
+Ident *Parser::parseIdent() {
     if (currentTokenKind() != TK::Ident) return nullptr;
-    auto ident = std::make_shared<Ident>(currentToken().getData<std::string>());
+    auto ident = make<Ident>(astContext, tokenList->getIdentifier(currentToken()));
     ident->setSourceLocation(getCurrentSourceLocation());
     consume();
     return ident;
@@ -1012,7 +1150,7 @@ std::shared_ptr<Ident> Parser::parseIdent() {
 
 
 // Problem: the array literal syntax introduces ambiguity w/ the lambda syntax, more specifically the capture list.
-std::shared_ptr<ArrayLiteralExpr> Parser::parseArrayLiteral() {
+ArrayLiteralExpr *Parser::parseArrayLiteral() {
     LKFatalError("TODO: handle potential ambiguities");
     auto SL = getCurrentSourceLocation();
     assertTkAndConsume(TK::OpeningSquareBrackets);
@@ -1020,7 +1158,7 @@ std::shared_ptr<ArrayLiteralExpr> Parser::parseArrayLiteral() {
     auto elements = parseExpressionList(TK::ClosingSquareBrackets);
     assertTkAndConsume(TK::ClosingSquareBrackets);
     
-    auto expr = std::make_shared<ArrayLiteralExpr>(elements);
+    auto expr = make<ArrayLiteralExpr>(astContext, elements);
     expr->setSourceLocation(SL);
     return expr;
 }
@@ -1091,14 +1229,14 @@ static const TokenSet expressionDelimitingTokens = {
 };
 
 
-std::shared_ptr<Expr> Parser::parseExpression(PrecedenceGroup precedenceGroupConstraint) {
+Expr *Parser::parseExpression(PrecedenceGroup precedenceGroupConstraint) {
     if (expressionDelimitingTokens.contains(currentTokenKind())) {
         return nullptr;
     }
     
     auto sourceLoc = getCurrentSourceLocation();
     
-    std::shared_ptr<Expr> expr;
+    Expr *expr = nullptr;
     
     switch (currentTokenKind()) {
         case TK::OpeningParens: {
@@ -1134,7 +1272,7 @@ std::shared_ptr<Expr> Parser::parseExpression(PrecedenceGroup precedenceGroupCon
         case TK::Ident: {
             expr = parseIdent();
             save_pos(fallback_pos_after_ident);
-            std::shared_ptr<TemplateParamArgList> templateParamsArgList;
+            TemplateParamArgList *templateParamsArgList = nullptr;
             
             if (currentTokenKind() == TK::OpeningAngledBracket) {
                 templateParamsArgList = parseTemplateArgumentList();
@@ -1142,17 +1280,17 @@ std::shared_ptr<Expr> Parser::parseExpression(PrecedenceGroup precedenceGroupCon
             
             if (currentTokenKind() == TK::Colon && peekKind() == TK::Colon) {
                 auto &ident = llvm::cast<Ident>(expr)->value;
-                std::shared_ptr<TypeDesc> typeDesc;
+                TypeDesc *typeDesc = nullptr;
                 
                 if (!templateParamsArgList) {
-                    typeDesc = TypeDesc::makeNominal(ident);
+                    typeDesc = TypeDesc::makeNominal(astContext, ident);
                 } else {
-                    typeDesc = TypeDesc::makeNominalTemplated(ident, templateParamsArgList->elements);
+                    typeDesc = TypeDesc::makeNominalTemplated(astContext, ident, templateParamsArgList->elements);
                 }
                 
                 consume(2);
-                auto memberName = parseIdentAsString();
-                expr = std::make_shared<StaticDeclRefExpr>(typeDesc, memberName);
+                auto memberName = parseIdentAsSymbol();
+                expr = make<StaticDeclRefExpr>(astContext, typeDesc, memberName);
                 
             } else {
                 restore_pos(fallback_pos_after_ident);
@@ -1180,10 +1318,10 @@ std::shared_ptr<Expr> Parser::parseExpression(PrecedenceGroup precedenceGroupCon
     
     while (true) {
         LKAssert(expr);
-        if (_last_entry_expr_ptr == expr.get()) {
+        if (_last_entry_expr_ptr == expr) {
             unhandledToken(currentToken());
         }
-        _last_entry_expr_ptr = expr.get();
+        _last_entry_expr_ptr = expr;
         
         if (expressionDelimitingTokens.contains(currentTokenKind())) {
             if (currentTokenKind() == TK::EqualsSign && peekKind() == TK::EqualsSign) {
@@ -1221,8 +1359,8 @@ std::shared_ptr<Expr> Parser::parseExpression(PrecedenceGroup precedenceGroupCon
             
             const auto loc = getCurrentSourceLocation();
             consume();
-            auto memberName = parseIdentAsString();
-            expr = std::make_shared<ast::MemberExpr>(expr, memberName);
+            auto memberName = parseIdentAsSymbol();
+            expr = ast::make<ast::MemberExpr>(astContext, expr, memberName);
             expr->setSourceLocation(loc);
             if (currentTokenKind() == TK::OpeningAngledBracket || currentTokenKind() == TK::OpeningParens) {
                 goto parse_call_expr;
@@ -1237,11 +1375,11 @@ std::shared_ptr<Expr> Parser::parseExpression(PrecedenceGroup precedenceGroupCon
             consume();
 //            auto offsetExpr = parseExpression();
 //            assertTkAndConsume(TK::ClosingSquareBrackets);
-//            expr = std::make_shared<ast::SubscriptExpr>(expr, offsetExpr);
+//            expr = ast::make<ast::SubscriptExpr>(astContext, expr, offsetExpr);
 //            expr->setSourceLocation(loc);
             auto args = parseExpressionList(TK::ClosingSquareBrackets);
             assertTkAndConsume(TK::ClosingSquareBrackets);
-            expr = std::make_shared<ast::SubscriptExpr>(expr, args);
+            expr = ast::make<ast::SubscriptExpr>(astContext, expr, args);
             expr->setSourceLocation(loc);
         }
         
@@ -1267,7 +1405,7 @@ std::shared_ptr<Expr> Parser::parseExpression(PrecedenceGroup precedenceGroupCon
                 
                 //consume(2);
                 auto callTarget = parseExpression(PrecedenceGroup::FunctionPipeline);
-                expr = std::make_shared<ast::CallExpr>(callTarget, std::vector<std::shared_ptr<ast::Expr>>{ expr });
+                expr = ast::make<ast::CallExpr>(astContext, callTarget, std::vector<ast::Expr *>{ expr });
                 expr->setSourceLocation(operatorLoc);
                 continue;
             }
@@ -1281,7 +1419,7 @@ std::shared_ptr<Expr> Parser::parseExpression(PrecedenceGroup precedenceGroupCon
                     restore_pos(fallback);
                     return expr;
                 }
-                expr = std::make_shared<ast::BinOp>(op, expr, rhs);
+                expr = ast::make<ast::BinOp>(astContext, op, expr, rhs);
                 expr->setSourceLocation(operatorLoc);
             } else {
                 restore_pos(fallback);
@@ -1438,7 +1576,7 @@ std::optional<ast::Operator> Parser::parseOperator(bool includeFunctionDeclOpera
 
 
 
-std::shared_ptr<ast::CallExpr> Parser::parseCallExpr(std::shared_ptr<ast::Expr> target) {
+ast::CallExpr *Parser::parseCallExpr(ast::Expr *target) {
     auto templateArgs = parseTemplateArgumentList();
     
     
@@ -1450,7 +1588,7 @@ std::shared_ptr<ast::CallExpr> Parser::parseCallExpr(std::shared_ptr<ast::Expr>
     
     auto callArguments = parseExpressionList(TK::ClosingParens);
     assertTkAndConsume(TK::ClosingParens);
-    auto callExpr = std::make_shared<ast::CallExpr>(target, callArguments);
+    auto callExpr = ast::make<ast::CallExpr>(astContext, target, callArguments);
     callExpr->setSourceLocation(target->getSourceLocation());
     callExpr->explicitTemplateArgs = templateArgs;
     return callExpr;
@@ -1458,10 +1596,10 @@ std::shared_ptr<ast::CallExpr> Parser::parseCallExpr(std::shared_ptr<ast::Expr>
 
 
 
-std::shared_ptr<ast::TemplateParamArgList> Parser::parseTemplateArgumentList() {
+ast::TemplateParamArgList *Parser::parseTemplateArgumentList() {
     if (currentTokenKind() != TK::OpeningAngledBracket) return nullptr;
     
-    auto argList = std::make_shared<ast::TemplateParamArgList>();
+    auto argList = ast::make<ast::TemplateParamArgList>(astContext);
     argList->setSourceLocation(getCurrentSourceLocation());
     
     save_pos(pos_of_less_than_sign);
@@ -1501,7 +1639,7 @@ static const TokenSet memberAccessSeparatingTokens = {
 
 
 ast::MatchExprPattern Parser::parseMatchExprPattern() {
-    std::shared_ptr<ast::Expr> expr, cond;
+    ast::Expr *expr = nullptr, *cond = nullptr;
     expr = parseExpression();
     if (currentTokenKind() == TK::If) {
         consume();
@@ -1514,7 +1652,7 @@ ast::MatchExprPattern Parser::parseMatchExprPattern() {
 
 
 
-std::shared_ptr<ast::MatchExpr> Parser::parseMatchExpr() {
+ast::MatchExpr *Parser::parseMatchExpr() {
     assertTkAndConsume(TK::Match);
     auto target = parseExpression();
     assertTkAndConsume(TK::OpeningCurlyBraces);
@@ -1545,17 +1683,17 @@ std::shared_ptr<ast::MatchExpr> Parser::parseMatchExpr() {
     }
 ret:
     assertTkAndConsume(TK::ClosingCurlyBraces);
-    return std::make_shared<ast::MatchExpr>(target, branches);
+    return ast::make<ast::MatchExpr>(astContext, target, branches);
 }
 
 
 
 
 
-std::shared_ptr<ast::LambdaExpr> Parser::parseLambdaExpr() {
+ast::LambdaExpr *Parser::parseLambdaExpr() {
     if (currentTokenKind() != TK::OpeningSquareBrackets) return nullptr;
     
-    auto lambdaExpr = std::make_shared<ast::LambdaExpr>();
+    auto lambdaExpr = ast::make<ast::LambdaExpr>(astContext);
     lambdaExpr->setSourceLocation(getSourceLocation());
     consume();
     
@@ -1567,13 +1705,13 @@ std::shared_ptr<ast::LambdaExpr> Parser::parseLambdaExpr() {
         }
         
         if (!(captureElement.ident = parseIdent())) {
-            diagnostics::emitError(getCurrentSourceLocation(), "expected identifier");
+            diagnostics::emitError(sourceManager, getCurrentSourceLocation(), "expected identifier");
         }
         
         if (currentTokenKind() == TK::EqualsSign) {
             consume();
             if (!(captureElement.expr = parseExpression())) {
-                diagnostics::emitError(getCurrentSourceLocation(), "expected expression");
+                diagnostics::emitError(sourceManager, getCurrentSourceLocation(), "expected expression");
             }
         } else {
             captureElement.expr = captureElement.ident;
@@ -1603,7 +1741,7 @@ std::shared_ptr<ast::LambdaExpr> Parser::parseLambdaExpr() {
 // MARK: Literals
 
 
-std::shared_ptr<NumberLiteral> Parser::parseNumberLiteral() {
+NumberLiteral *Parser::parseNumberLiteral() {
     uint64_t value;
     NumberLiteral::NumberType type;
     bool isNegated = false;
@@ -1617,23 +1755,19 @@ std::shared_ptr<NumberLiteral> Parser::parseNumberLiteral() {
     
     switch (currentTokenKind()) {
         case TK::IntegerLiteral:
-            value = currentToken().getData<uint64_t>();
             type = NumberLiteral::NumberType::Integer;
             break;
         
-        case TK::DoubleLiteral: {
-            value = util::bitcast<uint64_t>(currentToken().getData<double>());
+        case TK::DoubleLiteral:
+            // Double literals are stored bitcast to uint64_t
             type = NumberLiteral::NumberType::Double;
             break;
-        }
         
         case TK::CharLiteral:
-            value = currentToken().getData<char>();
             type = NumberLiteral::NumberType::Character;
             break;
         
         case TK::BoolLiteral:
-            value = currentToken().getData<bool>();
             type = NumberLiteral::NumberType::Boolean;
             break;
         
@@ -1641,38 +1775,39 @@ std::shared_ptr<NumberLiteral> Parser::parseNumberLiteral() {
             restore_pos(prev_pos);
             return nullptr;
     }
+    value = getTokenList().getNumericValue(currentToken());
     consume();
     
     if (isNegated) {
         value *= -1;
     }
-    return std::make_shared<NumberLiteral>(value, type);
+    return make<NumberLiteral>(astContext, value, type);
 }
 
 
 
 
-std::shared_ptr<StringLiteral> Parser::parseStringLiteral() {
+StringLiteral *Parser::parseStringLiteral() {
     const auto& token = currentToken();
     
     if (token.getKind() != TK::StringLiteral && token.getKind() != TK::ByteStringLiteral) {
         return nullptr;
     }
     
-    auto value = token.getData<std::string>();
+    auto value = getTokenList().getStringValue(token);
     auto kind = token.getKind() == TK::StringLiteral
         ? StringLiteral::StringLiteralKind::NormalString
         : StringLiteral::StringLiteralKind::ByteString;
     
     consume();
-    return std::make_shared<StringLiteral>(value, kind);
+    return make<StringLiteral>(astContext, value, kind);
 }
 
 
-std::shared_ptr<UnaryExpr> Parser::parseUnaryExpr() {
+UnaryExpr *Parser::parseUnaryExpr() {
     if (!unaryOperators.contains(currentTokenKind())) return nullptr;
     auto op = unaryOperators[currentTokenKind()];
     consume();
     auto expr = parseExpression(PrecedenceGroup::PrefixOperator);
-    return std::make_shared<UnaryExpr>(op, expr);
+    return make<UnaryExpr>(astContext, op, expr);
 }
@@ -11,13 +11,21 @@
 #include "util/util.h"
 //#include "Token.h"
 #include "lex/Lexer.h"
+#include "lex/Diagnostics.h"
 #include "AST.h"
 #include "Attributes.h"
 
+#include "llvm/Support/ThreadPool.h"
+
 #include <memory>
 #include <vector>
 #include <initializer_list>
 #include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <variant>
+#include <mutex>
+#include <condition_variable>
 
 
 namespace yo::parser {
@@ -49,7 +57,13 @@ enum class PrecedenceGroup : uint8_t {
 
 class Parser {
 public:
-    Parser() {}
+    /// All nodes created by the parser are allocated in `astContext`, which has to outlive the AST.
+    /// The parsed files are added to `sourceManager`
+    Parser(ast::ASTContext &astContext, lex::SourceManager &sourceManager)
+    : astContext(astContext), sourceManager(sourceManager) {}
+    
+    /// Parses the file at the specified path, along w/ all modules imported by it.
+    /// Modules are lexed and parsed in parallel, the resulting AST contains their declarations in import order
     ast::AST parse(const std::string &filepath);
     
     void setCustomStdlibRoot(const std::string &path) {
@@ -57,33 +71,91 @@ public:
     }
     
 private:
-    std::vector<lex::Token> tokens;
-    int64_t position;
-    std::vector<std::string> importedFiles;
+    struct Import {
+        // Index of the `use` token in the importing module's tokens
+        int64_t tokenIndex;
+        std::string moduleName;
+        // Set if the import couldn't be resolved
+        std::optional<diagnostics::DeferredError> error;
+    };
+    
+    /// A source file that is part of the compilation
+    struct Module {
+        // The module's path, or the name of an embedded stdlib module
+        const std::string name;
+        // Location of the (first) import of this module, empty for the root module
+        const lex::SourceLocation importLoc;
+        // Shared w/ the parsers of the module's lazily parsed function bodies
+        std::shared_ptr<const lex::TokenList> tokenList;
+        std::vector<Import> imports;
+        // The module's top-level statements, in source order. Imports are represented by the name of the imported module
+        std::vector<std::variant<ast::TopLevelStmt *, std::string>> items;
+        
+        // Errors encountered when loading (ie, reading or lexing) and parsing the module.
+        // These are emitted when merging the modules' declarations, so that we always report the error a serial parser would've encountered first
+        std::optional<diagnostics::DeferredError> loadError;
+        std::optional<diagnostics::DeferredError> parseError;
+        
+        Module(std::string name, lex::SourceLocation importLoc) : name(name), importLoc(importLoc) {}
+    };
+    
+    ast::ASTContext &astContext;
+    lex::SourceManager &sourceManager;
     std::optional<std::string> customStdlibRoot;
     
-    void resolveImport();
+    // All modules discovered so far, keyed by name. Only used by the Parser instance `parse` was called on
+    std::mutex modulesMutex;
+    std::condition_variable modulesCondition;
+    std::unordered_map<std::string, std::unique_ptr<Module>> modules;
+    uint64_t numPendingModules = 0;
+    std::unique_ptr<llvm::ThreadPool> threadPool;
+    
+    // The module being parsed. Every module is parsed by its own Parser instance
+    std::shared_ptr<const lex::TokenList> tokenList;
+    int64_t position = 0;
+    
+    // Whether function bodies should only be parsed once they're needed (ie, when IRGen first accesses them)
+    bool shouldParseFunctionBodiesLazily = false;
+    
+    void addModule(const std::string &name, const lex::SourceLocation &importLoc);
+    void loadModule(Module &module);
+    void parseModule(Module &module);
+    void appendModuleDecls(const Module &module, ast::AST &ast, std::unordered_set<const Module *> &visitedModules) const;
+    
+    std::string resolveImport(const lex::SourceLocation&, std::string moduleName, const std::string &importingFilepath);
     std::string resolveImportPathRelativeToBaseDirectory(const lex::SourceLocation&, const std::string &moduleName, const std::string &baseDirectory);
     
-    const lex::Token& currentToken() { return tokens[position]; }
+    const lex::TokenList& getTokenList() const {
+        return *tokenList;
+    }
+    
+    std::string_view getSourceText(const lex::Token &token) const {
+        return getTokenList().getSourceText(token);
+    }
+    
+    lex::SourceLocation getSourceLocation(const lex::Token &token) const {
+        return getTokenList().getSourceLocation(token);
+    }
+    
+    const lex::Token& currentToken() { return tokenList->getTokens()[position]; }
     
     lex::TokenKind currentTokenKind() {
         return currentToken().getKind();
     }
     const lex::Token& peek(int64_t offset = 1) {
-        return tokens[position + offset];
+        return tokenList->getTokens()[position + offset];
     }
     lex::TokenKind peekKind(int64_t offset = 1) {
         return peek(offset).getKind();
     }
     void consume(int64_t count = 1) { position += count; }
     
-    const lex::SourceLocation& getCurrentSourceLocation() {
-        return currentToken().getSourceLocation();
+    lex::SourceLocation getCurrentSourceLocation() {
+        return getSourceLocation(currentToken());
     }
     
-    const lex::SourceLocation& getSourceLocation(int64_t offset = 0) {
-        return tokens[position + offset].getSourceLocation();
+    lex::SourceLocation getSourceLocation(int64_t offset = 0) {
+        return getSourceLocation(peek(offset));
     }
     
     
@@ -102,35 +174,36 @@ private:
     
     // Parsing
     
-    std::shared_ptr<ast::TopLevelStmt> parseTopLevelStmt();
+    ast::TopLevelStmt *parseTopLevelStmt();
     
     std::vector<yo::attributes::Attribute> parseAttributes();
     
-    std::shared_ptr<ast::FunctionDecl> parseFunctionDecl(attributes::FunctionAttributes);
-    std::shared_ptr<ast::ImplBlock> parseImplBlock();
-    std::shared_ptr<ast::TemplateParamDeclList> parseTemplateParamDeclList();
-    std::shared_ptr<ast::StructDecl> parseStructDecl(attributes::StructAttributes);
-    std::shared_ptr<ast::TypealiasDecl> parseTypealias();
-    std::shared_ptr<ast::VariantDecl> parseVariantDecl();
+    ast::FunctionDecl *parseFunctionDecl(attributes::FunctionAttributes);
+    std::optional<int64_t> findMatchingClosingCurlyBraces();
+    ast::ImplBlock *parseImplBlock();
+    ast::TemplateParamDeclList *parseTemplateParamDeclList();
+    ast::StructDecl *parseStructDecl(attributes::StructAttributes);
+    ast::TypealiasDecl *parseTypealias();
+    ast::VariantDecl *parseVariantDecl();
     
-    void parseFunctionSignatureAndParamNames(ast::FunctionSignature&, std::vector<std::shared_ptr<ast::Ident>>&);
+    void parseFunctionSignatureAndParamNames(ast::FunctionSignature&, std::vector<ast::Ident *>&);
     
-    std::vector<std::shared_ptr<ast::VarDecl>> parseStructPropertyDeclList();
+    std::vector<ast::VarDecl *> parseStructPropertyDeclList();
     
-    std::shared_ptr<ast::TypeDesc> parseType();
+    ast::TypeDesc *parseType();
     
-    std::shared_ptr<ast::CompoundStmt> parseCompoundStmt();
+    ast::CompoundStmt *parseCompoundStmt();
     
-    std::shared_ptr<ast::LocalStmt> parseLocalStmt();
-    std::shared_ptr<ast::ReturnStmt> parseReturnStmt();
-    std::shared_ptr<ast::VarDecl> parseVariableDecl();
+    ast::LocalStmt *parseLocalStmt();
+    ast::ReturnStmt *parseReturnStmt();
+    ast::VarDecl *parseVariableDecl();
     
-    std::shared_ptr<ast::IfStmt> parseIfStmt();
-    std::shared_ptr<ast::WhileStmt> parseWhileStmt();
-    std::shared_ptr<ast::ForLoop> parseForLoop();
-    std::shared_ptr<ast::BreakContStmt> parseBreakOrContinueStmt();
+    ast::IfStmt *parseIfStmt();
+    ast::WhileStmt *parseWhileStmt();
+    ast::ForLoop *parseForLoop();
+    ast::BreakContStmt *parseBreakOrContinueStmt();
     
-    std::shared_ptr<ast::Expr> parseExpression(PrecedenceGroup currentPrecedenceGroup = PrecedenceGroup::Initial);
+    ast::Expr *parseExpression(PrecedenceGroup currentPrecedenceGroup = PrecedenceGroup::Initial);
     
     /// includeFunctionDeclOperators controls whether operators that usually take arguments, like `[]` or `()` should be treated as valid operators, or not
     std::optional<ast::Operator> parseOperator(bool includeFunctionDeclOperators = false);
@@ -139,29 +212,29 @@ private:
     // Parses a CallExpr
     // Precondition: The current token most be either a less than sign or opening parentheses
     // If the current token is a less than sign and ParseCallExpr fails to parse a list of type expressions, it returns nullptr, with the parser's position reset to the less than sign
-    std::shared_ptr<ast::CallExpr> parseCallExpr(std::shared_ptr<ast::Expr> target);
+    ast::CallExpr *parseCallExpr(ast::Expr *target);
     
     /// Parse an explicit template argument list
     /// For example everything between the target name and the first parentheses in `foo<i8, i8, i8>(<args>)`
-    std::shared_ptr<ast::TemplateParamArgList> parseTemplateArgumentList();
+    ast::TemplateParamArgList *parseTemplateArgumentList();
     
     
-    std::shared_ptr<ast::TupleExpr> parseTupleExpr();
-    std::vector<std::shared_ptr<ast::Expr>> parseExpressionList(lex::TokenKind delimiter);
+    ast::TupleExpr *parseTupleExpr();
+    std::vector<ast::Expr *> parseExpressionList(lex::TokenKind delimiter);
     
-    std::shared_ptr<ast::ArrayLiteralExpr> parseArrayLiteral();
+    ast::ArrayLiteralExpr *parseArrayLiteral();
     
-    std::string parseIdentAsString();
-    std::shared_ptr<ast::Ident> parseIdent();
+    util::Symbol parseIdentAsSymbol();
+    ast::Ident *parseIdent();
     
-    std::shared_ptr<ast::MatchExpr> parseMatchExpr();
+    ast::MatchExpr *parseMatchExpr();
     ast::MatchExprPattern parseMatchExprPattern();
     
-    std::shared_ptr<ast::LambdaExpr> parseLambdaExpr();
+    ast::LambdaExpr *parseLambdaExpr();
     
-    std::shared_ptr<ast::NumberLiteral> parseNumberLiteral();
-    std::shared_ptr<ast::StringLiteral> parseStringLiteral();
-    std::shared_ptr<ast::UnaryExpr> parseUnaryExpr();
+    ast::NumberLiteral *parseNumberLiteral();
+    ast::StringLiteral *parseStringLiteral();
+    ast::UnaryExpr *parseUnaryExpr();
 };
 
 }
@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include "ASTContext.h"
 #include "lex/SourceLocation.h"
 #include "util/util.h"
+#include "util/Symbol.h"
 
 #include <string>
 #include <variant>
@@ -40,10 +42,10 @@ enum class CallingConvention {
 
 struct FunctionTypeInfo {
     CallingConvention callingConvention;
-    std::shared_ptr<TypeDesc> returnType;
-    std::vector<std::shared_ptr<TypeDesc>> parameterTypes;
+    TypeDesc *returnType = nullptr;
+    std::vector<TypeDesc *> parameterTypes;
     
-    FunctionTypeInfo(CallingConvention cc, std::shared_ptr<TypeDesc> returnType, std::vector<std::shared_ptr<TypeDesc>> parameterTypes)
+    FunctionTypeInfo(CallingConvention cc, TypeDesc *returnType, std::vector<TypeDesc *> parameterTypes)
     : callingConvention(cc), returnType(returnType), parameterTypes(parameterTypes) {}
 };
 
@@ -64,16 +66,18 @@ public:
     };
     
 private:
-    using NominalTemplatedDataT = std::pair<std::string, std::vector<std::shared_ptr<TypeDesc>>>; // TODO have this store an args list instead!!
+    friend class ASTContext;
+    
+    using NominalTemplatedDataT = std::pair<util::Symbol, std::vector<TypeDesc *>>; // TODO have this store an args list instead!!
     
     Kind kind;
     std::variant<
-        std::string,                            // Kind::Nominal
+        util::Symbol,                           // Kind::Nominal
         NominalTemplatedDataT,                  // Kind::NominalTemplated
-        std::shared_ptr<TypeDesc>,              // Kind::Pointer | Kind::Reference
+        TypeDesc *,                             // Kind::Pointer | Kind::Reference
         FunctionTypeInfo,                       // Kind::Function
-        std::shared_ptr<Expr>,                  // Kind::Decltype
-        std::vector<std::shared_ptr<TypeDesc>>  // Kind:Tuple
+        Expr *,                                 // Kind::Decltype
+        std::vector<TypeDesc *>                 // Kind:Tuple
     > data;
     yo::irgen::Type *resolvedType = nullptr;
     SourceLocation srcLoc;
@@ -87,38 +91,38 @@ private:
     
     
 public:
-    static std::shared_ptr<TypeDesc> makeNominal(std::string name, SourceLocation loc = SourceLocation()) {
-        return std::shared_ptr<TypeDesc>(new TypeDesc(Kind::Nominal, name, loc));
+    static TypeDesc *makeNominal(ASTContext &context, util::Symbol name, SourceLocation loc = SourceLocation()) {
+        return context.make<TypeDesc>(Kind::Nominal, name, loc);
     }
     
-    static std::shared_ptr<TypeDesc> makeNominalTemplated(std::string name, std::vector<std::shared_ptr<TypeDesc>> Ts, SourceLocation loc = SourceLocation()) {
-        return std::shared_ptr<TypeDesc>(new TypeDesc(Kind::NominalTemplated, NominalTemplatedDataT(name, Ts), loc));
+    static TypeDesc *makeNominalTemplated(ASTContext &context, util::Symbol name, std::vector<TypeDesc *> Ts, SourceLocation loc = SourceLocation()) {
+        return context.make<TypeDesc>(Kind::NominalTemplated, NominalTemplatedDataT(name, Ts), loc);
     }
     
-    static std::shared_ptr<TypeDesc> makePointer(std::shared_ptr<TypeDesc> pointee, SourceLocation loc = SourceLocation()) {
-        return std::shared_ptr<TypeDesc>(new TypeDesc(Kind::Pointer, pointee, loc));
+    static TypeDesc *makePointer(ASTContext &context, TypeDesc *pointee, SourceLocation loc = SourceLocation()) {
+        return context.make<TypeDesc>(Kind::Pointer, pointee, loc);
     }
     
-    static std::shared_ptr<TypeDesc> makeReference(std::shared_ptr<TypeDesc> pointee, SourceLocation loc = SourceLocation()) {
-        return std::shared_ptr<TypeDesc>(new TypeDesc(Kind::Reference, pointee, loc));
+    static TypeDesc *makeReference(ASTContext &context, TypeDesc *pointee, SourceLocation loc = SourceLocation()) {
+        return context.make<TypeDesc>(Kind::Reference, pointee, loc);
     }
     
-    static std::shared_ptr<TypeDesc> makeFunction(CallingConvention cc, std::shared_ptr<TypeDesc> returnTy, std::vector<std::shared_ptr<TypeDesc>> parameterTypes, SourceLocation loc = SourceLocation()) {
-        return std::shared_ptr<TypeDesc>(new TypeDesc(Kind::Function, FunctionTypeInfo(cc, returnTy, parameterTypes), loc));
+    static TypeDesc *makeFunction(ASTContext &context, CallingConvention cc, TypeDesc *returnTy, std::vector<TypeDesc *> parameterTypes, SourceLocation loc = SourceLocation()) {
+        return context.make<TypeDesc>(Kind::Function, FunctionTypeInfo(cc, returnTy, parameterTypes), loc);
     }
     
-    static std::shared_ptr<TypeDesc> makeTuple(std::vector<std::shared_ptr<TypeDesc>> M, SourceLocation SL = SourceLocation()) {
-        return std::shared_ptr<TypeDesc>(new TypeDesc(Kind::Tuple, M, SL));
+    static TypeDesc *makeTuple(ASTContext &context, std::vector<TypeDesc *> M, SourceLocation SL = SourceLocation()) {
+        return context.make<TypeDesc>(Kind::Tuple, M, SL);
     }
     
-    static std::shared_ptr<TypeDesc> makeResolved(yo::irgen::Type *type, SourceLocation loc = SourceLocation()) {
-        auto typeDesc = std::shared_ptr<TypeDesc>(new TypeDesc(Kind::Resolved, loc));
+    static TypeDesc *makeResolved(ASTContext &context, yo::irgen::Type *type, SourceLocation loc = SourceLocation()) {
+        auto typeDesc = context.make<TypeDesc>(Kind::Resolved, loc);
         typeDesc->setResolvedType(type);
         return typeDesc;
     }
     
-    static std::shared_ptr<TypeDesc> makeDecltype(std::shared_ptr<ast::Expr> expr, SourceLocation loc = SourceLocation()) {
-        return std::shared_ptr<TypeDesc>(new TypeDesc(Kind::Decltype, expr, loc));
+    static TypeDesc *makeDecltype(ASTContext &context, ast::Expr *expr, SourceLocation loc = SourceLocation()) {
+        return context.make<TypeDesc>(Kind::Decltype, expr, loc);
     }
     
     
@@ -161,17 +165,17 @@ public:
     }
     
     
-    const std::string& getName() const {
+    util::Symbol getName() const {
         LKAssert(isNominal() || isNominalTemplated());
         return isOfKind(Kind::Nominal)
-            ? std::get<std::string>(data)
+            ? std::get<util::Symbol>(data)
             : std::get<NominalTemplatedDataT>(data).first;
     }
     
     /// Returns the referenced type, if this is a pointer or a reference
-    std::shared_ptr<TypeDesc> getPointee() const {
+    TypeDesc *getPointee() const {
         LKAssert(kind == Kind::Pointer || kind == Kind::Reference);
-        return std::get<std::shared_ptr<TypeDesc>>(data);
+        return std::get<TypeDesc *>(data);
     }
     
     const FunctionTypeInfo& getFunctionTypeInfo() const {
@@ -198,12 +202,12 @@ public:
     }
     void setSourceLocationNested(const SourceLocation&);
     
-    std::shared_ptr<Expr> getDecltypeExpr() const {
-        return std::get<std::shared_ptr<Expr>>(data);
+    Expr *getDecltypeExpr() const {
+        return std::get<Expr *>(data);
     }
     
-    const std::vector<std::shared_ptr<TypeDesc>>& getTupleMembers() const {
-        return std::get<std::vector<std::shared_ptr<TypeDesc>>>(data);
+    const std::vector<TypeDesc *>& getTupleMembers() const {
+        return std::get<std::vector<TypeDesc *>>(data);
     }
     
 };
@@ -213,7 +217,7 @@ inline std::ostream& operator<<(std::ostream &OS, const TypeDesc &typeDesc) {
     return OS << typeDesc.str();
 }
 
-inline std::ostream& operator<<(std::ostream &OS, const std::shared_ptr<TypeDesc> &typeDesc) {
+inline std::ostream& operator<<(std::ostream &OS, TypeDesc *typeDesc) {
     return OS << typeDesc->str();
 }
 
@@ -16,15 +16,17 @@
 
 namespace yo::util::map {
 
-template <typename K, typename V>
-inline bool has_key(const std::map<K, V> &map, const K &key) {
+// Works w/ both ordered and unordered maps
+template <typename M>
+inline bool has_key(const M &map, const typename M::key_type &key) {
     return map.find(key) != map.end();
 }
 
 
-template <typename K, typename V>
-inline std::optional<V> get_opt(const std::map<K, V> &map, const K &key) {
-    if (has_key(map, key)) return map.at(key);
+template <typename M>
+inline std::optional<typename M::mapped_type> get_opt(const M &map, const typename M::key_type &key) {
+    auto it = map.find(key);
+    if (it != map.end()) return it->second;
     else return std::nullopt;
 }
 
@@ -11,100 +11,130 @@
 #include "util.h"
 #include "Format.h"
 #include "Counter.h"
-#include "VectorUtils.h"
+#include "Symbol.h"
 
 #include <string>
+#include <cstdint>
 #include <tuple>
 #include <vector>
+#include <deque>
+#include <unordered_map>
 #include <algorithm>
-#include <optional>
+#include <atomic>
+#include <utility>
 
 
 namespace yo::util {
 
 
-template <typename Value, typename Key = std::string>
+/// A scope mapping names to values, where newer entries shadow older entries w/ the same name.
+///
+/// Entries are kept in insertion order (which is the order in which the local scope is destructed),
+/// and every name maps to its most recent entry, which links to the entry it shadows.
+/// Removed entries are only marked as such (and dropped once the scope is rolled back to a marker preceding them),
+/// which means that markers stay valid, and pointers returned by `get` remain valid until the scope is rolled back.
+/// Entry ids are unique across all scopes of the same type, which is what makes state tokens comparable across scopes.
+template <typename Value, typename Key = Symbol>
 class NamedScope {
 public:
     using ID = uint64_t;
     using Entry = std::tuple<Key, ID, Value>;
+    using Marker = uint64_t;
+    /// Identifies the set of live entries: if two tokens are equal, the scopes they were obtained from contained the same entries
+    using StateToken = std::pair<size_t, ID>;
     
 private:
-    Counter<ID> idCounter;
-    std::vector<Entry> entries;
+    static constexpr size_t kNoEntry = SIZE_MAX;
     
-public:
-    using Marker = uint64_t;
+    struct Record {
+        Key key;
+        ID id;
+        Value value;
+        size_t shadowed; // index of the entry w/ the same key this entry shadows, or kNoEntry
+        size_t prevLive; // index of an entry preceding this one which was live when this entry was inserted, or kNoEntry
+        bool isLive;
+    };
+    
+    inline static std::atomic<ID> nextID = 1;
+    std::deque<Record> records;
+    // Index of the most recent live entry for a key
+    std::unordered_map<Key, size_t> heads;
+    size_t numLiveRecords = 0;
+    size_t lastLive = kNoEntry;
     
+public:
     bool isEmpty() const {
-        return entries.empty();
+        return numLiveRecords == 0;
     }
     
     uint64_t size() const {
-        return entries.size();
+        return numLiveRecords;
     }
     
-    ID insert(const Key &key, const Value &value) {
-        auto id = idCounter.increment();
-        entries.emplace_back(key, id, value);
+    ID insert(const Key &key, Value value) {
+        auto id = nextID.fetch_add(1, std::memory_order_relaxed);
+        auto [it, didInsert] = heads.try_emplace(key, kNoEntry);
+        records.push_back(Record{ key, id, std::move(value), it->second, lastLive, true });
+        it->second = records.size() - 1;
+        lastLive = records.size() - 1;
+        numLiveRecords++;
         return id;
     }
     
     bool contains(const Key &key) const {
-        return util::vector::contains_where(entries, [&key](const auto &entry) {
-            return std::get<0>(entry) == key;
-        });
+        return heads.find(key) != heads.end();
     }
     
-    std::optional<Value> get(const Key &key) const {
-        for (auto it = entries.rbegin(); it != entries.rend(); it++) {
-            if (std::get<0>(*it) == key) {
-                return std::get<2>(*it);
-            }
-        }
-        return std::nullopt;
+    /// The value of the most recently added entry with the specified key, or nullptr
+    const Value* get(const Key &key) const {
+        auto it = heads.find(key);
+        if (it == heads.end()) return nullptr;
+        return &records[it->second].value;
     }
     
     Marker getMarker() const {
-        return entries.size();
+        return records.size();
     }
     
-    const std::vector<Entry>& getEntries() const {
-        return entries;
+    /// Since ids are never reused, the live entries are determined by their number and the id of the most recent one
+    StateToken getStateToken() const {
+        return { numLiveRecords, lastLive == kNoEntry ? 0 : records[lastLive].id };
     }
     
     std::vector<Entry> getEntriesSinceMarker(Marker M) const {
-        if (M >= entries.size()) return {};
-        return std::vector<Entry>(entries.begin() + M, entries.end());
+        std::vector<Entry> entries;
+        for (size_t idx = M; idx < records.size(); idx++) {
+            auto &record = records[idx];
+            if (record.isLive) {
+                entries.emplace_back(record.key, record.id, record.value);
+            }
+        }
+        return entries;
     }
     
     /// Remove the most recently added entry with the specified key
     void remove(const Key &key) {
-        auto it = std::find_if(entries.rbegin(), entries.rend(), [&key](const auto &entry) -> bool {
-            return std::get<0>(entry) == key;
-        });
-        
-        if (it == entries.rend()) {
+        auto it = heads.find(key);
+        if (it == heads.end()) {
             auto msg = fmt::format("cannot delete nonexistent entru with key '{}'", key);
             LKFatalError("%s", msg.c_str());
-        } else {
-            entries.erase((it + 1).base());
         }
+        unlinkRecord(it->second);
     }
     
     /// Remove an entry by id
     void remove(ID id) {
-        for (auto it = entries.rbegin(); it != entries.rend(); it++) {
-            if (std::get<1>(*it) == id) {
-                entries.erase((it + 1).base());
-                return;
-            }
+        // ids are handed out in increasing order, so the records are sorted by id
+        auto it = std::lower_bound(records.begin(), records.end(), id, [](const Record &record, ID id) {
+            return record.id < id;
+        });
+        if (it != records.end() && it->id == id && it->isLive) {
+            unlinkRecord(it - records.begin());
         }
     }
     
     /// Remove multiple entries by ids
     void removeAll(const std::vector<ID> &ids) {
-        // TODO surely this can be implemented better?
         for (auto id : ids) {
             remove(id);
         }
@@ -112,11 +142,60 @@ public:
     
     /// Removes all entries *including* the marker
     void removeAllSinceMarker(Marker M) {
-        entries.erase(entries.begin() + M, entries.end());
+        while (records.size() > M) {
+            auto &record = records.back();
+            if (record.isLive) {
+                unlinkRecord(records.size() - 1);
+            }
+            records.pop_back();
+        }
     }
     
     void removeAll() {
-        entries = {};
+        records.clear();
+        heads.clear();
+        numLiveRecords = 0;
+        lastLive = kNoEntry;
+    }
+    
+private:
+    void unlinkRecord(size_t index) {
+        auto &record = records[index];
+        auto &head = heads.at(record.key);
+        if (head == index) {
+            if (record.shadowed == kNoEntry) {
+                heads.erase(record.key);
+            } else {
+                head = record.shadowed;
+            }
+        } else {
+            // the entry itself is shadowed by a newer entry, find the entry shadowing it
+            size_t next = head;
+            while (records[next].shadowed != index) {
+                next = records[next].shadowed;
+            }
+            records[next].shadowed = record.shadowed;
+        }
+        record.isLive = false;
+        numLiveRecords--;
+        if (index == lastLive) {
+            lastLive = findLiveRecord(record.prevLive);
+        }
+    }
+    
+    /// The index of the most recent live entry at or before `index`, skipping over removed entries
+    size_t findLiveRecord(size_t index) {
+        size_t live = index;
+        while (live != kNoEntry && !records[live].isLive) {
+            live = records[live].prevLive;
+        }
+        // shorten the chain for subsequent lookups
+        while (index != live && index != kNoEntry) {
+            auto next = records[index].prevLive;
+            records[index].prevLive = live;
+            index = next;
+        }
+        return live;
     }
 };
 
@@ -0,0 +1,50 @@
+//
+//  Symbol.cpp
+//  yo
+//
+
+#include "Symbol.h"
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Allocator.h"
+
+#include <array>
+#include <functional>
+#include <mutex>
+
+using namespace yo;
+using namespace yo::util;
+
+
+namespace {
+
+// The interned strings are split into shards, to reduce contention when multiple threads are lexing concurrently
+struct Shard {
+    std::mutex mutex;
+    // StringMap entries are never moved, so we can hand out pointers to the values
+    llvm::StringMap<std::string, llvm::BumpPtrAllocator> strings;
+};
+
+constexpr size_t kNumShards = 16;
+
+std::array<Shard, kNumShards>& getShards() {
+    static std::array<Shard, kNumShards> shards;
+    return shards;
+}
+
+const std::string* intern(std::string_view string) {
+    auto &shard = getShards()[std::hash<std::string_view>()(string) % kNumShards];
+    std::lock_guard lock(shard.mutex);
+    auto &entry = *shard.strings.try_emplace(string, string).first;
+    return &entry.getValue();
+}
+
+} // end anonymous namespace
+
+
+Symbol::Symbol() {
+    static const std::string *empty = intern("");
+    string = empty;
+}
+
+Symbol::Symbol(std::string_view string) : string(intern(string)) {}
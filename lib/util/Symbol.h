@@ -0,0 +1,78 @@
+//
+//  Symbol.h
+//  yo
+//
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <functional>
+
+namespace yo::util {
+
+
+/// An interned string.
+///
+/// All symbols w/ the same contents share the same storage, which means that symbols can be compared and hashed by address.
+/// Interned strings are never deallocated, ie references to a symbol's string remain valid for the lifetime of the process.
+/// Symbols can be created concurrently from multiple threads.
+class Symbol {
+    const std::string *string;
+    
+public:
+    /// The empty symbol
+    Symbol();
+    explicit Symbol(std::string_view);
+    
+    const std::string& str() const {
+        return *string;
+    }
+    
+    operator const std::string&() const {
+        return *string;
+    }
+    
+    operator std::string_view() const {
+        return *string;
+    }
+    
+    bool empty() const {
+        return string->empty();
+    }
+    
+    size_t size() const {
+        return string->size();
+    }
+    
+    friend bool operator==(Symbol lhs, Symbol rhs) { return lhs.string == rhs.string; }
+    friend bool operator!=(Symbol lhs, Symbol rhs) { return lhs.string != rhs.string; }
+    
+    friend bool operator==(Symbol lhs, std::string_view rhs) { return *lhs.string == rhs; }
+    friend bool operator!=(Symbol lhs, std::string_view rhs) { return *lhs.string != rhs; }
+    friend bool operator==(std::string_view lhs, Symbol rhs) { return lhs == *rhs.string; }
+    friend bool operator!=(std::string_view lhs, Symbol rhs) { return lhs != *rhs.string; }
+    
+    // Symbols are ordered by their contents, so that iterating ordered containers keyed by symbols is deterministic
+    friend bool operator<(Symbol lhs, Symbol rhs) {
+        return lhs.string != rhs.string && *lhs.string < *rhs.string;
+    }
+    
+    friend std::ostream& operator<<(std::ostream &OS, Symbol symbol) {
+        return OS << *symbol.string;
+    }
+    
+    friend struct std::hash<Symbol>;
+};
+
+
+} // ns yo::util
+
+
+template <>
+struct std::hash<yo::util::Symbol> {
+    size_t operator()(yo::util::Symbol symbol) const {
+        return std::hash<const std::string *>()(symbol.string);
+    }
+};
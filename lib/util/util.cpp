@@ -13,8 +13,6 @@
 #include <cxxabi.h>
 #include <cstring>
 #include <cstdarg>
-#include <fstream>
-#include <sstream>
 #include <sys/stat.h>
 
 
@@ -250,36 +248,6 @@ bool util::fs::file_exists(const std::string &path) {
 }
 
 
-std::string util::fs::read_file(const std::string& path) {
-    // TODO interpret path == "-" as stdin
-    std::ifstream file(path);
-    std::ostringstream contents;
-    contents << file.rdbuf();
-    file.close();
-    return contents.str();
-}
-
-
-// zero-based line number
-std::string util::fs::read_specific_line(const std::string& path, uint64_t lineNumber) {
-    lineNumber += 1;
-    uint64_t currentLineNumber = 0;
-    std::ifstream file(path);
-    std::string line;
-    
-    while (currentLineNumber != lineNumber && std::getline(file, line)) {
-        currentLineNumber += 1;
-    };
-    
-    if (currentLineNumber == lineNumber) {
-        return line;
-    } else {
-        LKFatalError("Unable to read %s:%llu", path.c_str(), lineNumber);
-    }
-}
-
-
-
 std::string util::fs::path_get_filename(const std::string &path) {
     if (path == "-") {
         return "<stdin>";
@@ -153,18 +153,7 @@ using remove_cvref_t = std::remove_cv_t<std::remove_reference_t<T>>;
 
 
 template <typename T>
-struct is_shared_ptr_impl : std::false_type {};
-
-template <typename T>
-struct is_shared_ptr_impl<std::shared_ptr<T>> : std::true_type {};
-
-
-template <typename T>
-inline constexpr bool is_shared_ptr_v = is_shared_ptr_impl<remove_cvref_t<T>>::value;
-
-
-template <typename T>
-inline constexpr bool is_nullable_v = std::is_pointer_v<T> || is_shared_ptr_v<T>;
+inline constexpr bool is_nullable_v = std::is_pointer_v<T>;
 
 
 // Extracts a member pointer's class and member type
@@ -260,8 +249,6 @@ std::pair<std::string, std::string> extractPathAndFilename(const std::string &pa
 
 namespace fs {
 bool file_exists(const std::string &path);
-std::string read_file(const std::string& path);
-std::string read_specific_line(const std::string& path, uint64_t lineNumber);
 std::string path_get_filename(const std::string& path);
 }
 
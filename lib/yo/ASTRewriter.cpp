@@ -11,7 +11,6 @@
 #include "parse/Attributes.h"
 #include "util/MapUtils.h"
 #include "util/VectorUtils.h"
-#include "util/llvm_casting.h"
 
 #include "llvm/Support/Casting.h"
 
@@ -34,7 +33,7 @@ using NK = ast::Node::Kind;
 LKFatalError("Unhandled Node: %s", ast::nodeKindToString(node->getKind()).c_str());
 
 
-std::shared_ptr<ast::LocalStmt> ASTRewriter::handleLocalStmt(std::shared_ptr<ast::LocalStmt> node) {
+ast::LocalStmt *ASTRewriter::handleLocalStmt(ast::LocalStmt *node) {
     switch (node->getKind()) {
         CASE(ReturnStmt)
         CASE(Assignment)
@@ -48,7 +47,7 @@ std::shared_ptr<ast::LocalStmt> ASTRewriter::handleLocalStmt(std::shared_ptr<ast
     }
 }
 
-std::shared_ptr<ast::Expr> ASTRewriter::handleExpr(std::shared_ptr<ast::Expr> node) {
+ast::Expr *ASTRewriter::handleExpr(ast::Expr *node) {
     if (!node) {
         return nullptr;
     }
@@ -83,7 +82,7 @@ std::shared_ptr<ast::Expr> ASTRewriter::handleExpr(std::shared_ptr<ast::Expr> no
 
 
 
-std::shared_ptr<ast::TypeDesc> ASTRewriter::handleTypeDesc(std::shared_ptr<ast::TypeDesc> typeDesc) {
+ast::TypeDesc *ASTRewriter::handleTypeDesc(ast::TypeDesc *typeDesc) {
     using TDK = ast::TypeDesc::Kind;
     
     if (!typeDesc) {
@@ -94,29 +93,29 @@ std::shared_ptr<ast::TypeDesc> ASTRewriter::handleTypeDesc(std::shared_ptr<ast::
     
     switch (typeDesc->getKind()) {
         case TDK::Resolved:
-            return ast::TypeDesc::makeResolved(typeDesc->getResolvedType(), loc);
+            return ast::TypeDesc::makeResolved(astContext, typeDesc->getResolvedType(), loc);
         
         case TDK::Pointer:
-            return ast::TypeDesc::makePointer(handleTypeDesc(typeDesc->getPointee()), loc);
+            return ast::TypeDesc::makePointer(astContext, handleTypeDesc(typeDesc->getPointee()), loc);
         
         case TDK::Reference:
-            return ast::TypeDesc::makeReference(handleTypeDesc(typeDesc->getPointee()), loc);
+            return ast::TypeDesc::makeReference(astContext, handleTypeDesc(typeDesc->getPointee()), loc);
         
         case TDK::Nominal: {
             if (auto ty = util::map::get_opt(templateArgumentMapping, typeDesc->getName())) {
-                return std::make_shared<ast::TypeDesc>(**ty);
+                return ast::make<ast::TypeDesc>(astContext, **ty);
             }
-            return std::make_shared<ast::TypeDesc>(*typeDesc);
+            return ast::make<ast::TypeDesc>(astContext, *typeDesc);
         }
         
         case TDK::Decltype:
-            return ast::TypeDesc::makeDecltype(handleExpr(typeDesc->getDecltypeExpr()), loc);
+            return ast::TypeDesc::makeDecltype(astContext, handleExpr(typeDesc->getDecltypeExpr()), loc);
         
         case TDK::NominalTemplated: {
             auto resolvedTemplateArgs = util::vector::map(typeDesc->getTemplateArgs(), [this](auto &ty) {
                 return handleTypeDesc(ty);
             });
-            return ast::TypeDesc::makeNominalTemplated(typeDesc->getName(), resolvedTemplateArgs, loc);
+            return ast::TypeDesc::makeNominalTemplated(astContext, typeDesc->getName(), resolvedTemplateArgs, loc);
         }
         
         
@@ -124,7 +123,7 @@ std::shared_ptr<ast::TypeDesc> ASTRewriter::handleTypeDesc(std::shared_ptr<ast::
             auto resolvedTypes = util::vector::map(typeDesc->getTupleMembers(), [this](auto &type) {
                 return handleTypeDesc(type);
             });
-            return ast::TypeDesc::makeTuple(resolvedTypes, loc);
+            return ast::TypeDesc::makeTuple(astContext, resolvedTypes, loc);
         }
         
         case TDK::Function:
@@ -146,7 +145,7 @@ ast::FunctionSignature ASTRewriter::handleFunctionSignature(const ast::FunctionS
     specSig.returnType = handleTypeDesc(signature.returnType);
     
     if (signature.numberOfTemplateParameters() > 0) {
-        specSig.templateParamsDecl = std::make_shared<ast::TemplateParamDeclList>();
+        specSig.templateParamsDecl = ast::make<ast::TemplateParamDeclList>(astContext);
         specSig.templateParamsDecl->setSourceLocation(signature.templateParamsDecl->getSourceLocation());
         
         for (const auto &param : signature.templateParamsDecl->getParams()) {
@@ -166,11 +165,11 @@ ast::FunctionSignature ASTRewriter::handleFunctionSignature(const ast::FunctionS
 }
 
 
-std::shared_ptr<ast::FunctionDecl> ASTRewriter::handleFunctionDecl(std::shared_ptr<ast::FunctionDecl> decl) {
-    auto specializedFuncDecl = std::make_shared<ast::FunctionDecl>(decl->getFunctionKind(),
+ast::FunctionDecl *ASTRewriter::handleFunctionDecl(ast::FunctionDecl *decl) {
+    auto specializedFuncDecl = ast::make<ast::FunctionDecl>(astContext, decl->getFunctionKind(),
                                                                    decl->getName(),
                                                                    handleFunctionSignature(decl->getSignature()),
-                                                                   decl->getAttributes());
+                                                                   decl->getAttributes(), ast::make<ast::CompoundStmt>(astContext));
     specializedFuncDecl->setSourceLocation(decl->getSourceLocation());
     specializedFuncDecl->setParamNames(decl->getParamNames()); // TODO make copies here!
     
@@ -187,8 +186,8 @@ std::shared_ptr<ast::FunctionDecl> ASTRewriter::handleFunctionDecl(std::shared_p
 
 
 
-std::shared_ptr<ast::StructDecl> ASTRewriter::handleStructDecl(std::shared_ptr<ast::StructDecl> decl) {
-    auto spec = std::make_shared<ast::StructDecl>(*decl);
+ast::StructDecl *ASTRewriter::handleStructDecl(ast::StructDecl *decl) {
+    auto spec = ast::make<ast::StructDecl>(astContext, *decl);
     spec->members = util::vector::map(decl->members, [this](const auto &member) {
         return handleVarDecl(member);
     });
@@ -196,8 +195,8 @@ std::shared_ptr<ast::StructDecl> ASTRewriter::handleStructDecl(std::shared_ptr<a
 }
 
 
-std::shared_ptr<ast::VariantDecl> ASTRewriter::handleVariantDecl(std::shared_ptr<ast::VariantDecl> decl) {
-    auto spec = std::make_shared<ast::VariantDecl>(*decl);
+ast::VariantDecl *ASTRewriter::handleVariantDecl(ast::VariantDecl *decl) {
+    auto spec = ast::make<ast::VariantDecl>(astContext, *decl);
     spec->name = handleIdent(decl->name);
     spec->members = util::vector::map(decl->members, [this](const ast::VariantDecl::MemberDecl &member) {
         ast::VariantDecl::MemberDecl spec(member);
@@ -213,8 +212,8 @@ std::shared_ptr<ast::VariantDecl> ASTRewriter::handleVariantDecl(std::shared_ptr
 #pragma mark - Local Statements
 
 
-std::shared_ptr<ast::CompoundStmt> ASTRewriter::handleCompoundStmt(std::shared_ptr<ast::CompoundStmt> stmt) {
-    auto spec = std::make_shared<ast::CompoundStmt>(*stmt);
+ast::CompoundStmt *ASTRewriter::handleCompoundStmt(ast::CompoundStmt *stmt) {
+    auto spec = ast::make<ast::CompoundStmt>(astContext, *stmt);
     spec->statements = util::vector::map(stmt->statements, [&](const auto &stmt) {
         return handleLocalStmt(stmt);
     });
@@ -222,22 +221,22 @@ std::shared_ptr<ast::CompoundStmt> ASTRewriter::handleCompoundStmt(std::shared_p
 }
 
 
-std::shared_ptr<ast::VarDecl> ASTRewriter::handleVarDecl(std::shared_ptr<ast::VarDecl> decl) {
-    auto spec = std::make_shared<ast::VarDecl>(*decl);
+ast::VarDecl *ASTRewriter::handleVarDecl(ast::VarDecl *decl) {
+    auto spec = ast::make<ast::VarDecl>(astContext, *decl);
     spec->type = handleTypeDesc(decl->type);
     spec->initialValue = handleExpr(decl->initialValue);
     return spec;
 }
 
 
-std::shared_ptr<ast::ReturnStmt> ASTRewriter::handleReturnStmt(std::shared_ptr<ast::ReturnStmt> stmt) {
-    auto spec = std::make_shared<ast::ReturnStmt>(*stmt);
+ast::ReturnStmt *ASTRewriter::handleReturnStmt(ast::ReturnStmt *stmt) {
+    auto spec = ast::make<ast::ReturnStmt>(astContext, *stmt);
     spec->expr = handleExpr(stmt->expr);
     return spec;
 }
 
-std::shared_ptr<ast::Assignment> ASTRewriter::handleAssignment(std::shared_ptr<ast::Assignment> stmt) {
-    auto spec = std::make_shared<ast::Assignment>(*stmt);
+ast::Assignment *ASTRewriter::handleAssignment(ast::Assignment *stmt) {
+    auto spec = ast::make<ast::Assignment>(astContext, *stmt);
     spec->target = handleExpr(stmt->target);
     spec->value = handleExpr(stmt->value);
     return spec;
@@ -245,17 +244,17 @@ std::shared_ptr<ast::Assignment> ASTRewriter::handleAssignment(std::shared_ptr<a
 
 
 
-std::shared_ptr<ast::WhileStmt> ASTRewriter::handleWhileStmt(std::shared_ptr<ast::WhileStmt> stmt) {
-    auto spec = std::make_shared<ast::WhileStmt>(*stmt);
+ast::WhileStmt *ASTRewriter::handleWhileStmt(ast::WhileStmt *stmt) {
+    auto spec = ast::make<ast::WhileStmt>(astContext, *stmt);
     spec->condition = handleExpr(stmt->condition);
     spec->body = handleCompoundStmt(stmt->body);
     return spec;
 }
 
-std::shared_ptr<ast::IfStmt> ASTRewriter::handleIfStmt(std::shared_ptr<ast::IfStmt> stmt) {
-    auto spec = std::make_shared<ast::IfStmt>(*stmt);
+ast::IfStmt *ASTRewriter::handleIfStmt(ast::IfStmt *stmt) {
+    auto spec = ast::make<ast::IfStmt>(astContext, *stmt);
     spec->branches = util::vector::map(stmt->branches, [&](const auto &branch) {
-        auto spec = std::make_shared<ast::IfStmt::Branch>(*branch);
+        auto spec = ast::make<ast::IfStmt::Branch>(astContext, *branch);
         spec->condition = handleExpr(branch->condition);
         spec->body = handleCompoundStmt(branch->body);
         return spec;
@@ -264,8 +263,8 @@ std::shared_ptr<ast::IfStmt> ASTRewriter::handleIfStmt(std::shared_ptr<ast::IfSt
 }
 
 
-std::shared_ptr<ast::ForLoop> ASTRewriter::handleForLoop(std::shared_ptr<ast::ForLoop> stmt) {
-    auto spec = std::make_shared<ast::ForLoop>(*stmt);
+ast::ForLoop *ASTRewriter::handleForLoop(ast::ForLoop *stmt) {
+    auto spec = ast::make<ast::ForLoop>(astContext, *stmt);
     spec->ident = handleIdent(stmt->ident);
     spec->expr = handleExpr(stmt->expr);
     spec->body = handleCompoundStmt(stmt->body);
@@ -273,8 +272,8 @@ std::shared_ptr<ast::ForLoop> ASTRewriter::handleForLoop(std::shared_ptr<ast::Fo
 }
 
 
-std::shared_ptr<ast::ExprStmt> ASTRewriter::handleExprStmt(std::shared_ptr<ast::ExprStmt> stmt) {
-    auto spec = std::make_shared<ast::ExprStmt>(*stmt);
+ast::ExprStmt *ASTRewriter::handleExprStmt(ast::ExprStmt *stmt) {
+    auto spec = ast::make<ast::ExprStmt>(astContext, *stmt);
     spec->expr = handleExpr(stmt->expr);
     return spec;
 }
@@ -283,8 +282,8 @@ std::shared_ptr<ast::ExprStmt> ASTRewriter::handleExprStmt(std::shared_ptr<ast::
 
 #pragma mark - Expressions
 
-std::shared_ptr<ast::CallExpr> ASTRewriter::handleCallExpr(std::shared_ptr<ast::CallExpr> call) {
-    auto spec = std::make_shared<ast::CallExpr>(*call);
+ast::CallExpr *ASTRewriter::handleCallExpr(ast::CallExpr *call) {
+    auto spec = ast::make<ast::CallExpr>(astContext, *call);
     spec->target = handleExpr(call->target);
     spec->arguments = util::vector::map(call->arguments, [this](const auto &expr) {
         return handleExpr(expr);
@@ -294,8 +293,8 @@ std::shared_ptr<ast::CallExpr> ASTRewriter::handleCallExpr(std::shared_ptr<ast::
 }
 
 
-std::shared_ptr<ast::SubscriptExpr> ASTRewriter::handleSubscriptExpr(std::shared_ptr<ast::SubscriptExpr> expr) {
-    auto spec = std::make_shared<ast::SubscriptExpr>(*expr);
+ast::SubscriptExpr *ASTRewriter::handleSubscriptExpr(ast::SubscriptExpr *expr) {
+    auto spec = ast::make<ast::SubscriptExpr>(astContext, *expr);
     spec->target = handleExpr(expr->target);
     spec->args = util::vector::map(expr->args, [this](const auto &expr) {
         return handleExpr(expr);
@@ -304,20 +303,20 @@ std::shared_ptr<ast::SubscriptExpr> ASTRewriter::handleSubscriptExpr(std::shared
 }
 
 
-std::shared_ptr<ast::MemberExpr> ASTRewriter::handleMemberExpr(std::shared_ptr<ast::MemberExpr> expr) {
-    auto spec = std::make_shared<ast::MemberExpr>(*expr);
+ast::MemberExpr *ASTRewriter::handleMemberExpr(ast::MemberExpr *expr) {
+    auto spec = ast::make<ast::MemberExpr>(astContext, *expr);
     spec->target = handleExpr(expr->target);
     return spec;
 }
 
 
-std::shared_ptr<ast::Ident> ASTRewriter::handleIdent(std::shared_ptr<ast::Ident> ident) {
-    return std::make_shared<ast::Ident>(*ident);
+ast::Ident *ASTRewriter::handleIdent(ast::Ident *ident) {
+    return ast::make<ast::Ident>(astContext, *ident);
 }
 
 
-std::shared_ptr<ast::StaticDeclRefExpr> ASTRewriter::handleStaticDeclRefExpr(std::shared_ptr<ast::StaticDeclRefExpr> expr) {
-    auto spec = std::make_shared<ast::StaticDeclRefExpr>(*expr);
+ast::StaticDeclRefExpr *ASTRewriter::handleStaticDeclRefExpr(ast::StaticDeclRefExpr *expr) {
+    auto spec = ast::make<ast::StaticDeclRefExpr>(astContext, *expr);
     spec->typeDesc = handleTypeDesc(expr->typeDesc);
     return spec;
 }
@@ -326,8 +325,8 @@ std::shared_ptr<ast::StaticDeclRefExpr> ASTRewriter::handleStaticDeclRefExpr(std
 
 
 
-std::shared_ptr<ast::MatchExpr> ASTRewriter::handleMatchExpr(std::shared_ptr<ast::MatchExpr> expr) {
-    auto spec = std::make_shared<ast::MatchExpr>(*expr);
+ast::MatchExpr *ASTRewriter::handleMatchExpr(ast::MatchExpr *expr) {
+    auto spec = ast::make<ast::MatchExpr>(astContext, *expr);
     spec->target = handleExpr(expr->target);
     spec->branches = util::vector::map(expr->branches, [this](const ast::MatchExprBranch &branch) {
         ast::MatchExprBranch spec(branch);
@@ -345,23 +344,23 @@ std::shared_ptr<ast::MatchExpr> ASTRewriter::handleMatchExpr(std::shared_ptr<ast
 
 
 
-std::shared_ptr<ast::BinOp> ASTRewriter::handleBinOp(std::shared_ptr<ast::BinOp> expr) {
-    auto spec = std::make_shared<ast::BinOp>(*expr);
+ast::BinOp *ASTRewriter::handleBinOp(ast::BinOp *expr) {
+    auto spec = ast::make<ast::BinOp>(astContext, *expr);
     spec->lhs = handleExpr(expr->lhs);
     spec->rhs = handleExpr(expr->rhs);
     return spec;
 }
 
 
-std::shared_ptr<ast::UnaryExpr> ASTRewriter::handleUnaryExpr(std::shared_ptr<ast::UnaryExpr> expr) {
-    auto spec = std::make_shared<ast::UnaryExpr>(*expr);
+ast::UnaryExpr *ASTRewriter::handleUnaryExpr(ast::UnaryExpr *expr) {
+    auto spec = ast::make<ast::UnaryExpr>(astContext, *expr);
     spec->expr = handleExpr(expr->expr);
     return spec;
 }
 
 
 
-std::shared_ptr<ast::LambdaExpr> ASTRewriter::handleLambdaExpr(std::shared_ptr<ast::LambdaExpr> lambdaExpr) {
+ast::LambdaExpr *ASTRewriter::handleLambdaExpr(ast::LambdaExpr *lambdaExpr) {
     LKFatalError("TODO: implement!");
 }
 
@@ -369,12 +368,12 @@ std::shared_ptr<ast::LambdaExpr> ASTRewriter::handleLambdaExpr(std::shared_ptr<a
 
 
 
-std::shared_ptr<ast::TemplateParamDeclList> ASTRewriter::handleTemplateParamDeclList(std::shared_ptr<ast::TemplateParamDeclList> decl) {
+ast::TemplateParamDeclList *ASTRewriter::handleTemplateParamDeclList(ast::TemplateParamDeclList *decl) {
     if (!decl) {
         return nullptr;
     }
     
-    auto spec = std::make_shared<ast::TemplateParamDeclList>(*decl);
+    auto spec = ast::make<ast::TemplateParamDeclList>(astContext, *decl);
     spec->setParams(util::vector::map(decl->getParams(), [this](const ast::TemplateParamDeclList::Param &param) {
         ast::TemplateParamDeclList::Param spec(param);
         spec.name = handleIdent(param.name);
@@ -386,12 +385,12 @@ std::shared_ptr<ast::TemplateParamDeclList> ASTRewriter::handleTemplateParamDecl
 
 
 
-std::shared_ptr<ast::TemplateParamArgList> ASTRewriter::handleTemplateParamArgList(std::shared_ptr<ast::TemplateParamArgList> tmplArgs) {
+ast::TemplateParamArgList *ASTRewriter::handleTemplateParamArgList(ast::TemplateParamArgList *tmplArgs) {
     if (!tmplArgs) {
         return nullptr;
     }
     
-    auto spec = std::make_shared<ast::TemplateParamArgList>(*tmplArgs);
+    auto spec = ast::make<ast::TemplateParamArgList>(astContext, *tmplArgs);
     spec->elements = util::vector::map(tmplArgs->elements, [this](const auto &typeDesc) {
         return handleTypeDesc(typeDesc);
     });
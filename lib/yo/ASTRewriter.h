@@ -26,15 +26,18 @@ namespace yo::irgen {
 /// with the option to substitute some type descs
 class ASTRewriter {
 public:
-    using TmplParamMapping = std::map<std::string, std::shared_ptr<ast::TypeDesc>>;
+    using TmplParamMapping = std::map<util::Symbol, ast::TypeDesc *>;
     //NominalTypeMappingT
     const TmplParamMapping templateArgumentMapping; // TODO rename
     
     
-    ASTRewriter() {}
-    explicit ASTRewriter(const TmplParamMapping &M) : templateArgumentMapping(M) {}
+    // The context the copied nodes are allocated in
+    ast::ASTContext &astContext;
     
-#define DEF_FN(T) std::shared_ptr<ast::T> handle##T(std::shared_ptr<ast::T>);
+    explicit ASTRewriter(ast::ASTContext &astContext) : astContext(astContext) {}
+    ASTRewriter(ast::ASTContext &astContext, const TmplParamMapping &M) : templateArgumentMapping(M), astContext(astContext) {}
+    
+#define DEF_FN(T) ast::T *handle##T(ast::T *);
     DEF_FN(TopLevelStmt)
     DEF_FN(LocalStmt)
     DEF_FN(Expr)
@@ -7,32 +7,51 @@
 //
 
 #include "lex/Diagnostics.h"
+#include "lex/SourceManager.h"
 #include "parse/Parser.h"
 #include "Driver.h"
 #include "IRGen.h"
+#include "TypeContext.h"
+#include "ObjectCache.h"
 #include "util/util.h"
 
+#include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/CodeGen/ParallelCG.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/IR/IRPrintingPasses.h"
+#include "llvm/Linker/Linker.h"
 #include "llvm/MC/TargetRegistry.h"
+#include "llvm/Passes/PassBuilder.h"
 #include "llvm/Target/TargetOptions.h"
 #include "llvm/Target/TargetMachine.h"
-#include "llvm/Transforms/IPO.h"
-//#include "llvm/Transforms/IPO/PassManagerBuilder.h"
-#include "llvm/Transforms/IPO/AlwaysInliner.h"
+#include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Host.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/Program.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/VersionTuple.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+
 
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <memory>
 #include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
 
 
 using namespace yo;
@@ -45,29 +64,77 @@ using namespace yo::driver;
 #pragma mark - Optimizations
 
 
-void addOptimizationPasses(const Options &options, llvm::PassRegistry &PR, llvm::legacy::PassManager &MPM, llvm::legacy::FunctionPassManager &FPM) {
-    // TODO https://llvm.org/docs/NewPassManager.html
-////    llvm::initializeIPO(PR);
-////    llvm::initializeRegToMemPass(PR);
-////    llvm::initializeSimpleInlinerPass(PR);
-////    llvm::initializeStripDeadPrototypesLegacyPassPass(PR);
-//    
-//    llvm::PassManagerBuilder PMBuilder;
-//    PMBuilder.OptLevel = options.optimize ? 1 : 0;
-//    PMBuilder.SizeLevel = 0;
-//    
-//    if (!options.fnoInline) {
-//        if (PMBuilder.OptLevel > 1) {
-//            PMBuilder.Inliner = llvm::createFunctionInliningPass(PMBuilder.OptLevel, PMBuilder.SizeLevel, false);
-//        } else {
-//            PMBuilder.Inliner = llvm::createAlwaysInlinerLegacyPass();
-//        }
-//    }
-//    
-//    PMBuilder.populateFunctionPassManager(FPM);
-//    PMBuilder.populateModulePassManager(MPM);
-//    
-////    MPM.add(llvm::createStripDeadPrototypesPass()); // TODO
+llvm::OptimizationLevel getLLVMOptimizationLevel(OptimizationLevel level) {
+    switch (level) {
+        case OptimizationLevel::O0: return llvm::OptimizationLevel::O0;
+        case OptimizationLevel::O1: return llvm::OptimizationLevel::O1;
+        case OptimizationLevel::O2: return llvm::OptimizationLevel::O2;
+        case OptimizationLevel::O3: return llvm::OptimizationLevel::O3;
+        case OptimizationLevel::Os: return llvm::OptimizationLevel::Os;
+        case OptimizationLevel::Oz: return llvm::OptimizationLevel::Oz;
+    }
+    llvm_unreachable("invalid optimization level");
+}
+
+
+llvm::CodeGenOpt::Level getCodeGenOptLevel(OptimizationLevel level) {
+    switch (level) {
+        case OptimizationLevel::O0: return llvm::CodeGenOpt::None;
+        case OptimizationLevel::O1: return llvm::CodeGenOpt::Less;
+        case OptimizationLevel::O2:
+        case OptimizationLevel::Os:
+        case OptimizationLevel::Oz: return llvm::CodeGenOpt::Default;
+        case OptimizationLevel::O3: return llvm::CodeGenOpt::Aggressive;
+    }
+    llvm_unreachable("invalid optimization level");
+}
+
+
+// `-fno-inline` disables all inlining, including functions explicitly marked as `always_inline`.
+// The default pipelines always contain an inliner pass, so instead of leaving that out we mark every function as noinline (which is also what clang does)
+void disableInlining(llvm::Module &M) {
+    for (llvm::Function &F : M) {
+        if (F.isDeclaration()) continue;
+        F.removeFnAttr(llvm::Attribute::AlwaysInline);
+        F.removeFnAttr(llvm::Attribute::InlineHint);
+        F.addFnAttr(llvm::Attribute::NoInline);
+    }
+}
+
+
+void runOptimizationPasses(const Options &options, llvm::Module &M, llvm::TargetMachine *TM) {
+    if (options.fnoInline) {
+        disableInlining(M);
+    }
+    
+    llvm::LoopAnalysisManager LAM;
+    llvm::FunctionAnalysisManager FAM;
+    llvm::CGSCCAnalysisManager CGAM;
+    llvm::ModuleAnalysisManager MAM;
+    
+    // Passing the target machine to the pass builder registers the TargetIRAnalysis, so that passes get the correct TTI
+    llvm::PassBuilder PB(TM);
+    
+    llvm::TargetLibraryInfoImpl TLII(llvm::Triple(M.getTargetTriple()));
+    FAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
+    
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+    
+    auto level = getLLVMOptimizationLevel(options.optimizationLevel);
+    llvm::ModulePassManager MPM;
+    
+    if (level == llvm::OptimizationLevel::O0) {
+        // still runs the always-inliner (unless that was disabled above)
+        MPM = PB.buildO0DefaultPipeline(level);
+    } else {
+        MPM = PB.buildPerModuleDefaultPipeline(level);
+    }
+    
+    MPM.run(M, MAM);
 }
 
 
@@ -77,6 +144,30 @@ void addOptimizationPasses(const Options &options, llvm::PassRegistry &PR, llvm:
 #pragma mark - EmitModule
 
 
+// Configures the module for the target machine, verifies and optimizes it, and dumps the IR if requested
+void prepareModule(const Options &options, llvm::Module &module, llvm::TargetMachine *targetMachine) {
+    module.setDataLayout(targetMachine->createDataLayout());
+    module.setTargetTriple(targetMachine->getTargetTriple().str());
+    
+    if (llvm::verifyModule(module, &llvm::errs())) {
+        LKFatalError("module verification failed");
+    }
+    
+    if (options.dumpLLVMPreOpt) {
+        llvm::outs() << "Pre-Optimized IR:\n";
+        module.print(llvm::outs(), nullptr, /*ShouldPreserveUseListOrder*/ true);
+    }
+    
+    runOptimizationPasses(options, module, targetMachine);
+    
+    if (options.dumpLLVM) {
+        std::string banner = options.optimizationLevel == OptimizationLevel::O0 ? "Final IR:" : "Final IR (Optimized):";
+        llvm::outs() << banner << "\n";
+        module.print(llvm::outs(), nullptr, /*ShouldPreserveUseListOrder*/ true);
+    }
+}
+
+
 
 bool emit(llvm::Module &M, llvm::TargetMachine *TM, llvm::raw_pwrite_stream &OS, llvm::CodeGenFileType CGFT) {
     llvm::legacy::PassManager PM;
@@ -97,16 +188,205 @@ void emitIR(llvm::Module &M, llvm::raw_pwrite_stream &OS) {
 }
 
 
+unsigned getNumCodegenThreads(const Options &options) {
+    if (options.numCodegenThreads == 0) {
+        return llvm::heavyweight_hardware_concurrency().compute_thread_count();
+    }
+    return options.numCodegenThreads;
+}
+    
+
+// Codegen emits one object file per thread
+std::vector<std::string> getObjectFilePaths(const Options &options, const std::string &filename) {
+    auto numThreads = getNumCodegenThreads(options);
+    if (numThreads <= 1) {
+        return { util::fmt::format("{}.o", filename) };
+    }
+    
+    std::vector<std::string> objectFilePaths;
+    for (unsigned idx = 0; idx < numThreads; idx++) {
+        objectFilePaths.push_back(util::fmt::format("{}.{}.o", filename, idx));
+    }
+    return objectFilePaths;
+}
+
+
+// Emits the module as one object file per path.
+// When using multiple threads, the module is split into one partition per thread, which are code-generated concurrently into separate objects.
+// Note that splitting the module externalizes its local symbols.
+void emitObjectFiles(llvm::Module &M, const std::function<std::unique_ptr<llvm::TargetMachine>()> &createTargetMachine, const std::vector<std::string> &objectFilePaths) {
+    std::vector<std::unique_ptr<llvm::raw_fd_ostream>> streams;
+    std::vector<llvm::raw_pwrite_stream *> OSs;
+    
+    for (const auto &path : objectFilePaths) {
+        std::error_code EC;
+        auto &OS = streams.emplace_back(std::make_unique<llvm::raw_fd_ostream>(path, EC));
+        if (EC) {
+            LKFatalError("unable to open '%s' for writing: %s", path.c_str(), EC.message().c_str());
+        }
+        OSs.push_back(OS.get());
+    }
+    
+    if (OSs.size() == 1) {
+        emit(M, createTargetMachine().get(), *OSs.front(), llvm::CodeGenFileType::CGFT_ObjectFile);
+        return;
+    }
+    
+    llvm::splitCodeGen(M, OSs, {}, createTargetMachine, llvm::CodeGenFileType::CGFT_ObjectFile);
+}
+
+
+// The object cache only stores object files and assembly, which means that it can't be used if we need the optimized IR as well
+bool canUseObjectCache(const Options &options) {
+    const auto &outputs = options.outputFileTypes;
+    return !options.cacheDirectory.empty()
+        && !options.dumpLLVM && !options.dumpLLVMPreOpt
+        && !outputs.contains(OutputFileType::LLVM_IR) && !outputs.contains(OutputFileType::LLVM_BC)
+        && (outputs.contains(OutputFileType::ObjectFile) || outputs.contains(OutputFileType::Assembly));
+}
+
+
+
+#pragma mark - Linking
+
+static std::optional<std::string> findGCCDirectory(const llvm::Triple &triple) {
+    // Distributions disagree on the triple's vendor component, so we try the common spellings
+    auto arch = triple.getArchName().str();
+    std::vector<std::string> triples = {
+        util::fmt::format("{}-linux-gnu", arch),
+        util::fmt::format("{}-pc-linux-gnu", arch),
+        util::fmt::format("{}-unknown-linux-gnu", arch),
+        util::fmt::format("{}-redhat-linux", arch),
+        util::fmt::format("{}-suse-linux", arch)
+    };
+
+    // If multiple versions are installed, we use the newest one (which is also what gcc itself would use)
+    std::optional<std::string> gccDirectory;
+    llvm::VersionTuple gccVersion;
+    for (const auto &libDirectory : { "/usr/lib", "/usr/lib64" }) {
+        for (const auto &gccTriple : triples) {
+            std::error_code EC;
+            auto path = util::fmt::format("{}/gcc/{}", libDirectory, gccTriple);
+            for (llvm::sys::fs::directory_iterator it(path, EC), end; it != end && !EC; it.increment(EC)) {
+                llvm::VersionTuple version;
+                if (version.tryParse(llvm::sys::path::filename(it->path())) || version <= gccVersion) {
+                    continue;
+                }
+                if (util::fs::file_exists(util::fmt::format("{}/crtbegin.o", it->path()))) {
+                    gccDirectory = it->path();
+                    gccVersion = version;
+                }
+            }
+        }
+    }
+    return gccDirectory;
+}
 
-// returns true on success
-bool emitModule(const Options &options, std::unique_ptr<llvm::Module> module, const std::string &filename) {
+
+std::optional<ELFLinkEnvironment> driver::findELFLinkEnvironment(const std::string &targetTriple) {
+    llvm::Triple triple(targetTriple);
+    if (!triple.isOSLinux() || !triple.isGNUEnvironment()) {
+        return std::nullopt;
+    }
+    
+    ELFLinkEnvironment env;
+    switch (triple.getArch()) {
+        case llvm::Triple::x86_64:
+            env.emulation = "elf_x86_64";
+            env.dynamicLinker = "/lib64/ld-linux-x86-64.so.2";
+            break;
+        case llvm::Triple::aarch64:
+            env.emulation = "aarch64linux";
+            env.dynamicLinker = "/lib/ld-linux-aarch64.so.1";
+            break;
+        default:
+            return std::nullopt;
+    }
+    
+    // The dynamic linker's path is part of the ABI, but some distributions (eg, NixOS) don't install it there
+    if (!util::fs::file_exists(env.dynamicLinker)) {
+        return std::nullopt;
+    }
+    
+    auto multiarchDirectory = util::fmt::format("/usr/lib/{}-linux-gnu", triple.getArchName().str());
+    for (const auto &dir : { multiarchDirectory, std::string("/usr/lib64"), std::string("/usr/lib") }) {
+        if (util::fs::file_exists(util::fmt::format("{}/crt1.o", dir))
+            && util::fs::file_exists(util::fmt::format("{}/crti.o", dir))
+            && util::fs::file_exists(util::fmt::format("{}/crtn.o", dir))) {
+            env.libDirectory = dir;
+            break;
+        }
+    }
+    
+    // crtbegin.o and crtend.o (which run the global ctors and dtors), and libgcc are part of gcc, not libc
+    auto gccDirectory = findGCCDirectory(triple);
+    if (env.libDirectory.empty() || !gccDirectory || !util::fs::file_exists(util::fmt::format("{}/crtend.o", *gccDirectory))) {
+        return std::nullopt;
+    }
+    env.gccDirectory = *gccDirectory;
+    return env;
+}
+
+
+std::vector<std::string> driver::getELFLinkerArgs(const ELFLinkEnvironment &env, const std::vector<std::string> &objectFilePaths, const std::string &outputPath) {
+    auto crt = [](const std::string &directory, const char *name) {
+        return util::fmt::format("{}/{}", directory, name);
+    };
+    
+    // This is the link line gcc uses for non-PIE executables
+    std::vector<std::string> args = {
+        "--eh-frame-hdr",
+        "-m", env.emulation,
+        "-dynamic-linker", env.dynamicLinker,
+        "-o", outputPath,
+        crt(env.libDirectory, "crt1.o"), crt(env.libDirectory, "crti.o"), crt(env.gccDirectory, "crtbegin.o"),
+        "-L", env.gccDirectory,
+        "-L", env.libDirectory
+    };
+    args.insert(args.end(), objectFilePaths.begin(), objectFilePaths.end());
+    args.insert(args.end(), {
+        "-lgcc", "--as-needed", "-lgcc_s", "--no-as-needed",
+        "-lc",
+        "-lgcc", "--as-needed", "-lgcc_s", "--no-as-needed",
+        crt(env.gccDirectory, "crtend.o"), crt(env.libDirectory, "crtn.o")
+    });
+    return args;
+}
+    
+
+// Invoking the linker directly avoids the overhead of the compiler driver (and doesn't require one to be installed).
+// The link line is reconstructed from what gcc would pass, which doesn't necessarily match what the system's compiler driver does,
+// so this is only an optimization: if linking fails, the caller falls back to the compiler driver
+bool driver::linkDirectly(const std::string &targetTriple, const std::vector<std::string> &objectFilePaths, const std::string &outputPath) {
+    auto env = findELFLinkEnvironment(targetTriple);
+    if (!env) {
+        return false;
+    }
+    // Not using `?:` here (or below), since GCC miscompiles it for class types like ErrorOr (the value is freed twice)
+    auto linkerPath = llvm::sys::findProgramByName("ld.lld");
+    if (!linkerPath) {
+        linkerPath = llvm::sys::findProgramByName("ld");
+    }
+    if (!linkerPath) {
+        return false;
+    }
+    
+    auto args = getELFLinkerArgs(*env, objectFilePaths, outputPath);
+    std::vector<llvm::StringRef> argv = { linkerPath.get() };
+    argv.insert(argv.end(), args.begin(), args.end());
+    
+    // The linker's output is discarded, since the compiler driver will report any errors that remain
+    return llvm::sys::ExecuteAndWait(argv[0], argv, {}, { {}, llvm::StringRef(""), llvm::StringRef("") }) == 0;
+}
+
+
+
+// returns true on success. If `isPrepared` is set, the module already was verified and optimized (see `prepareModule`)
+bool emitModule(const Options &options, std::unique_ptr<llvm::Module> module, const std::string &filename, bool isPrepared = false) {
     llvm::InitializeNativeTarget();
     llvm::InitializeNativeTargetAsmParser();
     llvm::InitializeNativeTargetAsmPrinter();
     
-    llvm::PassRegistry &PR = *llvm::PassRegistry::getPassRegistry();
-    //llvm::initializeCore(PR);
-    
     std::string error;
     std::error_code EC;
     
@@ -126,103 +406,284 @@ bool emitModule(const Options &options, std::unique_ptr<llvm::Module> module, co
     auto features = "";
     
     llvm::TargetOptions opt;
+    // Emit global ctors and dtors into .init_array/.fini_array instead of .ctors/.dtors, which lld (unlike ld) doesn't convert
+    opt.UseInitArray = true;
     auto RM = std::optional<llvm::Reloc::Model>();
-    auto targetMachine = target->createTargetMachine(targetTriple, hostCPU, features, opt, RM);
+    auto CM = std::optional<llvm::CodeModel::Model>();
+    // Parallel codegen needs a separate target machine per thread
+    auto createTargetMachine = [&]() -> std::unique_ptr<llvm::TargetMachine> {
+        return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(targetTriple, hostCPU, features, opt, RM, CM, getCodeGenOptLevel(options.optimizationLevel)));
+    };
+    auto targetMachine = createTargetMachine();
     
-    module->setDataLayout(targetMachine->createDataLayout());
-    module->setTargetTriple(targetTriple);
+    std::vector<std::string> objectFilePaths;
+    if (options.outputFileTypes.contains(OutputFileType::ObjectFile)) {
+        objectFilePaths = getObjectFilePaths(options, filename);
+    }
+
+    // Look up the object file(s) and/or assembly in the cache, which lets us skip optimization and codegen entirely
+    std::optional<ObjectCache> cache;
+    std::string cacheKey;
+    std::vector<ObjectCache::Artifact> cacheArtifacts;
+
+    if (canUseObjectCache(options)) {
+        cache.emplace(options.cacheDirectory, options.cacheSizeLimit);
+        
+        // The key is computed from the unoptimized module, which has to know its target at this point
+        module->setDataLayout(targetMachine->createDataLayout());
+        module->setTargetTriple(targetTriple);
+        auto configuration = util::fmt::format("{};{};{};O{};{};{}", targetTriple, hostCPU.str(), features,
+                                               static_cast<int>(options.optimizationLevel), options.fnoInline, getNumCodegenThreads(options));
+        cacheKey = ObjectCache::computeKey(*module, configuration);
+        
+        if (options.outputFileTypes.contains(OutputFileType::Assembly)) {
+            cacheArtifacts.push_back({ ".s", util::fmt::format("{}.s", filename) });
+        }
+        for (const auto &path : objectFilePaths) {
+            cacheArtifacts.push_back({ path.substr(filename.size()), path });
+        }
+    }
     
+    if (!cache || !cache->lookup(cacheKey, cacheArtifacts)) {
+        if (!isPrepared) {
+            prepareModule(options, *module, targetMachine.get());
+        }
+        
+        if (options.outputFileTypes.isEmpty()) {
+            return true;
+        }
+        
+        
+        if (options.outputFileTypes.contains(OutputFileType::LLVM_IR)) {
+            llvm::raw_fd_ostream OS(util::fmt::format("{}.ll", filename), EC);
+            emitIR(*module, OS);
+        }
+
     
-//    llvm::outs() << *module << '\n';
     
-    // Create and run passes
+        // Emit object file(s) and/or assembly
     
-    llvm::legacy::PassManager PM;
-    llvm::legacy::FunctionPassManager FPM(module.get());
+        if (options.outputFileTypes.contains(OutputFileType::Assembly)) {
+            llvm::raw_fd_ostream OS(util::fmt::format("{}.s", filename), EC);
+            emit(*module, targetMachine.get(), OS, llvm::CodeGenFileType::CGFT_AssemblyFile);
+        }
+        
+        // Bitcode is written before the object files, since splitting the module for parallel codegen modifies it
+        if (options.outputFileTypes.contains(OutputFileType::LLVM_BC)) {
+            llvm::raw_fd_ostream OS(util::fmt::format("{}.bc", filename), EC);
+            llvm::WriteBitcodeToFile(*module, OS);
+        }
+        
+        if (options.outputFileTypes.contains(OutputFileType::ObjectFile)) {
+            emitObjectFiles(*module, createTargetMachine, objectFilePaths);
+        }
+        
+        if (cache) {
+            cache->insert(cacheKey, cacheArtifacts);
+        }
+    }
     
-    PM.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
-    FPM.add(llvm::createTargetTransformInfoWrapperPass(targetMachine->getTargetIRAnalysis()));
-    PM.add(llvm::createVerifierPass());
+    if (cache && options.printCacheStatistics) {
+        auto stats = cache->getStatistics();
+        util::fmt::print("object cache: {} hits, {} misses, {} files ({} bytes)\n", stats.hits, stats.misses, stats.numFiles, stats.totalSize);
+    }
 
-    if (options.dumpLLVMPreOpt) {
-        PM.add(llvm::createPrintModulePass(llvm::outs(), "Pre-Optimized IR:", true));
+    
+    if (!options.outputFileTypes.contains(OutputFileType::Binary)) {
+        return true;
     }
-    addOptimizationPasses(options, PR, PM, FPM);
 
-    FPM.doInitialization();
-    for (llvm::Function &F : *module) {
-        if (!F.isDeclaration()) {
-            FPM.run(F);
-        }
+    // Link object file(s) into executable
+
+    // Invoke the linker directly, unless we're told not to. If we don't know how to do that for the target, or linking failed, we fall back to the compiler driver
+    if (!options.useExternalLinker && linkDirectly(targetTriple, objectFilePaths, "a.out")) {
+        return true;
     }
-    FPM.doFinalization();
 
-    if (options.dumpLLVM) {
-        std::string banner = !options.optimize ? "Final IR:" : "Final IR (Optimized):";
-        PM.add(llvm::createPrintModulePass(llvm::outs(), banner, true));
+    // Using clang/gcc to link since that seems to work more reliable than directly calling ld
+    auto linkerPath = llvm::sys::findProgramByName("clang");
+    if (!linkerPath) {
+        linkerPath = llvm::sys::findProgramByName("gcc");
+    }
+    if (!linkerPath) {
+        LKFatalError("unable to find clang or gcc");
     }
 
-    PM.run(*module);
+    std::vector<llvm::StringRef> ld_argv = { linkerPath.get() };
+    ld_argv.insert(ld_argv.end(), objectFilePaths.begin(), objectFilePaths.end());
+    ld_argv.insert(ld_argv.end(), { "-lc", "-o", "a.out" });
 
-    if (options.outputFileTypes.isEmpty()) {
-        return true;
+
+    auto res = llvm::sys::ExecuteAndWait(ld_argv[0], ld_argv);
+    if (res != 0) {
+        LKFatalError("'%s' returned with non-zero exit code %i", linkerPath->c_str(), res);
     }
 
+    return true;
+}
 
-    if (options.outputFileTypes.contains(OutputFileType::LLVM_IR)) {
-        llvm::raw_fd_ostream OS(util::fmt::format("{}.ll", filename), EC);
-        emitIR(*module, OS);
-    }
 
+
+#pragma mark - JIT
+
+
+// The target machine configuration the JIT compiles for, modules run in the JIT should be optimized for the same configuration
+llvm::orc::JITTargetMachineBuilder getJITTargetMachineBuilder(const Options &options, llvm::ExitOnError &exitOnErr) {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmParser();
+    llvm::InitializeNativeTargetAsmPrinter();
     
+    auto JTMB = exitOnErr(llvm::orc::JITTargetMachineBuilder::detectHost());
+    JTMB.setCodeGenOptLevel(getCodeGenOptLevel(options.optimizationLevel));
+    return JTMB;
+}
     
-    // Emit object file and/or assembly
-    std::string objectFilePath;
-    
-    if (options.outputFileTypes.contains(OutputFileType::Assembly)) {
-        llvm::raw_fd_ostream OS(util::fmt::format("{}.s", filename), EC);
-        emit(*module, targetMachine, OS, llvm::CodeGenFileType::CGFT_AssemblyFile);
+
+bool runPreparedModuleInJIT(const Options &options, llvm::orc::JITTargetMachineBuilder JTMB, std::unique_ptr<llvm::Module> module,
+                            std::unique_ptr<llvm::LLVMContext> context, int &programExitCode, llvm::ExitOnError &exitOnErr) {
+    // main is either `() -> i32` or `(i32, **i8) -> i32`, and has to be called through a pointer of the matching type
+    auto mainDecl = module->getFunction("main");
+    if (!mainDecl || mainDecl->isDeclaration()) {
+        llvm::errs() << "JIT error: the program doesn't define a main function\n";
+        return false;
     }
-    
-    if (options.outputFileTypes.contains(OutputFileType::ObjectFile)) {
-        objectFilePath = util::fmt::format("{}.o", filename);
-        llvm::raw_fd_ostream OS(objectFilePath, EC);
-        emit(*module, targetMachine, OS, llvm::CodeGenFileType::CGFT_ObjectFile);
+    auto mainFnTy = mainDecl->getFunctionType();
+    bool takesArguments = mainFnTy->getNumParams() == 2;
+    if (!mainFnTy->getReturnType()->isIntegerTy(32) || (mainFnTy->getNumParams() != 0 && !takesArguments)) {
+        llvm::errs() << "JIT error: unsupported signature of main function: " << *mainFnTy << "\n";
+        return false;
     }
     
-    if (options.outputFileTypes.contains(OutputFileType::LLVM_BC)) {
-        llvm::raw_fd_ostream OS(util::fmt::format("{}.bc", filename), EC);
-        llvm::WriteBitcodeToFile(*module, OS);
+    auto jit = exitOnErr(llvm::orc::LLJITBuilder().setJITTargetMachineBuilder(std::move(JTMB)).create());
+    auto &mainJD = jit->getMainJITDylib();
+    
+    // Symbols not defined by the module (ie, libc) are resolved from the compiler's own process
+    mainJD.addGenerator(exitOnErr(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(jit->getDataLayout().getGlobalPrefix())));
+    exitOnErr(jit->addIRModule(llvm::orc::ThreadSafeModule(std::move(module), std::move(context))));
+    
+    auto mainAddress = exitOnErr(jit->lookup("main"));
+    
+    std::vector<std::string> args = { options.inputFile };
+    args.insert(args.end(), options.runArgs.begin(), options.runArgs.end());
+    
+    std::vector<char *> argv;
+    for (auto &arg : args) {
+        argv.push_back(arg.data());
     }
-
+    argv.push_back(nullptr);
     
-    if (!options.outputFileTypes.contains(OutputFileType::Binary)) {
-        return true;
+    // initialize and deinitialize run the module's llvm.global_ctors and llvm.global_dtors, respectively
+    exitOnErr(jit->initialize(mainJD));
+    if (takesArguments) {
+        programExitCode = mainAddress.toPtr<int(*)(int, char **)>()(static_cast<int>(args.size()), argv.data());
+    } else {
+        programExitCode = mainAddress.toPtr<int(*)()>()();
     }
+    exitOnErr(jit->deinitialize(mainJD));
+    
+    return true;
+}
 
-    // Link object file into executable
 
+bool driver::runModuleInJIT(const Options &options, std::unique_ptr<llvm::Module> module, std::unique_ptr<llvm::LLVMContext> context, int &programExitCode) {
+    llvm::ExitOnError exitOnErr("JIT error: ");
+    auto JTMB = getJITTargetMachineBuilder(options, exitOnErr);
+    prepareModule(options, *module, exitOnErr(JTMB.createTargetMachine()).get());
+    return runPreparedModuleInJIT(options, std::move(JTMB), std::move(module), std::move(context), programExitCode, exitOnErr);
+}
 
-    // Using clang/gcc to link since that seems to work more reliable than directly calling ld
-    auto linkerPath = llvm::sys::findProgramByName("clang") ?: llvm::sys::findProgramByName("gcc");
-    if (!linkerPath) {
-        LKFatalError("unable to find clang or gcc");
-    }
 
-    std::vector<llvm::StringRef> ld_argv = {
-        linkerPath.get(),
-        objectFilePath,
-        "-lc",
-        "-o", "a.out"
-    };
 
+#pragma mark - IRGen
 
-    auto res = llvm::sys::ExecuteAndWait(ld_argv[0], ld_argv);
-    if (res != 0) {
-        LKFatalError("'%s' returned with non-zero exit code %i", linkerPath->c_str(), res);
+unsigned getNumIRGenThreads(const Options &options) {
+    if (options.numIRGenThreads == 0) {
+        return llvm::heavyweight_hardware_concurrency().compute_thread_count();
     }
+    return options.numIRGenThreads;
+}
 
-    return true;
+
+// Parses the input file and lowers the function bodies in the specified partition (see IRGenerator::setLoweringPartition) into a module.
+// The context is taken out of the generator, so that it can outlive it
+std::unique_ptr<llvm::Module> generateModule(const Options &options, unsigned partitionIndex, unsigned numPartitions, std::unique_ptr<llvm::LLVMContext> &context) {
+    // Own the source files, the AST and the types, which are referenced by the generator
+    lex::SourceManager sourceManager;
+    ast::ASTContext astContext;
+    irgen::TypeContext typeContext;
+    parser::Parser parser(astContext, sourceManager);
+    
+    if (!options.stdlibRoot.empty()) {
+        parser.setCustomStdlibRoot(options.stdlibRoot);
+    }
+    
+    auto ast = parser.parse(options.inputFile);
+//    ast::print_ast(ast);
+    
+    if (options.dumpAST && partitionIndex == 0) {
+        std::cout << ast::description(ast) << std::endl;
+    }
+    
+    irgen::IRGenerator irgen(ast, astContext, typeContext, sourceManager, options.inputFile, options);
+    irgen.setLoweringPartition(partitionIndex, numPartitions);
+    irgen.runCodegen();
+    context = irgen.takeContext();
+    return irgen.getModule();
+}
+
+
+// Lowers the program on multiple threads, and links the resulting modules into the first partition's module.
+// Since the generator mutates the AST, every thread parses the program into its own AST, and registers all of its decls.
+// The function bodies are lowered in parallel, one partition per thread, each into a module in its own context.
+// Modules can only be linked within the same context, which is why the other partitions are handed back as bitcode.
+// Errors are deferred, and only the error of the first failing partition is reported, so that the same error is reported in every run
+std::unique_ptr<llvm::Module> generateModuleInParallel(const Options &options, unsigned numPartitions, std::unique_ptr<llvm::LLVMContext> &context) {
+    std::unique_ptr<llvm::Module> module;
+    std::vector<llvm::SmallVector<char, 0>> partitionsBitcode(numPartitions);
+    std::vector<std::optional<diagnostics::DeferredError>> errors(numPartitions);
+    
+    {
+        llvm::ThreadPool threadPool(llvm::hardware_concurrency(numPartitions));
+        for (unsigned idx = 0; idx < numPartitions; idx++) {
+            threadPool.async([&, idx]() {
+                diagnostics::DeferErrorsScope deferErrors;
+                try {
+                    std::unique_ptr<llvm::LLVMContext> partitionContext;
+                    auto partitionModule = generateModule(options, idx, numPartitions, partitionContext);
+                    if (idx == 0) {
+                        module = std::move(partitionModule);
+                        context = std::move(partitionContext);
+                        return;
+                    }
+                    llvm::raw_svector_ostream OS(partitionsBitcode[idx]);
+                    llvm::WriteBitcodeToFile(*partitionModule, OS);
+                } catch (const diagnostics::DeferredError &error) {
+                    errors[idx] = error;
+                }
+            });
+        }
+        threadPool.wait();
+    }
+    
+    for (const auto &error : errors) {
+        if (error) {
+            diagnostics::emitDeferredError(*error);
+        }
+    }
+    
+    llvm::Linker linker(*module);
+    for (unsigned idx = 1; idx < numPartitions; idx++) {
+        const auto &bitcode = partitionsBitcode[idx];
+        auto partitionModule = llvm::parseBitcodeFile(llvm::MemoryBufferRef(llvm::StringRef(bitcode.data(), bitcode.size()), module->getModuleIdentifier()), *context);
+        if (!partitionModule) {
+            LKFatalError("unable to read IRGen partition %u: %s", idx, llvm::toString(partitionModule.takeError()).c_str());
+        }
+        if (linker.linkInModule(std::move(*partitionModule))) {
+            LKFatalError("unable to link IRGen partition %u", idx);
+        }
+    }
+    
+    return module;
 }
 
 
@@ -240,7 +701,7 @@ extern "C" void LKCompilerSetInternalOptionSigabrtOnFatalError(bool newValue) {
 }
 
 
-bool driver::run(driver::Options options) {
+bool driver::run(driver::Options options, int *programExitCode) {
     auto cwd = std::filesystem::current_path();
     std::cout << "cwd: " << cwd << std::endl;
     
@@ -250,35 +711,39 @@ bool driver::run(driver::Options options) {
         diagnostics::emitError(util::fmt::format("input file '{}' does not exist", options.inputFile));
     }
     
-    const std::string inputFile = options.inputFile;
-    const std::string inputFilename = util::fs::path_get_filename(inputFile);
+    const std::string inputFilename = util::fs::path_get_filename(options.inputFile);
     
-    parser::Parser parser;
+    // The context outlives the generator, so that it can be handed off to the JIT
+    std::unique_ptr<llvm::LLVMContext> context;
+    std::unique_ptr<llvm::Module> M;
     
-    if (!options.stdlibRoot.empty()) {
-        parser.setCustomStdlibRoot(options.stdlibRoot);
+    if (auto numIRGenThreads = getNumIRGenThreads(options); numIRGenThreads > 1) {
+        M = generateModuleInParallel(options, numIRGenThreads, context);
+    } else {
+        M = generateModule(options, 0, 1, context);
     }
     
-    auto ast = parser.parse(inputFile);
-//    ast::print_ast(ast);
+    if (options.outputFileTypes.contains(OutputFileType::Binary)) {
+        options.outputFileTypes.insert(OutputFileType::ObjectFile);
+    }
     
-    if (options.dumpAST) {
-        std::cout << ast::description(ast) << std::endl;
+    if (!options.runInJIT) {
+        return emitModule(options, std::move(M), inputFilename);
     }
     
-    irgen::IRGenerator irgen(ast, inputFile, options);
-    irgen.runCodegen();
+    LKAssert(programExitCode && "running in the JIT requires a programExitCode");
     
-    std::unique_ptr<llvm::Module> M = irgen.getModule();
+    // The module is only optimized once, for the JIT's target machine configuration.
+    // Since the JIT takes ownership of the module, any requested output files are emitted from a copy of the optimized module
+    llvm::ExitOnError exitOnErr("JIT error: ");
+    auto JTMB = getJITTargetMachineBuilder(options, exitOnErr);
+    prepareModule(options, *M, exitOnErr(JTMB.createTargetMachine()).get());
     
-    if (options.outputFileTypes.contains(OutputFileType::Binary)) {
-        options.outputFileTypes.insert(OutputFileType::ObjectFile);
+    if (!options.outputFileTypes.isEmpty() && !emitModule(options, llvm::CloneModule(*M), inputFilename, /*isPrepared*/ true)) {
+        return false;
     }
     
-    if (emitModule(options, std::move(M), inputFilename)) {
-        return true;
-    }
-    return false;
+    return runPreparedModuleInJIT(options, std::move(JTMB), std::move(M), std::move(context), *programExitCode, exitOnErr);
 }
 
 
@@ -11,7 +11,15 @@
 #include "util/util.h"
 #include "util/OptionSet.h"
 
+#include <memory>
+#include <optional>
 #include <string>
+#include <vector>
+
+namespace llvm {
+class LLVMContext;
+class Module;
+}
 
 
 namespace yo::driver {
@@ -25,17 +33,33 @@ enum class OutputFileType : uint8_t {
 };
 
 
+enum class OptimizationLevel : uint8_t {
+    O0, O1, O2, O3, Os, Oz
+};
+
+
 
 struct Options {
     std::string inputFile;
     std::string stdlibRoot;
-    bool optimize;
+    OptimizationLevel optimizationLevel;
     bool emitDebugMetadata;
     util::OptionSet<OutputFileType> outputFileTypes;
     
     bool fnoInline;
     bool fzeroInitialize;
     
+    unsigned numIRGenThreads; // 0: use all available cores
+    unsigned numCodegenThreads; // 0: use all available cores
+    bool useExternalLinker; // link via clang/gcc, instead of invoking the linker directly
+    
+    std::string cacheDirectory; // object cache location, the cache is disabled if empty
+    uint64_t cacheSizeLimit; // in bytes, 0: no limit
+    bool printCacheStatistics;
+    
+    bool runInJIT; // run the program's main function in-process after codegen
+    std::vector<std::string> runArgs; // arguments passed to the program when running it in the JIT (excluding argv[0])
+    
     bool dumpLLVM;
     bool dumpLLVMPreOpt;
     bool dumpAST;
@@ -46,6 +70,33 @@ struct Options {
 };
 
 
-bool run(Options);
+/// What's needed to link a dynamically linked executable against the system's libc, w/o going through a compiler driver
+struct ELFLinkEnvironment {
+    std::string emulation; // the linker's `-m` argument
+    std::string dynamicLinker;
+    std::string libDirectory; // contains libc and its crt objects
+    std::string gccDirectory; // contains libgcc and crtbegin.o/crtend.o
+};
+
+/// Returns nullopt if the target isn't a supported Linux/GNU target, or the crt objects aren't installed
+std::optional<ELFLinkEnvironment> findELFLinkEnvironment(const std::string &targetTriple);
+
+/// The arguments (excluding argv[0]) for linking the object files into an executable w/ a GNU-compatible linker (ld, ld.lld)
+std::vector<std::string> getELFLinkerArgs(const ELFLinkEnvironment&, const std::vector<std::string> &objectFilePaths, const std::string &outputPath);
+
+/// Links the object files into an executable by running ld.lld (or, if that isn't installed, ld) as a subprocess, w/out going through a compiler driver.
+/// Returns false if that isn't possible for the target, no linker was found, or linking failed
+bool linkDirectly(const std::string &targetTriple, const std::vector<std::string> &objectFilePaths, const std::string &outputPath);
+
+
+/// Runs the module's main function in-process, instead of linking it into an executable. Returns true on success.
+/// The JIT takes ownership of the module, and the context it was created in. The program's arguments are the input file, followed by `runArgs`,
+/// and are only passed if main declares parameters for them
+bool runModuleInJIT(const Options&, std::unique_ptr<llvm::Module>, std::unique_ptr<llvm::LLVMContext>, int &programExitCode);
+
+
+/// Compiles the input file, returns false if compilation failed.
+/// If `runInJIT` is set, the program is then run in-process, and its exit code written to `programExitCode`
+bool run(Options, int *programExitCode = nullptr);
 
 }
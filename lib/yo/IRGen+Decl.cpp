@@ -8,11 +8,12 @@
 
 #include "IRGen.h"
 #include "Mangling.h"
+#include "TypeContext.h"
 #include "lex/Diagnostics.h"
 #include "util_llvm.h"
 #include "util/VectorUtils.h"
 #include "util/MapUtils.h"
-#include "util/llvm_casting.h"
+#include "llvm/Support/Casting.h"
 
 
 using namespace yo;
@@ -51,7 +52,7 @@ void IRGenerator::registerNamedDecl(NamedDeclInfo &declInfo) {
 
 
 
-void IRGenerator::registerTypealias(std::shared_ptr<ast::TypealiasDecl> decl, NamedDeclInfo &declInfo) {
+void IRGenerator::registerTypealias(ast::TypealiasDecl *decl, NamedDeclInfo &declInfo) {
     // TODO add support for typealias templates!!
     
     auto type = resolveTypeDesc(decl->type);
@@ -63,7 +64,7 @@ void IRGenerator::registerTypealias(std::shared_ptr<ast::TypealiasDecl> decl, Na
 
 
 
-VariantType* IRGenerator::registerVariantDecl(std::shared_ptr<ast::VariantDecl> decl, NamedDeclInfo &declInfo) {
+VariantType* IRGenerator::registerVariantDecl(ast::VariantDecl *decl, NamedDeclInfo &declInfo) {
     declInfo.isRegistered = true;
     
     if (decl->isTemplateDecl() && !decl->isInstantiatedTemplateDecl()) {
@@ -124,10 +125,10 @@ VariantType* IRGenerator::registerVariantDecl(std::shared_ptr<ast::VariantDecl>
             std::make_pair("__index", indexType),
             std::make_pair("__data", largestMember->second)
         };
-        underlyingType = StructType::create("__variant_impl", "", members, decl->getSourceLocation());
+        underlyingType = StructType::create(typeContext, "__variant_impl", "", members, decl->getSourceLocation());
     }
     
-    auto variantType = new VariantType(name, elements, underlyingType, decl->getSourceLocation());
+    auto variantType = typeContext.create<VariantType>(name, elements, underlyingType, decl->getSourceLocation());
     nominalTypes.insert(decl->name->value, variantType);
     
     for (const auto &element : variantType->getElements()) {
@@ -145,24 +146,24 @@ void IRGenerator::synthesizeVariantConstructor(VariantType *variantTy, const Var
     auto &[name, data] = elem;
     
     ast::FunctionSignature sig;
-    sig.returnType = ast::TypeDesc::makeResolved(variantTy);
-    sig.paramTypes = { ast::TypeDesc::makeResolved(variantTy) };
+    sig.returnType = ast::TypeDesc::makeResolved(astContext, variantTy);
+    sig.paramTypes = { ast::TypeDesc::makeResolved(astContext, variantTy) };
     for (auto ty : data->getMembers()) {
-        sig.paramTypes.push_back(ast::TypeDesc::makeResolved(ty));
+        sig.paramTypes.push_back(ast::TypeDesc::makeResolved(astContext, ty));
     }
     attributes::FunctionAttributes attr;
 
-    auto funcDecl = std::make_shared<ast::FunctionDecl>(ast::FunctionKind::StaticMethod, name, sig, attr);
-    funcDecl->paramNames = { makeIdent("__unused") };
+    auto funcDecl = ast::make<ast::FunctionDecl>(astContext, ast::FunctionKind::StaticMethod, util::Symbol(name), sig, attr, ast::make<ast::CompoundStmt>(astContext));
+    funcDecl->paramNames = { makeIdent(astContext, "__unused") };
     for (size_t idx = 0; idx < data->memberCount(); idx++) {
-        funcDecl->paramNames.push_back(makeIdent(util::fmt::format("__arg{}", idx)));
+        funcDecl->paramNames.push_back(makeIdent(astContext, util::fmt::format("__arg{}", idx)));
     }
     
-    funcDecl->body = std::make_shared<ast::CompoundStmt>();
-    auto &B = funcDecl->body->statements;
+    funcDecl->setBody(ast::make<ast::CompoundStmt>(astContext));
+    auto &B = funcDecl->getBody()->statements;
     
-    auto callExpr = std::make_shared<ast::CallExpr>(makeIdent("__trap"));
-    B.push_back(std::make_shared<ast::ExprStmt>(callExpr));
+    auto callExpr = ast::make<ast::CallExpr>(astContext, makeIdent(astContext, "__trap"));
+    B.push_back(ast::make<ast::ExprStmt>(astContext, callExpr));
     addToAstAndRegister(funcDecl);
 }
 
@@ -171,7 +172,7 @@ void IRGenerator::synthesizeVariantConstructor(VariantType *variantTy, const Var
 
 
 
-llvm::Function* IRGenerator::registerFunction(std::shared_ptr<ast::FunctionDecl> functionDecl, NamedDeclInfo &declInfo) {
+llvm::Function* IRGenerator::registerFunction(ast::FunctionDecl *functionDecl, NamedDeclInfo &declInfo) {
     declInfo.isRegistered = true;
     EmptyScopeHandle ESH(*this);
     
@@ -192,15 +193,15 @@ llvm::Function* IRGenerator::registerFunction(std::shared_ptr<ast::FunctionDecl>
         
         // Check signature
         if (sig.paramTypes.empty() && resolveTypeDesc(sig.returnType) != builtinTypes.yo.i32) {
-            diagnostics::emitError(functionDecl->getSourceLocation(), "invalid signature: 'main' must return 'i32'");
+            diagnostics::emitError(sourceManager, functionDecl->getSourceLocation(), "invalid signature: 'main' must return 'i32'");
         } else if (!sig.paramTypes.empty()) {
             ast::FunctionSignature expectedSig;
-            expectedSig.returnType = ast::TypeDesc::makeResolved(builtinTypes.yo.i32);
+            expectedSig.returnType = ast::TypeDesc::makeResolved(astContext, builtinTypes.yo.i32);
             expectedSig.paramTypes = {
-                expectedSig.returnType, ast::TypeDesc::makeResolved(builtinTypes.yo.i8Ptr->getPointerTo())
+                expectedSig.returnType, ast::TypeDesc::makeResolved(astContext, builtinTypes.yo.i8Ptr->getPointerTo())
             };
             if (!equal(sig, expectedSig)) {
-                diagnostics::emitError(functionDecl->getSourceLocation(), util::fmt::format("invalid signature for function 'main'. Expected {}, got {}", expectedSig, sig));
+                diagnostics::emitError(sourceManager, functionDecl->getSourceLocation(), util::fmt::format("invalid signature for function 'main'. Expected {}, got {}", expectedSig, sig));
             }
         }
     }
@@ -219,13 +220,13 @@ llvm::Function* IRGenerator::registerFunction(std::shared_ptr<ast::FunctionDecl>
         // TODO detect ambiguous template declarations (ie, same name w/ same signature, etc)
         auto canonicalName = mangling::mangleCanonicalName(functionDecl);
         
-        if (attrs.int_isCtor && !functions[canonicalName].empty()) {
+        if (attrs.int_isCtor && functions.contains(canonicalName)) {
             // Prevent multiple ambiguous (and unnecessary) overloads for compiler-generated template instantiations
 //            LKFatalError("when/why do we reach here?");
             return nullptr;
         }
         
-        functions[canonicalName].push_back(ResolvedCallable(sig, functionDecl, nullptr, hasImplicitSelfArg));
+        functions.insert(canonicalName, std::nullopt, ResolvedCallable(sig, functionDecl, nullptr, hasImplicitSelfArg));
         return nullptr;
     }
     
@@ -242,7 +243,7 @@ llvm::Function* IRGenerator::registerFunction(std::shared_ptr<ast::FunctionDecl>
         auto type = resolveTypeDesc(sig.paramTypes[idx]);
         auto name = functionDecl->getParamNames()[idx]->value;
         paramTypes[idx] = type;
-        llvmParamTypes[idx] = type->getLLVMType();
+        llvmParamTypes[idx] = getLLVMType(type);
         localScope.insert(name, ValueBinding(type, nullptr, []() -> llvm::Value* {
             LKFatalError("invalid operation");
         }, [](llvm::Value *) {
@@ -260,11 +261,11 @@ llvm::Function* IRGenerator::registerFunction(std::shared_ptr<ast::FunctionDecl>
     
     
     auto canonicalName = mangling::mangleCanonicalName(functionDecl);
-    auto resolvedName = attrs.extern_ ? canonicalName : mangleFullyResolved(functionDecl);
+    auto resolvedName = attrs.extern_ ? canonicalName : util::Symbol(mangleFullyResolved(functionDecl));
     
     
-    if (util::map::has_key(resolvedFunctions, resolvedName)) {
-        auto &otherRC = resolvedFunctions.at(resolvedName);
+    if (auto otherRCPtr = functions.getWithResolvedName(resolvedName)) {
+        auto &otherRC = *otherRCPtr;
         const auto &otherAttrs = otherRC.funcDecl->getAttributes();
         
         // TODO is this assert really necessary/good?
@@ -273,9 +274,9 @@ llvm::Function* IRGenerator::registerFunction(std::shared_ptr<ast::FunctionDecl>
         if (attrs.extern_ || otherAttrs.extern_) {
             // if one of multiple decls is extern, all must be, and they must have the same signature
             if (attrs.extern_ != otherAttrs.extern_) { // TODO replace w/ `attrs != otherAttrs` to check for full equality
-                diagnostics::emitNote(otherRC.funcDecl->getSourceLocation(), "other declaration here");
+                diagnostics::emitNote(sourceManager, otherRC.funcDecl->getSourceLocation(), "other declaration here");
                 auto msg = util::fmt::format("multiple declarations of function '{}' with different attribute lists", resolvedName);
-                diagnostics::emitError(functionDecl->getSourceLocation(), msg);
+                diagnostics::emitError(sourceManager, functionDecl->getSourceLocation(), msg);
             }
             // TODO we should to remove the other decl from namedDeclInfos (otherwise there can be duplicates in name lookup)!
 //            auto &declInfos = namedDeclInfos[canonicalName];
@@ -292,7 +293,7 @@ llvm::Function* IRGenerator::registerFunction(std::shared_ptr<ast::FunctionDecl>
                     return llvm::cast<llvm::Function>(otherRC.llvmValue);
                 }
                 // Note: if we end up here, that indicates a bug in the compiler's function synthesis?
-                LKFatalError("multiple fwd decls for the same function '%s'", resolvedName.c_str());
+                LKFatalError("multiple fwd decls for the same function '%s'", resolvedName.str().c_str());
             }
             
             // one of the two functions is a fwd decl and the other isn't
@@ -306,33 +307,22 @@ llvm::Function* IRGenerator::registerFunction(std::shared_ptr<ast::FunctionDecl>
             } else {
                 // trying to register a function for which there exists a forward decl
                 // essentially, we just swap out the declarations
-                ResolvedCallable RC(functionDecl, otherRC.llvmValue, hasImplicitSelfArg);
-                resolvedFunctions.insert_or_assign(resolvedName, RC);
-                
-                std::vector<ResolvedCallable> &RCs = functions[canonicalName];
-                for (size_t idx = 0; idx < RCs.size(); idx++) {
-                    if (RCs[idx].funcDecl == otherRC.funcDecl) {
-                        RCs[idx] = RC;
-                    }
-                }
+                auto &RC = functions.replace(otherRC, ResolvedCallable(functionDecl, otherRC.llvmValue, hasImplicitSelfArg));
                 return llvm::cast<llvm::Function>(RC.llvmValue);
             }
             
         } else {
-            diagnostics::emitNote(otherRC.funcDecl->getSourceLocation(), "other declaration here");
-            diagnostics::emitError(functionDecl->getSourceLocation(), "multiple function declarations w/ same signature");
+            diagnostics::emitNote(sourceManager, otherRC.funcDecl->getSourceLocation(), "other declaration here");
+            diagnostics::emitError(sourceManager, functionDecl->getSourceLocation(), "multiple function declarations w/ same signature");
         }
     }
     
     
-    auto FT = FunctionType::get(returnType, paramTypes, sig.isVariadic);
-    auto F = llvm::Function::Create(llvm::cast<llvm::FunctionType>(getLLVMType(FT)), llvm::Function::LinkageTypes::ExternalLinkage, resolvedName, *module);
+    auto FT = FunctionType::get(typeContext, returnType, paramTypes, sig.isVariadic);
+    auto F = llvm::Function::Create(llvm::cast<llvm::FunctionType>(getLLVMType(FT)), llvm::Function::LinkageTypes::ExternalLinkage, resolvedName.str(), *module);
     F->setDSOLocal(!functionDecl->getAttributes().extern_);
     
-    ResolvedCallable RC(functionDecl, F, hasImplicitSelfArg);
-    LKAssert(!util::map::has_key(resolvedFunctions, resolvedName));
-    resolvedFunctions.emplace(resolvedName, RC);
-    functions[canonicalName].push_back(RC);
+    functions.insert(canonicalName, resolvedName, ResolvedCallable(functionDecl, F, hasImplicitSelfArg));
     
     declInfo.llvmValue = F;
     declInfo.type = FT;
@@ -342,7 +332,7 @@ llvm::Function* IRGenerator::registerFunction(std::shared_ptr<ast::FunctionDecl>
 
 
 
-llvm::Value* IRGenerator::codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl> functionDecl) {
+llvm::Value* IRGenerator::codegenFunctionDecl(ast::FunctionDecl *functionDecl) {
     const auto &sig = functionDecl->getSignature();
     const auto &attr = functionDecl->getAttributes();
     
@@ -399,11 +389,11 @@ llvm::Value* IRGenerator::codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl>
     builder.SetInsertPoint(entryBB);
     
     if (shouldEmitDebugInfo()) {
-        auto unit = DIFileForSourceLocation(debugInfo.builder, functionDecl->getSourceLocation());
-        auto SP = debugInfo.builder.createFunction(unit, functionDecl->getName(), resolvedName, unit,
-                                           sig.getSourceLocation().getLine(),
+        auto unit = DIFileForSourceLocation(debugInfo.builder, sourceManager, functionDecl->getSourceLocation());
+        auto SP = debugInfo.builder.createFunction(unit, functionDecl->getName().str(), resolvedName, unit,
+                                           sourceManager.getLine(sig.getSourceLocation()),
                                            toDISubroutineType(sig),
-                                           sig.getSourceLocation().getLine(),
+                                           sourceManager.getLine(sig.getSourceLocation()),
                                            llvm::DINode::FlagZero,
                                            llvm::DISubprogram::DISPFlags::SPFlagDefinition);
         emitDebugLocation(nullptr);
@@ -420,17 +410,16 @@ llvm::Value* IRGenerator::codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl>
     
     for (size_t i = paramsOffset; i < sig.numberOfParameters(); i++) {
         auto type = resolveTypeDesc(sig.paramTypes[i]);
-        auto alloca = builder.CreateAlloca(type->getLLVMType());
+        auto alloca = builder.CreateAlloca(getLLVMType(type));
         const auto &name = functionDecl->getParamNames()[i]->value;
-        alloca->setName(name);
+        alloca->setName(name.str());
         
         localScope.insert(name, ValueBinding{
             type, alloca, [=]() -> llvm::Value* {
-                LKFatalError("");
-                return builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, alloca);
+                return builder.CreateLoad(getLLVMType(type), alloca);
             }, [=](llvm::Value *V) {
                 // TODO turn this into an assignment-side error
-                LKFatalError("Function arguments are read-only (%s in %s)", name.c_str(), resolvedName.c_str());
+                LKFatalError("Function arguments are read-only (%s in %s)", name.str().c_str(), resolvedName.c_str());
             },
             ValueBinding::Flags::CanRead
         });
@@ -447,10 +436,10 @@ llvm::Value* IRGenerator::codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl>
         if (shouldEmitDebugInfo()) {
             auto SP = debugInfo.lexicalBlocks.back();
             auto varInfo = debugInfo.builder.createParameterVariable(SP, alloca->getName(), i - paramsOffset + 1, SP->getFile(),
-                                                                     paramNameDecl->getSourceLocation().getLine(),
-                                                                     resolveTypeDesc(paramTy)->getLLVMDIType());
+                                                                     sourceManager.getLine(paramNameDecl->getSourceLocation()),
+                                                                     getDIType(resolveTypeDesc(paramTy)));
             debugInfo.builder.insertDeclare(alloca, varInfo, debugInfo.builder.createExpression(),
-                                            llvm::DILocation::get(C, paramNameDecl->getSourceLocation().getLine(), paramNameDecl->getSourceLocation().getColumn(), SP), entryBB);
+                                            llvm::DILocation::get(C, sourceManager.getLine(paramNameDecl->getSourceLocation()), sourceManager.getColumn(paramNameDecl->getSourceLocation()), SP), entryBB);
         }
     }
     
@@ -462,7 +451,7 @@ llvm::Value* IRGenerator::codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl>
         retvalAlloca = builder.CreateAlloca(F->getFunctionType()->getReturnType());
         retvalAlloca->setName(kRetvalAllocaIdentifier);
         
-        localScope.insert(kRetvalAllocaIdentifier, ValueBinding(
+        localScope.insert(util::Symbol(kRetvalAllocaIdentifier), ValueBinding(
             returnType, retvalAlloca, []() -> llvm::Value* {
                 LKFatalError("retval is write-only");
             }, [this, retvalAlloca](llvm::Value *V) {
@@ -475,9 +464,9 @@ llvm::Value* IRGenerator::codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl>
         if (shouldEmitDebugInfo()) {
             auto SP = debugInfo.lexicalBlocks.back();
             auto D = debugInfo.builder.createAutoVariable(SP, kRetvalAllocaIdentifier, SP->getFile(),
-                                                          sig.getSourceLocation().getLine(), returnType->getLLVMDIType());
+                                                          sourceManager.getLine(sig.getSourceLocation()), getDIType(returnType));
             debugInfo.builder.insertDeclare(retvalAlloca, D, debugInfo.builder.createExpression(),
-                                            llvm::DILocation::get(C, sig.getSourceLocation().getLine(), 0, SP), entryBB);
+                                            llvm::DILocation::get(C, sourceManager.getLine(sig.getSourceLocation()), 0, SP), entryBB);
         }
     }
     
@@ -487,9 +476,9 @@ llvm::Value* IRGenerator::codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl>
     // TODO is this a good idea?
     if (functionDecl->getBody()->isEmpty() || !functionDecl->getBody()->statements.back()->isOfKind(NK::ReturnStmt)) {
         if (returnType->isVoidTy()) {
-            functionDecl->getBody()->statements.push_back(std::make_shared<ast::ReturnStmt>(nullptr));
+            functionDecl->getBody()->statements.push_back(ast::make<ast::ReturnStmt>(astContext, nullptr));
         } else {
-            diagnostics::emitError(functionDecl->getSourceLocation(), "missing return statement at end of function body");
+            diagnostics::emitError(sourceManager, functionDecl->getSourceLocation(), "missing return statement at end of function body");
         }
     }
     
@@ -502,7 +491,7 @@ llvm::Value* IRGenerator::codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl>
     
     // These were alreadu\y destructed (either by returning from the local scope, or by reaching the end of the function body)
     localScope.removeAllSinceMarker(currentFunction.stackTopMarker);
-    LKAssert(localScope.size() == currentFunction.stackTopMarker);
+    LKAssert(localScope.getMarker() == currentFunction.stackTopMarker);
     
     // Cleanup the rest of the local scope (parameters and kRetvalAllocaIdentifier, although the return value won't be destructed)
     destructLocalScopeUntilMarker(0, true);
@@ -511,8 +500,7 @@ llvm::Value* IRGenerator::codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl>
     if (returnType->isVoidTy()) {
         builder.CreateRetVoid();
     } else {
-        LKFatalError("");
-        builder.CreateRet(builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, retvalAlloca));
+        builder.CreateRet(builder.CreateLoad(F->getReturnType(), retvalAlloca));
     }
     
     
@@ -11,7 +11,7 @@
 #include "ASTRewriter.h"
 #include "lex/Diagnostics.h"
 #include "util_llvm.h"
-#include "util/llvm_casting.h"
+#include "llvm/Support/Casting.h"
 #include "util/MapUtils.h"
 
 #include <string>
@@ -25,19 +25,19 @@ using namespace yo::irgen;
 using NK = ast::Node::Kind;
 
 
-llvm::Value* IRGenerator::codegenRawLLVMValueExpr(std::shared_ptr<ast::RawLLVMValueExpr> rawExpr, ValueKind) {
+llvm::Value* IRGenerator::codegenRawLLVMValueExpr(ast::RawLLVMValueExpr *rawExpr, ValueKind) {
     return rawExpr->value;
 }
 
 
-llvm::Value* IRGenerator::codegenExprStmt(std::shared_ptr<ast::ExprStmt> exprStmt) {
+llvm::Value* IRGenerator::codegenExprStmt(ast::ExprStmt *exprStmt) {
     auto expr = exprStmt->expr;
     auto type = getType(expr);
     auto ident = currentFunction.getTmpIdent();
     llvm::AllocaInst *alloca = nullptr;
     
     if (!type->isVoidTy()) {
-        alloca = builder.CreateAlloca(type->getLLVMType());
+        alloca = builder.CreateAlloca(getLLVMType(type));
         alloca->setName(ident);
         includeInStackDestruction(type, alloca);
     }
@@ -51,7 +51,7 @@ llvm::Value* IRGenerator::codegenExprStmt(std::shared_ptr<ast::ExprStmt> exprStm
 }
 
 
-llvm::Value* IRGenerator::codegenNumberLiteral(std::shared_ptr<ast::NumberLiteral> numberLiteral, ValueKind VK) {
+llvm::Value* IRGenerator::codegenNumberLiteral(ast::NumberLiteral *numberLiteral, ValueKind VK) {
     using NT = ast::NumberLiteral::NumberType;
     
     LKAssert(VK == RValue);
@@ -79,7 +79,7 @@ llvm::Value* IRGenerator::codegenNumberLiteral(std::shared_ptr<ast::NumberLitera
 
 
 
-llvm::Value* IRGenerator::codegenStringLiteral(std::shared_ptr<ast::StringLiteral> stringLiteral, ValueKind VK) {
+llvm::Value* IRGenerator::codegenStringLiteral(ast::StringLiteral *stringLiteral, ValueKind VK) {
     using SLK = ast::StringLiteral::StringLiteralKind;
 
     switch (stringLiteral->kind) {
@@ -90,15 +90,15 @@ llvm::Value* IRGenerator::codegenStringLiteral(std::shared_ptr<ast::StringLitera
             return builder.CreateGlobalStringPtr(stringLiteral->value);
         
         case SLK::NormalString: {
-            if (!nominalTypes.contains("String")) {
-                diagnostics::emitError(stringLiteral->getSourceLocation(), "unable to find 'String' type");
+            if (!nominalTypes.contains(util::Symbol("String"))) {
+                diagnostics::emitError(sourceManager, stringLiteral->getSourceLocation(), "unable to find 'String' type");
             }
             auto &loc = stringLiteral->getSourceLocation();
-            auto target = makeIdent("String");
+            auto target = makeIdent(astContext, "String");
             target->setSourceLocation(loc);
-            auto callExpr = std::make_shared<ast::CallExpr>(target);
+            auto callExpr = ast::make<ast::CallExpr>(astContext, target);
             callExpr->arguments = {
-                std::make_shared<ast::RawLLVMValueExpr>(builder.CreateGlobalStringPtr(stringLiteral->value), builtinTypes.yo.i8Ptr)
+                ast::make<ast::RawLLVMValueExpr>(astContext, builder.CreateGlobalStringPtr(stringLiteral->value), builtinTypes.yo.i8Ptr)
             };
             callExpr->setSourceLocation(loc);
             callExpr->arguments[0]->setSourceLocation(loc);
@@ -109,12 +109,12 @@ llvm::Value* IRGenerator::codegenStringLiteral(std::shared_ptr<ast::StringLitera
 
 
 
-llvm::Value* IRGenerator::codegenIdent(std::shared_ptr<ast::Ident> ident, ValueKind returnValueKind) {
+llvm::Value* IRGenerator::codegenIdent(ast::Ident *ident, ValueKind returnValueKind) {
     emitDebugLocation(ident);
     
     auto binding = localScope.get(ident->value);
     if (!binding) {
-        diagnostics::emitError(ident->getSourceLocation(), util::fmt::format("use of undeclared identifier '{}'", ident->value));
+        diagnostics::emitError(sourceManager, ident->getSourceLocation(), util::fmt::format("use of undeclared identifier '{}'", ident->value));
     }
 
     switch (returnValueKind) {
@@ -124,14 +124,14 @@ llvm::Value* IRGenerator::codegenIdent(std::shared_ptr<ast::Ident> ident, ValueK
         case RValue:
             if (!binding->hasFlag(ValueBinding::Flags::CanRead)) {
                 auto msg = util::fmt::format("value binding for ident '{}' in local scope does not allow reading", ident->value);
-                diagnostics::emitError(ident->getSourceLocation(), msg);
+                diagnostics::emitError(sourceManager, ident->getSourceLocation(), msg);
             }
             return binding->read();
     }
 }
 
 
-llvm::Value* IRGenerator::codegenCastExpr(std::shared_ptr<ast::CastExpr> castExpr, ValueKind VK) {
+llvm::Value* IRGenerator::codegenCastExpr(ast::CastExpr *castExpr, ValueKind VK) {
     LKAssert(VK == RValue && "TODO: implement?");
     
     using LLVMCastOp = llvm::Instruction::CastOps;
@@ -166,8 +166,8 @@ llvm::Value* IRGenerator::codegenCastExpr(std::shared_ptr<ast::CastExpr> castExp
                 auto dstTyNT = static_cast<NumericalType *>(dstTy);
                 
                 if (srcTyNT->isIntegerTy() && dstTyNT->isIntegerTy()) {
-                    auto srcIntWidth = srcTyNT->getLLVMType()->getIntegerBitWidth();
-                    auto dstIntWidth = dstTyNT->getLLVMType()->getIntegerBitWidth();
+                    auto srcIntWidth = getLLVMType(srcTyNT)->getIntegerBitWidth();
+                    auto dstIntWidth = getLLVMType(dstTyNT)->getIntegerBitWidth();
                     
                     if (srcIntWidth > dstIntWidth) {
                         // casting to a smaller type
@@ -201,17 +201,17 @@ llvm::Value* IRGenerator::codegenCastExpr(std::shared_ptr<ast::CastExpr> castExp
             }
             
             auto msg = util::fmt::format("unable to resolve static_cast. No known conversion from '{}' to '{}'", srcTy, dstTy);
-            diagnostics::emitError(castExpr->getSourceLocation(), msg);
+            diagnostics::emitError(sourceManager, castExpr->getSourceLocation(), msg);
         }
     }
     
     if (op == invalidCastOp) {
         auto msg = util::fmt::format("unable to resolve cast from '{}' to '{}'", srcTy, dstTy);
-        diagnostics::emitError(castExpr->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, castExpr->getSourceLocation(), msg);
     }
     
     emitDebugLocation(castExpr);
-    return builder.CreateCast(op, codegenExpr(castExpr->expr), dstTy->getLLVMType());
+    return builder.CreateCast(op, codegenExpr(castExpr->expr), getLLVMType(dstTy));
 }
 
 
@@ -220,7 +220,7 @@ llvm::Value* IRGenerator::codegenCastExpr(std::shared_ptr<ast::CastExpr> castExp
 
 
 
-llvm::Value* IRGenerator::codegenMemberExpr(std::shared_ptr<ast::MemberExpr> memberExpr, ValueKind returnValueKind, SkipCodegenOption skipCodegenOption, Type **outType) {
+llvm::Value* IRGenerator::codegenMemberExpr(ast::MemberExpr *memberExpr, ValueKind returnValueKind, SkipCodegenOption skipCodegenOption, Type **outType) {
     auto skipCodegen = skipCodegenOption == kSkipCodegen;
     
     
@@ -243,7 +243,7 @@ llvm::Value* IRGenerator::codegenMemberExpr(std::shared_ptr<ast::MemberExpr> mem
                     auto variantTy = llvm::cast<VariantType>(type);
                     if (!variantTy->hasElement(memberExpr->memberName)) {
                         auto msg = util::fmt::format("variant type '{}' does not contain element '{}'", variantTy, memberExpr->memberName);
-                        diagnostics::emitError(memberExpr->getSourceLocation(), msg);
+                        diagnostics::emitError(sourceManager, memberExpr->getSourceLocation(), msg);
                     }
                     
                     if (variantTy->elementHasAssociatedData(memberExpr->memberName)) {
@@ -275,7 +275,7 @@ llvm::Value* IRGenerator::codegenMemberExpr(std::shared_ptr<ast::MemberExpr> mem
         } else {
             // targetIdent is not a type, but also not in the local scope
             auto msg = util::fmt::format("unable to resolve '{}'", targetIdent->value);
-            diagnostics::emitError(targetIdent->getSourceLocation(), msg);
+            diagnostics::emitError(sourceManager, targetIdent->getSourceLocation(), msg);
         }
     
     } else {
@@ -295,13 +295,13 @@ handle_as_expr:
 
     if (!structTy) {
         auto msg = util::fmt::format("invalid member expr base type: '{}'", targetTy);
-        diagnostics::emitError(memberExpr->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, memberExpr->getSourceLocation(), msg);
     }
 
     const auto [memberIndex, memberType] = structTy->getMember(memberExpr->memberName);
     if (!memberType) {
         auto msg = util::fmt::format("unable to find member '{}' in type '{}'", memberExpr->memberName, structTy);
-        diagnostics::emitError(memberExpr->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, memberExpr->getSourceLocation(), msg);
     }
     
     setOutType(memberType);
@@ -327,27 +327,25 @@ handle_as_expr:
         includeInStackDestruction(targetTy, targetV);
     }
     
-    LKFatalError("");
     emitDebugLocation(memberExpr);
     if (needsLoad) {
-        targetV = builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, targetV);
+        targetV = builder.CreateLoad(getLLVMType(targetTy), targetV);
     }
     
-    auto V = builder.CreateGEP(/*TODO*/this->builtinTypes.llvm.Void, targetV, offsets);
+    auto V = builder.CreateGEP(getLLVMType(structTy), targetV, offsets);
     
     switch (returnValueKind) {
         case LValue:
             return V;
         case RValue:
-            LKFatalError("");
-            return builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, V);
+            return builder.CreateLoad(getLLVMType(memberType), V);
     }
 }
 
 
 
 
-llvm::Value* IRGenerator::codegenSubscriptExpr(std::shared_ptr<ast::SubscriptExpr> expr, ValueKind VK, SkipCodegenOption codegenOption, Type **outType) {
+llvm::Value* IRGenerator::codegenSubscriptExpr(ast::SubscriptExpr *expr, ValueKind VK, SkipCodegenOption codegenOption, Type **outType) {
     bool skipCodegen = codegenOption == kSkipCodegen;
     auto setOutType = [&](Type *ty) {
         if (outType) *outType = ty;
@@ -362,11 +360,11 @@ llvm::Value* IRGenerator::codegenSubscriptExpr(std::shared_ptr<ast::SubscriptExp
     
     auto diag_invaild_argc = [&](const std::string &ctx) {
         auto msg = util::fmt::format("{} subscript must have exactly one argument", ctx);
-        diagnostics::emitError(expr->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, expr->getSourceLocation(), msg);
     };
     auto diag_arg_not_integral = [&](Type *ty, const std::string &ctx) {
         auto msg = util::fmt::format("invalid type '{}' for {} argument (must be integral type)", ty, ctx);
-        diagnostics::emitError(expr->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, expr->getSourceLocation(), msg);
     };
     
     if (auto ptrTy = llvm::dyn_cast<PointerType>(targetTy)) {
@@ -383,20 +381,17 @@ llvm::Value* IRGenerator::codegenSubscriptExpr(std::shared_ptr<ast::SubscriptExp
             return nullptr;
         }
         
-        LKFatalError("");
         auto target = codegenExpr(expr->target);
         auto offset = codegenExpr(expr->args[0]);
         if (needsLoad) {
-            target = builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, target);
+            target = builder.CreateLoad(getLLVMType(ptrTy), target);
         }
         
         emitDebugLocation(expr);
-        auto GEP = builder.CreateGEP(/*TODO*/this->builtinTypes.llvm.Void, target, offset);
+        auto GEP = builder.CreateGEP(getLLVMType(ptrTy->getPointee()), target, offset);
         
-        switch (VK) {
-            case LValue: return GEP;
-            case RValue: return builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, GEP);
-        }
+        // The subscript is a reference to the element, meaning that both value kinds evaluate to the element's address
+        return GEP;
     }
     
     
@@ -416,12 +411,12 @@ llvm::Value* IRGenerator::codegenSubscriptExpr(std::shared_ptr<ast::SubscriptExp
             }
         } else {
             auto msg = util::fmt::format("invalid element index for tuple type '{}'", tupleTy);
-            diagnostics::emitError(expr->getSourceLocation(), msg);
+            diagnostics::emitError(sourceManager, expr->getSourceLocation(), msg);
         }
         LKAssert(!skipCodegen);
         
         auto memberName = formatTupleMemberAtIndex(index);
-        auto memberExpr = std::make_shared<ast::MemberExpr>(expr->target, memberName);
+        auto memberExpr = ast::make<ast::MemberExpr>(astContext, expr->target, util::Symbol(memberName));
         memberExpr->setSourceLocation(expr->getSourceLocation());
         return codegenExpr(memberExpr, VK);
     }
@@ -431,10 +426,10 @@ llvm::Value* IRGenerator::codegenSubscriptExpr(std::shared_ptr<ast::SubscriptExp
         return getType(expr);
     });
     
-    auto callTarget = std::make_shared<ast::MemberExpr>(expr->target, mangling::encodeOperator(ast::Operator::Subscript));
+    auto callTarget = ast::make<ast::MemberExpr>(astContext, expr->target, mangling::encodeOperator(ast::Operator::Subscript));
     callTarget->setSourceLocation(expr->target->getSourceLocation());
     
-    auto callExpr = std::make_shared<ast::CallExpr>(callTarget);
+    auto callExpr = ast::make<ast::CallExpr>(astContext, callTarget);
     callExpr->setSourceLocation(expr->getSourceLocation());
     callExpr->arguments = expr->args;
     
@@ -448,11 +443,11 @@ llvm::Value* IRGenerator::codegenSubscriptExpr(std::shared_ptr<ast::SubscriptExp
     }
     
     auto msg = util::fmt::format("type '{}' is not subscriptable", targetTy); // TODO this should print the unadjusted target type!
-    diagnostics::emitError(expr->getSourceLocation(), msg);
+    diagnostics::emitError(sourceManager, expr->getSourceLocation(), msg);
 }
 
 bool isValidUnaryOpLogicalNegType(Type *ty) {
-    if (ty == Type::getBoolType() || ty->isPointerTy()) {
+    if (ty == Type::getBoolType(ty->getContext()) || ty->isPointerTy()) {
         return true;
     }
     if (auto numTy = llvm::dyn_cast<NumericalType>(ty)) {
@@ -462,7 +457,7 @@ bool isValidUnaryOpLogicalNegType(Type *ty) {
 }
 
 
-llvm::Value* IRGenerator::codegenUnaryExpr(std::shared_ptr<ast::UnaryExpr> unaryExpr, ValueKind VK) {
+llvm::Value* IRGenerator::codegenUnaryExpr(ast::UnaryExpr *unaryExpr, ValueKind VK) {
     LKAssert(VK == RValue && "TODO: implement");
     emitDebugLocation(unaryExpr);
     
@@ -479,7 +474,7 @@ llvm::Value* IRGenerator::codegenUnaryExpr(std::shared_ptr<ast::UnaryExpr> unary
             auto ty = getType(expr);
             if (!isValidUnaryOpLogicalNegType(ty)) {
                 auto msg = util::fmt::format("type '{}' cannpt be used in logical negation", ty);
-                diagnostics::emitError(unaryExpr->getSourceLocation(), msg);
+                diagnostics::emitError(sourceManager, unaryExpr->getSourceLocation(), msg);
             }
             auto V = codegenExpr(expr);
             emitDebugLocation(unaryExpr);
@@ -488,7 +483,7 @@ llvm::Value* IRGenerator::codegenUnaryExpr(std::shared_ptr<ast::UnaryExpr> unary
         
         case ast::UnaryExpr::Operation::AddressOf: {
             if (isTemporary(expr)) {
-                diagnostics::emitError(unaryExpr->getSourceLocation(), "can't take address of temporary");
+                diagnostics::emitError(sourceManager, unaryExpr->getSourceLocation(), "can't take address of temporary");
             }
             return codegenExpr(expr, LValue);
         }
@@ -497,14 +492,13 @@ llvm::Value* IRGenerator::codegenUnaryExpr(std::shared_ptr<ast::UnaryExpr> unary
 
 
 
-llvm::Value* IRGenerator::codegenBoolComp(std::shared_ptr<ast::Expr> expr) {
+llvm::Value* IRGenerator::codegenBoolComp(ast::Expr *expr) {
     auto type = getType(expr);
     
     if (type == builtinTypes.yo.Bool) {
         return codegenExpr(expr);
     } else if (type == builtinTypes.yo.Bool->getReferenceTo()) {
-        LKFatalError("");
-        return builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, codegenExpr(expr));
+        return builder.CreateLoad(getLLVMType(builtinTypes.yo.Bool), codegenExpr(expr));
     } else {
         LKFatalError("TODO?");
     }
@@ -515,14 +509,14 @@ llvm::Value* IRGenerator::codegenBoolComp(std::shared_ptr<ast::Expr> expr) {
 
 
 
-llvm::Value* IRGenerator::codegenMatchExpr(std::shared_ptr<ast::MatchExpr> matchExpr, ValueKind VK) {
+llvm::Value* IRGenerator::codegenMatchExpr(ast::MatchExpr *matchExpr, ValueKind VK) {
     return MatchMaker(*this, matchExpr, VK).run();
 }
 
 
 
 
-llvm::Value* IRGenerator::codegenArrayLiteralExpr(std::shared_ptr<ast::ArrayLiteralExpr> arrayLiteral, ValueKind VK) {
+llvm::Value* IRGenerator::codegenArrayLiteralExpr(ast::ArrayLiteralExpr *arrayLiteral, ValueKind VK) {
     if (arrayLiteral->elements.empty()) {
         LKFatalError(""); // this needs special handling to deduce the expected type!
     }
@@ -533,36 +527,36 @@ llvm::Value* IRGenerator::codegenArrayLiteralExpr(std::shared_ptr<ast::ArrayLite
 
 
 StructType* IRGenerator::synthesizeUnderlyingStructTypeForTupleType(TupleType *tupleTy) {
-    if (auto ST = tupleTy->getUnderlyingStructType()) {
-        return ST;
+    if (auto ST = util::map::get_opt(tupleStructTypes, tupleTy)) {
+        return *ST;
     }
     
-    auto SD = std::make_shared<ast::StructDecl>();
+    auto SD = ast::make<ast::StructDecl>(astContext);
     SD->attributes.no_debug_info = true;
     SD->attributes.int_isSynthesized = true;
-    SD->name = util::fmt::format("__tuple_{}", mangling::mangleFullyResolved(tupleTy));
+    SD->name = util::Symbol(util::fmt::format("__tuple_{}", mangling::mangleFullyResolved(tupleTy)));
     
     for (int64_t idx = 0; idx < tupleTy->memberCount(); idx++) {
-        auto name = makeIdent(formatTupleMemberAtIndex(idx));
-        auto type = ast::TypeDesc::makeResolved(tupleTy->getMembers()[idx]);
-        SD->members.push_back(std::make_shared<ast::VarDecl>(name, type));
+        auto name = makeIdent(astContext, formatTupleMemberAtIndex(idx));
+        auto type = ast::TypeDesc::makeResolved(astContext, tupleTy->getMembers()[idx]);
+        SD->members.push_back(ast::make<ast::VarDecl>(astContext, name, type));
     }
     
     auto ST = withCleanSlate(*this, [this, SD] { return addToAstAndRegister(SD); });
     ST->setFlag(Type::Flags::IsSynthesized);
-    tupleTy->setUnderlyingStructType(ST);
+    tupleStructTypes[tupleTy] = ST;
     return ST;
 }
 
 
 
-llvm::Value* IRGenerator::codegenTupleExpr(std::shared_ptr<ast::TupleExpr> tupleExpr, ValueKind VK) {
+llvm::Value* IRGenerator::codegenTupleExpr(ast::TupleExpr *tupleExpr, ValueKind VK) {
     LKAssert(VK == RValue);
     
     auto tupleTy = llvm::cast<TupleType>(getType(tupleExpr));
     auto underlyingST = synthesizeUnderlyingStructTypeForTupleType(tupleTy);
     
-    auto callExpr = std::make_shared<ast::CallExpr>(nullptr);
+    auto callExpr = ast::make<ast::CallExpr>(astContext, nullptr);
     callExpr->arguments = tupleExpr->elements;
     callExpr->setSourceLocation(tupleExpr->getSourceLocation());
     
@@ -604,18 +598,26 @@ bool isValidBinopOperator(ast::Operator op) {
 
 
 
-llvm::Value* IRGenerator::codegenBinOp(std::shared_ptr<ast::BinOp> binop, ValueKind VK) {
+llvm::Value* IRGenerator::codegenBinOp(ast::BinOp *binop, ValueKind VK) {
     LKAssert(VK == RValue && "TODO: implement");
     
     if (!isValidBinopOperator(binop->getOperator())) {
-        diagnostics::emitError(binop->getSourceLocation(), "not a valid binary operator");
+        diagnostics::emitError(sourceManager, binop->getSourceLocation(), "not a valid binary operator");
     }
     
-    auto callExpr = std::make_shared<ast::CallExpr>(makeIdent(mangling::mangleCanonicalName(binop->getOperator())),
-                                                    std::vector<std::shared_ptr<ast::Expr>> { binop->getLhs(), binop->getRhs() });
+    return codegenExpr(getCallExprForBinOp(binop));
+}
+
+
+ast::CallExpr* IRGenerator::getCallExprForBinOp(ast::BinOp *binop) {
+    if (auto it = binopCallExprs.find(binop); it != binopCallExprs.end()) {
+        return it->second;
+    }
+    auto callExpr = ast::make<ast::CallExpr>(astContext, makeIdent(astContext, mangling::mangleCanonicalName(binop->getOperator())),
+                                             std::vector<ast::Expr *> { binop->getLhs(), binop->getRhs() });
     callExpr->setSourceLocation(binop->getSourceLocation());
-    return codegenExpr(callExpr);
-    
+    binopCallExprs[binop] = callExpr;
+    return callExpr;
 }
 
 
@@ -625,7 +627,7 @@ llvm::Value* IRGenerator::codegenBinOp(std::shared_ptr<ast::BinOp> binop, ValueK
 #pragma mark - lambdas
 
 
-llvm::Value* IRGenerator::codegenLambdaExpr(std::shared_ptr<ast::LambdaExpr> lambdaExpr, ValueKind VK) {
+llvm::Value* IRGenerator::codegenLambdaExpr(ast::LambdaExpr *lambdaExpr, ValueKind VK) {
     if (VK != RValue) {
         LKFatalError("TODO?");
     }
@@ -633,7 +635,7 @@ llvm::Value* IRGenerator::codegenLambdaExpr(std::shared_ptr<ast::LambdaExpr> lam
     auto lambdaST = synthesizeLambdaExpr(lambdaExpr);
     
     
-    auto callExpr = std::make_shared<ast::CallExpr>(nullptr);
+    auto callExpr = ast::make<ast::CallExpr>(astContext, nullptr);
     callExpr->setSourceLocation(lambdaExpr->getSourceLocation());
     
     for (const auto &captureElem : lambdaExpr->captureList) {
@@ -646,17 +648,17 @@ llvm::Value* IRGenerator::codegenLambdaExpr(std::shared_ptr<ast::LambdaExpr> lam
 }
 
 
-StructType* IRGenerator::synthesizeLambdaExpr(std::shared_ptr<ast::LambdaExpr> lambdaExpr) {
+StructType* IRGenerator::synthesizeLambdaExpr(ast::LambdaExpr *lambdaExpr) {
     if (auto ST = lambdaExpr->_structType) {
         return ST;
     }
     
     auto &SL = lambdaExpr->getSourceLocation();
     
-    auto SD = std::make_shared<ast::StructDecl>();
+    auto SD = ast::make<ast::StructDecl>(astContext);
     SD->setSourceLocation(SL);
     SD->attributes.int_isSynthesized = true;
-    SD->name = util::fmt::format("__{}_lambda_{}", currentFunction.decl->getName(), currentFunction.getCounter());;
+    SD->name = util::Symbol(util::fmt::format("__{}_lambda_{}", currentFunction.decl->getName(), currentFunction.getCounter()));
     
     for (const auto &captureElem : lambdaExpr->captureList) {
         auto capturedTy = getType(captureElem.expr);
@@ -664,7 +666,7 @@ StructType* IRGenerator::synthesizeLambdaExpr(std::shared_ptr<ast::LambdaExpr> l
             capturedTy = capturedTy->getReferenceTo();
         }
         
-        auto decl = std::make_shared<ast::VarDecl>(captureElem.ident, ast::TypeDesc::makeResolved(capturedTy));
+        auto decl = ast::make<ast::VarDecl>(astContext, captureElem.ident, ast::TypeDesc::makeResolved(astContext, capturedTy));
         decl->setSourceLocation(SL);
         SD->members.push_back(decl);
     }
@@ -674,22 +676,21 @@ StructType* IRGenerator::synthesizeLambdaExpr(std::shared_ptr<ast::LambdaExpr> l
     lambdaExpr->_structType = ST;
     
 //    auto &sig = lambdaExpr->signature;
-//    sig.paramTypes.insert(sig.paramTypes.begin(), ast::TypeDesc::makeResolved(ST));
+//    sig.paramTypes.insert(sig.paramTypes.begin(), ast::TypeDesc::makeResolved(astContext, ST));
 //    resolveTypeDesc(sig.returnType); // TODO is this necessary? (probably yes, bc we want the lambda to pick up the types declated in its scope?)
 //    for (auto &TD : sig.paramTypes) {
 //        resolveTypeDesc(TD);
 //    }
     
-//    sig.paramTypes.insert(sig.paramTypes.begin(), ast::TypeDesc::makeReference(ast::TypeDesc::makeNominal(SD->getName())));
+//    sig.paramTypes.insert(sig.paramTypes.begin(), ast::TypeDesc::makeReference(astContext, ast::TypeDesc::makeNominal(astContext, SD->getName())));
     
-    auto imp = std::make_shared<ast::FunctionDecl>(ast::FunctionKind::InstanceMethod,
+    auto imp = ast::make<ast::FunctionDecl>(astContext, ast::FunctionKind::InstanceMethod,
                                                    mangling::encodeOperator(ast::Operator::FnCall),
-                                                   lambdaExpr->signature, attributes::FunctionAttributes());
-    imp->setBody(lambdaExpr->body);
-    //util::vector::insert_at_front(imp->getSignature().paramTypes, ast::TypeDesc::makeResolved(ST->getReferenceTo()));
-    util::vector::insert_at_front(imp->getSignature().paramTypes, ast::TypeDesc::makeReference(ast::TypeDesc::makeResolved(ST)));
+                                                   lambdaExpr->signature, attributes::FunctionAttributes(), lambdaExpr->body);
+    //util::vector::insert_at_front(imp->getSignature().paramTypes, ast::TypeDesc::makeResolved(astContext, ST->getReferenceTo()));
+    util::vector::insert_at_front(imp->getSignature().paramTypes, ast::TypeDesc::makeReference(astContext, ast::TypeDesc::makeResolved(astContext, ST)));
     imp->setParamNames(lambdaExpr->paramNames);
-    util::vector::insert_at_front(imp->paramNames, makeIdent("self", SL));
+    util::vector::insert_at_front(imp->paramNames, makeIdent(astContext, "self", SL));
     imp->setSourceLocation(SL);
     
     addToAstAndRegister(imp);
@@ -709,7 +710,7 @@ StructType* IRGenerator::synthesizeLambdaExpr(std::shared_ptr<ast::LambdaExpr> l
 // This only looks at the explicitly passed template arguments, not
 // This function returns fully resolved TypeDesc objects
 TemplateTypeMapping
-IRGenerator::resolveTemplateDeclTemplateParamsFromExplicitArgs(std::shared_ptr<ast::TemplateDecl> decl, std::shared_ptr<ast::TemplateParamArgList> templateArgsList, bool setInternalTypes) {
+IRGenerator::resolveTemplateDeclTemplateParamsFromExplicitArgs(ast::TemplateDecl *decl, ast::TemplateParamArgList *templateArgsList, bool setInternalTypes) {
     TemplateTypeMapping mapping;
     
     const auto &explicitArgs = templateArgsList->elements;
@@ -718,7 +719,7 @@ IRGenerator::resolveTemplateDeclTemplateParamsFromExplicitArgs(std::shared_ptr<a
     auto numArgs = explicitArgs.size();
     
     if (numParams > numArgs) {
-        diagnostics::emitError(templateArgsList->getSourceLocation(), "too many template arguments");
+        diagnostics::emitError(sourceManager, templateArgsList->getSourceLocation(), "too many template arguments");
     }
     
     // TODO:
@@ -727,14 +728,14 @@ IRGenerator::resolveTemplateDeclTemplateParamsFromExplicitArgs(std::shared_ptr<a
     for (size_t i = 0; i < numParams; i++) {
         auto &param = params[i];
         if (i < numArgs) {
-            mapping[param.name->value] = ast::TypeDesc::makeResolved(resolveTypeDesc(explicitArgs[i], setInternalTypes));
+            mapping[param.name->value] = ast::TypeDesc::makeResolved(astContext, resolveTypeDesc(explicitArgs[i], setInternalTypes));
         } else if (auto defaultType = param.defaultType) {
             // TODO what if a default parameter depends on one of the previous params? (like what std::vector does?)
             // TODO issue? this resolves the type desc in the wrong context (caller vs callee!)
-            mapping[param.name->value] = ast::TypeDesc::makeResolved(resolveTypeDesc(defaultType, setInternalTypes));
+            mapping[param.name->value] = ast::TypeDesc::makeResolved(astContext, resolveTypeDesc(defaultType, setInternalTypes));
         } else {
             auto msg = util::fmt::format("unable to resolve template parameter '{}'", param.name->value);
-            diagnostics::emitError(templateArgsList->getSourceLocation(), msg);
+            diagnostics::emitError(sourceManager, templateArgsList->getSourceLocation(), msg);
         }
     }
     
@@ -745,7 +746,7 @@ IRGenerator::resolveTemplateDeclTemplateParamsFromExplicitArgs(std::shared_ptr<a
 
 // TODO this should somehow return an error message explaining why the template deduction failed (eg "too many template arguments", etc)
 std::optional<TemplateTypeMapping>
-IRGenerator::attemptToResolveTemplateArgumentTypesForCall(const ast::FunctionSignature &signature, std::shared_ptr<ast::CallExpr> call, const std::vector<std::pair<Type *, std::shared_ptr<ast::Expr>>> &args) {
+IRGenerator::attemptToResolveTemplateArgumentTypesForCall(const ast::FunctionSignature &signature, ast::CallExpr *call, const std::vector<std::pair<Type *, ast::Expr *>> &args) {
     using TDK = ast::TypeDesc::Kind;
     
     LKAssert(signature.isTemplateDecl());
@@ -788,7 +789,7 @@ IRGenerator::attemptToResolveTemplateArgumentTypesForCall(const ast::FunctionSig
     };
     
     
-    std::map<std::string, DeductionInfo> mapping;
+    std::map<util::Symbol, DeductionInfo> mapping;
     
     
     // Handle explicitly specified types
@@ -802,7 +803,7 @@ IRGenerator::attemptToResolveTemplateArgumentTypesForCall(const ast::FunctionSig
     
     
     // retval: true -> success, false -> failure
-    auto imp = [&](std::string name, Type *ty, uint64_t argIdx) -> bool {
+    auto imp = [&](util::Symbol name, Type *ty, uint64_t argIdx) -> bool {
         auto &arg = args[argIdx].second;
         auto reason = arg->isOfKind(NK::NumberLiteral) ? DR::Literal : DR::Expr;
         
@@ -841,9 +842,9 @@ IRGenerator::attemptToResolveTemplateArgumentTypesForCall(const ast::FunctionSig
     };
     
     
-    std::function<bool(std::shared_ptr<ast::TypeDesc>, Type *, uint64_t)> handle;
+    std::function<bool(ast::TypeDesc *, Type *, uint64_t)> handle;
     
-    handle = [&](std::shared_ptr<ast::TypeDesc> typeDesc, Type *ty, uint64_t argIdx) -> bool {
+    handle = [&](ast::TypeDesc *typeDesc, Type *ty, uint64_t argIdx) -> bool {
         switch (typeDesc->getKind()) {
             case TDK::Nominal: {
                 if (!util::vector::contains(templateParamNames, typeDesc->getName())) {
@@ -958,7 +959,7 @@ IRGenerator::attemptToResolveTemplateArgumentTypesForCall(const ast::FunctionSig
     
     TemplateTypeMapping retval;
     for (auto &[name, deduction] : mapping) {
-        retval[name] = ast::TypeDesc::makeResolved(deduction.type);
+        retval[name] = ast::TypeDesc::makeResolved(astContext, deduction.type);
     }
     return retval;
 }
@@ -967,11 +968,11 @@ IRGenerator::attemptToResolveTemplateArgumentTypesForCall(const ast::FunctionSig
 
 
 
-ast::FunctionSignature makeFunctionSignatureFromFunctionTypeInfo(const FunctionType *fnType) {
+ast::FunctionSignature makeFunctionSignatureFromFunctionTypeInfo(ast::ASTContext &astContext, const FunctionType *fnType) {
     ast::FunctionSignature sig;
-    sig.returnType = ast::TypeDesc::makeResolved(fnType->getReturnType());
-    sig.paramTypes = util::vector::map(fnType->getParameterTypes(), [](Type *ty) {
-        return ast::TypeDesc::makeResolved(ty);
+    sig.returnType = ast::TypeDesc::makeResolved(astContext, fnType->getReturnType());
+    sig.paramTypes = util::vector::map(fnType->getParameterTypes(), [&astContext](Type *ty) {
+        return ast::TypeDesc::makeResolved(astContext, ty);
     });
     return sig;
 }
@@ -982,16 +983,28 @@ ast::FunctionSignature makeFunctionSignatureFromFunctionTypeInfo(const FunctionT
 //// NOTE: This function returning true *does not* mean that the callable is the perfect (or even right, in some instances) target
 //// for the function call. All this function does is run some checks to see if the provided arguments are compatible with the callable's
 //// signature, and return true if that is the case
-//bool callableIsSuitableForFunctionCall(const ResolvedCallable &callable, std::shared_ptr<ast::CallExpr> call) {
+//bool callableIsSuitableForFunctionCall(const ResolvedCallable &callable, ast::CallExpr *call) {
 //    LKFatalError("implement");
 //}
 
 
 
 
-ResolvedCallable IRGenerator::specializeTemplateFunctionDeclForCallExpr(std::shared_ptr<ast::FunctionDecl> funcDecl, TemplateTypeMapping templateArgMapping, bool hasImplicitSelfArg, SkipCodegenOption codegenOption) {
+ResolvedCallable IRGenerator::specializeTemplateFunctionDeclForCallExpr(ast::FunctionDecl *funcDecl, TemplateTypeMapping templateArgMapping, bool hasImplicitSelfArg, SkipCodegenOption codegenOption) {
+    // Reuse a previous instantiation w/ the same template arguments, instead of rewriting the decl again
+    TemplateInstantiationKey instantiationKey(funcDecl, templateArgMapping, hasImplicitSelfArg);
+    bool isCacheable = !instantiationKey.hasTemporaryArgs();
+    
+    if (isCacheable) {
+        auto it = functionTemplateInstantiations.find(instantiationKey);
+        // An instantiation created w/ kSkipCodegen isn't registered, so it can only be reused when skipping codegen
+        if (it != functionTemplateInstantiations.end() && (it->second.llvmValue || codegenOption == kSkipCodegen || it->second.funcDecl->getAttributes().intrinsic)) {
+            return it->second;
+        }
+    }
+    
     //auto specializedDecl = ASTRewriter::specializeWithMapping(funcDecl, templateArgMapping);
-    auto specializedDecl = ASTRewriter(templateArgMapping).handleFunctionDecl(funcDecl);
+    auto specializedDecl = ASTRewriter(astContext, templateArgMapping).handleFunctionDecl(funcDecl);
     
 //    std::vector<Type *> templateArgTypes;
 //    for (const auto &param : funcDecl->getSignature().templateParamsDecl->getParams()) {
@@ -1027,6 +1040,9 @@ ResolvedCallable IRGenerator::specializeTemplateFunctionDeclForCallExpr(std::sha
     auto mangled = mangleFullyResolved(specializedDecl);
     if (auto decl = getResolvedFunctionWithName(mangled)) {
         if (this->equal(specializedDecl->getSignature(), decl->funcDecl->getSignature())) {
+            if (isCacheable) {
+                functionTemplateInstantiations.insert_or_assign(instantiationKey, *decl);
+            }
             return *decl;
         }
     }
@@ -1036,7 +1052,11 @@ ResolvedCallable IRGenerator::specializeTemplateFunctionDeclForCallExpr(std::sha
         specializedDecl->getAttributes().int_isDelayed = false; // TODO what does this do?
         llvmFunction = addToAstAndRegister(specializedDecl);
     }
-    return ResolvedCallable(specializedDecl, llvmFunction, hasImplicitSelfArg);
+    ResolvedCallable RC(specializedDecl, llvmFunction, hasImplicitSelfArg);
+    if (isCacheable) {
+        functionTemplateInstantiations.insert_or_assign(instantiationKey, RC);
+    }
+    return RC;
 }
 
 
@@ -1122,7 +1142,7 @@ bool collectTempTypes(Type *type, std::set<Type *> &found) {
 
 
 /// This function assumes that both targets match the call (ie, are valid targets)
-CandidateViabilityComparisonResult FunctionCallTargetCandidate::compare(IRGenerator &irgen, const FunctionCallTargetCandidate &other, const std::vector<std::pair<Type *, std::shared_ptr<ast::Expr>>> &args) const {
+CandidateViabilityComparisonResult FunctionCallTargetCandidate::compare(IRGenerator &irgen, const FunctionCallTargetCandidate &other, const std::vector<std::pair<Type *, ast::Expr *>> &args) const {
     const auto &lhs = *this;
     const auto &rhs = other;
     
@@ -1157,9 +1177,9 @@ CandidateViabilityComparisonResult FunctionCallTargetCandidate::compare(IRGenera
         } else if (args[idx].second->isOfKind(NK::NumberLiteral)) {
             util::fmt::print("lhs: {}", lhs.getSignature());
             util::fmt::print("rhs: {}", rhs.getSignature());
-            diagnostics::emitNote(lhs.target.funcDecl->getSourceLocation(), "");
-            diagnostics::emitNote(rhs.target.funcDecl->getSourceLocation(), "");
-            diagnostics::emitNote(args[idx].second->getSourceLocation(), "");
+            diagnostics::emitNote(irgen.sourceManager, lhs.target.funcDecl->getSourceLocation(), "");
+            diagnostics::emitNote(irgen.sourceManager, rhs.target.funcDecl->getSourceLocation(), "");
+            diagnostics::emitNote(irgen.sourceManager, args[idx].second->getSourceLocation(), "");
             LKFatalError("TODO");
         } else {
             continue;
@@ -1198,14 +1218,14 @@ CandidateViabilityComparisonResult FunctionCallTargetCandidate::compare(IRGenera
             
             for (auto &param : lhs.getSignature().templateParamsDecl->getParams()) {
                 auto tmpName = util::fmt::format("U{}", ++counter);
-                mapping[param.name->value] = ast::TypeDesc::makeNominal(tmpName);
+                mapping[param.name->value] = ast::TypeDesc::makeNominal(irgen.astContext, util::Symbol(tmpName));
             }
             
-            auto specSig = ASTRewriter(mapping).handleFunctionSignature(lhs.getSignature());
+            auto specSig = ASTRewriter(irgen.astContext, mapping).handleFunctionSignature(lhs.getSignature());
             
             for (const auto &[_ignored_name, typeDesc] : mapping) {
                 auto name = typeDesc->getName();
-                auto type = Type::createTemporary(mangling::mangleAsStruct(name), name);
+                auto type = Type::createTemporary(irgen.typeContext, mangling::mangleAsStruct(name), name);
                 typeDesc->setResolvedType(type);
                 tmpTypes.emplace_back(type, irgen.nominalTypes.insert(name, type));
             }
@@ -1214,9 +1234,9 @@ CandidateViabilityComparisonResult FunctionCallTargetCandidate::compare(IRGenera
                 return irgen.resolveTypeDesc(TD, false);
             });
             
-            auto tmpCallExpr = std::make_shared<ast::CallExpr>(nullptr);
-            auto args = util::vector::map(argTys, [](Type *type) -> std::pair<Type *, std::shared_ptr<ast::Expr>> {
-                return std::make_pair(type, std::make_shared<ast::RawLLVMValueExpr>(nullptr, type));
+            auto tmpCallExpr = ast::make<ast::CallExpr>(irgen.astContext, nullptr);
+            auto args = util::vector::map(argTys, [&irgen](Type *type) -> std::pair<Type *, ast::Expr *> {
+                return std::make_pair(type, ast::make<ast::RawLLVMValueExpr>(irgen.astContext, nullptr, type));
             });
             
             auto deduction = irgen.attemptToResolveTemplateArgumentTypesForCall(rhs.getSignature(), tmpCallExpr, args);
@@ -1257,7 +1277,7 @@ CandidateViabilityComparisonResult FunctionCallTargetCandidate::compare(IRGenera
 
 
 
-ResolvedCallable IRGenerator::resolveCall(std::shared_ptr<ast::CallExpr> callExpr, SkipCodegenOption codegenOption) {
+ResolvedCallable IRGenerator::resolveCall(ast::CallExpr *callExpr, SkipCodegenOption codegenOption) {
     std::vector<FunctionCallTargetCandidate> candidates;
     std::vector<CallTargetRejectionReason> rejections;
     ResolveCallResultStatus result;
@@ -1272,10 +1292,10 @@ ResolvedCallable IRGenerator::resolveCall(std::shared_ptr<ast::CallExpr> callExp
             std::cout << "\n\n\n\n" << callExpr->description() << std::endl;
             for (const auto &rejection : rejections) {
                 auto msg = util::fmt::format("[{}: {}] not viable: {}", rejection.decl->name, rejection.decl->signature, rejection.reason);
-//                diagnostics::emitNote(rejection.decl->getSourceLocation(), util::fmt::format("[{}] not viable: {}", rejection.decl->signature, rejection.reason));
-                diagnostics::emitNote(rejection.decl->getSourceLocation(), msg);
+//                diagnostics::emitNote(sourceManager, rejection.decl->getSourceLocation(), util::fmt::format("[{}] not viable: {}", rejection.decl->signature, rejection.reason));
+                diagnostics::emitNote(sourceManager, rejection.decl->getSourceLocation(), msg);
             }
-            diagnostics::emitError(callExpr->getSourceLocation(), util::fmt::format("unable to resolve call"));
+            diagnostics::emitError(sourceManager, callExpr->getSourceLocation(), util::fmt::format("unable to resolve call"));
         }
         
         case ResolveCallResultStatus::AmbiguousCandidates: {
@@ -1290,9 +1310,9 @@ ResolvedCallable IRGenerator::resolveCall(std::shared_ptr<ast::CallExpr> callExp
                     });
                     OS << "]";
                 }
-                diagnostics::emitNote(candidate.getSignature().getSourceLocation(), OS.str());
+                diagnostics::emitNote(sourceManager, candidate.getSignature().getSourceLocation(), OS.str());
             }
-            diagnostics::emitError(callExpr->getSourceLocation(), "ambiguous call");
+            diagnostics::emitError(sourceManager, callExpr->getSourceLocation(), "ambiguous call");
         }
     }
 }
@@ -1300,7 +1320,7 @@ ResolvedCallable IRGenerator::resolveCall(std::shared_ptr<ast::CallExpr> callExp
 
 
 std::optional<ResolvedCallable>
-IRGenerator::resolveCall_opt(std::shared_ptr<ast::CallExpr> callExpr, SkipCodegenOption codegenOption) {
+IRGenerator::resolveCall_opt(ast::CallExpr *callExpr, SkipCodegenOption codegenOption) {
     std::vector<FunctionCallTargetCandidate> candidates;
     std::vector<CallTargetRejectionReason> rejections;
     ResolveCallResultStatus status;
@@ -1311,10 +1331,24 @@ IRGenerator::resolveCall_opt(std::shared_ptr<ast::CallExpr> callExpr, SkipCodege
 // This function will only return if the call can be resolved
 // TODO add a string& parameter "descriptive target name", which then can be used in error messages like "cant resolve call to {}" (eg "operator +", etc)
 std::optional<ResolvedCallable>
-IRGenerator::resolveCall_imp(std::shared_ptr<ast::CallExpr> callExpr, SkipCodegenOption codegenOption, std::vector<FunctionCallTargetCandidate> &candidates, std::vector<CallTargetRejectionReason> &rejections, ResolveCallResultStatus &resultStatus) {
+IRGenerator::resolveCall_imp(ast::CallExpr *callExpr, SkipCodegenOption codegenOption, std::vector<FunctionCallTargetCandidate> &candidates, std::vector<CallTargetRejectionReason> &rejections, ResolveCallResultStatus &resultStatus) {
     // TODO this function is rather long, refactor!!!
     
-    const bool skipCodegen = codegenOption == kSkipCodegen;
+    const auto localScopeState = localScope.getStateToken();
+    const auto nominalTypesState = nominalTypes.getStateToken();
+    // Captured before resolving the call, since resolving it might register new functions (ie, template instantiations)
+    const auto functionsGeneration = functions.getGeneration();
+    const auto namedDeclsGeneration = namedDeclInfos.getGeneration();
+    
+    if (auto it = resolvedCallTargets.find(callExpr); it != resolvedCallTargets.end()) {
+        auto &cached = it->second;
+        if (cached.localScopeState == localScopeState && cached.nominalTypesState == nominalTypesState
+            && cached.functionsGeneration == functionsGeneration && cached.namedDeclsGeneration == namedDeclsGeneration) {
+            resultStatus = ResolveCallResultStatus::Success;
+            return finalizeCallTarget(cached.bestMatch, codegenOption);
+        }
+    }
+    
     std::string targetName;
     
     
@@ -1325,10 +1359,10 @@ IRGenerator::resolveCall_imp(std::shared_ptr<ast::CallExpr> callExpr, SkipCodege
     
     
     std::vector<ResolvedCallable> potentialTargets;
-    std::vector<std::pair<Type *, std::shared_ptr<ast::Expr>>> allArgs;
+    std::vector<std::pair<Type *, ast::Expr *>> allArgs;
     bool didAddImplicitSelfArgToArgsList = false;
     
-    auto addImplicitFstArg = [&](std::shared_ptr<ast::Expr> expr) {
+    auto addImplicitFstArg = [&](ast::Expr *expr) {
         if (didAddImplicitSelfArgToArgsList) {
             return;
         }
@@ -1338,35 +1372,22 @@ IRGenerator::resolveCall_imp(std::shared_ptr<ast::CallExpr> callExpr, SkipCodege
     };
     
     
-    auto getRC = [&](const std::shared_ptr<ast::FunctionDecl> &decl) -> ResolvedCallable& {
-        // TODO this is pretty bad!!!!!
-        // do we really need the functions and resolvedFunctions maps?
-        auto imp = [&]() -> std::optional<std::reference_wrapper<ResolvedCallable>> {
-            for (auto &[name, RCs] : functions) {
-                for (auto &RC : RCs) {
-                    if (RC.funcDecl.get() == decl.get()) {
-                        return RC;
-                    }
-                }
-            }
-            return std::nullopt;
-        };
-        
-        if (auto RC = imp()) {
-            return RC->get();
+    auto getRC = [&](ast::FunctionDecl *decl) -> ResolvedCallable& {
+        if (auto RC = functions.get(decl)) {
+            return *RC;
         } else {
-            registerNamedDecls(mangling::mangleCanonicalName(decl), [](const std::shared_ptr<ast::TopLevelStmt> &decl) -> bool {
+            registerNamedDecls(mangling::mangleCanonicalName(decl), [](ast::TopLevelStmt *decl) -> bool {
                 return decl->isOfKind(NK::FunctionDecl);
             });
-            if (auto RC = imp()) {
-                return RC->get();
+            if (auto RC = functions.get(decl)) {
+                return *RC;
             }
         }
         LKFatalError("");
     };
     
     // assuming that `expr` is a call target w/ an implicit self argument, returns that self argument
-    auto getImplicitSelfArg = [](std::shared_ptr<ast::Expr> expr) -> std::shared_ptr<ast::Expr> {
+    auto getImplicitSelfArg = [](ast::Expr *expr) -> ast::Expr *{
         if (expr->isOfKind(NK::Ident)) {
             return expr;
         } else if (auto memberExpr = llvm::dyn_cast<ast::MemberExpr>(expr)) {
@@ -1378,12 +1399,12 @@ IRGenerator::resolveCall_imp(std::shared_ptr<ast::CallExpr> callExpr, SkipCodege
         }
     };
     
-    auto addInstanceOrStaticFunction = [&](Type *selfType, const std::shared_ptr<ast::FunctionDecl> &decl) {
-        std::shared_ptr<ast::Expr> implicitArg;
+    auto addInstanceOrStaticFunction = [&](Type *selfType, ast::FunctionDecl *decl) {
+        ast::Expr *implicitArg = nullptr;
         if (decl->isOfFunctionKind(ast::FunctionKind::InstanceMethod)) {
             implicitArg = getImplicitSelfArg(callExpr->target); // TODO this wont work for overloaded operators ?!
         } else {
-            implicitArg = std::make_shared<ast::RawLLVMValueExpr>(nullptr, selfType);
+            implicitArg = ast::make<ast::RawLLVMValueExpr>(astContext, nullptr, selfType);
             implicitArg->setSourceLocation(callExpr->getSourceLocation());
         }
         addImplicitFstArg(implicitArg);
@@ -1418,11 +1439,13 @@ IRGenerator::resolveCall_imp(std::shared_ptr<ast::CallExpr> callExpr, SkipCodege
                 if (auto fnTy = llvm::dyn_cast<FunctionType>(type)) {
                     LKFatalError("TODO");
                 }
-                auto memberTable = NameLookup(*this).computeMemberTableForType(type);
-                for (const ValueInfo &VI : memberTable.members[mangling::encodeOperator(ast::Operator::FnCall)]) {
-                    if (VI.kind == ValueInfo::Kind::Function) {
-                        auto &[selfTy, funcDecl] = VI.getFunctionInfo();
-                        addInstanceOrStaticFunction(selfTy, funcDecl);
+                auto &memberTable = NameLookup(*this).computeMemberTableForType(type);
+                if (auto members = util::map::get_opt(memberTable.members, mangling::encodeOperator(ast::Operator::FnCall))) {
+                    for (const ValueInfo &VI : *members) {
+                        if (VI.kind == ValueInfo::Kind::Function) {
+                            auto &[selfTy, funcDecl] = VI.getFunctionInfo();
+                            addInstanceOrStaticFunction(selfTy, funcDecl);
+                        }
                     }
                 }
                 break;
@@ -1436,16 +1459,16 @@ IRGenerator::resolveCall_imp(std::shared_ptr<ast::CallExpr> callExpr, SkipCodege
                 // call target resolves to a type -> ctor call?
                 auto type = result.getTypeRef();
                 if (auto structTy = llvm::dyn_cast<StructType>(type)) {
-                    if (auto type = util::map::get_opt(namedDeclInfos, structTy->getName())) {
+                    if (!namedDeclInfos.lookup(util::Symbol(structTy->getName())).empty()) {
                         auto ctorName = mangling::mangleCanonicalName(ast::FunctionKind::StaticMethod, structTy->getName());
-                        if (auto ctorCandidates = util::map::get_opt(functions, ctorName)) {
-                            auto ctor = util::vector::first_where(*ctorCandidates, [](const ResolvedCallable &RC) {
-                                return RC.funcDecl->getAttributes().int_isCtor;
-                            });
-                            if (ctor.has_value()) {
-                                resultStatus = ResolveCallResultStatus::Success;
+                        if (auto ctorCandidates = functions.lookup(ctorName); !ctorCandidates.empty()) {
+                            for (auto ctor : ctorCandidates) {
+                                if (ctor->funcDecl->getAttributes().int_isCtor) {
+                                    resultStatus = ResolveCallResultStatus::Success;
+                                    return *ctor;
+                                }
                             }
-                            return ctor;
+                            return std::nullopt;
                         } else {
                             LKFatalError("unable to find compiler-generated constructor decl");
                         }
@@ -1464,9 +1487,9 @@ IRGenerator::resolveCall_imp(std::shared_ptr<ast::CallExpr> callExpr, SkipCodege
                     case NK::StructDecl: {
                         auto structDecl = llvm::cast<ast::StructDecl>(decl);
                         auto ctorTargetName = mangling::mangleCanonicalName(ast::FunctionKind::StaticMethod, structDecl->getName());
-                        const auto &targets = functions[ctorTargetName];
+                        auto targets = functions.lookup(ctorTargetName);
                         LKAssert(targets.size() == 1);
-                        auto &target = targets[0];
+                        auto &target = *targets[0];
 
                         LKAssert(target.signature.isTemplateDecl() && target.funcDecl->getSignature().isTemplateDecl());
                         LKAssert(target.funcDecl->getAttributes().int_isCtor);
@@ -1655,10 +1678,21 @@ IRGenerator::resolveCall_imp(std::shared_ptr<ast::CallExpr> callExpr, SkipCodege
     
     
     
-    auto bestMatch = candidates.front();
+    auto &bestMatch = candidates.front();
+    resolvedCallTargets.insert_or_assign(callExpr, ResolvedCallTarget{
+        localScopeState, nominalTypesState, functionsGeneration, namedDeclsGeneration, bestMatch
+    });
     
+    resultStatus = ResolveCallResultStatus::Success;
+    return finalizeCallTarget(bestMatch, codegenOption);
+}
+
+
+
+// Emits the selected target (if necessary), and specializes it if it is a template
+ResolvedCallable IRGenerator::finalizeCallTarget(const FunctionCallTargetCandidate &bestMatch, SkipCodegenOption codegenOption) {
     if (auto &attr = bestMatch.target.funcDecl->getAttributes();
-        !skipCodegen && attr.int_isDelayed && !bestMatch.getSignature().isTemplateDecl())
+        codegenOption == kRunCodegen && attr.int_isDelayed && !bestMatch.getSignature().isTemplateDecl())
     {
         attr.int_isDelayed = false;
         EmptyScopeHandle ESH(*this);
@@ -1667,11 +1701,9 @@ IRGenerator::resolveCall_imp(std::shared_ptr<ast::CallExpr> callExpr, SkipCodege
     
     
     if (bestMatch.getSignature().isTemplateDecl() && !bestMatch.target.llvmValue) {
-        resultStatus = ResolveCallResultStatus::Success;
         return specializeTemplateFunctionDeclForCallExpr(bestMatch.target.funcDecl, bestMatch.templateArgumentMapping, bestMatch.target.hasImplicitSelfArg, codegenOption);
     }
     
-    resultStatus = ResolveCallResultStatus::Success;
     return bestMatch.target;
 }
 
@@ -1698,7 +1730,7 @@ bool callerCalleeSideEffectsCompatible(const std::vector<yo::attributes::SideEff
 }
 
 
-llvm::Value* IRGenerator::codegenCallExpr(std::shared_ptr<ast::CallExpr> call, ValueKind VK) {
+llvm::Value* IRGenerator::codegenCallExpr(ast::CallExpr *call, ValueKind VK) {
     emitDebugLocation(call);
     
     auto resolvedTarget = resolveCall(call, kRunCodegen);
@@ -1718,7 +1750,7 @@ llvm::Value* IRGenerator::codegenCallExpr(std::shared_ptr<ast::CallExpr> call, V
         // TODO properly implement side effects!
         if (!callerCalleeSideEffectsCompatible(currentFunction.decl->getAttributes().side_effects, calledFuncDecl->getAttributes().side_effects)) {
             auto targetName = mangling::mangleCanonicalName(calledFuncDecl);
-            LKFatalError("cannot call '%s' because side effects", targetName.c_str());
+            LKFatalError("cannot call '%s' because side effects", targetName.str().c_str());
         }
     }
     
@@ -1745,11 +1777,15 @@ llvm::Value* IRGenerator::codegenCallExpr(std::shared_ptr<ast::CallExpr> call, V
             }
             
             auto msg = util::fmt::format("incompatible type for argument #{}. Expected '{}', got '{}'", i, expectedType, exprTy);
-            diagnostics::emitError(expr->getSourceLocation(), msg);
+            diagnostics::emitError(sourceManager, expr->getSourceLocation(), msg);
         }
         cont:
         // TODO is modifying the arguments in-place necessarily a good idea?
-        call->arguments[i - resolvedTarget.hasImplicitSelfArg] = expr;
+        if (auto &arg = call->arguments[i - resolvedTarget.hasImplicitSelfArg]; arg != expr) {
+            // the call's type was computed from the original argument's type
+            arg = expr;
+            resolvedExprTypes.erase(call);
+        }
     }
     
     if (resolvedTarget.funcDecl && resolvedTarget.funcDecl->getAttributes().intrinsic) {
@@ -1793,8 +1829,7 @@ llvm::Value* IRGenerator::codegenCallExpr(std::shared_ptr<ast::CallExpr> call, V
             LKAssert(argTy->isReferenceTy());
             if (!didConstructCopy) {
                 //  only insert a load if no copy was made. otherwise, the copy constructor already returns a non-reference object
-                LKFatalError("");
-                V = builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, V);
+                V = builder.CreateLoad(getLLVMType(llvm::cast<ReferenceType>(argTy)->getReferencedType()), V);
             }
         }
         args.push_back(V);
@@ -1802,7 +1837,7 @@ llvm::Value* IRGenerator::codegenCallExpr(std::shared_ptr<ast::CallExpr> call, V
     
     if (hasImplicitSelfArg) {
         // TODO this is missing checks to make sure selfTy actually matches / is convertible to the expected argument type !?
-        std::shared_ptr<ast::Expr> implicitSelfArg;
+        ast::Expr *implicitSelfArg = nullptr;
         
         if (call->target->isOfKind(NK::MemberExpr) && !resolvedTarget.funcDecl->isCallOperatorOverload()) {
             implicitSelfArg = llvm::cast<ast::MemberExpr>(call->target)->target;
@@ -1816,8 +1851,8 @@ llvm::Value* IRGenerator::codegenCallExpr(std::shared_ptr<ast::CallExpr> call, V
             // if a call target is a temporary, we need to make sure the object outlives the call
             // we do this by putting it on the stack, thus implicitly registering it for destruction once we leave the current scope
             // TODO the object should be destructed immediately after the call returns / at the end of the enclosing statement !
-            auto ident = makeIdent(currentFunction.getTmpIdent(), implicitSelfArg->getSourceLocation());
-            auto varDecl = std::make_shared<ast::VarDecl>(ident, nullptr, implicitSelfArg);
+            auto ident = makeIdent(astContext, currentFunction.getTmpIdent(), implicitSelfArg->getSourceLocation());
+            auto varDecl = ast::make<ast::VarDecl>(astContext, ident, nullptr, implicitSelfArg);
             args[0] = codegenVarDecl(varDecl);
         } else {
             args[0] = codegenExpr(implicitSelfArg, LValue);
@@ -1833,8 +1868,7 @@ llvm::Value* IRGenerator::codegenCallExpr(std::shared_ptr<ast::CallExpr> call, V
             auto V = codegenExpr(arg, RValue);
             
             if (auto refTy = llvm::dyn_cast<ReferenceType>(argTy)) {
-                LKFatalError("");
-                V = builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, V);
+                V = builder.CreateLoad(getLLVMType(refTy->getReferencedType()), V);
                 argTy = refTy->getReferencedType();
             }
             
@@ -1948,7 +1982,7 @@ static const std::map<Intrinsic, ast::Operator> intrinsicsComparisonOperationMap
 };
 
 
-llvm::Value *IRGenerator::codegen_HandleIntrinsic(std::shared_ptr<ast::FunctionDecl> funcDecl, std::shared_ptr<ast::CallExpr> call) {
+llvm::Value *IRGenerator::codegen_HandleIntrinsic(ast::FunctionDecl *funcDecl, ast::CallExpr *call) {
     emitDebugLocation(call);
     
     auto name = mangling::mangleCanonicalName(funcDecl);
@@ -1959,20 +1993,20 @@ llvm::Value *IRGenerator::codegen_HandleIntrinsic(std::shared_ptr<ast::FunctionD
         case Intrinsic::ReinterpretCast: {
             if (call->numberOfExplicitTemplateArgs() != 1) {
                 auto msg = util::fmt::format("invalid number of explicit template arguments. expected 1, got {}", call->numberOfExplicitTemplateArgs());
-                diagnostics::emitError(call->getSourceLocation(), msg);
+                diagnostics::emitError(sourceManager, call->getSourceLocation(), msg);
             }
             auto dstTy = call->explicitTemplateArgs->at(0);
             auto arg = call->arguments[0];
             auto castKind = intrinsic == Intrinsic::StaticCast
                 ? ast::CastExpr::CastKind::StaticCast
                 : ast::CastExpr::CastKind::Bitcast;
-            auto castExpr = std::make_shared<ast::CastExpr>(arg, dstTy, castKind);
+            auto castExpr = ast::make<ast::CastExpr>(astContext, arg, dstTy, castKind);
             castExpr->setSourceLocation(funcDecl->getSourceLocation());
             return codegenExpr(castExpr);
         }
         
         case Intrinsic::Sizeof: {
-            auto ty = resolveTypeDesc(call->explicitTemplateArgs->at(0))->getLLVMType();
+            auto ty = getLLVMType(resolveTypeDesc(call->explicitTemplateArgs->at(0)));
             return llvm::ConstantInt::get(builtinTypes.llvm.i64, module->getDataLayout().getTypeAllocSize(ty));
         }
         
@@ -2014,7 +2048,7 @@ llvm::Value *IRGenerator::codegen_HandleIntrinsic(std::shared_ptr<ast::FunctionD
             return codegen_HandleLogOpIntrinsic(intrinsic, call);
         
         case Intrinsic::Func:
-            return builder.CreateGlobalStringPtr(currentFunction.decl->getName());
+            return builder.CreateGlobalStringPtr(currentFunction.decl->getName().str());
         
         case Intrinsic::PrettyFunc: {
             std::ostringstream OS;
@@ -2042,7 +2076,7 @@ llvm::Value *IRGenerator::codegen_HandleIntrinsic(std::shared_ptr<ast::FunctionD
     }
     
     
-    diagnostics::emitError(call->getSourceLocation(), util::fmt::format("unhandled call to intrinsic '{}'", name));
+    diagnostics::emitError(sourceManager, call->getSourceLocation(), util::fmt::format("unhandled call to intrinsic '{}'", name));
 }
 
 
@@ -2105,7 +2139,7 @@ bool isValidFloatArithBinop(ast::Operator op) {
 }
 
 
-llvm::Value* IRGenerator::codegen_HandleArithmeticIntrinsic(ast::Operator op, std::shared_ptr<ast::CallExpr> call) {
+llvm::Value* IRGenerator::codegen_HandleArithmeticIntrinsic(ast::Operator op, ast::CallExpr *call) {
     LKAssert(call->arguments.size() == 2);
     
     Type *lhsTy = nullptr, *rhsTy = nullptr;
@@ -2115,7 +2149,7 @@ llvm::Value* IRGenerator::codegen_HandleArithmeticIntrinsic(ast::Operator op, st
     
     if (!typecheckAndApplyTrivialNumberTypeCastsIfNecessary_binop(&lhs, &rhs, &lhsTy, &rhsTy)) { // THIS
         auto msg = util::fmt::format("unable to create binop for operand types '{}' and '{}'", lhsTy, rhsTy);
-        diagnostics::emitError(call->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, call->getSourceLocation(), msg);
     }
     
     LKAssert(lhsTy->isNumericalTy() && rhsTy->isNumericalTy());
@@ -2140,7 +2174,7 @@ llvm::Value* IRGenerator::codegen_HandleArithmeticIntrinsic(ast::Operator op, st
 
 
 // TODO/NOTE: this function has only a single callee, so we can probably rewrite it to better fit that single use case?
-bool IRGenerator::typecheckAndApplyTrivialNumberTypeCastsIfNecessary_binop(std::shared_ptr<ast::Expr> *lhs, std::shared_ptr<ast::Expr> *rhs, Type **lhsTy_out, Type **rhsTy_out) {
+bool IRGenerator::typecheckAndApplyTrivialNumberTypeCastsIfNecessary_binop(ast::Expr **lhs, ast::Expr **rhs, Type **lhsTy_out, Type **rhsTy_out) {
     LKAssert(lhsTy_out && rhsTy_out);
     
     auto lhsTy = getType(*lhs);
@@ -2164,13 +2198,13 @@ bool IRGenerator::typecheckAndApplyTrivialNumberTypeCastsIfNecessary_binop(std::
     if (llvm::isa<ast::NumberLiteral>(*lhs)) {
         // lhs is literal, cast to type of ths
         auto loc = (*lhs)->getSourceLocation();
-        *lhs = std::make_shared<ast::CastExpr>(*lhs, ast::TypeDesc::makeResolved(rhsTy), ast::CastExpr::CastKind::StaticCast);
+        *lhs = ast::make<ast::CastExpr>(astContext, *lhs, ast::TypeDesc::makeResolved(astContext, rhsTy), ast::CastExpr::CastKind::StaticCast);
         (*lhs)->setSourceLocation(loc);
         *lhsTy_out = rhsTy;
     } else if (llvm::isa<ast::NumberLiteral>(*rhs)) {
         // rhs is literal, cast to type of lhs
         auto loc = (*rhs)->getSourceLocation();
-        *rhs = std::make_shared<ast::CastExpr>(*rhs, ast::TypeDesc::makeResolved(lhsTy), ast::CastExpr::CastKind::StaticCast);
+        *rhs = ast::make<ast::CastExpr>(astContext, *rhs, ast::TypeDesc::makeResolved(astContext, lhsTy), ast::CastExpr::CastKind::StaticCast);
         (*rhs)->setSourceLocation(loc);
         *rhsTy_out = lhsTy;
     } else {
@@ -2210,7 +2244,7 @@ llvm::CmpInst::Predicate getMatchingLLVMCmpInstPredicateForComparisonOperator_Fl
 
 
 
-llvm::Value* IRGenerator::codegen_HandleComparisonIntrinsic(ast::Operator op, std::shared_ptr<ast::CallExpr> call) {
+llvm::Value* IRGenerator::codegen_HandleComparisonIntrinsic(ast::Operator op, ast::CallExpr *call) {
     LKAssert(call->arguments.size() == 2);
     
     auto lhsExpr = call->arguments.at(0);
@@ -2224,7 +2258,7 @@ llvm::Value* IRGenerator::codegen_HandleComparisonIntrinsic(ast::Operator op, st
     if (lhsTy->isPointerTy() && rhsTy->isPointerTy()) {
         if (lhsTy != rhsTy) {
             auto msg = util::fmt::format("cannot compare pointers to unrelated types '{}' and '{}'", lhsTy, rhsTy);
-            diagnostics::emitError(call->getSourceLocation(), msg);
+            diagnostics::emitError(sourceManager, call->getSourceLocation(), msg);
         }
         auto lhs = codegenExpr(lhsExpr);
         auto rhs = codegenExpr(rhsExpr);
@@ -2246,7 +2280,7 @@ llvm::Value* IRGenerator::codegen_HandleComparisonIntrinsic(ast::Operator op, st
     
     if (!(lhsTy->isNumericalTy() && rhsTy->isNumericalTy())) {
         auto msg = util::fmt::format("no known comparison for types '{}' and '{}'", lhsTy, rhsTy);
-        diagnostics::emitError(call->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, call->getSourceLocation(), msg);
     }
     
     
@@ -2277,9 +2311,9 @@ llvm::Value* IRGenerator::codegen_HandleComparisonIntrinsic(ast::Operator op, st
             castDestTy = builtinTypes.yo.i64;
         }
         
-        auto lhsCast = std::make_shared<ast::CastExpr>(lhsExpr, ast::TypeDesc::makeResolved(castDestTy), ast::CastExpr::CastKind::StaticCast);
+        auto lhsCast = ast::make<ast::CastExpr>(astContext, lhsExpr, ast::TypeDesc::makeResolved(astContext, castDestTy), ast::CastExpr::CastKind::StaticCast);
         lhsCast->setSourceLocation(lhsExpr->getSourceLocation());
-        auto rhsCast = std::make_shared<ast::CastExpr>(rhsExpr, ast::TypeDesc::makeResolved(castDestTy), ast::CastExpr::CastKind::StaticCast);
+        auto rhsCast = ast::make<ast::CastExpr>(astContext, rhsExpr, ast::TypeDesc::makeResolved(astContext, castDestTy), ast::CastExpr::CastKind::StaticCast);
         rhsCast->setSourceLocation(rhsExpr->getSourceLocation());
         
         lhsVal = codegenExpr(lhsCast);
@@ -2296,7 +2330,7 @@ llvm::Value* IRGenerator::codegen_HandleComparisonIntrinsic(ast::Operator op, st
 
 
 
-llvm::Value* IRGenerator::codegen_HandleLogOpIntrinsic(Intrinsic I, std::shared_ptr<ast::CallExpr> call) {
+llvm::Value* IRGenerator::codegen_HandleLogOpIntrinsic(Intrinsic I, ast::CallExpr *call) {
     LKAssert(call->arguments.size() == 2);
     LKAssert(I == Intrinsic::LAnd || I == Intrinsic::LOr);
     
@@ -9,7 +9,7 @@
 #include "IRGen.h"
 #include "lex/Diagnostics.h"
 #include "util_llvm.h"
-#include "util/llvm_casting.h"
+#include "llvm/Support/Casting.h"
 #include "util/VectorUtils.h"
 
 using namespace yo;
@@ -17,7 +17,7 @@ using namespace yo::irgen;
 using NK = ast::Node::Kind;
 
 
-llvm::Value* IRGenerator::codegenCompoundStmt(std::shared_ptr<ast::CompoundStmt> compoundStmt) {
+llvm::Value* IRGenerator::codegenCompoundStmt(ast::CompoundStmt *compoundStmt) {
     const auto &stmts = compoundStmt->statements;
     
     auto marker = localScope.getMarker();
@@ -42,7 +42,7 @@ llvm::Value* IRGenerator::codegenCompoundStmt(std::shared_ptr<ast::CompoundStmt>
 
 
 // TODO should assignments return something?
-llvm::Value* IRGenerator::codegenAssignment(std::shared_ptr<ast::Assignment> assignment) {
+llvm::Value* IRGenerator::codegenAssignment(ast::Assignment *assignment) {
     llvm::Value *llvmTargetLValue = nullptr;
     llvm::Value *llvmRhsVal = nullptr;
     auto rhsExpr = assignment->value;
@@ -57,19 +57,18 @@ llvm::Value* IRGenerator::codegenAssignment(std::shared_ptr<ast::Assignment> ass
         
         auto lhsLValue = codegenExpr(binop->getLhs(), LValue, /*insertImplicitLoadInst*/ false);
         llvmTargetLValue = lhsLValue;
-        LKFatalError("dafuq");
-        auto lhsRValue = builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, lhsLValue);
+        auto lhsRValue = builder.CreateLoad(getLLVMType(lhsTy), lhsLValue);
         
-        auto newLhs = std::make_shared<ast::RawLLVMValueExpr>(lhsRValue, lhsTy);
+        auto newLhs = ast::make<ast::RawLLVMValueExpr>(astContext, lhsRValue, lhsTy);
         newLhs->setSourceLocation(assignment->target->getSourceLocation());
         
-        auto newBinop = std::make_shared<ast::BinOp>(binop->getOperator(), newLhs, binop->getRhs());
+        auto newBinop = ast::make<ast::BinOp>(astContext, binop->getOperator(), newLhs, binop->getRhs());
         newBinop->setSourceLocation(binop->getSourceLocation());
         rhsExpr = newBinop;
         
     } else {
         if (isTemporary(assignment->target)) {
-            diagnostics::emitError(assignment->target->getSourceLocation(), "cannot assign to temporary value");
+            diagnostics::emitError(sourceManager, assignment->target->getSourceLocation(), "cannot assign to temporary value");
         }
         llvmTargetLValue = codegenExpr(assignment->target, LValue, /*insertImplicitLoadInst*/ false);
         
@@ -88,11 +87,11 @@ llvm::Value* IRGenerator::codegenAssignment(std::shared_ptr<ast::Assignment> ass
 //        Type *T;
 //        if (!typecheckAndApplyTrivialNumberTypeCastsIfNecessary(rhsExpr, lhsTy, &T)) {
 //            auto msg = util::fmt::format("cannot assign to '{}' from incompatible type '{}'", lhsTy, T);
-//            diagnostics::emitError(assignment->getSourceLocation(), msg);
+//            diagnostics::emitError(sourceManager, assignment->getSourceLocation(), msg);
 //        }
         if (!applyImplicitConversionIfNecessary(rhsExpr, lhsTy)) {
             auto msg = util::fmt::format("cannot assign to '{}' from value of incompatible type '{}'", lhsTy, getType(rhsExpr));
-            diagnostics::emitError(assignment->getSourceLocation(), msg);
+            diagnostics::emitError(sourceManager, assignment->getSourceLocation(), msg);
         }
     }
     
@@ -104,8 +103,7 @@ ok:
             ))
     {
         emitDebugLocation(assignment);
-        LKFatalError("");
-        llvmTargetLValue = builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, llvmTargetLValue);
+        llvmTargetLValue = builder.CreateLoad(getLLVMType(lhsTy), llvmTargetLValue);
     }
     
     if (assignment->shouldDestructOldValue) {
@@ -117,15 +115,13 @@ ok:
     
     if (lhsTy->isReferenceTy() && assignment->overwriteReferences) {
         llvmRhsVal = codegenExpr(rhsExpr, LValue, /*insertImplicitLoadInst*/ false);
-        LKFatalError("");
-        llvmRhsVal = builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, llvmRhsVal);
+        llvmRhsVal = builder.CreateLoad(getLLVMType(lhsTy), llvmRhsVal);
     } else {
         bool didConstructCopy;
         llvmRhsVal = constructCopyIfNecessary(rhsTy, rhsExpr, &didConstructCopy);
         if (!didConstructCopy && rhsTy->isReferenceTy()) {
             emitDebugLocation(assignment);
-            LKFatalError("");
-            llvmRhsVal = builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, llvmRhsVal);
+            llvmRhsVal = builder.CreateLoad(getLLVMType(llvm::cast<ReferenceType>(rhsTy)->getReferencedType()), llvmRhsVal);
         }
     }
     
@@ -140,11 +136,11 @@ ok:
 
 
 
-llvm::Value* IRGenerator::codegenVarDecl(std::shared_ptr<ast::VarDecl> varDecl) {
+llvm::Value* IRGenerator::codegenVarDecl(ast::VarDecl *varDecl) {
     if (localScope.contains(varDecl->getName())) {
         // TODO is there a good reason why this shouldn't be allowed?
         auto msg = util::fmt::format("redeclaration of '{}'", varDecl->getName());
-        diagnostics::emitError(varDecl->ident->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, varDecl->ident->getSourceLocation(), msg);
     }
     
     
@@ -154,7 +150,7 @@ llvm::Value* IRGenerator::codegenVarDecl(std::shared_ptr<ast::VarDecl> varDecl)
     if (varDecl->type == nullptr) {
         // If no type is specified, there _has_ to be an initial value
         if (!varDecl->initialValue) {
-            diagnostics::emitError(varDecl->getSourceLocation(), "must specify initial value");
+            diagnostics::emitError(sourceManager, varDecl->getSourceLocation(), "must specify initial value");
         }
         type = getType(varDecl->initialValue);
         hasInferredType = true;
@@ -162,7 +158,7 @@ llvm::Value* IRGenerator::codegenVarDecl(std::shared_ptr<ast::VarDecl> varDecl)
         type = resolveTypeDesc(varDecl->type);
     }
     if (!type) {
-        diagnostics::emitError(varDecl->getSourceLocation(), "unable to infer type of variable");
+        diagnostics::emitError(sourceManager, varDecl->getSourceLocation(), "unable to infer type of variable");
     }
     
     if (varDecl->declaresUntypedReference && !type->isReferenceTy()) {
@@ -173,12 +169,12 @@ llvm::Value* IRGenerator::codegenVarDecl(std::shared_ptr<ast::VarDecl> varDecl)
     
     if (type->isReferenceTy()) {
         if (!varDecl->initialValue) {
-            diagnostics::emitError(varDecl->getSourceLocation(), "lvalue reference declaration requires initial value");
+            diagnostics::emitError(sourceManager, varDecl->getSourceLocation(), "lvalue reference declaration requires initial value");
         }
         
         if (isTemporary(varDecl->initialValue)) {
             auto msg = util::fmt::format("lvalue reference of type '{}' cannot bind to temporary of type '{}'", type, getType(varDecl->initialValue));
-            diagnostics::emitError(varDecl->initialValue->getSourceLocation(), msg);
+            diagnostics::emitError(sourceManager, varDecl->initialValue->getSourceLocation(), msg);
         }
     } else {
         // TODO necessary?
@@ -186,26 +182,25 @@ llvm::Value* IRGenerator::codegenVarDecl(std::shared_ptr<ast::VarDecl> varDecl)
     
     emitDebugLocation(varDecl);
     auto alloca = builder.CreateAlloca(getLLVMType(type));
-    alloca->setName(varDecl->getName());
+    alloca->setName(varDecl->getName().str());
     
     // Create Debug Metadata
     if (shouldEmitDebugInfo()) {
         auto D = debugInfo.builder.createAutoVariable(currentFunction.llvmFunction->getSubprogram(),
-                                                      varDecl->getName(),
+                                                      varDecl->getName().str(),
                                                       debugInfo.lexicalBlocks.back()->getFile(),
-                                                      varDecl->getSourceLocation().getLine(),
+                                                      sourceManager.getLine(varDecl->getSourceLocation()),
                                                       getDIType(type));
         auto &SL = varDecl->getSourceLocation();
         debugInfo.builder.insertDeclare(alloca, D,
                                         debugInfo.builder.createExpression(),
-                                        llvm::DILocation::get(C, SL.getLine(), SL.getColumn(), currentFunction.llvmFunction->getSubprogram()),
+                                        llvm::DILocation::get(C, sourceManager.getLine(SL), sourceManager.getColumn(SL), currentFunction.llvmFunction->getSubprogram()),
                                         builder.GetInsertBlock());
     }
     
     localScope.insert(varDecl->getName(), ValueBinding(
         type, alloca, [=]() -> llvm::Value* {
-            LKFatalError("");
-            return builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, alloca);
+            return builder.CreateLoad(getLLVMType(type), alloca);
         }, [=](llvm::Value *V) {
             //LKAssert(V->getType() == alloca->getType()->getPointerElementType());
             builder.CreateStore(V, alloca);
@@ -217,7 +212,7 @@ llvm::Value* IRGenerator::codegenVarDecl(std::shared_ptr<ast::VarDecl> varDecl)
         // Q: Why create and handle an assignment to set the initial value, instead of just calling Binding.Write?
         // A: The Assignment codegen also includes the trivial type transformations, whish we'd otherwise have to implement again in here
         if (!type->isReferenceTy()) {
-            auto assignment = std::make_shared<ast::Assignment>(varDecl->ident, initialValueExpr);
+            auto assignment = ast::make<ast::Assignment>(astContext, varDecl->ident, initialValueExpr);
             assignment->setSourceLocation(varDecl->getSourceLocation());
             assignment->shouldDestructOldValue = false;
             codegenAssignment(assignment);
@@ -228,7 +223,7 @@ llvm::Value* IRGenerator::codegenVarDecl(std::shared_ptr<ast::VarDecl> varDecl)
         }
     } else {
         if (!driverOptions.fzeroInitialize) {
-            diagnostics::emitError(varDecl->getSourceLocation(), "no initial value specified");
+            diagnostics::emitError(sourceManager, varDecl->getSourceLocation(), "no initial value specified");
         } else {
             // zero initialize
             if (!(type->isPointerTy() || type->isNumericalTy())) {
@@ -236,9 +231,9 @@ llvm::Value* IRGenerator::codegenVarDecl(std::shared_ptr<ast::VarDecl> varDecl)
                 // 1) should function types be considered pointers? (probably, right?)
                 // 2) there are other types that can also be zero-initialized? (basically everything!)
                 // -> this is a stupid requirement
-                diagnostics::emitError(varDecl->getSourceLocation(), "only pointer or numerical types can be zero-initialized");
+                diagnostics::emitError(sourceManager, varDecl->getSourceLocation(), "only pointer or numerical types can be zero-initialized");
             } else {
-                auto null = llvm::Constant::getNullValue(type->getLLVMType());
+                auto null = llvm::Constant::getNullValue(getLLVMType(type));
                 emitDebugLocation(varDecl);
                 builder.CreateStore(null, alloca);
             }
@@ -252,7 +247,7 @@ llvm::Value* IRGenerator::codegenVarDecl(std::shared_ptr<ast::VarDecl> varDecl)
 
 
 
-llvm::Value* IRGenerator::codegenReturnStmt(std::shared_ptr<ast::ReturnStmt> returnStmt) {
+llvm::Value* IRGenerator::codegenReturnStmt(ast::ReturnStmt *returnStmt) {
     const auto returnType = resolveTypeDesc(currentFunction.decl->getSignature().returnType);
 
     if (auto expr = returnStmt->expr) {
@@ -261,7 +256,7 @@ llvm::Value* IRGenerator::codegenReturnStmt(std::shared_ptr<ast::ReturnStmt> ret
         auto typeMismatch = [&]() {
             auto msg = util::fmt::format("expression evaluates to type '{}', which is incompatible with the expected return type '{}'",
                                         retvalTy, returnType);
-            diagnostics::emitError(returnStmt->getSourceLocation(), msg);
+            diagnostics::emitError(sourceManager, returnStmt->getSourceLocation(), msg);
         };
         
         if (retvalTy == returnType) {
@@ -270,7 +265,7 @@ llvm::Value* IRGenerator::codegenReturnStmt(std::shared_ptr<ast::ReturnStmt> ret
         
         if (returnType->isReferenceTy()) {
             if (isTemporary(expr)) {
-                diagnostics::emitError(returnStmt->getSourceLocation(), "cannot return reference to temporary");
+                diagnostics::emitError(sourceManager, returnStmt->getSourceLocation(), "cannot return reference to temporary");
             } else if (!retvalTy->isReferenceTy() && retvalTy->getReferenceTo() == returnType) {
                 goto handle;
             } else {
@@ -288,7 +283,7 @@ llvm::Value* IRGenerator::codegenReturnStmt(std::shared_ptr<ast::ReturnStmt> ret
             emitDebugLocation(returnStmt);
             builder.CreateStore(V, currentFunction.retvalAlloca);
         } else {
-            auto assignment = std::make_shared<ast::Assignment>(makeIdent(kRetvalAllocaIdentifier), expr);
+            auto assignment = ast::make<ast::Assignment>(astContext, makeIdent(astContext, kRetvalAllocaIdentifier), expr);
             assignment->setSourceLocation(returnStmt->getSourceLocation());
             assignment->shouldDestructOldValue = false;
             codegenAssignment(assignment);
@@ -306,7 +301,7 @@ llvm::Value* IRGenerator::codegenReturnStmt(std::shared_ptr<ast::ReturnStmt> ret
 
 
 
-llvm::Value* IRGenerator::codegenIfStmt(std::shared_ptr<ast::IfStmt> ifStmt) {
+llvm::Value* IRGenerator::codegenIfStmt(ast::IfStmt *ifStmt) {
     // TODO does this need more debug locations?
     emitDebugLocation(ifStmt);
     
@@ -360,7 +355,7 @@ llvm::Value* IRGenerator::codegenIfStmt(std::shared_ptr<ast::IfStmt> ifStmt) {
         
 //        if (auto BoolTy = builtinTypes.yo.Bool; condTy != BoolTy && condTy != BoolTy->getReferenceTo()) {
 //            auto msg = util::fmt::format("type of expression ('{}') incompatible with expected type '{}'", condTy, BoolTy);
-//            diagnostics::emitError(branch->getSourceLocation(), msg);
+//            diagnostics::emitError(sourceManager, branch->getSourceLocation(), msg);
 //        }
         
 //        auto condV = codegenExpr(branch->condition);
@@ -435,7 +430,7 @@ llvm::Value* IRGenerator::codegenIfStmt(std::shared_ptr<ast::IfStmt> ifStmt) {
 
 
 
-llvm::Value* IRGenerator::codegenWhileStmt(std::shared_ptr<ast::WhileStmt> whileStmt) {
+llvm::Value* IRGenerator::codegenWhileStmt(ast::WhileStmt *whileStmt) {
     emitDebugLocation(whileStmt);
     
     // TODO what if there;s a return statement in the body!
@@ -473,63 +468,63 @@ llvm::Value* IRGenerator::codegenWhileStmt(std::shared_ptr<ast::WhileStmt> while
 
 
 
-std::shared_ptr<ast::CallExpr> makeInstanceMethodCallExpr(std::shared_ptr<ast::Expr> target, std::string methodName) {
-    auto callTarget = std::make_shared<ast::MemberExpr>(target, methodName);
+ast::CallExpr *makeInstanceMethodCallExpr(ast::ASTContext &astContext, ast::Expr *target, util::Symbol methodName) {
+    auto callTarget = ast::make<ast::MemberExpr>(astContext, target, methodName);
     callTarget->setSourceLocation(target->getSourceLocation());
     
-    auto call = std::make_shared<ast::CallExpr>(callTarget);
+    auto call = ast::make<ast::CallExpr>(astContext, callTarget);
     call->setSourceLocation(target->getSourceLocation());
     
     return call;
 }
 
 
-llvm::Value* IRGenerator::codegenForLoop(std::shared_ptr<ast::ForLoop> forLoop) {
+llvm::Value* IRGenerator::codegenForLoop(ast::ForLoop *forLoop) {
     auto targetTy = getType(forLoop->expr);
     
     if (!memberFunctionCallResolves(targetTy, kIteratorMethodName, {})) {
         auto msg = util::fmt::format("expression of type '{}' is not iterable", targetTy);
-        diagnostics::emitError(forLoop->expr->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, forLoop->expr->getSourceLocation(), msg);
     }
     
     
-    auto loopExprIdent = makeIdent(currentFunction.getTmpIdent(), forLoop->getSourceLocation());
-    auto iteratorIdent = makeIdent(currentFunction.getTmpIdent(), forLoop->getSourceLocation());
+    auto loopExprIdent = makeIdent(astContext, currentFunction.getTmpIdent(), forLoop->getSourceLocation());
+    auto iteratorIdent = makeIdent(astContext, currentFunction.getTmpIdent(), forLoop->getSourceLocation());
     
     // make sure the target's lifetime exceeds the iterator's
-    auto loopExprVarDecl = std::make_shared<ast::VarDecl>(loopExprIdent, nullptr, forLoop->expr);
+    auto loopExprVarDecl = ast::make<ast::VarDecl>(astContext, loopExprIdent, nullptr, forLoop->expr);
     if (!isTemporary(forLoop->expr)) {
         loopExprVarDecl->declaresUntypedReference = true;
     }
     
-    auto iteratorCallExpr = makeInstanceMethodCallExpr(loopExprIdent, kIteratorMethodName);
+    auto iteratorCallExpr = makeInstanceMethodCallExpr(astContext, loopExprIdent, kIteratorMethodName);
     iteratorCallExpr->setSourceLocation(forLoop->getSourceLocation());
     
     // let it = <target>.iterator();
-    auto iteratorVarDecl = std::make_shared<ast::VarDecl>(iteratorIdent, nullptr, iteratorCallExpr);
+    auto iteratorVarDecl = ast::make<ast::VarDecl>(astContext, iteratorIdent, nullptr, iteratorCallExpr);
     iteratorVarDecl->setSourceLocation(forLoop->getSourceLocation());
     
     
     // while it.hasNext()
-    auto whileCond = makeInstanceMethodCallExpr(iteratorIdent, kIteratorHasNextMethodName);
-    auto whileBody = std::make_shared<ast::CompoundStmt>();
+    auto whileCond = makeInstanceMethodCallExpr(astContext, iteratorIdent, kIteratorHasNextMethodName);
+    auto whileBody = ast::make<ast::CompoundStmt>(astContext);
     whileBody->setSourceLocation(forLoop->body->getSourceLocation());
     
     // let [&]<ident> = it.next();
-    auto nextElemCall = makeInstanceMethodCallExpr(iteratorIdent, kIteratorNextMethodName);
+    auto nextElemCall = makeInstanceMethodCallExpr(astContext, iteratorIdent, kIteratorNextMethodName);
     nextElemCall->setSourceLocation(forLoop->expr->getSourceLocation());
-    auto elemDecl = std::make_shared<ast::VarDecl>(forLoop->ident, nullptr, nextElemCall);
+    auto elemDecl = ast::make<ast::VarDecl>(astContext, forLoop->ident, nullptr, nextElemCall);
     elemDecl->declaresUntypedReference = forLoop->capturesByReference;
     elemDecl->setSourceLocation(forLoop->ident->getSourceLocation());
     
     whileBody->statements.push_back(elemDecl);
     util::vector::append(whileBody->statements, forLoop->body->statements);
     
-    auto whileStmt = std::make_shared<ast::WhileStmt>(whileCond, whileBody);
+    auto whileStmt = ast::make<ast::WhileStmt>(astContext, whileCond, whileBody);
     whileStmt->setSourceLocation(forLoop->getSourceLocation());
     
     // Wrap in a compound to make sure the iterator gets deallocated immediately after the loop exits
-    auto stmt = std::make_shared<ast::CompoundStmt>();
+    auto stmt = ast::make<ast::CompoundStmt>(astContext);
     stmt->setSourceLocation(forLoop->getSourceLocation());
     stmt->statements.push_back(loopExprVarDecl);
     stmt->statements.push_back(iteratorVarDecl);
@@ -540,10 +535,10 @@ llvm::Value* IRGenerator::codegenForLoop(std::shared_ptr<ast::ForLoop> forLoop)
 
 
 
-llvm::Value* IRGenerator::codegenBreakContStmt(std::shared_ptr<ast::BreakContStmt> stmt) {
+llvm::Value* IRGenerator::codegenBreakContStmt(ast::BreakContStmt *stmt) {
     if (currentFunction.breakContDestinations.empty()) {
         auto msg = util::fmt::format("'{}' statement may only be used in a loop", stmt->isBreak() ? "break" : "continue");
-        diagnostics::emitError(stmt->getSourceLocation(), msg);
+        diagnostics::emitError(sourceManager, stmt->getSourceLocation(), msg);
     }
     
     llvm::BasicBlock *dest;
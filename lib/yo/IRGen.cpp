@@ -13,12 +13,13 @@
 #include "lex/Diagnostics.h"
 #include "parse/Attributes.h"
 #include "util_llvm.h"
-#include "util/llvm_casting.h"
+#include "llvm/Support/Casting.h"
 #include "util/MapUtils.h"
 
 #include <optional>
 #include <limits>
 #include <set>
+#include <unordered_set>
 
 
 using namespace yo;
@@ -33,20 +34,16 @@ using NK = ast::Node::Kind;
 LKFatalError("Unhandled Node: '%s'", ast::nodeKindToString(node->getKind()).c_str());
 
 
-// just to make sure the additions to llvm's casting APIs are picked up correctly
-static_assert(std::is_same_v<decltype(llvm::cast<yo::ast::NumberLiteral>(std::declval<std::shared_ptr<yo::ast::Node>&>())), std::shared_ptr<yo::ast::NumberLiteral>>);
 
 
-
-
-std::shared_ptr<ast::Ident> irgen::makeIdent(const std::string& str, lex::SourceLocation SL) {
-    auto ident = std::make_shared<ast::Ident>(str);
+ast::Ident *irgen::makeIdent(ast::ASTContext &astContext, const std::string& str, lex::SourceLocation SL) {
+    auto ident = ast::make<ast::Ident>(astContext, str);
     ident->setSourceLocation(SL);
     return ident;
 }
 
 
-std::string irgen::mangleFullyResolved(const std::shared_ptr<ast::FunctionDecl>& functionDecl) {
+std::string irgen::mangleFullyResolved(ast::FunctionDecl *functionDecl) {
     if (functionDecl->getAttributes().no_mangle) {
         return functionDecl->getName();
     } else if (!functionDecl->getAttributes().mangledName.empty()) {
@@ -59,13 +56,13 @@ std::string irgen::mangleFullyResolved(const std::shared_ptr<ast::FunctionDecl>&
 
 // TODO is this a good idea?
 // Note: this assumes that the type has already been fully initialized (important for tuples and lambdas)
-StructType* irgen::getUnderlyingStruct(Type *ty) {
-    auto handle = [](Type *type) -> StructType* {
+StructType* IRGenerator::getUnderlyingStruct(Type *ty) {
+    auto handle = [this](Type *type) -> StructType* {
         if (!type) {
             return nullptr;
         }
         if (auto tupleTy = llvm::dyn_cast<TupleType>(type)) {
-            return tupleTy->getUnderlyingStructType();
+            return util::map::get_opt(tupleStructTypes, tupleTy).value_or(nullptr);
         } else {
             return llvm::dyn_cast<StructType>(type);
         }
@@ -82,7 +79,7 @@ StructType* irgen::getUnderlyingStruct(Type *ty) {
             return handle(llvm::cast<ReferenceType>(ty)->getReferencedType());
         
         case Type::TypeID::Tuple:
-            return llvm::cast<TupleType>(ty)->getUnderlyingStructType();
+            return handle(ty);
         
         default:
             return nullptr;
@@ -106,21 +103,21 @@ bool irgen::integerLiteralFitsInIntegralType(uint64_t value, Type *type) {
     auto size = numTy->getSize();
     bool isSigned = numTy->isSigned();
     
-    HANDLE(Type::getInt8Type()->getSize(), int8_t, uint8_t)
-    HANDLE(Type::getInt16Type()->getSize(), int16_t, uint16_t)
-    HANDLE(Type::getInt32Type()->getSize(), int32_t, uint32_t)
-    HANDLE(Type::getInt64Type()->getSize(), int64_t, uint64_t)
+    HANDLE(sizeof(int8_t), int8_t, uint8_t)
+    HANDLE(sizeof(int16_t), int16_t, uint16_t)
+    HANDLE(sizeof(int32_t), int32_t, uint32_t)
+    HANDLE(sizeof(int64_t), int64_t, uint64_t)
     
     LKFatalError("should not reach here?");
 #undef HANDLE
 }
 
 
-std::shared_ptr<ast::CallExpr> irgen::subscriptExprToCall(std::shared_ptr<ast::SubscriptExpr> subscriptExpr) {
-    auto callTarget = std::make_shared<ast::MemberExpr>(subscriptExpr->target, mangling::encodeOperator(ast::Operator::Subscript));
+ast::CallExpr *irgen::subscriptExprToCall(ast::ASTContext &astContext, ast::SubscriptExpr *subscriptExpr) {
+    auto callTarget = ast::make<ast::MemberExpr>(astContext, subscriptExpr->target, mangling::encodeOperator(ast::Operator::Subscript));
     callTarget->setSourceLocation(subscriptExpr->target->getSourceLocation());
     
-    auto callExpr = std::make_shared<ast::CallExpr>(callTarget);
+    auto callExpr = ast::make<ast::CallExpr>(astContext, callTarget);
     callExpr->setSourceLocation(subscriptExpr->getSourceLocation());
     callExpr->arguments = subscriptExpr->args;
     
@@ -128,8 +125,8 @@ std::shared_ptr<ast::CallExpr> irgen::subscriptExprToCall(std::shared_ptr<ast::S
 }
 
 
-llvm::DIFile* irgen::DIFileForSourceLocation(llvm::DIBuilder& builder, const lex::SourceLocation& loc) {
-    const auto [directory, filename] = util::string::extractPathAndFilename(loc.getFilepath());
+llvm::DIFile* irgen::DIFileForSourceLocation(llvm::DIBuilder& builder, const lex::SourceManager& SM, const lex::SourceLocation& loc) {
+    const auto [directory, filename] = util::string::extractPathAndFilename(SM.getFilepath(loc));
     return builder.createFile(filename, directory);
 }
 
@@ -141,10 +138,10 @@ llvm::DIFile* irgen::DIFileForSourceLocation(llvm::DIBuilder& builder, const lex
 
 // IRGenerator
 
-llvm::LLVMContext IRGenerator::C;
-
-IRGenerator::IRGenerator(ast::AST &ast, const std::string &translationUnitPath, const driver::Options &options)
-    : ast(ast), module(std::make_unique<llvm::Module>(util::fs::path_get_filename(translationUnitPath), C)),
+IRGenerator::IRGenerator(ast::AST &ast, ast::ASTContext &astContext, TypeContext &typeContext, const lex::SourceManager &sourceManager,
+                         const std::string &translationUnitPath, const driver::Options &options)
+    : context(std::make_unique<llvm::LLVMContext>()), C(*context),
+    ast(ast), astContext(astContext), typeContext(typeContext), sourceManager(sourceManager), module(std::make_unique<llvm::Module>(util::fs::path_get_filename(translationUnitPath), C)),
     builder(C),
     debugInfo{llvm::DIBuilder(*module), nullptr, {}},
     driverOptions(options)
@@ -162,8 +159,6 @@ IRGenerator::IRGenerator(ast::AST &ast, const std::string &translationUnitPath,
     };
     
     // create all primitives' llvm::Type and llvm::DIType objects
-    Type::initPrimitives();
-    
     auto preflight_type = [&](auto *type) -> auto* {
         // getLLVM{DI}Type() will also set the respective member fields in the type object
         getLLVMType(type);
@@ -171,19 +166,19 @@ IRGenerator::IRGenerator(ast::AST &ast, const std::string &translationUnitPath,
         return type;
     };
     builtinTypes.yo = {
-        .u8    = preflight_type(Type::getUInt8Type()),
-        .u16   = preflight_type(Type::getUInt16Type()),
-        .u32   = preflight_type(Type::getUInt32Type()),
-        .u64   = preflight_type(Type::getUInt64Type()),
-        .i8    = preflight_type(Type::getInt8Type()),
-        .i16   = preflight_type(Type::getInt16Type()),
-        .i32   = preflight_type(Type::getInt32Type()),
-        .i64   = preflight_type(Type::getInt64Type()),
-        .Bool  = preflight_type(Type::getBoolType()),
-        .f32   = preflight_type(Type::getFloat32Type()),
-        .f64   = preflight_type(Type::getFloat64Type()),
-        .Void  = preflight_type(Type::getVoidType()),
-        .i8Ptr = preflight_type(Type::getInt8Type()->getPointerTo())
+        .u8    = preflight_type(Type::getUInt8Type(typeContext)),
+        .u16   = preflight_type(Type::getUInt16Type(typeContext)),
+        .u32   = preflight_type(Type::getUInt32Type(typeContext)),
+        .u64   = preflight_type(Type::getUInt64Type(typeContext)),
+        .i8    = preflight_type(Type::getInt8Type(typeContext)),
+        .i16   = preflight_type(Type::getInt16Type(typeContext)),
+        .i32   = preflight_type(Type::getInt32Type(typeContext)),
+        .i64   = preflight_type(Type::getInt64Type(typeContext)),
+        .Bool  = preflight_type(Type::getBoolType(typeContext)),
+        .f32   = preflight_type(Type::getFloat32Type(typeContext)),
+        .f64   = preflight_type(Type::getFloat64Type(typeContext)),
+        .Void  = preflight_type(Type::getVoidType(typeContext)),
+        .i8Ptr = preflight_type(Type::getInt8Type(typeContext)->getPointerTo())
     };
     
     const auto [path, filename] = util::string::extractPathAndFilename(translationUnitPath);
@@ -191,14 +186,14 @@ IRGenerator::IRGenerator(ast::AST &ast, const std::string &translationUnitPath,
     
     debugInfo.compileUnit = debugInfo.builder.createCompileUnit(llvm::dwarf::DW_LANG_C,
                                                                 debugInfo.builder.createFile(filename, path),
-                                                                "yo", driverOptions.optimize, "", 0);
+                                                                "yo", driverOptions.optimizationLevel != driver::OptimizationLevel::O0, "", 0);
     debugInfo.lexicalBlocks.push_back(debugInfo.compileUnit);
     module->addModuleFlag(llvm::Module::Warning, "Debug Info Version", llvm::DEBUG_METADATA_VERSION);
 }
 
 
 
-void IRGenerator::emitDebugLocation(const std::shared_ptr<ast::Node> &node) {
+void IRGenerator::emitDebugLocation(ast::Node *node) {
     if (!shouldEmitDebugInfo()) return;
     
     if (!node || node->getSourceLocation().isEmpty())  {
@@ -206,16 +201,27 @@ void IRGenerator::emitDebugLocation(const std::shared_ptr<ast::Node> &node) {
         return;
     }
     const auto &SL = node->getSourceLocation();
-    builder.SetCurrentDebugLocation(llvm::DILocation::get(C, SL.getLine(), SL.getColumn(), debugInfo.lexicalBlocks.back()));
+    builder.SetCurrentDebugLocation(llvm::DILocation::get(C, sourceManager.getLine(SL), sourceManager.getColumn(SL), debugInfo.lexicalBlocks.back()));
 }
 
 
 void IRGenerator::runCodegen() {
     preflight();
     
+    // The decls registered during preflight are the same in every partition, and are split into contiguous ranges, one per partition.
+    // Decls added during codegen (template instantiations, lambdas, synthesized functions) are lowered by every partition which needs them
+    const size_t numPreflightDecls = ast.size();
+    const size_t partitionBegin = numPreflightDecls * loweringPartition.index / loweringPartition.count;
+    const size_t partitionEnd = numPreflightDecls * (loweringPartition.index + 1) / loweringPartition.count;
+    std::unordered_set<llvm::Value *> ownedFunctions;
+    
     // note that, since the ast is potentially mutated during codegen, this is an index-based loop
     for (size_t idx = 0; idx < ast.size(); idx++) {
-        codegenTLS(ast[idx]);
+        if (idx >= numPreflightDecls) {
+            codegenTLS(ast[idx]);
+        } else if (idx >= partitionBegin && idx < partitionEnd) {
+            ownedFunctions.insert(codegenTLS(ast[idx]));
+        }
     }
     
     for (const auto &[name, decl] : structDecls) {
@@ -226,7 +232,17 @@ void IRGenerator::runCodegen() {
         synthesizeDefaultDeallocMethod(decl, kRunCodegen);
     }
     
-    handleStartupAndShutdownFunctions();
+    if (loweringPartition.count > 1) {
+        for (auto &F : *module) {
+            if (!F.isDeclaration() && F.hasExternalLinkage() && !ownedFunctions.count(&F)) {
+                F.setLinkage(llvm::GlobalValue::LinkOnceODRLinkage);
+            }
+        }
+    }
+    
+    if (loweringPartition.index == 0) {
+        handleStartupAndShutdownFunctions();
+    }
     debugInfo.builder.finalize();
     
 //    for (llvm::Function &F : *module) {
@@ -240,31 +256,31 @@ void IRGenerator::runCodegen() {
 
 
 void IRGenerator::preflight() {
-    std::vector<std::shared_ptr<ast::ImplBlock>> implBlocks;
+    std::vector<ast::ImplBlock *> implBlocks;
     
     for (auto node : ast) {
         switch (node->getKind()) {
             case NK::FunctionDecl: {
                 auto FD = llvm::cast<ast::FunctionDecl>(node);
-                namedDeclInfos[FD->getName()].emplace_back(FD);
+                namedDeclInfos.insert(FD->getName(), FD);
                 break;
             }
                 
             case NK::StructDecl: {
                 auto SD = llvm::cast<ast::StructDecl>(node);
-                namedDeclInfos[SD->getName()].emplace_back(SD);
+                namedDeclInfos.insert(SD->getName(), SD);
                 break;
             }
             
             case NK::VariantDecl: {
                 auto VD = llvm::cast<ast::VariantDecl>(node);
-                namedDeclInfos[VD->name->value].emplace_back(VD);
+                namedDeclInfos.insert(VD->name->value, VD);
                 break;
             }
             
             case NK::TypealiasDecl: {
                 auto TD = llvm::cast<ast::TypealiasDecl>(node);
-                namedDeclInfos[TD->name].emplace_back(TD);
+                namedDeclInfos.insert(TD->name, TD);
                 break;
             }
             
@@ -282,11 +298,9 @@ void IRGenerator::preflight() {
         preflightImplBlock(implBlock);
     }
     
-    for (auto &[name, infos] : namedDeclInfos) {
-        for (auto &info : infos) {
-            registerNamedDecl(info);
-        }
-    }
+    namedDeclInfos.forEach([this](NamedDeclInfo &info) {
+        registerNamedDecl(info);
+    });
 }
 
 
@@ -294,12 +308,12 @@ void IRGenerator::preflight() {
 
 
 
-void ensureTemplateParametersAreDistinct(const ast::TemplateParamDeclList &paramDeclList) {
-    std::vector<std::string> paramNames;
+void ensureTemplateParametersAreDistinct(const lex::SourceManager &sourceManager, const ast::TemplateParamDeclList &paramDeclList) {
+    std::vector<util::Symbol> paramNames;
     
     for (auto &param : paramDeclList.getParams()) {
         if (util::vector::contains(paramNames, param.name->value)) {
-            diagnostics::emitError(paramDeclList.getSourceLocation(), util::fmt::format("duplicate template parameter name '{}'", param.name->value));
+            diagnostics::emitError(sourceManager, paramDeclList.getSourceLocation(), util::fmt::format("duplicate template parameter name '{}'", param.name->value));
         }
         paramNames.push_back(param.name->value);
     }
@@ -310,14 +324,14 @@ void ensureTemplateParametersAreDistinct(const ast::TemplateParamDeclList &param
 // (ie, a struct decl's param list should come before the decl list of one of the struct's member functions)
 // Note: this function assumes that the individual lists are duplicate-free
 // (otherwise, it will still catch these duplicates, but the error message won't really make sense)
-void ensureTemplateParametersDontShadow(std::initializer_list<std::shared_ptr<ast::TemplateParamDeclList>> lists) {
+void ensureTemplateParametersDontShadow(const lex::SourceManager &sourceManager, std::initializer_list<ast::TemplateParamDeclList *> lists) {
     std::vector<ast::TemplateParamDeclList::Param> params;
     
     for (auto &list : lists) {
         for (auto &param : list->getParams()) {
             if (auto prev = util::vector::first_where(params, [&param](auto &P) { return P.name->value == param.name->value; })) {
-                diagnostics::emitNote(prev.value().name->getSourceLocation(), "previously declared here");
-                diagnostics::emitError(param.name->getSourceLocation(),
+                diagnostics::emitNote(sourceManager, prev.value().name->getSourceLocation(), "previously declared here");
+                diagnostics::emitError(sourceManager, param.name->getSourceLocation(),
                                        util::fmt::format("declaration of '{}' shadows template parameter from outer scope", param.name->value));
             } else {
                 params.push_back(param);
@@ -327,22 +341,22 @@ void ensureTemplateParametersDontShadow(std::initializer_list<std::shared_ptr<as
 }
 
 
-void assertIsValidMemberFunction(const ast::FunctionDecl &FD, std::shared_ptr<ast::TemplateParamDeclList> implBlockTemplateParams = nullptr) {
+void assertIsValidMemberFunction(const lex::SourceManager &sourceManager, const ast::FunctionDecl &FD, ast::TemplateParamDeclList *implBlockTemplateParams = nullptr) {
     auto &sig = FD.getSignature();
     auto &attr = FD.getAttributes();
     
     if (attr.no_mangle) {
-        diagnostics::emitError(FD.getSourceLocation(), "type member function cannot have 'no_mangle' attribute");
+        diagnostics::emitError(sourceManager, FD.getSourceLocation(), "type member function cannot have 'no_mangle' attribute");
     }
     
     if (!attr.mangledName.empty()) {
-        diagnostics::emitError(FD.getSourceLocation(), "type member function cannot have explicitly set mangled name");
+        diagnostics::emitError(sourceManager, FD.getSourceLocation(), "type member function cannot have explicitly set mangled name");
     }
     
     if (sig.isTemplateDecl()) {
-        ensureTemplateParametersAreDistinct(*sig.templateParamsDecl);
+        ensureTemplateParametersAreDistinct(sourceManager, *sig.templateParamsDecl);
         if (implBlockTemplateParams) {
-            ensureTemplateParametersDontShadow({implBlockTemplateParams, sig.templateParamsDecl});
+            ensureTemplateParametersDontShadow(sourceManager, {implBlockTemplateParams, sig.templateParamsDecl});
         }
     }
 }
@@ -352,23 +366,23 @@ void assertIsValidMemberFunction(const ast::FunctionDecl &FD, std::shared_ptr<as
 
 
 
-void IRGenerator::preflightImplBlock(std::shared_ptr<ast::ImplBlock> implBlock) {
+void IRGenerator::preflightImplBlock(ast::ImplBlock *implBlock) {
     auto typeDesc = implBlock->typeDesc;
     
     if (typeDesc->isReference()) {
         // TODO is this limitation actually necessary / good?
-        diagnostics::emitError(typeDesc->getSourceLocation(), "impl block type desc cannot be an lvalue reference");
+        diagnostics::emitError(sourceManager, typeDesc->getSourceLocation(), "impl block type desc cannot be an lvalue reference");
     }
     
     if (implBlock->isTemplateDecl()) {
         for (auto &param : implBlock->templateParamsDecl->getParams()) {
             if (param.defaultType) {
-                diagnostics::emitError(param.name->getSourceLocation(), "template parameter in impl block cannot have a default value");
+                diagnostics::emitError(sourceManager, param.name->getSourceLocation(), "template parameter in impl block cannot have a default value");
             }
         }
     }
     
-    auto isInstanceMethod = [](std::shared_ptr<ast::FunctionDecl> decl) -> bool {
+    auto isInstanceMethod = [](ast::FunctionDecl *decl) -> bool {
         const auto &sig = decl->getSignature();
         if (sig.numberOfParameters() == 0) {
             return false;
@@ -383,13 +397,13 @@ void IRGenerator::preflightImplBlock(std::shared_ptr<ast::ImplBlock> implBlock)
     
     for (auto &funcDecl : implBlock->methods) {
         // using a copy is important here so that each function gets its own typedesc, and they don't interfere w/ each other
-        auto implBlockTypeDesc = ASTRewriter().handleTypeDesc(implBlock->typeDesc);
+        auto implBlockTypeDesc = ASTRewriter(astContext).handleTypeDesc(implBlock->typeDesc);
         
         // substitute all uses of `Self` in the function
         // TODO this will mess up functions w/ a template parameter named "Self"
         
         if (isInstanceMethod(funcDecl)) {
-            assertIsValidMemberFunction(*funcDecl, implBlock->templateParamsDecl);
+            assertIsValidMemberFunction(sourceManager, *funcDecl, implBlock->templateParamsDecl);
             
             // TODO this will cause the arrow to be correct, but there should also be a note saying smth like "resolved to xxx" where xxx is the impl block type desc
 //            implBlockTypeDesc->setSourceLocationNested(funcDecl->signature.paramTypes[0]->getPointee()->getSourceLocation);
@@ -397,13 +411,13 @@ void IRGenerator::preflightImplBlock(std::shared_ptr<ast::ImplBlock> implBlock)
             // TODO if this is a type desc which for some reason cannot be resolved, the diag when registering a function will point to the impl block, instead of the func decl
             funcDecl->setFunctionKind(ast::FunctionKind::InstanceMethod);
             
-            funcDecl = ASTRewriter({{ "Self", implBlockTypeDesc }}).handleFunctionDecl(funcDecl);
+            funcDecl = ASTRewriter(astContext, {{ util::Symbol("Self"), implBlockTypeDesc }}).handleFunctionDecl(funcDecl);
             
             if (implBlock->isTemplateDecl()) {
                 funcDecl->hasInsertedImplBlockTemplateParams = true;
                 funcDecl->implBlockTmplParamsStartIndex = funcDecl->signature.numberOfTemplateParameters();
                 if (!funcDecl->getSignature().templateParamsDecl) {
-                    funcDecl->getSignature().templateParamsDecl = std::make_shared<ast::TemplateParamDeclList>();
+                    funcDecl->getSignature().templateParamsDecl = ast::make<ast::TemplateParamDeclList>(astContext);
                 }
                 // TODO ensure there are no duplicates in the tmpl lists!
                 for (const ast::TemplateParamDeclList::Param &param : implBlock->templateParamsDecl->getParams()) {
@@ -416,13 +430,13 @@ void IRGenerator::preflightImplBlock(std::shared_ptr<ast::ImplBlock> implBlock)
             
             funcDecl->setFunctionKind(ast::FunctionKind::StaticMethod);
             util::vector::insert_at_front(funcDecl->signature.paramTypes, implBlockTypeDesc);
-            util::vector::insert_at_front(funcDecl->paramNames, makeIdent("__unused"));
+            util::vector::insert_at_front(funcDecl->paramNames, makeIdent(astContext, "__unused"));
             
             LKAssert(funcDecl->signature.numberOfParameters() > 0);
         }
         
         ast.push_back(funcDecl);
-        namedDeclInfos[mangling::mangleCanonicalName(funcDecl)].emplace_back(funcDecl);
+        namedDeclInfos.insert(mangling::mangleCanonicalName(funcDecl), funcDecl);
     }
 }
 
@@ -437,7 +451,10 @@ void IRGenerator::preflightImplBlock(std::shared_ptr<ast::ImplBlock> implBlock)
 
 // TODO why does this function exist?
 std::optional<ResolvedCallable> IRGenerator::getResolvedFunctionWithName(const std::string &name) {
-    return util::map::get_opt(resolvedFunctions, name);
+    if (auto RC = functions.getWithResolvedName(util::Symbol(name))) {
+        return *RC;
+    }
+    return std::nullopt;
 }
 
 
@@ -447,37 +464,37 @@ std::optional<ResolvedCallable> IRGenerator::getResolvedFunctionWithName(const s
 // TODO move the struct decl stuff to IRGen+Decl.cpp !!
 
 
-StructType* IRGenerator::registerStructDecl(std::shared_ptr<ast::StructDecl> structDecl, NamedDeclInfo &declInfo) {
+StructType* IRGenerator::registerStructDecl(ast::StructDecl *structDecl, NamedDeclInfo &declInfo) {
     declInfo.isRegistered = true;
     
     auto canonicalName = structDecl->name;
     auto structName = structDecl->name;
     
     if (structDecl->attributes.trivial && structDecl->isTemplateDecl()) {
-        diagnostics::emitError(structDecl->getSourceLocation(), "trivial struct cannot be a template");
+        diagnostics::emitError(sourceManager, structDecl->getSourceLocation(), "trivial struct cannot be a template");
         // TODO implement the other checks!!!
     }
     
     if (structDecl->isTemplateDecl()) {
         LKAssert(!structDecl->attributes.no_init && "struct template cannot have no_init attribute");
         
-        ensureTemplateParametersAreDistinct(*structDecl->templateParamsDecl);
+        ensureTemplateParametersAreDistinct(sourceManager, *structDecl->templateParamsDecl);
         
         ast::FunctionSignature ctorSig;
-        ctorSig.returnType = ast::TypeDesc::makeNominalTemplated(structName, util::vector::map(structDecl->templateParamsDecl->getParams(), [](auto &param) {
-            return ast::TypeDesc::makeNominal(param.name->value);
+        ctorSig.returnType = ast::TypeDesc::makeNominalTemplated(astContext, structName, util::vector::map(structDecl->templateParamsDecl->getParams(), [this](auto &param) {
+            return ast::TypeDesc::makeNominal(astContext, param.name->value);
         }));
-        ctorSig.paramTypes.push_back(ASTRewriter().handleTypeDesc(ctorSig.returnType));
-        ctorSig.templateParamsDecl = std::make_shared<ast::TemplateParamDeclList>(*structDecl->templateParamsDecl);
+        ctorSig.paramTypes.push_back(ASTRewriter(astContext).handleTypeDesc(ctorSig.returnType));
+        ctorSig.templateParamsDecl = ast::make<ast::TemplateParamDeclList>(astContext, *structDecl->templateParamsDecl);
         ctorSig.setSourceLocation(structDecl->getSourceLocation());
 
-        auto ctorFnDecl = std::make_shared<ast::FunctionDecl>(ast::FunctionKind::StaticMethod,
+        auto ctorFnDecl = ast::make<ast::FunctionDecl>(astContext, ast::FunctionKind::StaticMethod,
                                                               structName, ctorSig,
-                                                              attributes::FunctionAttributes());
+                                                              attributes::FunctionAttributes(), ast::make<ast::CompoundStmt>(astContext));
         ctorFnDecl->setSourceLocation(structDecl->getSourceLocation());
         ctorFnDecl->getAttributes().int_isCtor = true;
         ctorFnDecl->getAttributes().int_isSynthesized = true;
-        ctorFnDecl->paramNames = { makeIdent("__unused") };
+        ctorFnDecl->paramNames = { makeIdent(astContext, "__unused") };
 
         addToAstAndRegister(ctorFnDecl);
         return nullptr;
@@ -485,7 +502,7 @@ StructType* IRGenerator::registerStructDecl(std::shared_ptr<ast::StructDecl> str
     
     
     
-    structName = mangling::mangleFullyResolved(structDecl);
+    structName = util::Symbol(mangling::mangleFullyResolved(structDecl));
     
     // TODO add a check somewhere here to make sure there are no duplicate struct members
     StructType::MembersT structMembers;
@@ -498,7 +515,7 @@ StructType* IRGenerator::registerStructDecl(std::shared_ptr<ast::StructDecl> str
         structMembers.push_back({ varDecl->getName(), type });
     }
     
-    auto structTy = StructType::create(structName, canonicalName, structMembers, structDecl->templateInstantiationArguments, structDecl->getSourceLocation());
+    auto structTy = StructType::create(typeContext, structName, canonicalName, structMembers, structDecl->templateInstantiationArguments, structDecl->getSourceLocation());
     structDecl->type = structTy;
     if (structDecl->attributes.int_isSynthesized) {
         structTy->setFlag(Type::Flags::IsSynthesized);
@@ -516,19 +533,19 @@ StructType* IRGenerator::registerStructDecl(std::shared_ptr<ast::StructDecl> str
     
     if (!structDecl->attributes.no_init) {
         ast::FunctionSignature signature;
-        signature.paramTypes = { ast::TypeDesc::makeResolved(structTy) };
-        signature.returnType = ast::TypeDesc::makeResolved(structTy);
+        signature.paramTypes = { ast::TypeDesc::makeResolved(astContext, structTy) };
+        signature.returnType = ast::TypeDesc::makeResolved(astContext, structTy);
         signature.setSourceLocation(structDecl->getSourceLocation());
 
         attributes::FunctionAttributes attributes;
         attributes.no_debug_info = structDecl->attributes.no_debug_info;
 
-        auto ctorFnDecl = std::make_shared<ast::FunctionDecl>(ast::FunctionKind::StaticMethod,
-                                                              structName, signature, attributes);
+        auto ctorFnDecl = ast::make<ast::FunctionDecl>(astContext, ast::FunctionKind::StaticMethod,
+                                                              structName, signature, attributes, ast::make<ast::CompoundStmt>(astContext));
         ctorFnDecl->setSourceLocation(structDecl->getSourceLocation());
         ctorFnDecl->getAttributes().int_isCtor = true;
         ctorFnDecl->getAttributes().int_isSynthesized = true;
-        ctorFnDecl->paramNames = { makeIdent("__unused") };
+        ctorFnDecl->paramNames = { makeIdent(astContext, "__unused") };
 
         addToAstAndRegister(ctorFnDecl);
 
@@ -551,7 +568,7 @@ StructType* IRGenerator::registerStructDecl(std::shared_ptr<ast::StructDecl> str
 
 #define CASE(N, T) case NK::T: return codegen##T(llvm::cast<ast::T>(N));
 
-llvm::Value *IRGenerator::codegenTLS(std::shared_ptr<ast::TopLevelStmt> TLS) {
+llvm::Value *IRGenerator::codegenTLS(ast::TopLevelStmt *TLS) {
     switch (TLS->getKind()) {
         CASE(TLS, FunctionDecl)
         
@@ -567,7 +584,7 @@ llvm::Value *IRGenerator::codegenTLS(std::shared_ptr<ast::TopLevelStmt> TLS) {
 }
 
 
-llvm::Value *IRGenerator::codegenLocalStmt(std::shared_ptr<ast::LocalStmt> localStmt) {
+llvm::Value *IRGenerator::codegenLocalStmt(ast::LocalStmt *localStmt) {
     switch (localStmt->getKind()) {
         CASE(localStmt, CompoundStmt)
         CASE(localStmt, VarDecl)
@@ -587,7 +604,7 @@ llvm::Value *IRGenerator::codegenLocalStmt(std::shared_ptr<ast::LocalStmt> local
 #undef CASE
 
 
-llvm::Value *IRGenerator::codegenExpr(std::shared_ptr<ast::Expr> expr, ValueKind VK, bool insertImplicitLoadInst) {
+llvm::Value *IRGenerator::codegenExpr(ast::Expr *expr, ValueKind VK, bool insertImplicitLoadInst) {
 #define CASE(T) case NK::T: V = codegen##T(llvm::cast<ast::T>(expr), VK); break;
     
     llvm::Value *V = nullptr;
@@ -612,15 +629,16 @@ llvm::Value *IRGenerator::codegenExpr(std::shared_ptr<ast::Expr> expr, ValueKind
     }
 #undef CASE
     
-    LKFatalError("");
-//    if (
-//        insertImplicitLoadInst && V && VK == LValue && getType(expr)->isReferenceTy()
-//        && (llvm::isa<llvm::AllocaInst>(V) || llvm::isa<llvm::GetElementPtrInst>(V)) // TODO this line isn't really needed, right?
-//        && V->getType()->isPointerTy() && V->getType()->getPointerElementType() == getType(expr)->getLLVMType()
-//    ) {
-//        LKFatalError("");
-//        V = builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, V);
-//    }
+    // The lvalue of a local variable or struct member of reference type is the location the reference is stored in,
+    // which has to be loaded to get the referenced object's address. (Other reference lvalues, eg pointer subscripts, already are that address)
+    if (insertImplicitLoadInst && V && VK == LValue && getType(expr)->isReferenceTy()) {
+        auto refLLVMTy = getLLVMType(getType(expr));
+        auto alloca = llvm::dyn_cast<llvm::AllocaInst>(V);
+        if ((alloca && alloca->getAllocatedType() == refLLVMTy && expr->isOfKind(NK::Ident))
+            || (llvm::isa<llvm::GetElementPtrInst>(V) && expr->isOfKind(NK::MemberExpr))) {
+            V = builder.CreateLoad(refLLVMTy, V);
+        }
+    }
     return V;
 }
 
@@ -639,8 +657,8 @@ void IRGenerator::handleStartupAndShutdownFunctions() {
     auto imp = [&](llvm::StringRef dest, bool attributes::FunctionAttributes::* attr) {
         std::vector<ResolvedCallable> functions;
 
-        for (const auto &[name, callable] : resolvedFunctions) {
-            if (callable.funcDecl && callable.funcDecl->getAttributes().*attr) {
+        for (const auto &callable : this->functions.getAll()) {
+            if (callable.llvmValue && callable.funcDecl && callable.funcDecl->getAttributes().*attr) {
                 functions.push_back(callable);
             }
         }
@@ -676,7 +694,7 @@ void IRGenerator::handleStartupAndShutdownFunctions() {
 #pragma mark - Allocation & Memory Management
 
 
-llvm::Value* IRGenerator::constructStruct(StructType *structTy, std::shared_ptr<ast::CallExpr> call, bool putInLocalScope, ValueKind VK) {
+llvm::Value* IRGenerator::constructStruct(StructType *structTy, ast::CallExpr *call, bool putInLocalScope, ValueKind VK) {
     emitDebugLocation(call);
     auto alloca = builder.CreateAlloca(getLLVMType(structTy));
     auto ident = currentFunction.getTmpIdent();
@@ -686,17 +704,16 @@ llvm::Value* IRGenerator::constructStruct(StructType *structTy, std::shared_ptr<
                          module->getDataLayout().getTypeAllocSize(alloca->getAllocatedType()),
                          alloca->getAlign());
     
-    auto id = localScope.insert(ident, ValueBinding(structTy, alloca, [=]() {
+    auto id = localScope.insert(util::Symbol(ident), ValueBinding(structTy, alloca, [=]() {
         emitDebugLocation(call);
-        LKFatalError("");
-        return builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, alloca);
+        return builder.CreateLoad(getLLVMType(structTy), alloca);
     }, [=](llvm::Value *V) {
         LKFatalError("use references to write to object?");
     }, ValueBinding::Flags::ReadWrite));
     
     // TODO rewrite to use an rawllvmvalue as self param instead of temporarily inserting this into the local scope!
-    auto callTarget = std::make_shared<ast::MemberExpr>(makeIdent(ident), kInitializerMethodName);
-    auto callExpr = std::make_shared<ast::CallExpr>(*call);
+    auto callTarget = ast::make<ast::MemberExpr>(astContext, makeIdent(astContext, ident), kInitializerMethodName);
+    auto callExpr = ast::make<ast::CallExpr>(astContext, *call);
     callExpr->target = callTarget;
     
     codegenExpr(callExpr);
@@ -711,13 +728,12 @@ llvm::Value* IRGenerator::constructStruct(StructType *structTy, std::shared_ptr<
 //            LKFatalError("why?");
             return alloca;
         case RValue:
-            LKFatalError("");
-            return builder.CreateLoad(/*TODO*/this->builtinTypes.llvm.Void, alloca);
+            return builder.CreateLoad(getLLVMType(structTy), alloca);
     }
 }
 
 
-llvm::Value* IRGenerator::constructCopyIfNecessary(Type *type, std::shared_ptr<ast::Expr> expr, bool *didConstructCopy) {
+llvm::Value* IRGenerator::constructCopyIfNecessary(Type *type, ast::Expr *expr, bool *didConstructCopy) {
     // TODO if we let the lambda mutate `type`, we can get rid of the unpacking below
     auto shouldMakeCopy = [&, type]() mutable -> bool {
         if (isTemporary(expr)) {
@@ -743,7 +759,7 @@ llvm::Value* IRGenerator::constructCopyIfNecessary(Type *type, std::shared_ptr<a
             auto refTy = llvm::cast<ReferenceType>(type);
             structTy = llvm::cast<StructType>(refTy->getReferencedType());
         }
-        auto call = std::make_shared<ast::CallExpr>(nullptr);
+        auto call = ast::make<ast::CallExpr>(astContext, nullptr);
         call->setSourceLocation(expr->getSourceLocation());
         call->arguments = { expr };
         if (didConstructCopy) *didConstructCopy = true;
@@ -757,7 +773,7 @@ llvm::Value* IRGenerator::constructCopyIfNecessary(Type *type, std::shared_ptr<a
 
 llvm::Value* IRGenerator::destructValueIfNecessary(Type *type, llvm::Value *value, bool includeReferences) {
     LKAssert(value->getType()->isPointerTy());
-    auto expr = std::make_shared<ast::RawLLVMValueExpr>(value, type->isReferenceTy() ? type : type->getReferenceTo());
+    auto expr = ast::make<ast::RawLLVMValueExpr>(astContext, value, type->isReferenceTy() ? type : type->getReferenceTo());
     if (auto destructStmt = createDestructStmtIfDefined(type, expr, includeReferences)) {
         return codegenLocalStmt(destructStmt);
     } else {
@@ -765,12 +781,12 @@ llvm::Value* IRGenerator::destructValueIfNecessary(Type *type, llvm::Value *valu
     }
 }
 
-std::shared_ptr<ast::LocalStmt> IRGenerator::createDestructStmtIfDefined(Type *type, llvm::Value *value, bool includeReferences) {
-    auto expr = std::make_shared<ast::RawLLVMValueExpr>(value, type->isReferenceTy() ? type : type->getReferenceTo());
+ast::LocalStmt *IRGenerator::createDestructStmtIfDefined(Type *type, llvm::Value *value, bool includeReferences) {
+    auto expr = ast::make<ast::RawLLVMValueExpr>(astContext, value, type->isReferenceTy() ? type : type->getReferenceTo());
     return createDestructStmtIfDefined(type, expr, includeReferences);
 }
 
-std::shared_ptr<ast::LocalStmt> IRGenerator::createDestructStmtIfDefined(Type *type, std::shared_ptr<ast::Expr> expr, bool includeReferences) {
+ast::LocalStmt *IRGenerator::createDestructStmtIfDefined(Type *type, ast::Expr *expr, bool includeReferences) {
     if (includeReferences && type->isReferenceTy()) {
         type = llvm::cast<ReferenceType>(type)->getReferencedType();
     }
@@ -781,14 +797,14 @@ std::shared_ptr<ast::LocalStmt> IRGenerator::createDestructStmtIfDefined(Type *t
     }
     
     auto canonicalDeallocName = mangling::mangleCanonicalName(ast::FunctionKind::InstanceMethod, kSynthesizedDeallocMethodName);
-    if (!util::map::has_key(functions, canonicalDeallocName)) {
+    if (!functions.contains(canonicalDeallocName)) {
         return nullptr;
     }
     
-    auto callTarget = std::make_shared<ast::MemberExpr>(expr, kSynthesizedDeallocMethodName);
-    auto callExpr = std::make_shared<ast::CallExpr>(callTarget);
+    auto callTarget = ast::make<ast::MemberExpr>(astContext, expr, kSynthesizedDeallocMethodName);
+    auto callExpr = ast::make<ast::CallExpr>(astContext, callTarget);
     callExpr->setSourceLocation(currentFunction.decl->getSourceLocation());
-    auto stmt = std::make_shared<ast::ExprStmt>(callExpr);
+    auto stmt = ast::make<ast::ExprStmt>(astContext, callExpr);
     stmt->setSourceLocation(callExpr->getSourceLocation());
     return stmt;
 }
@@ -797,7 +813,7 @@ std::shared_ptr<ast::LocalStmt> IRGenerator::createDestructStmtIfDefined(Type *t
 void IRGenerator::includeInStackDestruction(Type *type, llvm::Value *value) {
     auto ident = currentFunction.getTmpIdent();
     value->setName(ident);
-    localScope.insert(ident, ValueBinding(type, value, nullptr, nullptr, ValueBinding::Flags::None));
+    localScope.insert(util::Symbol(ident), ValueBinding(type, value, nullptr, nullptr, ValueBinding::Flags::None));
 }
 
 
@@ -833,9 +849,8 @@ llvm::Value* IRGenerator::constructVariant(VariantType *type, const std::string
     
     auto underlyingStructType = llvm::cast<StructType>(type->getUnderlyingType());
     auto alloca = builder.CreateAlloca(getLLVMType(underlyingStructType));
-    LKFatalError("");
-    auto ptr = builder.CreateStructGEP(/*TODO*/this->builtinTypes.llvm.Void, alloca, 0);
-    auto TagType = llvm::cast<llvm::IntegerType>(getLLVMType(underlyingStructType->getMember("__index").second)); // todo extract __index into a global constant!
+    auto ptr = builder.CreateStructGEP(getLLVMType(underlyingStructType), alloca, 0);
+    auto TagType = llvm::cast<llvm::IntegerType>(getLLVMType(underlyingStructType->getMember(util::Symbol("__index")).second)); // todo extract __index into a global constant!
     builder.CreateStore(llvm::ConstantInt::get(TagType, tagValue), ptr);
     return alloca;
 }
@@ -869,7 +884,7 @@ Type* IRGenerator::resolvePrimitiveType(std::string_view name) {
 
 // Attempts to resolve an AST TypeDesc and returns a unique `yo::Type*` pointer.
 // Also creates the `yo::Type`'s `llvm::Type` and `llvm::DIType` and sets the respective member fields
-Type* IRGenerator::resolveTypeDesc(std::shared_ptr<ast::TypeDesc> typeDesc, bool setInternalResolvedType) {
+Type* IRGenerator::resolveTypeDesc(ast::TypeDesc *typeDesc, bool setInternalResolvedType) {
     // HUGE FUCKING PROBLEM: typedescs should be resolved in the context which they were declared, not the one in which they might be used
     // (this isn't that big an issue rn, but might become in the future)
     // ^ Update: this is pretty much fixed now?
@@ -895,7 +910,7 @@ Type* IRGenerator::resolveTypeDesc(std::shared_ptr<ast::TypeDesc> typeDesc, bool
     }
     
     if (typeDesc->isReference() && typeDesc->getPointee()->isReference()) {
-        diagnostics::emitError(typeDesc->getSourceLocation(), "reference type cannot have indirection count > 1");
+        diagnostics::emitError(sourceManager, typeDesc->getSourceLocation(), "reference type cannot have indirection count > 1");
     }
     
     switch (typeDesc->getKind()) {
@@ -910,7 +925,7 @@ Type* IRGenerator::resolveTypeDesc(std::shared_ptr<ast::TypeDesc> typeDesc, bool
             
             } else {
                 // a nominal, non-primitive type
-                registerNamedDecls(name, [](const std::shared_ptr<ast::TopLevelStmt> &decl) -> bool {
+                registerNamedDecls(name, [](ast::TopLevelStmt *decl) -> bool {
                     // we're trying to resolve a nominal type, therefore we can ignore function decls in here
                     return !decl->isOfKind(NK::FunctionDecl);
                 });
@@ -919,7 +934,7 @@ Type* IRGenerator::resolveTypeDesc(std::shared_ptr<ast::TypeDesc> typeDesc, bool
                     return handleResolvedTy(*entry);
                 }
                 
-                diagnostics::emitError(typeDesc->getSourceLocation(), util::fmt::format("unable to resolve nominal type '{}'", name));
+                diagnostics::emitError(sourceManager, typeDesc->getSourceLocation(), util::fmt::format("unable to resolve nominal type '{}'", name));
             }
             break;
         }
@@ -933,7 +948,7 @@ Type* IRGenerator::resolveTypeDesc(std::shared_ptr<ast::TypeDesc> typeDesc, bool
             auto resolvedMembers = util::vector::map(typeDesc->getTupleMembers(), [&](auto &TD) -> Type* {
                 return resolveTypeDesc(TD, setInternalResolvedType);
             });
-            return handleResolvedTy(TupleType::get(resolvedMembers));
+            return handleResolvedTy(TupleType::get(typeContext, resolvedMembers));
         }
         
         case TDK::Function: {
@@ -942,47 +957,44 @@ Type* IRGenerator::resolveTypeDesc(std::shared_ptr<ast::TypeDesc> typeDesc, bool
             const auto paramTypes = util::vector::map(FTI.parameterTypes, [&](const auto &TD) {
                 return resolveTypeDesc(TD, setInternalResolvedType);
             });
-            return handleResolvedTy(FunctionType::get(resolveTypeDesc(FTI.returnType, setInternalResolvedType), paramTypes, false)); // TODO add support for variadics!!
+            return handleResolvedTy(FunctionType::get(typeContext, resolveTypeDesc(FTI.returnType, setInternalResolvedType), paramTypes, false)); // TODO add support for variadics!!
         }
         
         case TDK::Decltype:
             return handleResolvedTy(getType(typeDesc->getDecltypeExpr()));
         
         case TDK::NominalTemplated: {
-            registerNamedDecls(typeDesc->getName(), [](const std::shared_ptr<ast::TopLevelStmt> &decl) -> bool {
+            registerNamedDecls(typeDesc->getName(), [](ast::TopLevelStmt *decl) -> bool {
                 return !decl->isOfKind(NK::FunctionDecl);
             });
             
-            llvm::SmallVector<std::shared_ptr<ast::TopLevelStmt>, 2> matchingDecls;
+            llvm::SmallVector<ast::TopLevelStmt *, 2> matchingDecls;
             
-            for (const auto &[name, declInfos] : namedDeclInfos) {
-                if (name != typeDesc->getName()) continue;
-                for (const NamedDeclInfo &DI : declInfos) {
-                    switch (DI.decl->getKind()) {
-                        case NK::StructDecl:
-                            if (llvm::cast<ast::StructDecl>(DI.decl)->isInstantiatedTemplateDecl()) {
-                                continue;
-                            }
-                            break;
-                        case NK::VariantDecl:
-                            if (llvm::cast<ast::VariantDecl>(DI.decl)->isInstantiatedTemplateDecl()) {
-                                continue;
-                            }
-                            break;
-                        default:
+            for (const NamedDeclInfo *DI : namedDeclInfos.lookup(typeDesc->getName())) {
+                switch (DI->decl->getKind()) {
+                    case NK::StructDecl:
+                        if (llvm::cast<ast::StructDecl>(DI->decl)->isInstantiatedTemplateDecl()) {
                             continue;
-                    }
-                    matchingDecls.push_back(DI.decl);
+                        }
+                        break;
+                    case NK::VariantDecl:
+                        if (llvm::cast<ast::VariantDecl>(DI->decl)->isInstantiatedTemplateDecl()) {
+                            continue;
+                        }
+                        break;
+                    default:
+                        continue;
                 }
+                matchingDecls.push_back(DI->decl);
             }
             if (matchingDecls.size() == 0) {
-                diagnostics::emitError(typeDesc->getSourceLocation(), "unable to resolve type");
+                diagnostics::emitError(sourceManager, typeDesc->getSourceLocation(), "unable to resolve type");
             } else if (matchingDecls.size() > 1) {
                 LKFatalError("multiple matching types?");
             }
             LKAssert(matchingDecls.size() == 1);
             
-            auto argsList = std::make_shared<ast::TemplateParamArgList>();
+            auto argsList = ast::make<ast::TemplateParamArgList>(astContext);
             argsList->setSourceLocation(typeDesc->getSourceLocation());
             argsList->elements = util::vector::map(typeDesc->getTemplateArgs(), [&](auto &tmplArg) {
                 resolveTypeDesc(tmplArg, setInternalResolvedType);
@@ -1037,10 +1049,10 @@ bool IRGenerator::equal(const ast::FunctionSignature &lhs, const ast::FunctionSi
 
 
 llvm::Type *IRGenerator::getLLVMType(Type *type) {
-    if (auto T = type->getLLVMType()) return T;
+    if (auto T = util::map::get_opt(llvmTypes, type)) return *T;
     
-    auto handle_llvm_type = [type](llvm::Type *llvmTy) -> llvm::Type* {
-        type->setLLVMType(llvmTy);
+    auto handle_llvm_type = [this, type](llvm::Type *llvmTy) -> llvm::Type* {
+        llvmTypes[type] = llvmTy;
         return llvmTy;
     };
     
@@ -1099,11 +1111,7 @@ llvm::Type *IRGenerator::getLLVMType(Type *type) {
         
         case Type::TypeID::Tuple: {
             auto tupleTy = llvm::cast<TupleType>(type);
-            if (auto ST = tupleTy->getUnderlyingStructType()) {
-                return handle_llvm_type(getLLVMType(ST));
-            } else {
-                return handle_llvm_type(getLLVMType(synthesizeUnderlyingStructTypeForTupleType(tupleTy)));
-            }
+            return handle_llvm_type(getLLVMType(synthesizeUnderlyingStructTypeForTupleType(tupleTy)));
         }
         
         case Type::TypeID::Function: {
@@ -1142,12 +1150,12 @@ llvm::Type *IRGenerator::getLLVMType(Type *type) {
 
 
 llvm::DIType* IRGenerator::getDIType(Type *type) {
-    if (auto ty = type->getLLVMDIType()) {
-        return ty;
+    if (auto ty = util::map::get_opt(llvmDITypes, type)) {
+        return *ty;
     }
     
-    auto handle_di_type = [type](llvm::DIType *diType) -> llvm::DIType* {
-        type->setLLVMDIType(diType);
+    auto handle_di_type = [this, type](llvm::DIType *diType) -> llvm::DIType* {
+        llvmDITypes[type] = diType;
         return diType;
     };
     
@@ -1216,7 +1224,7 @@ llvm::DIType* IRGenerator::getDIType(Type *type) {
             };
             
             if (auto ST = llvm::dyn_cast<StructType>(type)) {
-                scope = DIFileForSourceLocation(builder, ST->getSourceLocation());
+                scope = DIFileForSourceLocation(builder, sourceManager, ST->getSourceLocation());
                 for (size_t idx = 0; idx < ST->memberCount(); idx++) {
                     const auto &[name, type] = ST->getMembers()[idx];
                     registerMember(idx, name, getLLVMType(type), getDIType(type), llvm::cast<llvm::DIFile>(scope), 0 /* TODO struct member line number? */);
@@ -1233,7 +1241,7 @@ llvm::DIType* IRGenerator::getDIType(Type *type) {
             }
             
             auto ty = builder.createStructType(scope, type->str_desc(), type->isStructTy() ? llvm::cast<llvm::DIFile>(scope) : nullptr,
-                                               type->isStructTy() ? llvm::cast<StructType>(type)->getSourceLocation().getLine() : 0,
+                                               type->isStructTy() ? sourceManager.getLine(llvm::cast<StructType>(type)->getSourceLocation()) : 0,
                                                DL.getTypeSizeInBits(llvmStructTy), DL.getPrefTypeAlignment(llvmStructTy),
                                                llvm::DINode::DIFlags::FlagZero, /*derivedFrom*/ nullptr, builder.getOrCreateArray(llvmMembers));
             return handle_di_type(ty);
@@ -1272,9 +1280,9 @@ llvm::DISubroutineType* IRGenerator::toDISubroutineType(const ast::FunctionSigna
     std::vector<llvm::Metadata *>types;
     types.reserve(signature.numberOfParameters() + 1);
     
-    types.push_back(resolveTypeDesc(signature.returnType)->getLLVMDIType());
+    types.push_back(getDIType(resolveTypeDesc(signature.returnType)));
     for (const auto& paramTy : signature.paramTypes) {
-        types.push_back(resolveTypeDesc(paramTy)->getLLVMDIType());
+        types.push_back(getDIType(resolveTypeDesc(paramTy)));
     }
     return debugInfo.builder.createSubroutineType(debugInfo.builder.getOrCreateTypeArray(types));
 }
@@ -1283,7 +1291,7 @@ llvm::DISubroutineType* IRGenerator::toDISubroutineType(const ast::FunctionSigna
 
 
 
-bool IRGenerator::valueIsTriviallyConvertible(std::shared_ptr<ast::NumberLiteral> numberExpr, Type *dstTy) {
+bool IRGenerator::valueIsTriviallyConvertible(ast::NumberLiteral *numberExpr, Type *dstTy) {
     // TODO is this function strict enough?
     using NT = ast::NumberLiteral::NumberType;
     
@@ -1328,16 +1336,16 @@ bool IRGenerator::valueIsTriviallyConvertible(std::shared_ptr<ast::NumberLiteral
 
 
 
-bool IRGenerator::applyImplicitConversionIfNecessary(std::shared_ptr<ast::Expr> &expr, Type *dstTy) {
+bool IRGenerator::applyImplicitConversionIfNecessary(ast::Expr *&expr, Type *dstTy) {
     auto srcTy = getType(expr);
     
     if (srcTy == dstTy) {
         return true;
     }
     
-    auto wrapInStaticCast = [](std::shared_ptr<ast::Expr> expr, Type *type) {
+    auto wrapInStaticCast = [this](ast::Expr *expr, Type *type) {
         auto loc = expr->getSourceLocation();
-        auto ret = std::make_shared<ast::CastExpr>(expr, ast::TypeDesc::makeResolved(type), ast::CastExpr::CastKind::StaticCast);
+        auto ret = ast::make<ast::CastExpr>(astContext, expr, ast::TypeDesc::makeResolved(astContext, type), ast::CastExpr::CastKind::StaticCast);
         ret->setSourceLocation(loc);
         return ret;
     };
@@ -1369,7 +1377,25 @@ bool IRGenerator::applyImplicitConversionIfNecessary(std::shared_ptr<ast::Expr>
 
 
 
-Type* IRGenerator::getType(std::shared_ptr<ast::Expr> expr) {
+// The type is cached, and only recomputed if the local scope or the nominal types changed since
+Type* IRGenerator::getType(ast::Expr *expr) {
+    auto localScopeState = localScope.getStateToken();
+    auto nominalTypesState = nominalTypes.getStateToken();
+    
+    if (auto it = resolvedExprTypes.find(expr); it != resolvedExprTypes.end()) {
+        auto &cached = it->second;
+        if (cached.localScopeState == localScopeState && cached.nominalTypesState == nominalTypesState) {
+            return cached.type;
+        }
+    }
+    
+    auto type = getType_imp(expr);
+    resolvedExprTypes.insert_or_assign(expr, ResolvedExprType{ localScopeState, nominalTypesState, type });
+    return type;
+}
+
+
+Type* IRGenerator::getType_imp(ast::Expr *expr) {
     switch (expr->getKind()) {
         case NK::NumberLiteral: {
             using NT = ast::NumberLiteral::NumberType;
@@ -1388,10 +1414,10 @@ Type* IRGenerator::getType(std::shared_ptr<ast::Expr> expr) {
                 case SLK::ByteString:
                     return builtinTypes.yo.i8Ptr;
                 case SLK::NormalString: {
-                    if (auto StringTy = nominalTypes.get("String")) {
+                    if (auto StringTy = nominalTypes.get(util::Symbol("String"))) {
                         return *StringTy;
                     } else {
-                        diagnostics::emitError(expr->getSourceLocation(), "unable to find 'String' type");
+                        diagnostics::emitError(sourceManager, expr->getSourceLocation(), "unable to find 'String' type");
                     }
                 }
             }
@@ -1402,14 +1428,14 @@ Type* IRGenerator::getType(std::shared_ptr<ast::Expr> expr) {
             if (auto binding = localScope.get(identExpr->value)) {
                 return binding->type;
             } else {
-                diagnostics::emitError(identExpr->getSourceLocation(), util::fmt::format("unable to resolve identifier '{}'", identExpr->value));
+                diagnostics::emitError(sourceManager, identExpr->getSourceLocation(), util::fmt::format("unable to resolve identifier '{}'", identExpr->value));
             }
         }
         
         case NK::ArrayLiteralExpr: {
             auto literal = llvm::cast<ast::ArrayLiteralExpr>(expr);
             if (literal->elements.empty()) {
-                diagnostics::emitError(literal->getSourceLocation(), "unable to deduce type from empty array literal");
+                diagnostics::emitError(sourceManager, literal->getSourceLocation(), "unable to deduce type from empty array literal");
             }
             return getType(literal->elements.front());
         }
@@ -1471,14 +1497,8 @@ Type* IRGenerator::getType(std::shared_ptr<ast::Expr> expr) {
             return builtinTypes.yo.Bool;
         
         case NK::BinOp: {
-            auto binopExpr = llvm::cast<ast::BinOp>(expr);
-            auto mangledCanonicalName = mangling::mangleCanonicalName(binopExpr->getOperator());
-//            auto mangledCanonicalName = mangling::encodeOperator(binopExpr->getOperator());
-            // TODO don't allocate an object for every check!
-            auto tempCallExpr = std::make_shared<ast::CallExpr>(makeIdent(mangledCanonicalName),
-                                                                std::vector<std::shared_ptr<ast::Expr>>{ binopExpr->getLhs(), binopExpr->getRhs() });
-            tempCallExpr->setSourceLocation(binopExpr->getSourceLocation());
-            return resolveTypeDesc(resolveCall(tempCallExpr, kSkipCodegen).signature.returnType);
+            auto callExpr = getCallExprForBinOp(llvm::cast<ast::BinOp>(expr));
+            return resolveTypeDesc(resolveCall(callExpr, kSkipCodegen).signature.returnType);
         }
         
         case NK::LambdaExpr: {
@@ -1489,7 +1509,7 @@ Type* IRGenerator::getType(std::shared_ptr<ast::Expr> expr) {
         case NK::TupleExpr: {
             auto tupleExpr = llvm::cast<ast::TupleExpr>(expr);
             auto elementTys = util::vector::map(tupleExpr->elements, [&](auto E) { return getType(E); });
-            return TupleType::get(elementTys);
+            return TupleType::get(typeContext, elementTys);
         }
         
         default:
@@ -1502,7 +1522,7 @@ Type* IRGenerator::getType(std::shared_ptr<ast::Expr> expr) {
 
 
 // Whether the expression evaluates to a temporary value. ??This implies that `expr` cannot become an lvalue (except for references, of course)??
-bool IRGenerator::isTemporary(std::shared_ptr<ast::Expr> expr) {
+bool IRGenerator::isTemporary(ast::Expr *expr) {
     // TODO this seems way too simple?
     // TODO what about ast::RawLLVMValueExpr?
     auto ty = getType(expr);
@@ -1545,17 +1565,25 @@ bool IRGenerator::typeIsDestructible(Type *type) {
 
 
 template <typename T>
-Type* IRGenerator::instantiateTemplateDecl(const std::shared_ptr<T> &decl, const std::shared_ptr<ast::TemplateParamArgList> &tmplArgs) {
+Type* IRGenerator::instantiateTemplateDecl(T *decl, ast::TemplateParamArgList *tmplArgs) {
     LKAssert(decl->isTemplateDecl());
     
     TemplateTypeMapping tmplMapping = resolveTemplateDeclTemplateParamsFromExplicitArgs(decl, tmplArgs, false);
     
-    std::shared_ptr<T> specDecl;
+    TemplateInstantiationKey instantiationKey(decl, tmplMapping);
+    bool isCacheable = !instantiationKey.hasTemporaryArgs();
+    if (isCacheable) {
+        if (auto ty = util::map::get_opt(typeTemplateInstantiations, instantiationKey)) {
+            return *ty;
+        }
+    }
+    
+    T *specDecl = nullptr;
     
     if constexpr(std::is_same_v<T, ast::StructDecl>) {
-        specDecl = ASTRewriter(tmplMapping).handleStructDecl(decl);
+        specDecl = ASTRewriter(astContext, tmplMapping).handleStructDecl(decl);
     } else if constexpr(std::is_same_v<T, ast::VariantDecl>) {
-        specDecl = ASTRewriter(tmplMapping).handleVariantDecl(decl);
+        specDecl = ASTRewriter(astContext, tmplMapping).handleVariantDecl(decl);
     } else {
         static_assert(util::always_false_v<T>);
     }
@@ -1568,18 +1596,21 @@ Type* IRGenerator::instantiateTemplateDecl(const std::shared_ptr<T> &decl, const
     }
     
     auto mangledName = mangling::mangleFullyResolved(specDecl);
-    bool isTemporary = util::map::contains_where(tmplMapping, [](const std::string &name, const std::shared_ptr<ast::TypeDesc> &TD) -> bool {
+    bool isTemporary = util::map::contains_where(tmplMapping, [](const std::string &name, ast::TypeDesc *TD) -> bool {
         return TD->getResolvedType() && TD->getResolvedType()->hasFlag(Type::Flags::IsTemporary);
     });
     if (isTemporary) {
-        return Type::createTemporary(mangledName, specDecl->getName(), specDecl->templateInstantiationArguments);
+        return Type::createTemporary(typeContext, mangledName, specDecl->getName(), specDecl->templateInstantiationArguments);
     }
     
-    if (auto ty = nominalTypes.get(mangledName)) {
-        return *ty;
+    Type *type = nullptr;
+    if (auto ty = nominalTypes.get(util::Symbol(mangledName))) {
+        type = *ty;
+    } else {
+        type = addToAstAndRegister(specDecl);
     }
-    
-    return addToAstAndRegister(specDecl);
+    typeTemplateInstantiations.emplace(std::move(instantiationKey), type);
+    return type;
 }
 
 
@@ -1596,25 +1627,25 @@ Type* IRGenerator::instantiateTemplateDecl(const std::shared_ptr<T> &decl, const
 // TODO there's a lot of duplicate code in the functions below!
 
 
-StructType* IRGenerator::synth_getStructDeclStructType(const std::shared_ptr<ast::StructDecl> &decl) {
+StructType* IRGenerator::synth_getStructDeclStructType(ast::StructDecl *decl) {
     if (auto ty = decl->type) {
         return ty;
     } else if (decl->isInstantiatedTemplateDecl()) {
-        return llvm::cast<StructType>(*nominalTypes.get(mangling::mangleFullyResolved(decl)));
+        return llvm::cast<StructType>(*nominalTypes.get(util::Symbol(mangling::mangleFullyResolved(decl))));
     } else {
         return llvm::cast<StructType>(*nominalTypes.get(decl->name));
     }
 }
 
 
-bool IRGenerator::memberFunctionCallResolves(Type *targetTy, const std::string &name, const std::vector<Type *> &argTys) {
-    auto expr_for_type = [](Type *type) {
-        return std::make_shared<ast::RawLLVMValueExpr>(nullptr, type);
+bool IRGenerator::memberFunctionCallResolves(Type *targetTy, util::Symbol name, const std::vector<Type *> &argTys) {
+    auto expr_for_type = [this](Type *type) {
+        return ast::make<ast::RawLLVMValueExpr>(astContext, nullptr, type);
     };
     
-    auto target = std::make_shared<ast::MemberExpr>(expr_for_type(targetTy), name);
-    auto call = std::make_shared<ast::CallExpr>(target);
-    call->arguments = util::vector::map(argTys, [&](Type *type) -> std::shared_ptr<ast::Expr> {
+    auto target = ast::make<ast::MemberExpr>(astContext, expr_for_type(targetTy), name);
+    auto call = ast::make<ast::CallExpr>(astContext, target);
+    call->arguments = util::vector::map(argTys, [&](Type *type) -> ast::Expr *{
         return expr_for_type(type);
     });
     return canResolveCall(call);
@@ -1622,7 +1653,7 @@ bool IRGenerator::memberFunctionCallResolves(Type *targetTy, const std::string &
 
 
 
-llvm::Value* IRGenerator::synthesizeDefaultMemberwiseInitializer(std::shared_ptr<ast::StructDecl> structDecl, SkipCodegenOption codegenOption) {
+llvm::Value* IRGenerator::synthesizeDefaultMemberwiseInitializer(ast::StructDecl *structDecl, SkipCodegenOption codegenOption) {
     // TODO set the source location for all nodes generated in here!
         
     const auto &SL = structDecl->getSourceLocation();
@@ -1643,39 +1674,39 @@ llvm::Value* IRGenerator::synthesizeDefaultMemberwiseInitializer(std::shared_ptr
     }
     
     
-    auto selfIdent = makeIdent("self", SL);
+    auto selfIdent = makeIdent(astContext, "self", SL);
     
     ast::FunctionSignature sig;
-    std::vector<std::shared_ptr<ast::Ident>> paramNames;
+    std::vector<ast::Ident *> paramNames;
     attributes::FunctionAttributes attr;
     
     attr.no_debug_info = structDecl->attributes.no_debug_info;
     attr.int_isFwdDecl = true;
     attr.int_isSynthesized = true;
     sig.setSourceLocation(SL);
-    sig.returnType = ast::TypeDesc::makeResolved(builtinTypes.yo.Void);
+    sig.returnType = ast::TypeDesc::makeResolved(astContext, builtinTypes.yo.Void);
     sig.paramTypes.reserve(ST->memberCount() + 1);
-    sig.paramTypes.push_back(ast::TypeDesc::makeResolved(ST->getReferenceTo()));
+    sig.paramTypes.push_back(ast::TypeDesc::makeResolved(astContext, ST->getReferenceTo()));
     
     paramNames.reserve(ST->memberCount() + 1);
     paramNames.push_back(selfIdent);
     
     util::vector::iteri(SM, [&](uint64_t idx, const std::pair<std::string, Type *> &elem) -> void {
-        sig.paramTypes.push_back(ast::TypeDesc::makeResolved(elem.second, SL));
-        paramNames.push_back(makeIdent(util::fmt::format("__arg{}", idx), SL));
+        sig.paramTypes.push_back(ast::TypeDesc::makeResolved(astContext, elem.second, SL));
+        paramNames.push_back(makeIdent(astContext, util::fmt::format("__arg{}", idx), SL));
     });
     
-    auto FD = std::make_shared<ast::FunctionDecl>(ast::FunctionKind::InstanceMethod, kInitializerMethodName, sig, attr);
+    auto FD = ast::make<ast::FunctionDecl>(astContext, ast::FunctionKind::InstanceMethod, kInitializerMethodName, sig, attr, ast::make<ast::CompoundStmt>(astContext));
     FD->setParamNames(paramNames);
     FD->setSourceLocation(SL);
     
-    auto body = std::make_shared<ast::CompoundStmt>();
+    auto body = ast::make<ast::CompoundStmt>(astContext);
     body->setSourceLocation(SL);
     
     for (uint64_t idx = 0; idx < SM.size(); idx++) {
-        auto target = std::make_shared<ast::MemberExpr>(selfIdent, SM.at(idx).first);
+        auto target = ast::make<ast::MemberExpr>(astContext, selfIdent, util::Symbol(SM.at(idx).first));
         target->setSourceLocation(SL);
-        auto A = std::make_shared<ast::Assignment>(target, paramNames.at(idx + 1));
+        auto A = ast::make<ast::Assignment>(astContext, target, paramNames.at(idx + 1));
         A->shouldDestructOldValue = false;
         A->overwriteReferences = true;
         A->setSourceLocation(SL);
@@ -1695,7 +1726,7 @@ llvm::Value* IRGenerator::synthesizeDefaultMemberwiseInitializer(std::shared_ptr
 
 
 
-llvm::Value* IRGenerator::synthesizeDefaultCopyConstructor(std::shared_ptr<ast::StructDecl> structDecl, SkipCodegenOption codegenOption) {
+llvm::Value* IRGenerator::synthesizeDefaultCopyConstructor(ast::StructDecl *structDecl, SkipCodegenOption codegenOption) {
     auto &SL = structDecl->getSourceLocation();
     auto ST = synth_getStructDeclStructType(structDecl);
     auto &SM = ST->getMembers();
@@ -1706,38 +1737,38 @@ llvm::Value* IRGenerator::synthesizeDefaultCopyConstructor(std::shared_ptr<ast::
     }
     
     ast::FunctionSignature sig;
-    std::vector<std::shared_ptr<ast::Ident>> paramNames;
+    std::vector<ast::Ident *> paramNames;
     attributes::FunctionAttributes attr;
     
     attr.no_debug_info = structDecl->attributes.no_debug_info;
     attr.int_isFwdDecl = true;
     attr.int_isSynthesized = true;
     sig.setSourceLocation(SL);
-    sig.returnType = ast::TypeDesc::makeResolved(builtinTypes.yo.Void);
-    sig.paramTypes.push_back(ast::TypeDesc::makeResolved(ST->getReferenceTo()));
-    sig.paramTypes.push_back(ast::TypeDesc::makeResolved(ST->getReferenceTo()));
+    sig.returnType = ast::TypeDesc::makeResolved(astContext, builtinTypes.yo.Void);
+    sig.paramTypes.push_back(ast::TypeDesc::makeResolved(astContext, ST->getReferenceTo()));
+    sig.paramTypes.push_back(ast::TypeDesc::makeResolved(astContext, ST->getReferenceTo()));
     
-    auto selfIdent = makeIdent("self", SL);
-    auto arg0Ident = makeIdent("__arg0", SL);
+    auto selfIdent = makeIdent(astContext, "self", SL);
+    auto arg0Ident = makeIdent(astContext, "__arg0", SL);
     
     paramNames.push_back(selfIdent);
     paramNames.push_back(arg0Ident);
     
-    auto FD = std::make_shared<ast::FunctionDecl>(ast::FunctionKind::InstanceMethod, kInitializerMethodName, sig, attr);
+    auto FD = ast::make<ast::FunctionDecl>(astContext, ast::FunctionKind::InstanceMethod, kInitializerMethodName, sig, attr, ast::make<ast::CompoundStmt>(astContext));
     FD->setParamNames(paramNames);
     FD->setSourceLocation(SL);
     
     
-    auto body = std::make_shared<ast::CompoundStmt>();
+    auto body = ast::make<ast::CompoundStmt>(astContext);
     body->setSourceLocation(SL);
     
     for (uint64_t idx = 0; idx < SM.size(); idx++) {
-        auto &memberName = SM.at(idx).first;
-        auto lhs = std::make_shared<ast::MemberExpr>(selfIdent, memberName);
+        auto memberName = util::Symbol(SM.at(idx).first);
+        auto lhs = ast::make<ast::MemberExpr>(astContext, selfIdent, memberName);
         lhs->setSourceLocation(SL);
-        auto rhs = std::make_shared<ast::MemberExpr>(arg0Ident, memberName);
+        auto rhs = ast::make<ast::MemberExpr>(astContext, arg0Ident, memberName);
         rhs->setSourceLocation(SL);
-        auto ass = std::make_shared<ast::Assignment>(lhs, rhs);
+        auto ass = ast::make<ast::Assignment>(astContext, lhs, rhs);
         ass->setSourceLocation(SL);
         ass->shouldDestructOldValue = false;
         ass->overwriteReferences = true;
@@ -1757,38 +1788,38 @@ llvm::Value* IRGenerator::synthesizeDefaultCopyConstructor(std::shared_ptr<ast::
 
 
 
-llvm::Value* IRGenerator::synthesizeDefaultDeallocMethod(std::shared_ptr<ast::StructDecl> structDecl, SkipCodegenOption codegenOption) {
+llvm::Value* IRGenerator::synthesizeDefaultDeallocMethod(ast::StructDecl *structDecl, SkipCodegenOption codegenOption) {
     auto &SL = structDecl->getSourceLocation();
     auto ST = synth_getStructDeclStructType(structDecl);
     auto &SM = ST->getMembers();
     
-    auto selfIdent = makeIdent("self", SL);
+    auto selfIdent = makeIdent(astContext, "self", SL);
     
     ast::FunctionSignature sig;
     attributes::FunctionAttributes attr;
-    std::vector<std::shared_ptr<ast::Ident>> paramNames = { selfIdent };
+    std::vector<ast::Ident *> paramNames = { selfIdent };
     
     attr.no_debug_info = structDecl->attributes.no_debug_info;
     attr.int_isFwdDecl = true;
     attr.int_isSynthesized = true;
-    sig.returnType = ast::TypeDesc::makeResolved(builtinTypes.yo.Void);
-    sig.paramTypes = { ast::TypeDesc::makeResolved(ST->getReferenceTo()) };
+    sig.returnType = ast::TypeDesc::makeResolved(astContext, builtinTypes.yo.Void);
+    sig.paramTypes = { ast::TypeDesc::makeResolved(astContext, ST->getReferenceTo()) };
     
-    auto FD = std::make_shared<ast::FunctionDecl>(ast::FunctionKind::InstanceMethod, kSynthesizedDeallocMethodName, sig, attr);
+    auto FD = ast::make<ast::FunctionDecl>(astContext, ast::FunctionKind::InstanceMethod, kSynthesizedDeallocMethodName, sig, attr, ast::make<ast::CompoundStmt>(astContext));
     FD->setParamNames(paramNames);
     FD->setSourceLocation(SL);
     
-    auto body = std::make_shared<ast::CompoundStmt>();
+    auto body = ast::make<ast::CompoundStmt>(astContext);
     body->setSourceLocation(SL);
     
     
-//    auto callExpr = std::make_shared<ast::CallExpr>(makeIdent("printf", SL));
+//    auto callExpr = ast::make<ast::CallExpr>(astContext, makeIdent(astContext, "printf", SL));
 //    callExpr->setSourceLocation(SL);
 //    callExpr->arguments = {
-//        std::make_shared<ast::StringLiteral>(util::fmt::format("[{} __dealloc]\n", ST->getName()), ast::StringLiteral::StringLiteralKind::ByteString)
+//        ast::make<ast::StringLiteral>(astContext, util::fmt::format("[{} __dealloc]\n", ST->getName()), ast::StringLiteral::StringLiteralKind::ByteString)
 //    };
 //    callExpr->arguments[0]->setSourceLocation(SL);
-//    auto EStmt = std::make_shared<ast::ExprStmt>(callExpr);
+//    auto EStmt = ast::make<ast::ExprStmt>(astContext, callExpr);
 //    EStmt->setSourceLocation(SL);
 //    body->statements.push_back(EStmt);
     
@@ -1798,9 +1829,9 @@ llvm::Value* IRGenerator::synthesizeDefaultDeallocMethod(std::shared_ptr<ast::St
         auto setSL = [&SL](auto node) {
             node->setSourceLocation(SL);
         };
-        auto target = std::make_shared<ast::MemberExpr>(selfIdent, kDeallocMethodName);
-        auto call = std::make_shared<ast::CallExpr>(target);
-        auto stmt = std::make_shared<ast::ExprStmt>(call);
+        auto target = ast::make<ast::MemberExpr>(astContext, selfIdent, kDeallocMethodName);
+        auto call = ast::make<ast::CallExpr>(astContext, target);
+        auto stmt = ast::make<ast::ExprStmt>(astContext, call);
         body->statements.push_back(stmt);
         setSL(target);
         setSL(call);
@@ -1812,7 +1843,7 @@ llvm::Value* IRGenerator::synthesizeDefaultDeallocMethod(std::shared_ptr<ast::St
     
     // Destruct all members
     for (const auto &[name, type] : SM) {
-        auto memberAccess = std::make_shared<ast::MemberExpr>(selfIdent, name);
+        auto memberAccess = ast::make<ast::MemberExpr>(astContext, selfIdent, util::Symbol(name));
         if (auto stmt = createDestructStmtIfDefined(type, memberAccess, /*includeReferences*/ false)) {
             body->statements.push_back(stmt);
         }
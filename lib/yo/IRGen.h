@@ -9,6 +9,7 @@
 #pragma once
 
 #include "lex/SourceLocation.h"
+#include "lex/SourceManager.h"
 #include "parse/AST.h"
 #include "Driver.h"
 #include "Type.h"
@@ -19,6 +20,7 @@
 #include "util/Format.h"
 #include "util/Counter.h"
 #include "util/OptionSet.h"
+#include "util/VectorUtils.h"
 
 #include "llvm/IR/Module.h"
 #include "llvm/IR/IRBuilder.h"
@@ -30,6 +32,8 @@
 #include <memory>
 #include <optional>
 #include <utility>
+#include <unordered_map>
+#include <deque>
 
 
 namespace yo::irgen {
@@ -37,7 +41,7 @@ namespace yo::irgen {
 enum class Intrinsic : uint8_t;
 class IRGenerator;
 
-using TemplateTypeMapping = std::map<std::string, std::shared_ptr<ast::TypeDesc>>;
+using TemplateTypeMapping = std::map<util::Symbol, ast::TypeDesc *>;
 
 inline void dump_tmpl_mapping(const TemplateTypeMapping &M) {
     util::fmt::print("Template Type Mapping:");
@@ -47,12 +51,11 @@ inline void dump_tmpl_mapping(const TemplateTypeMapping &M) {
 }
 
 
-StructType* getUnderlyingStruct(Type *ty);
-std::string mangleFullyResolved(const std::shared_ptr<ast::FunctionDecl>&);
+std::string mangleFullyResolved(ast::FunctionDecl *);
 bool integerLiteralFitsInIntegralType(uint64_t, Type *);
-llvm::DIFile* DIFileForSourceLocation(llvm::DIBuilder&, const lex::SourceLocation&);
-std::shared_ptr<ast::CallExpr> subscriptExprToCall(std::shared_ptr<ast::SubscriptExpr>);
-std::shared_ptr<ast::Ident> makeIdent(const std::string&, lex::SourceLocation = lex::SourceLocation());
+llvm::DIFile* DIFileForSourceLocation(llvm::DIBuilder&, const lex::SourceManager&, const lex::SourceLocation&);
+ast::CallExpr *subscriptExprToCall(ast::ASTContext&, ast::SubscriptExpr *);
+ast::Ident *makeIdent(ast::ASTContext&, const std::string&, lex::SourceLocation = lex::SourceLocation());
 
 inline std::string formatTupleMemberAtIndex(size_t index) {
     return util::fmt::format("__{}", index);
@@ -61,13 +64,13 @@ inline std::string formatTupleMemberAtIndex(size_t index) {
 
 // TODO is it a good idea to put these here?
 inline constexpr unsigned kInstanceMethodCallArgumentOffset = 1;
-static const std::string kInitializerMethodName = "init";
-static const std::string kDeallocMethodName = "dealloc";
-static const std::string kSynthesizedDeallocMethodName = "__dealloc";
+static const util::Symbol kInitializerMethodName("init");
+static const util::Symbol kDeallocMethodName("dealloc");
+static const util::Symbol kSynthesizedDeallocMethodName("__dealloc");
 static const std::string kRetvalAllocaIdentifier = "__retval";
-static const std::string kIteratorMethodName = "iterator";
-static const std::string kIteratorHasNextMethodName = "hasNext";
-static const std::string kIteratorNextMethodName = "next";
+static const util::Symbol kIteratorMethodName("iterator");
+static const util::Symbol kIteratorHasNextMethodName("hasNext");
+static const util::Symbol kIteratorNextMethodName("next");
 
 
 
@@ -104,23 +107,23 @@ struct ValueBinding {
     bool hasFlag(Flags F) const { return flags.contains(F); }
     
     ValueBinding(Type *type, llvm::Value *value, ReadImp read, WriteImp write, Flags F)
-    : type(type), value(value), read(read), write(write), flags(F) {}
+    : type(type), value(value), read(std::move(read)), write(std::move(write)), flags(F) {}
     
     ValueBinding(Type *type, llvm::Value *value, ReadImp read, WriteImp write, std::initializer_list<Flags> F)
-    : type(type), value(value), read(read), write(write), flags(F) {}
+    : type(type), value(value), read(std::move(read)), write(std::move(write)), flags(F) {}
 };
 
 
 struct ResolvedCallable {
     ast::FunctionSignature signature; // TODO can this be a `FunctionType *` instead?
-    std::shared_ptr<ast::FunctionDecl> funcDecl; // only nonnull if the callable is a function decl
+    ast::FunctionDecl *funcDecl = nullptr; // only nonnull if the callable is a function decl
     llvm::Value *llvmValue; // nullptr if this is a yet to be instantiated function template
     bool hasImplicitSelfArg;
     
-    ResolvedCallable(ast::FunctionSignature sig, std::shared_ptr<ast::FunctionDecl> funcDecl, llvm::Value *llvmValue, bool hasImplicitSelfArg)
+    ResolvedCallable(ast::FunctionSignature sig, ast::FunctionDecl *funcDecl, llvm::Value *llvmValue, bool hasImplicitSelfArg)
     : signature(sig), funcDecl(funcDecl), llvmValue(llvmValue), hasImplicitSelfArg(hasImplicitSelfArg) {}
     
-    ResolvedCallable(std::shared_ptr<ast::FunctionDecl> funcDecl, llvm::Value *llvmValue, bool hasImplicitSelfArg)
+    ResolvedCallable(ast::FunctionDecl *funcDecl, llvm::Value *llvmValue, bool hasImplicitSelfArg)
     : signature(funcDecl->getSignature()), funcDecl(funcDecl), llvmValue(llvmValue), hasImplicitSelfArg(hasImplicitSelfArg) {}
 };
 
@@ -131,7 +134,7 @@ struct FunctionState {
     struct BreakContDestinations {
         llvm::BasicBlock *breakDest, *contDest;
     };
-    std::shared_ptr<ast::FunctionDecl> decl = nullptr;
+    ast::FunctionDecl *decl = nullptr;
     llvm::Function *llvmFunction = nullptr;
     llvm::BasicBlock *returnBB = nullptr;
     llvm::Value *retvalAlloca = nullptr;
@@ -140,7 +143,7 @@ struct FunctionState {
     std::stack<BreakContDestinations> breakContDestinations;
     
     FunctionState() {}
-    FunctionState(std::shared_ptr<ast::FunctionDecl> decl, llvm::Function *llvmFunction, llvm::BasicBlock *returnBB, llvm::Value *retvalAlloca, util::NamedScope<ValueBinding>::Marker STM)
+    FunctionState(ast::FunctionDecl *decl, llvm::Function *llvmFunction, llvm::BasicBlock *returnBB, llvm::Value *retvalAlloca, util::NamedScope<ValueBinding>::Marker STM)
     : decl(decl), llvmFunction(llvmFunction), returnBB(returnBB), retvalAlloca(retvalAlloca), stackTopMarker(STM) {}
     
     std::string getTmpIdent() {
@@ -175,7 +178,7 @@ struct FunctionCallTargetCandidate {
         return target.signature;
     }
     
-    CandidateViabilityComparisonResult compare(IRGenerator &irgen, const FunctionCallTargetCandidate &other, const std::vector<std::pair<Type *, std::shared_ptr<ast::Expr>>>&) const;
+    CandidateViabilityComparisonResult compare(IRGenerator &irgen, const FunctionCallTargetCandidate &other, const std::vector<std::pair<Type *, ast::Expr *>>&) const;
 };
 
 
@@ -184,11 +187,171 @@ struct FunctionCallTargetCandidate {
 /// a named decl is a named declaration
 struct NamedDeclInfo {
     bool isRegistered = false;
-    std::shared_ptr<ast::TopLevelStmt> decl;
+    ast::TopLevelStmt *decl = nullptr;
     Type *type = nullptr;
     llvm::Value *llvmValue = nullptr; // only nonnull for functions?
     
-    NamedDeclInfo(std::shared_ptr<ast::TopLevelStmt> decl) : decl(decl) {}
+    NamedDeclInfo(ast::TopLevelStmt *decl) : decl(decl) {}
+};
+
+
+/// All named decls, identified by their canonical name
+class NamedDeclTable {
+    // deque bc decls can be added while others are being registered, which must not invalidate references to the existing infos
+    std::deque<NamedDeclInfo> infos;
+    std::unordered_map<util::Symbol, llvm::SmallVector<NamedDeclInfo *, 1>> buckets;
+    uint64_t generation = 0;
+    
+public:
+    NamedDeclInfo& insert(util::Symbol name, ast::TopLevelStmt *decl) {
+        auto &info = infos.emplace_back(decl);
+        buckets[name].push_back(&info);
+        generation++;
+        return info;
+    }
+    
+    /// Changes whenever a decl is added, which allows caching the results of lookups
+    uint64_t getGeneration() const {
+        return generation;
+    }
+    
+    /// All decls w/ the specified name, in the order in which they were added
+    llvm::ArrayRef<NamedDeclInfo *> lookup(util::Symbol name) const {
+        auto it = buckets.find(name);
+        if (it == buckets.end()) return {};
+        return it->second;
+    }
+    
+    /// Invokes `fn` for every decl w/ the specified name, including decls added to the bucket by `fn` itself
+    template <typename F>
+    void forEach(util::Symbol name, F &&fn) {
+        auto it = buckets.find(name);
+        if (it == buckets.end()) return;
+        // elements of an unordered_map are never moved, but the vector might be reallocated
+        auto &bucket = it->second;
+        for (size_t idx = 0; idx < bucket.size(); idx++) {
+            fn(*bucket[idx]);
+        }
+    }
+    
+    size_t size() const {
+        return infos.size();
+    }
+    
+    const NamedDeclInfo& at(size_t index) const {
+        return infos.at(index);
+    }
+    
+    /// Invokes `fn` for every decl, in the order in which they were added, including decls added by `fn` itself
+    template <typename F>
+    void forEach(F &&fn) {
+        for (size_t idx = 0; idx < infos.size(); idx++) {
+            fn(infos[idx]);
+        }
+    }
+};
+
+
+/// All registered functions.
+/// Callables can be looked up by their decl, by their canonical name (all overloads w/ that name), and by their fully resolved name.
+/// Function templates, intrinsics and ctors don't have a resolved name.
+class FunctionTable {
+    // deque bc the indices below point into it
+    std::deque<ResolvedCallable> callables;
+    std::unordered_map<ast::FunctionDecl *, ResolvedCallable *> byDecl;
+    std::unordered_map<util::Symbol, llvm::SmallVector<ResolvedCallable *, 1>> byCanonicalName;
+    std::unordered_map<util::Symbol, ResolvedCallable *> byResolvedName;
+    uint64_t generation = 0;
+    
+public:
+    ResolvedCallable& insert(util::Symbol canonicalName, std::optional<util::Symbol> resolvedName, ResolvedCallable RC) {
+        auto &callable = callables.emplace_back(std::move(RC));
+        byDecl[callable.funcDecl] = &callable;
+        byCanonicalName[canonicalName].push_back(&callable);
+        if (resolvedName) {
+            byResolvedName[*resolvedName] = &callable;
+        }
+        generation++;
+        return callable;
+    }
+    
+    /// Replaces a callable (ie, a forward declaration) w/ another one, which takes over the callable's names
+    ResolvedCallable& replace(ResolvedCallable &callable, ResolvedCallable RC) {
+        byDecl.erase(callable.funcDecl);
+        callable = std::move(RC);
+        byDecl[callable.funcDecl] = &callable;
+        generation++;
+        return callable;
+    }
+    
+    /// Changes whenever a callable is added or replaced, which allows caching the results of overload resolution
+    uint64_t getGeneration() const {
+        return generation;
+    }
+    
+    ResolvedCallable* get(ast::FunctionDecl *decl) const {
+        auto it = byDecl.find(decl);
+        return it != byDecl.end() ? it->second : nullptr;
+    }
+    
+    ResolvedCallable* getWithResolvedName(util::Symbol resolvedName) const {
+        auto it = byResolvedName.find(resolvedName);
+        return it != byResolvedName.end() ? it->second : nullptr;
+    }
+    
+    /// All overloads w/ the specified canonical name, in the order in which they were registered
+    llvm::ArrayRef<ResolvedCallable *> lookup(util::Symbol canonicalName) const {
+        auto it = byCanonicalName.find(canonicalName);
+        if (it == byCanonicalName.end()) return {};
+        return it->second;
+    }
+    
+    bool contains(util::Symbol canonicalName) const {
+        return byCanonicalName.find(canonicalName) != byCanonicalName.end();
+    }
+    
+    /// All callables, in the order in which they were registered
+    const std::deque<ResolvedCallable>& getAll() const {
+        return callables;
+    }
+};
+
+
+/// Identifies an instantiation of a function, struct or variant template w/ a specific set of template arguments
+struct TemplateInstantiationKey {
+    ast::TopLevelStmt *decl;
+    std::vector<Type *> templateArgs;
+    // Function instantiations only: the returned callable reflects whether the call passes an implicit self argument,
+    // so instantiations for calls w/ and w/out one are cached separately
+    bool hasImplicitSelfArg;
+    
+    TemplateInstantiationKey(ast::TopLevelStmt *decl, const TemplateTypeMapping &mapping, bool hasImplicitSelfArg = false)
+    : decl(decl), hasImplicitSelfArg(hasImplicitSelfArg) {
+        // The mapping's values are always resolved, and it is sorted by parameter name,
+        // meaning that two mappings for the same decl result in the same argument order
+        templateArgs.reserve(mapping.size());
+        for (auto &[name, typeDesc] : mapping) {
+            LKAssert(typeDesc->isResolved());
+            templateArgs.push_back(typeDesc->getResolvedType());
+        }
+    }
+    
+    /// Instantiations w/ temporary types are not cached, since the types are only placeholders
+    bool hasTemporaryArgs() const {
+        return util::vector::contains_where(templateArgs, [](Type *type) {
+            return type && type->hasFlag(Type::Flags::IsTemporary);
+        });
+    }
+    
+    bool operator==(const TemplateInstantiationKey &other) const {
+        return decl == other.decl && templateArgs == other.templateArgs && hasImplicitSelfArg == other.hasImplicitSelfArg;
+    }
+    
+    struct Hash {
+        size_t operator()(const TemplateInstantiationKey &key) const {
+            return llvm::hash_combine(key.decl, llvm::hash_combine_range(key.templateArgs.begin(), key.templateArgs.end()), key.hasImplicitSelfArg);
+        }
+    };
 };
 
 
@@ -205,7 +368,20 @@ private:
     friend class MatchMaker;
     friend struct FunctionCallTargetCandidate;
     
+    // Every generator has its own LLVM context, and caches the lowered types itself.
+    // This doesn't make generators independent: they still share the AST and type contexts (and the process-wide symbol table).
+    // Codegen also mutates the AST it runs on, so generators can't run concurrently on the same AST.
+    // Generators lowering different partitions of a program (see setLoweringPartition) each need their own AST and types
+    std::unique_ptr<llvm::LLVMContext> context;
+    llvm::LLVMContext &C;
+    
     ast::AST &ast;
+    // Nodes synthesized or specialized during codegen are allocated in the same context as the parsed AST
+    ast::ASTContext &astContext;
+    // Owns the types resolved during codegen
+    TypeContext &typeContext;
+    // Used to resolve source locations, for diagnostics and debug info
+    const lex::SourceManager &sourceManager;
     std::unique_ptr<llvm::Module> module;
     llvm::IRBuilder<> builder;
     
@@ -240,92 +416,137 @@ private:
     // If the type is a template specialization, the key is the mangled name
     util::NamedScope<Type *> nominalTypes;
     
-    // key: canonical name
-    std::map<std::string, std::vector<NamedDeclInfo>> namedDeclInfos;
+    NamedDeclTable namedDeclInfos;
+    
+    // Cached member tables, see NameLookup::computeMemberTableForType
+    std::unordered_map<Type *, TypeMembersTable> memberTables;
     
     /// All non-template struct declarations, identified by their name (template instantiations by their folly mangled name)
-    std::map<std::string, std::shared_ptr<ast::StructDecl>> structDecls; // TODO can we get rid of this?
+    std::map<util::Symbol, ast::StructDecl *> structDecls; // TODO can we get rid of this?
+    
+    FunctionTable functions;
+    
+    // Template instantiations, consulted before specializing a template decl
+    std::unordered_map<TemplateInstantiationKey, ResolvedCallable, TemplateInstantiationKey::Hash> functionTemplateInstantiations;
+    std::unordered_map<TemplateInstantiationKey, Type *, TemplateInstantiationKey::Hash> typeTemplateInstantiations;
+    
+    // The overload selected for a call, along w/ the state of the scopes and decl tables it was selected in.
+    // The selection is reused as long as none of these changed
+    struct ResolvedCallTarget {
+        decltype(localScope)::StateToken localScopeState;
+        decltype(nominalTypes)::StateToken nominalTypesState;
+        uint64_t functionsGeneration;
+        uint64_t namedDeclsGeneration;
+        FunctionCallTargetCandidate bestMatch;
+    };
+    std::unordered_map<ast::CallExpr *, ResolvedCallTarget> resolvedCallTargets;
+    
+    // Expression types, as computed by getType, along w/ the state of the scopes they were computed in.
+    // A type is reused as long as neither scope changed. Codegen discards an expression's entry when it replaces one of its operands
+    struct ResolvedExprType {
+        decltype(localScope)::StateToken localScopeState;
+        decltype(nominalTypes)::StateToken nominalTypesState;
+        Type *type;
+    };
+    std::unordered_map<ast::Expr *, ResolvedExprType> resolvedExprTypes;
     
-    // key: canonical function name
-    std::map<std::string, std::vector<ResolvedCallable>> functions;
-    // TODO: what's the point of `resolvedFunctions`?
-    // key: fully resolved function name
-    std::map<std::string, ResolvedCallable> resolvedFunctions;
+    // The call expressions binary operators are resolved and lowered as, created once per operator expression
+    std::unordered_map<ast::BinOp *, ast::CallExpr *> binopCallExprs;
+    
+    // Lowered types. These are kept here (rather than in the types), since they belong to the generator's context
+    std::unordered_map<Type *, llvm::Type *> llvmTypes;
+    std::unordered_map<Type *, llvm::DIType *> llvmDITypes;
+    // The structs backing tuple types
+    std::unordered_map<TupleType *, StructType *> tupleStructTypes;
     
     /// The function currently being generated
     irgen::FunctionState currentFunction;
 
+    // Which of the decls registered during preflight this generator lowers
+    struct {
+        unsigned index = 0;
+        unsigned count = 1;
+    } loweringPartition;
     
-public:
-    static llvm::LLVMContext C;
     
-    IRGenerator(ast::AST&, const std::string& translationUnitPath, const driver::Options&);
+public:
+    IRGenerator(ast::AST&, ast::ASTContext&, TypeContext&, const lex::SourceManager&, const std::string& translationUnitPath, const driver::Options&);
     
     IRGenerator(const IRGenerator&) = delete;
     IRGenerator& operator=(const IRGenerator&) = delete;
     
     void runCodegen();
     
+    /// Splits lowering into `count` partitions, of which this generator only lowers the one at `index`.
+    /// The generator still resolves and registers all decls, but only lowers the function bodies in its share of the decls registered during preflight,
+    /// along w/ the template instantiations and synthesized functions these need. Since other partitions might need the same instantiations,
+    /// they are emitted w/ linkonce_odr linkage. The startup and shutdown function tables are only emitted by the first partition.
+    /// Linking the partitions' modules yields the same program as lowering everything in a single generator
+    void setLoweringPartition(unsigned index, unsigned count) {
+        LKAssert(index < count);
+        loweringPartition.index = index;
+        loweringPartition.count = count;
+    }
+    
     std::unique_ptr<llvm::Module> getModule() {
         return std::move(module);
     }
     
+    /// Transfers ownership of the generator's context to the caller, who has to keep it alive for as long as the generator exists
+    std::unique_ptr<llvm::LLVMContext> takeContext() {
+        return std::move(context);
+    }
+    
     
 private:
     void preflight();
-    void preflightImplBlock(std::shared_ptr<ast::ImplBlock>);
+    void preflightImplBlock(ast::ImplBlock *);
     
     void registerNamedDecl(NamedDeclInfo &);
-    llvm::Function* registerFunction(std::shared_ptr<ast::FunctionDecl>, NamedDeclInfo&);
-    StructType* registerStructDecl(std::shared_ptr<ast::StructDecl>, NamedDeclInfo&);
-    void registerTypealias(std::shared_ptr<ast::TypealiasDecl>, NamedDeclInfo&);
-    VariantType* registerVariantDecl(std::shared_ptr<ast::VariantDecl>, NamedDeclInfo&);
+    llvm::Function* registerFunction(ast::FunctionDecl *, NamedDeclInfo&);
+    StructType* registerStructDecl(ast::StructDecl *, NamedDeclInfo&);
+    void registerTypealias(ast::TypealiasDecl *, NamedDeclInfo&);
+    VariantType* registerVariantDecl(ast::VariantDecl *, NamedDeclInfo&);
     
-    llvm::Function* addToAstAndRegister(const std::shared_ptr<ast::FunctionDecl> &decl) {
+    llvm::Function* addToAstAndRegister(ast::FunctionDecl *decl) {
         ast.push_back(decl);
-        auto &info = namedDeclInfos[decl->getName()].emplace_back(decl);
+        auto &info = namedDeclInfos.insert(decl->getName(), decl);
         return registerFunction(decl, info);
     }
     
-    StructType* addToAstAndRegister(const std::shared_ptr<ast::StructDecl> &decl) {
+    StructType* addToAstAndRegister(ast::StructDecl *decl) {
         ast.push_back(decl);
-        auto &info = namedDeclInfos[decl->getName()].emplace_back(decl);
+        auto &info = namedDeclInfos.insert(decl->getName(), decl);
         return registerStructDecl(decl, info);
     }
     
-    VariantType* addToAstAndRegister(const std::shared_ptr<ast::VariantDecl> &decl) {
+    VariantType* addToAstAndRegister(ast::VariantDecl *decl) {
         ast.push_back(decl);
-        auto &info = namedDeclInfos[decl->getName()].emplace_back(decl);
+        auto &info = namedDeclInfos.insert(decl->getName(), decl);
         return registerVariantDecl(decl, info);
     }
     
     
     /// register all names decls for a given name
-    void registerNamedDecls(const std::string &name) {
-        for (auto &[declName, declInfos] : namedDeclInfos) {
-            if (declName != name) continue;
-            for (auto &declInfo : declInfos) {
-                registerNamedDecl(declInfo);
-            }
-        }
+    void registerNamedDecls(util::Symbol name) {
+        namedDeclInfos.forEach(name, [this](NamedDeclInfo &declInfo) {
+            registerNamedDecl(declInfo);
+        });
     }
     
     /// register all names decls for a given name, depending on a predicate
     template <typename F>
-    void registerNamedDecls(const std::string &name, F &&fn) {
-        for (auto &[declName, declInfos] : namedDeclInfos) {
-            if (declName != name) continue;
-            for (auto &declInfo : declInfos) {
-                if (fn(declInfo.decl)) {
-                    registerNamedDecl(declInfo);
-                }
+    void registerNamedDecls(util::Symbol name, F &&fn) {
+        namedDeclInfos.forEach(name, [&](NamedDeclInfo &declInfo) {
+            if (fn(declInfo.decl)) {
+                registerNamedDecl(declInfo);
             }
-        }
+        });
     }
     
     
     // Debug Metadata
-    void emitDebugLocation(const std::shared_ptr<ast::Node>&);
+    void emitDebugLocation(ast::Node *);
     
     // Whether irgen should emit debug metadata
     // Note: if we're in a function, this also takes the function's `no_debug_info` attribute into account
@@ -341,77 +562,79 @@ private:
     // CODEGEN
     //
     
-    llvm::Value *codegenTLS(std::shared_ptr<ast::TopLevelStmt>);
-    llvm::Value *codegenLocalStmt(std::shared_ptr<ast::LocalStmt>);
-    llvm::Value *codegenExpr(std::shared_ptr<ast::Expr>, ValueKind = RValue, bool insertImplicitLoadInst = true); // TODO should this really default to rvalue?
+    llvm::Value *codegenTLS(ast::TopLevelStmt *);
+    llvm::Value *codegenLocalStmt(ast::LocalStmt *);
+    llvm::Value *codegenExpr(ast::Expr *, ValueKind = RValue, bool insertImplicitLoadInst = true); // TODO should this really default to rvalue?
     
     // ast::TopLevelStmt
-    llvm::Value *codegenFunctionDecl(std::shared_ptr<ast::FunctionDecl>);
+    llvm::Value *codegenFunctionDecl(ast::FunctionDecl *);
     
     // ast::LocalStmt
-    llvm::Value *codegenCompoundStmt(std::shared_ptr<ast::CompoundStmt>);
-    llvm::Value *codegenReturnStmt(std::shared_ptr<ast::ReturnStmt>);
-    llvm::Value *codegenVarDecl(std::shared_ptr<ast::VarDecl>);
-    llvm::Value *codegenAssignment(std::shared_ptr<ast::Assignment>);
-    llvm::Value *codegenIfStmt(std::shared_ptr<ast::IfStmt>);
-    llvm::Value *codegenWhileStmt(std::shared_ptr<ast::WhileStmt>);
-    llvm::Value *codegenForLoop(std::shared_ptr<ast::ForLoop>);
-    llvm::Value *codegenBreakContStmt(std::shared_ptr<ast::BreakContStmt>);
-    llvm::Value *codegenExprStmt(std::shared_ptr<ast::ExprStmt>);
+    llvm::Value *codegenCompoundStmt(ast::CompoundStmt *);
+    llvm::Value *codegenReturnStmt(ast::ReturnStmt *);
+    llvm::Value *codegenVarDecl(ast::VarDecl *);
+    llvm::Value *codegenAssignment(ast::Assignment *);
+    llvm::Value *codegenIfStmt(ast::IfStmt *);
+    llvm::Value *codegenWhileStmt(ast::WhileStmt *);
+    llvm::Value *codegenForLoop(ast::ForLoop *);
+    llvm::Value *codegenBreakContStmt(ast::BreakContStmt *);
+    llvm::Value *codegenExprStmt(ast::ExprStmt *);
     
     // ast::Expr
-    llvm::Value *codegenNumberLiteral(std::shared_ptr<ast::NumberLiteral>, ValueKind);
-    llvm::Value *codegenStringLiteral(std::shared_ptr<ast::StringLiteral>, ValueKind);
-    llvm::Value *codegenCastExpr(std::shared_ptr<ast::CastExpr>, ValueKind);
-    llvm::Value *codegenUnaryExpr(std::shared_ptr<ast::UnaryExpr>, ValueKind);
-    llvm::Value *codegenIdent(std::shared_ptr<ast::Ident>, ValueKind);
-    llvm::Value *codegenRawLLVMValueExpr(std::shared_ptr<ast::RawLLVMValueExpr>, ValueKind);
-    llvm::Value *codegenBinOp(std::shared_ptr<ast::BinOp>, ValueKind);
-    llvm::Value *codegenSubscriptExpr(std::shared_ptr<ast::SubscriptExpr>, ValueKind, SkipCodegenOption = kRunCodegen, Type ** = nullptr);
-    llvm::Value *codegenMemberExpr(std::shared_ptr<ast::MemberExpr>, ValueKind, SkipCodegenOption = kRunCodegen, Type ** = nullptr);
-    llvm::Value *codegenCallExpr(std::shared_ptr<ast::CallExpr>, ValueKind);
-    llvm::Value *codegenLambdaExpr(std::shared_ptr<ast::LambdaExpr>, ValueKind);
-    llvm::Value *codegenArrayLiteralExpr(std::shared_ptr<ast::ArrayLiteralExpr>, ValueKind);
-    llvm::Value *codegenTupleExpr(std::shared_ptr<ast::TupleExpr>, ValueKind);
-    llvm::Value *codegenMatchExpr(std::shared_ptr<ast::MatchExpr>, ValueKind);
+    llvm::Value *codegenNumberLiteral(ast::NumberLiteral *, ValueKind);
+    llvm::Value *codegenStringLiteral(ast::StringLiteral *, ValueKind);
+    llvm::Value *codegenCastExpr(ast::CastExpr *, ValueKind);
+    llvm::Value *codegenUnaryExpr(ast::UnaryExpr *, ValueKind);
+    llvm::Value *codegenIdent(ast::Ident *, ValueKind);
+    llvm::Value *codegenRawLLVMValueExpr(ast::RawLLVMValueExpr *, ValueKind);
+    llvm::Value *codegenBinOp(ast::BinOp *, ValueKind);
+    ast::CallExpr *getCallExprForBinOp(ast::BinOp *);
+    llvm::Value *codegenSubscriptExpr(ast::SubscriptExpr *, ValueKind, SkipCodegenOption = kRunCodegen, Type ** = nullptr);
+    llvm::Value *codegenMemberExpr(ast::MemberExpr *, ValueKind, SkipCodegenOption = kRunCodegen, Type ** = nullptr);
+    llvm::Value *codegenCallExpr(ast::CallExpr *, ValueKind);
+    llvm::Value *codegenLambdaExpr(ast::LambdaExpr *, ValueKind);
+    llvm::Value *codegenArrayLiteralExpr(ast::ArrayLiteralExpr *, ValueKind);
+    llvm::Value *codegenTupleExpr(ast::TupleExpr *, ValueKind);
+    llvm::Value *codegenMatchExpr(ast::MatchExpr *, ValueKind);
     
     /// codegen the expr as a boolean comparison
     /// always returns an rvalue
-    llvm::Value *codegenBoolComp(std::shared_ptr<ast::Expr>);
+    llvm::Value *codegenBoolComp(ast::Expr *);
     
     // Intrinsics
-    llvm::Value *codegen_HandleIntrinsic(std::shared_ptr<ast::FunctionDecl>, std::shared_ptr<ast::CallExpr>);
-    llvm::Value *codegen_HandleArithmeticIntrinsic(ast::Operator, std::shared_ptr<ast::CallExpr>);
-    llvm::Value *codegen_HandleComparisonIntrinsic(ast::Operator, std::shared_ptr<ast::CallExpr>);
-    llvm::Value *codegen_HandleLogOpIntrinsic(Intrinsic, std::shared_ptr<ast::CallExpr>);
+    llvm::Value *codegen_HandleIntrinsic(ast::FunctionDecl *, ast::CallExpr *);
+    llvm::Value *codegen_HandleArithmeticIntrinsic(ast::Operator, ast::CallExpr *);
+    llvm::Value *codegen_HandleComparisonIntrinsic(ast::Operator, ast::CallExpr *);
+    llvm::Value *codegen_HandleLogOpIntrinsic(Intrinsic, ast::CallExpr *);
     
     
 //    struct MatchExprPatternCodegenInfo {
 //        Type *targetType; // type of the expression we're matching against
-//        std::shared_ptr<ast::Expr> targetExpr; // the expression we're matching against
+//        ast::Expr *targetExpr = nullptr; // the expression we're matching against
 //        llvm::Value *targetLLVMValue; // Codegen result for TargetExpr
-//        std::shared_ptr<ast::Expr> patternExpr;
+//        ast::Expr *patternExpr = nullptr;
 //    };
 //    // TODO? this should be the central point that handles all pattern checks and returns the correct expressions, based on the input types
 //    llvm::Value *codegen_HandleMatchPatternExpr(MatchExprPatternCodegenInfo);
     
     
     // Types
-    Type* resolveTypeDesc(std::shared_ptr<ast::TypeDesc>, bool setInternalResolvedType = true);
+    Type* resolveTypeDesc(ast::TypeDesc *, bool setInternalResolvedType = true);
     llvm::Type* getLLVMType(Type *);
     llvm::DIType* getDIType(Type *);
+    StructType* getUnderlyingStruct(Type *);
     llvm::DISubroutineType* toDISubroutineType(const ast::FunctionSignature&);
     Type* resolvePrimitiveType(std::string_view name);
     
-    bool isTemporary(std::shared_ptr<ast::Expr>);
+    bool isTemporary(ast::Expr *);
     
     bool typeIsConstructible(Type *);
     bool typeIsCopyConstructible(Type *);
     bool typeIsDestructible(Type *);
     
     
-    llvm::Value* constructStruct(StructType *, std::shared_ptr<ast::CallExpr> ctorCall, bool putInLocalScope, ValueKind);
-    llvm::Value* constructCopyIfNecessary(Type *, std::shared_ptr<ast::Expr>, bool *didConstructCopy = nullptr);
+    llvm::Value* constructStruct(StructType *, ast::CallExpr *ctorCall, bool putInLocalScope, ValueKind);
+    llvm::Value* constructCopyIfNecessary(Type *, ast::Expr *, bool *didConstructCopy = nullptr);
     
     llvm::Value* constructVariant(VariantType *, const std::string &elementName);
     
@@ -421,8 +644,8 @@ private:
     
     /// Creates a call to the type's `dealloc` function, if defined
     /// Returns nullptr if the type does not have a `dealloc` method
-    std::shared_ptr<ast::LocalStmt> createDestructStmtIfDefined(Type *, std::shared_ptr<ast::Expr>, bool includeReferences);
-    std::shared_ptr<ast::LocalStmt> createDestructStmtIfDefined(Type *, llvm::Value *, bool includeReferences);
+    ast::LocalStmt *createDestructStmtIfDefined(Type *, ast::Expr *, bool includeReferences);
+    ast::LocalStmt *createDestructStmtIfDefined(Type *, llvm::Value *, bool includeReferences);
     
     /// Put the value into the local scope (thus including it in stack cleanup destructor calls)
     void includeInStackDestruction(Type *, llvm::Value *);
@@ -440,24 +663,24 @@ private:
     
     
     // `{Lhs|Rhs}Ty`: type of lhs/rhs, after applying typecasts, if casts were applied
-    bool typecheckAndApplyTrivialNumberTypeCastsIfNecessary_binop(std::shared_ptr<ast::Expr> *lhs, std::shared_ptr<ast::Expr> *rhs, Type **lhsTy, Type **rhsTy);
+    bool typecheckAndApplyTrivialNumberTypeCastsIfNecessary_binop(ast::Expr **lhs, ast::Expr **rhs, Type **lhsTy, Type **rhsTy);
     
     bool isImplicitConversionAvailable(Type *src, Type *dst);
     
     // Returns false if there is no implicit conversion to the expected type
-    bool applyImplicitConversionIfNecessary(std::shared_ptr<ast::Expr> &expr, Type *expectedType);
+    bool applyImplicitConversionIfNecessary(ast::Expr *&expr, Type *expectedType);
     
     
     // Other stuff
     std::optional<ResolvedCallable> getResolvedFunctionWithName(const std::string &name);
     
-    ResolvedCallable specializeTemplateFunctionDeclForCallExpr(std::shared_ptr<ast::FunctionDecl>, TemplateTypeMapping, bool hasImplicitSelfArg, SkipCodegenOption);
+    ResolvedCallable specializeTemplateFunctionDeclForCallExpr(ast::FunctionDecl *, TemplateTypeMapping, bool hasImplicitSelfArg, SkipCodegenOption);
     
     struct CallTargetRejectionReason {
         std::string reason;
-        std::shared_ptr<ast::FunctionDecl> decl;
+        ast::FunctionDecl *decl = nullptr;
         
-        CallTargetRejectionReason(std::string reason, std::shared_ptr<ast::FunctionDecl> decl) : reason(reason), decl(decl) {}
+        CallTargetRejectionReason(std::string reason, ast::FunctionDecl *decl) : reason(reason), decl(decl) {}
     };
     
     enum class ResolveCallResultStatus {
@@ -465,34 +688,36 @@ private:
         NoCandidates,
         AmbiguousCandidates
     };
-    std::optional<ResolvedCallable> resolveCall_imp(std::shared_ptr<ast::CallExpr>, SkipCodegenOption,
+    std::optional<ResolvedCallable> resolveCall_imp(ast::CallExpr *, SkipCodegenOption,
                                                     std::vector<FunctionCallTargetCandidate>&,
                                                     std::vector<CallTargetRejectionReason>&, ResolveCallResultStatus&);
-    ResolvedCallable resolveCall(std::shared_ptr<ast::CallExpr>, SkipCodegenOption);
+    ResolvedCallable finalizeCallTarget(const FunctionCallTargetCandidate &, SkipCodegenOption);
+    ResolvedCallable resolveCall(ast::CallExpr *, SkipCodegenOption);
     
-    std::optional<ResolvedCallable> resolveCall_opt(std::shared_ptr<ast::CallExpr>, SkipCodegenOption);
+    std::optional<ResolvedCallable> resolveCall_opt(ast::CallExpr *, SkipCodegenOption);
     
     // returns true if the call can be resolved, otherwise false.
     // does not emit IR for the call?
-    bool canResolveCall(std::shared_ptr<ast::CallExpr> expr) {
+    bool canResolveCall(ast::CallExpr *expr) {
         return resolveCall_opt(expr, kSkipCodegen).has_value();
     }
     
     
-    TemplateTypeMapping resolveTemplateDeclTemplateParamsFromExplicitArgs(std::shared_ptr<ast::TemplateDecl>, std::shared_ptr<ast::TemplateParamArgList>, bool setInternalTypes);
+    TemplateTypeMapping resolveTemplateDeclTemplateParamsFromExplicitArgs(ast::TemplateDecl *, ast::TemplateParamArgList *, bool setInternalTypes);
     
     std::optional<TemplateTypeMapping>
-    attemptToResolveTemplateArgumentTypesForCall(const ast::FunctionSignature&, std::shared_ptr<ast::CallExpr>, const std::vector<std::pair<Type *, std::shared_ptr<ast::Expr>>>&);
+    attemptToResolveTemplateArgumentTypesForCall(const ast::FunctionSignature&, ast::CallExpr *, const std::vector<std::pair<Type *, ast::Expr *>>&);
     
     
     /// Instantiate a template declaration (ie, a struct or a variant type).
     /// Template functions are handled separately
     template <typename T>
-    Type* instantiateTemplateDecl(const std::shared_ptr<T>&, const std::shared_ptr<ast::TemplateParamArgList>&);
+    Type* instantiateTemplateDecl(T *, ast::TemplateParamArgList *);
     
-    Type* getType(std::shared_ptr<ast::Expr>);
+    Type* getType(ast::Expr *);
+    Type* getType_imp(ast::Expr *);
     
-    bool valueIsTriviallyConvertible(std::shared_ptr<ast::NumberLiteral>, Type*);
+    bool valueIsTriviallyConvertible(ast::NumberLiteral *, Type*);
     
     bool equal(const ast::FunctionSignature&, const ast::FunctionSignature&);
     
@@ -505,15 +730,15 @@ private:
     // Types
     
     // basically, whether `targetTy().name(argTys...)` exists
-    bool memberFunctionCallResolves(Type *targetTy, const std::string &name, const std::vector<Type *> &argTys);
+    bool memberFunctionCallResolves(Type *targetTy, util::Symbol name, const std::vector<Type *> &argTys);
     
-    StructType* synth_getStructDeclStructType(const std::shared_ptr<ast::StructDecl>&);
+    StructType* synth_getStructDeclStructType(ast::StructDecl *);
     
-    llvm::Value* synthesizeDefaultMemberwiseInitializer(std::shared_ptr<ast::StructDecl>, SkipCodegenOption);
-    llvm::Value* synthesizeDefaultCopyConstructor(std::shared_ptr<ast::StructDecl>, SkipCodegenOption);
-    llvm::Value* synthesizeDefaultDeallocMethod(std::shared_ptr<ast::StructDecl>, SkipCodegenOption);
+    llvm::Value* synthesizeDefaultMemberwiseInitializer(ast::StructDecl *, SkipCodegenOption);
+    llvm::Value* synthesizeDefaultCopyConstructor(ast::StructDecl *, SkipCodegenOption);
+    llvm::Value* synthesizeDefaultDeallocMethod(ast::StructDecl *, SkipCodegenOption);
     
-    StructType* synthesizeLambdaExpr(std::shared_ptr<ast::LambdaExpr>);
+    StructType* synthesizeLambdaExpr(ast::LambdaExpr *);
     StructType* synthesizeUnderlyingStructTypeForTupleType(TupleType *tupleTy);
     
     void synthesizeVariantConstructor(VariantType *, const VariantType::Elements::value_type &);
@@ -528,14 +753,15 @@ class IRGenerator::EmptyScopeHandle {
     decltype(irgen.builder.GetInsertBlock()) prevInsertBlock;
     
 public:
+    // The local scope is moved out of (and back into) the irgen, instead of being copied
     explicit EmptyScopeHandle(IRGenerator &irgen)
-    : irgen(irgen), prevLocalScope(irgen.localScope), prevCurrentFunction(irgen.currentFunction), prevInsertBlock(irgen.builder.GetInsertBlock()) {
+    : irgen(irgen), prevLocalScope(std::move(irgen.localScope)), prevCurrentFunction(irgen.currentFunction), prevInsertBlock(irgen.builder.GetInsertBlock()) {
         irgen.localScope = {};
         irgen.currentFunction = {};
     }
     
     ~EmptyScopeHandle() {
-        irgen.localScope = prevLocalScope;
+        irgen.localScope = std::move(prevLocalScope);
         irgen.currentFunction = prevCurrentFunction;
         irgen.builder.SetInsertPoint(prevInsertBlock);
     }
@@ -176,28 +176,28 @@ public:
 #pragma mark - Canonical Mangling
 
 
-std::string mangleCanonicalName(ast::FunctionKind kind, std::string_view name) {
+util::Symbol mangleCanonicalName(ast::FunctionKind kind, std::string_view name) {
     switch (kind) {
         case ast::FunctionKind::GlobalFunction:
-            return std::string(name);
+            return util::Symbol(name);
         
         case ast::FunctionKind::StaticMethod:
-            return ManglingStringBuilder("__S")
+            return util::Symbol(ManglingStringBuilder("__S")
                 .appendWithCount(name)
-                .str();
+                .str());
         
         case ast::FunctionKind::InstanceMethod:
-            return ManglingStringBuilder("__I")
+            return util::Symbol(ManglingStringBuilder("__I")
                 .appendWithCount(name)
-                .str();
+                .str());
     }
 }
 
 
 
-std::string mangleCanonicalName(std::shared_ptr<ast::FunctionDecl> funcDecl) {
+util::Symbol mangleCanonicalName(ast::FunctionDecl *funcDecl) {
     if (!funcDecl->getAttributes().mangledName.empty()) {
-        return funcDecl->getAttributes().mangledName;
+        return util::Symbol(funcDecl->getAttributes().mangledName);
     }
     return mangleCanonicalName(funcDecl->getFunctionKind(), funcDecl->getName());
 }
@@ -277,7 +277,7 @@ std::string mangleFullyResolved(const irgen::Type *type) {
 
 
 // Mangled name includes type encodings for return- & parameter types
-std::string mangleFullyResolved(std::shared_ptr<ast::FunctionDecl> funcDecl) {
+std::string mangleFullyResolved(ast::FunctionDecl *funcDecl) {
     if (auto mangledName = funcDecl->getAttributes().mangledName; !mangledName.empty()) {
         return mangledName;
     }
@@ -354,7 +354,7 @@ std::string mangleTemplateDeclFullyResolved(char prefix, std::string_view name,
 
 
 // TODO rewrite to use an irgen::StructType* object instead!!!!
-std::string mangleFullyResolved(std::shared_ptr<ast::StructDecl> SD) {
+std::string mangleFullyResolved(ast::StructDecl *SD) {
 //    ManglingStringBuilder mangler(kMangledTypeStructPrefix);
 //    //bool isTemplate = SD->templateInstantiationArguments.size() > 0;
 //
@@ -378,7 +378,7 @@ std::string mangleFullyResolved(std::shared_ptr<ast::StructDecl> SD) {
 
 
 
-std::string mangleFullyResolved(std::shared_ptr<ast::VariantDecl> decl) {
+std::string mangleFullyResolved(ast::VariantDecl *decl) {
 //    ManglingStringBuilder mangler(kMangledTypePrefixVariant);
 //
 //    if (decl->isInstantiatedTemplateDecl()) {
@@ -394,12 +394,12 @@ std::string mangleFullyResolved(std::shared_ptr<ast::VariantDecl> decl) {
 
 
 
-std::string encodeOperator(ast::Operator op) {
-    return std::to_string(static_cast<uint8_t>(op));
+util::Symbol encodeOperator(ast::Operator op) {
+    return util::Symbol(std::to_string(static_cast<uint8_t>(op)));
 }
 
 
-std::string mangleCanonicalName(ast::Operator op) {
+util::Symbol mangleCanonicalName(ast::Operator op) {
 //    std::string str;
 //    str.push_back(kCanonicalPrefixOperatorOverload);
 //    str.append(encodeOperator(op));
@@ -670,8 +670,7 @@ std::string Demangler::demangleType() {
     } else {
         if (auto numTyId = util::map::reverse_lookup(numericalTypeEncodings, input.substr(0, 1))) {
             input.remove_prefix(1);
-            irgen::Type::initPrimitives();
-            return irgen::NumericalType::get(*numTyId)->str_desc();
+            return irgen::NumericalType::getName(*numTyId);
         }
     }
     
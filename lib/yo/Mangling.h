@@ -17,12 +17,13 @@
 
 
 namespace yo::mangling {
-    std::string mangleCanonicalName(std::shared_ptr<ast::FunctionDecl>);
-    std::string mangleCanonicalName(ast::FunctionKind kind, std::string_view name);
+    // Canonical names are interned, since they're used to look up functions
+    util::Symbol mangleCanonicalName(ast::FunctionDecl *);
+    util::Symbol mangleCanonicalName(ast::FunctionKind kind, std::string_view name);
     
-    std::string mangleFullyResolved(std::shared_ptr<ast::FunctionDecl>);
-    std::string mangleFullyResolved(std::shared_ptr<ast::StructDecl>);
-    std::string mangleFullyResolved(std::shared_ptr<ast::VariantDecl>);
+    std::string mangleFullyResolved(ast::FunctionDecl *);
+    std::string mangleFullyResolved(ast::StructDecl *);
+    std::string mangleFullyResolved(ast::VariantDecl *);
     
     std::string mangleAsStruct(std::string_view);
     std::string mangleFullyResolved(const irgen::Type *);
@@ -30,8 +31,8 @@ namespace yo::mangling {
     //bool isCanonicalInstanceMethodName(std::string_view ident);
     
     // Operators
-    std::string encodeOperator(ast::Operator);
-    std::string mangleCanonicalName(ast::Operator);
+    util::Symbol encodeOperator(ast::Operator);
+    util::Symbol mangleCanonicalName(ast::Operator);
     ast::Operator demangleCanonicalOperatorEncoding(std::string_view);
     
     
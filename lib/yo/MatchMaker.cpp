@@ -10,7 +10,6 @@
 #include "IRGen.h"
 #include "util/util.h"
 #include "util/VectorUtils.h"
-#include "util/llvm_casting.h"
 
 #include "llvm/Support/Casting.h"
 
@@ -98,8 +97,8 @@ llvm::Value* MatchMaker::run() {
     
     if (irgen.isTemporary(matchExpr->target)) {
         auto targetExpr = matchExpr->target;
-        auto ident = makeIdent(irgen.currentFunction.getTmpIdent(), targetExpr->getSourceLocation());
-        auto varDecl = std::make_shared<ast::VarDecl>(ident, nullptr, targetExpr);
+        auto ident = makeIdent(irgen.astContext, irgen.currentFunction.getTmpIdent(), targetExpr->getSourceLocation());
+        auto varDecl = ast::make<ast::VarDecl>(irgen.astContext, ident, nullptr, targetExpr);
         targetV = irgen.codegenVarDecl(varDecl);
     } else {
         targetV = irgen.codegenExpr(matchExpr->target, LValue);
@@ -107,7 +106,7 @@ llvm::Value* MatchMaker::run() {
             targetType = targetType->getReferenceTo(); // TODO is this a good idea? also, shouldn't this happen when we first assign targetType?
         }
     }
-    auto targetVRawExpr = std::make_shared<ast::RawLLVMValueExpr>(targetV, targetType);
+    auto targetVRawExpr = ast::make<ast::RawLLVMValueExpr>(irgen.astContext, targetV, targetType);
     targetVRawExpr->setSourceLocation(matchExpr->target->getSourceLocation());
     
     auto addBBAndSetAsInsertPoint = [&](llvm::BasicBlock *BB) {
@@ -178,7 +177,7 @@ llvm::Value* MatchMaker::run() {
                     nextCondBB = llvm::BasicBlock::Create(irgen.C);
                     
                     // literals are implemented using the `==` operator
-                    auto cmpBinop = std::make_shared<ast::BinOp>(ast::Operator::EQ, pattern.expr, targetVRawExpr);
+                    auto cmpBinop = ast::make<ast::BinOp>(irgen.astContext, ast::Operator::EQ, pattern.expr, targetVRawExpr);
                     cmpBinop->setSourceLocation(branch.getSourceLocation());
                     auto cond = irgen.codegenExpr(cmpBinop);
                     
@@ -34,7 +34,7 @@ class MatchMaker {
     
     
     IRGenerator &irgen;
-    std::shared_ptr<ast::MatchExpr> matchExpr;
+    ast::MatchExpr *matchExpr = nullptr;
     ValueKind VK;
     
     // type of the expression we're matching against
@@ -43,7 +43,7 @@ class MatchMaker {
     std::vector<std::vector<PatternKind>> patternKinds;
     
 public:
-    explicit MatchMaker(IRGenerator &irgen, std::shared_ptr<ast::MatchExpr> matchExpr, ValueKind VK)
+    explicit MatchMaker(IRGenerator &irgen, ast::MatchExpr *matchExpr, ValueKind VK)
     : irgen(irgen), matchExpr(matchExpr), VK(VK) {}
     
     /// Run codegen for a match expression
@@ -15,7 +15,7 @@
 #include "util/util.h"
 #include "util/Format.h"
 #include "util/MapUtils.h"
-#include "util/llvm_casting.h"
+#include "llvm/Support/Casting.h"
 
 #include <string>
 #include <map>
@@ -63,7 +63,7 @@ std::ostream& irgen::operator<<(std::ostream &OS, const ValueInfo &VI) {
 }
 
 
-std::vector<ValueInfo> NameLookup::lookup(const std::shared_ptr<ast::Expr> &expr) {
+std::vector<ValueInfo> NameLookup::lookup(ast::Expr *expr) {
     if (auto ident = llvm::dyn_cast<ast::Ident>(expr)) {
         if (auto binding = irgen.localScope.get(ident->value)) {
             return { ValueInfo::localVar(binding->type) };
@@ -76,38 +76,36 @@ std::vector<ValueInfo> NameLookup::lookup(const std::shared_ptr<ast::Expr> &expr
             results.push_back(ValueInfo::typeRef(*type));
         }
         
-        if (auto declInfos = util::map::get_opt(irgen.namedDeclInfos, ident->value)) {
-            for (const NamedDeclInfo &declInfo : *declInfos) {
-                switch (declInfo.decl->getKind()) {
-                    case NK::FunctionDecl: {
-                        // TODO just pass along the RC?!
-                        auto FD = llvm::cast<ast::FunctionDecl>(declInfo.decl);
-                        if (FD->isGlobalFunction()) {
-                            // the idea here is that it it's an ident, it can only refer to a global function (since there is no implicit self (yet?))
-                            results.push_back(ValueInfo::function(nullptr, llvm::cast<ast::FunctionDecl>(declInfo.decl)));
-                        }
-                        break;
+        for (const NamedDeclInfo *declInfo : irgen.namedDeclInfos.lookup(ident->value)) {
+            switch (declInfo->decl->getKind()) {
+                case NK::FunctionDecl: {
+                    // TODO just pass along the RC?!
+                    auto FD = llvm::cast<ast::FunctionDecl>(declInfo->decl);
+                    if (FD->isGlobalFunction()) {
+                        // the idea here is that it it's an ident, it can only refer to a global function (since there is no implicit self (yet?))
+                        results.push_back(ValueInfo::function(nullptr, llvm::cast<ast::FunctionDecl>(declInfo->decl)));
                     }
-                    case NK::StructDecl: {
-                        auto SD = llvm::cast<ast::StructDecl>(declInfo.decl);
-                        if (SD->isTemplateDecl()) {
-                            results.push_back(ValueInfo::typeRefTmpl(SD));
-                        }
-                        break;
+                    break;
+                }
+                case NK::StructDecl: {
+                    auto SD = llvm::cast<ast::StructDecl>(declInfo->decl);
+                    if (SD->isTemplateDecl()) {
+                        results.push_back(ValueInfo::typeRefTmpl(SD));
                     }
-                    case NK::VariantDecl: {
-                        auto VD = llvm::cast<ast::VariantDecl>(declInfo.decl);
-                        if (VD->isTemplateDecl()) {
-                            results.push_back(ValueInfo::typeRefTmpl(VD));
-                        }
-                        break;
+                    break;
+                }
+                case NK::VariantDecl: {
+                    auto VD = llvm::cast<ast::VariantDecl>(declInfo->decl);
+                    if (VD->isTemplateDecl()) {
+                        results.push_back(ValueInfo::typeRefTmpl(VD));
                     }
-                    case NK::TypealiasDecl:
-                        LKFatalError("");
-                    
-                    default:
-                        LKFatalError("");
+                    break;
                 }
+                case NK::TypealiasDecl:
+                    LKFatalError("");
+                    
+                default:
+                    LKFatalError("");
             }
         }
         return results;
@@ -117,7 +115,7 @@ std::vector<ValueInfo> NameLookup::lookup(const std::shared_ptr<ast::Expr> &expr
             // if the member expr's target is a raw expr, we're looking up a member function call
             // ^^ do we really know that for sure?
             // check whether the type has the member
-            auto membersTable = computeMemberTableForType(rawExpr->type);
+            auto &membersTable = computeMemberTableForType(rawExpr->type);
             if (auto members = util::map::get_opt(membersTable.members, memberExpr->memberName)) {
                 return *members;
             } else {
@@ -127,7 +125,7 @@ std::vector<ValueInfo> NameLookup::lookup(const std::shared_ptr<ast::Expr> &expr
             std::vector<ValueInfo> results;
             
             auto handleForType = [&](Type *type) {
-                auto membersTable = computeMemberTableForType(type);
+                auto &membersTable = computeMemberTableForType(type);
                 if (auto members = util::map::get_opt(membersTable.members, memberExpr->memberName)) {
                     util::vector::append(results, *members);
                 }
@@ -177,52 +175,55 @@ std::vector<ValueInfo> NameLookup::lookup(const std::shared_ptr<ast::Expr> &expr
 
 
 
-// TODO should these be cached?
-// Pro: def faster, this function gets called at least twice for each call expr
-// Con: we might miss some decls which only get added later (TODO are there such decls?)
-TypeMembersTable NameLookup::computeMemberTableForType(Type *type) {
+// Member tables are cached, since this function gets called at least twice for each call expr.
+// Decls can be added after a type's table was computed (eg: template instantiations), which is why the cached table
+// keeps track of how many decls it already checked, and only checks the ones added since then on subsequent lookups
+const TypeMembersTable& NameLookup::computeMemberTableForType(Type *type) {
     if (auto refTy = llvm::dyn_cast<ReferenceType>(type)) {
         type = refTy->getReferencedType();
     }
     
-    TypeMembersTable membersTable(type);
+    auto [it, isNewTable] = irgen.memberTables.try_emplace(type, type);
+    // unordered_map elements are never moved, the reference remains valid if computing the table adds other types' tables
+    auto &membersTable = it->second;
     
-    if (auto structTy = llvm::dyn_cast<StructType>(type)) {
-        for (auto &[memberName, memberType] : structTy->getMembers()) {
-            membersTable.addProperty(type, memberName, memberType);
-        }
-    } else if (auto variantTy = llvm::dyn_cast<VariantType>(type)) {
-        for (auto &[elemName, elemType] : variantTy->getElements()) {
-            // elements w/ associated data get static functions generated
-            if (!elemType) {
-                membersTable.addProperty(type, elemName, type, true);
+    if (isNewTable) {
+        if (auto structTy = llvm::dyn_cast<StructType>(type)) {
+            for (auto &[memberName, memberType] : structTy->getMembers()) {
+                membersTable.addProperty(type, util::Symbol(memberName), memberType);
+            }
+        } else if (auto variantTy = llvm::dyn_cast<VariantType>(type)) {
+            for (auto &[elemName, elemType] : variantTy->getElements()) {
+                // elements w/ associated data get static functions generated
+                if (!elemType) {
+                    membersTable.addProperty(type, util::Symbol(elemName), type, true);
+                }
             }
         }
     }
     
-    
-    for (const auto &[name, declInfos] : irgen.namedDeclInfos) {
-        for (const NamedDeclInfo &declInfo : declInfos) {
-            if (auto funcDecl = llvm::dyn_cast<ast::FunctionDecl>(declInfo.decl)) {
-                // collect all instance methods which, as their first parameter, can accept the type
+    // checking a decl may instantiate templates, which adds decls to the table
+    while (membersTable.numCheckedDecls < irgen.namedDeclInfos.size()) {
+        auto &declInfo = irgen.namedDeclInfos.at(membersTable.numCheckedDecls++);
+        if (auto funcDecl = llvm::dyn_cast<ast::FunctionDecl>(declInfo.decl)) {
+            // collect all instance methods which, as their first parameter, can accept the type
                 
-                auto shouldAdd = [&]() -> bool {
-                    if (!(funcDecl->isInstanceMethod() || funcDecl->isStaticMethod())) {
-                        return false;
-                    }
-                    if (funcDecl->getAttributes().int_isCtor) {
-                        return false;
-                    }
-                    if (!isAcceptableFirstParam(type, funcDecl)) {
-                        return false;
-                    }
+            auto shouldAdd = [&]() -> bool {
+                if (!(funcDecl->isInstanceMethod() || funcDecl->isStaticMethod())) {
+                    return false;
+                }
+                if (funcDecl->getAttributes().int_isCtor) {
+                    return false;
+                }
+                if (!isAcceptableFirstParam(type, funcDecl)) {
+                    return false;
+                }
                     
-                    return true;
-                };
+                return true;
+            };
                 
-                if (shouldAdd()) {
-                    membersTable.addMemberFunction(type, funcDecl);
-                }
+            if (shouldAdd()) {
+                membersTable.addMemberFunction(type, funcDecl);
             }
         }
     }
@@ -231,7 +232,7 @@ TypeMembersTable NameLookup::computeMemberTableForType(Type *type) {
     return membersTable;
 }
 
-bool NameLookup::isAcceptableFirstParam(Type *type, const std::shared_ptr<ast::FunctionDecl> &decl) {
+bool NameLookup::isAcceptableFirstParam(Type *type, ast::FunctionDecl *decl) {
     LKAssert(decl->getSignature().numberOfParameters() > 0);
     
     if (!decl->isInstanceMethod()) { // TODO is this too strict?
@@ -243,7 +244,7 @@ bool NameLookup::isAcceptableFirstParam(Type *type, const std::shared_ptr<ast::F
         // if the function has template params inserted from its impl block (ie, template params which are used in the first argument),
         // remove all other data from the signature and see whether the first argument can resolve to the type
         
-        auto sig = ASTRewriter().handleFunctionSignature(decl->getSignature());
+        auto sig = ASTRewriter(irgen.astContext).handleFunctionSignature(decl->getSignature());
         LKAssert(sig.isTemplateDecl());
         // remove all parameters except the first (implicit self)
         sig.paramTypes.erase(sig.paramTypes.begin() + 1, sig.paramTypes.end());
@@ -252,9 +253,9 @@ bool NameLookup::isAcceptableFirstParam(Type *type, const std::shared_ptr<ast::F
         auto &P = sig.templateParamsDecl->getParams();
         sig.templateParamsDecl->setParams(std::vector(P.begin() + decl->implBlockTmplParamsStartIndex, P.end()));
 
-        auto callExpr = std::make_shared<ast::CallExpr>(nullptr);
+        auto callExpr = ast::make<ast::CallExpr>(irgen.astContext, nullptr);
 
-        if (auto mapping = irgen.attemptToResolveTemplateArgumentTypesForCall(sig, callExpr, {{type, std::make_shared<ast::RawLLVMValueExpr>(nullptr, type)}})) {
+        if (auto mapping = irgen.attemptToResolveTemplateArgumentTypesForCall(sig, callExpr, {{type, ast::make<ast::RawLLVMValueExpr>(irgen.astContext, nullptr, type)}})) {
             return true;
         }
         return false;
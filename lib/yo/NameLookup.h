@@ -27,12 +27,12 @@ class IRGenerator;
 /// Info about a (named) value
 // TOOD rewrite, this is atrocious
 struct ValueInfo {
-    using TypeTmplInfo = std::shared_ptr<ast::TopLevelStmt>;
-    using FunctionInfo = std::pair<Type *, std::shared_ptr<ast::FunctionDecl>>;
+    using TypeTmplInfo = ast::TopLevelStmt *;
+    using FunctionInfo = std::pair<Type *, ast::FunctionDecl *>;
     struct PropertyInfo {
         Type *parentType; // the type this property is a member of // TODO come up w/ a better name
         Type *type;       // type of the property
-        std::string name;
+        util::Symbol name;
     };
     
     enum class Kind {
@@ -76,7 +76,7 @@ struct ValueInfo {
         return ValueInfo(Kind::TypeRef, type, false);
     }
     
-    static ValueInfo typeRefTmpl(std::shared_ptr<ast::TopLevelStmt> decl) {
+    static ValueInfo typeRefTmpl(ast::TopLevelStmt *decl) {
         return ValueInfo(Kind::TypeRefTmpl, decl, false);
     }
     
@@ -84,11 +84,11 @@ struct ValueInfo {
         return ValueInfo(Kind::LocalVar, type, false);
     }
     
-    static ValueInfo property(Type *parentType, Type *type, const std::string &name, bool isStatic = false) {
+    static ValueInfo property(Type *parentType, Type *type, util::Symbol name, bool isStatic = false) {
         return ValueInfo(Kind::Property, PropertyInfo{parentType, type, name}, isStatic);
     }
     
-    static ValueInfo function(Type *selfType, std::shared_ptr<ast::FunctionDecl> func, bool isStatic = false) {
+    static ValueInfo function(Type *selfType, ast::FunctionDecl *func, bool isStatic = false) {
         return ValueInfo(Kind::Function, std::make_pair(selfType, func), isStatic);
     }
 };
@@ -99,19 +99,20 @@ std::ostream& operator<<(std::ostream&, const ValueInfo&);
 
 struct TypeMembersTable {
     Type *type;
-    std::map<std::string, std::vector<ValueInfo>> members;
+    std::map<util::Symbol, std::vector<ValueInfo>> members;
+    size_t numCheckedDecls = 0; // number of named decls which already were checked for member functions of the type
     
     explicit TypeMembersTable(Type *ty) : type(ty) {}
     
-    void addProperty(Type *parentTy, const std::string &name, Type *type, bool isStatic = false) {
+    void addProperty(Type *parentTy, util::Symbol name, Type *type, bool isStatic = false) {
         members[name].push_back(ValueInfo::property(parentTy, type, name, isStatic));
     }
     
-    void addMemberFunction(Type *selfType, const std::shared_ptr<ast::FunctionDecl> &funcDecl, bool isStatic = false) {
+    void addMemberFunction(Type *selfType, ast::FunctionDecl *funcDecl, bool isStatic = false) {
         members[funcDecl->getName()].push_back(ValueInfo::function(selfType, funcDecl, isStatic));
     }
     
-    bool contains(const std::string &name) const {
+    bool contains(util::Symbol name) const {
         return members.find(name) != members.end();
     }
     
@@ -128,11 +129,11 @@ class NameLookup {
 public:
     explicit NameLookup(IRGenerator &irgen) : irgen(irgen) {}
     
-    std::vector<ValueInfo> lookup(const std::shared_ptr<ast::Expr>&);
-    TypeMembersTable computeMemberTableForType(Type *type);
+    std::vector<ValueInfo> lookup(ast::Expr *);
+    const TypeMembersTable& computeMemberTableForType(Type *type);
     
 private:
-    bool isAcceptableFirstParam(Type *, const std::shared_ptr<ast::FunctionDecl>&);
+    bool isAcceptableFirstParam(Type *, ast::FunctionDecl *);
 };
 
 
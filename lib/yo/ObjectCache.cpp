@@ -0,0 +1,144 @@
+//
+//  ObjectCache.cpp
+//  yo
+//
+
+#include "ObjectCache.h"
+#include "util/util.h"
+#include "util/Format.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <sstream>
+
+using namespace yo;
+using namespace yo::driver;
+
+
+// Bump this whenever the layout of the cache directory changes
+static constexpr const char *kCacheFormatVersion = "1";
+
+// llvm::pruneCache only considers files w/ this prefix
+static constexpr const char *kEntryPrefix = "llvmcache-";
+
+static constexpr const char *kStatisticsFilename = "stats";
+
+
+// Reads the hit and miss counters from the statistics file
+static void readCounters(const std::string &path, uint64_t &hits, uint64_t &misses) {
+    if (auto buffer = llvm::MemoryBuffer::getFile(path)) {
+        std::istringstream IS((*buffer)->getBuffer().str());
+        IS >> hits >> misses;
+    }
+}
+
+
+ObjectCache::ObjectCache(std::string directory, uint64_t maxSize) : directory(std::move(directory)), maxSize(maxSize) {
+    if (auto EC = llvm::sys::fs::create_directories(this->directory)) {
+        LKFatalError("unable to create cache directory '%s': %s", this->directory.c_str(), EC.message().c_str());
+    }
+}
+
+
+std::string ObjectCache::computeKey(const llvm::Module &module, llvm::StringRef configuration) {
+    llvm::SmallVector<char, 0> buffer;
+    llvm::raw_svector_ostream OS(buffer);
+    llvm::WriteBitcodeToFile(module, OS);
+    OS << '\0' << configuration;
+    OS << '\0' << kCacheFormatVersion << '\0' << YO_VERSION << '\0' << LLVM_VERSION_STRING;
+    
+    auto hash = llvm::SHA1::hash(llvm::ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(buffer.data()), buffer.size()));
+    return llvm::toHex(hash, /*LowerCase*/ true);
+}
+
+
+std::string ObjectCache::getEntryPath(const std::string &key, const Artifact &artifact) const {
+    return util::fmt::format("{}/{}{}{}", directory, kEntryPrefix, key, artifact.name);
+}
+
+
+bool ObjectCache::lookup(const std::string &key, const std::vector<Artifact> &artifacts) {
+    bool isHit = true;
+    for (const auto &artifact : artifacts) {
+        if (llvm::sys::fs::copy_file(getEntryPath(key, artifact), artifact.path)) {
+            isHit = false;
+            break;
+        }
+    }
+    updateStatistics(isHit);
+    return isHit;
+}
+
+
+void ObjectCache::insert(const std::string &key, const std::vector<Artifact> &artifacts) {
+    for (const auto &artifact : artifacts) {
+        // Write to a temporary file first and move it into place afterwards, so that concurrent compilations never see partial entries.
+        // The temporary file doesn't have the entry prefix, meaning that it's ignored by the pruning
+        llvm::SmallString<128> tempPath;
+        if (llvm::sys::fs::createUniqueFile(util::fmt::format("{}/tmp-%%%%%%%%", directory), tempPath)) {
+            return;
+        }
+        if (llvm::sys::fs::copy_file(artifact.path, tempPath) || llvm::sys::fs::rename(tempPath, getEntryPath(key, artifact))) {
+            llvm::sys::fs::remove(tempPath);
+            return;
+        }
+    }
+    
+    llvm::CachePruningPolicy policy;
+    policy.Interval = std::chrono::seconds(0); // always check the size after an insertion
+    policy.Expiration = std::chrono::seconds(0);
+    policy.MaxSizeBytes = maxSize;
+    llvm::pruneCache(directory, policy);
+}
+
+
+ObjectCache::Statistics ObjectCache::getStatistics() const {
+    Statistics stats;
+    
+    readCounters(util::fmt::format("{}/{}", directory, kStatisticsFilename), stats.hits, stats.misses);
+    
+    std::error_code EC;
+    for (llvm::sys::fs::directory_iterator it(directory, EC), end; it != end && !EC; it.increment(EC)) {
+        if (!util::string::has_prefix(llvm::sys::path::filename(it->path()), kEntryPrefix)) {
+            continue;
+        }
+        if (auto status = it->status()) {
+            stats.numFiles += 1;
+            stats.totalSize += status->getSize();
+        }
+    }
+    return stats;
+}
+
+
+// Statistics are updated by replacing the file, which means that concurrent compilations may lose an update, but never corrupt the file
+void ObjectCache::updateStatistics(bool isHit) {
+    auto statsPath = util::fmt::format("{}/{}", directory, kStatisticsFilename);
+    uint64_t hits = 0, misses = 0;
+    readCounters(statsPath, hits, misses);
+    (isHit ? hits : misses) += 1;
+    
+    llvm::SmallString<128> tempPath;
+    int FD;
+    if (llvm::sys::fs::createUniqueFile(util::fmt::format("{}/tmp-%%%%%%%%", directory), FD, tempPath)) {
+        return;
+    }
+    {
+        llvm::raw_fd_ostream OS(FD, /*shouldClose*/ true);
+        OS << hits << ' ' << misses << '\n';
+    }
+    if (llvm::sys::fs::rename(tempPath, statsPath)) {
+        llvm::sys::fs::remove(tempPath);
+    }
+}
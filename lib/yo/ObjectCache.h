@@ -0,0 +1,68 @@
+//
+//  ObjectCache.h
+//  yo
+//
+
+#pragma once
+
+#include "llvm/ADT/StringRef.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace llvm {
+class Module;
+}
+
+
+namespace yo::driver {
+
+/// A content-addressed cache of backend outputs (object files and assembly), stored in a directory.
+///
+/// Entries are keyed by the hash of the unoptimized module's bitcode, combined with the configuration of the optimizer and backend.
+/// Since the bitcode already captures everything the frontend did, the configuration only has to cover what happens after that
+/// (target, CPU, options, and the LLVM and yo versions).
+///
+/// The cache is pruned to stay below a maximum size, evicting the least recently used entries first.
+/// Hits and misses are counted in the cache directory, which means that the statistics cover all compilations using the cache.
+class ObjectCache {
+public:
+    /// A file produced by the backend, identified within a cache entry by its name (eg `.o`, or `.1.o` for the second of multiple objects)
+    struct Artifact {
+        std::string name;
+        std::string path;
+    };
+    
+    struct Statistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t numFiles = 0;
+        uint64_t totalSize = 0;
+    };
+    
+private:
+    std::string directory;
+    uint64_t maxSize;
+    
+public:
+    /// Opens (and, if necessary, creates) the cache in `directory`. A `maxSize` of 0 disables size-based eviction
+    ObjectCache(std::string directory, uint64_t maxSize);
+    
+    static std::string computeKey(const llvm::Module &module, llvm::StringRef configuration);
+    
+    /// Copies the entry's artifacts to their paths, and records a hit or a miss.
+    /// Returns false if any of the artifacts isn't cached, in which case the caller is expected to produce and insert them.
+    bool lookup(const std::string &key, const std::vector<Artifact> &artifacts);
+    
+    /// Adds the artifacts (which have to exist at their paths) to the cache, and prunes it
+    void insert(const std::string &key, const std::vector<Artifact> &artifacts);
+    
+    Statistics getStatistics() const;
+    
+private:
+    std::string getEntryPath(const std::string &key, const Artifact &artifact) const;
+    void updateStatistics(bool isHit);
+};
+
+} // ns yo::driver
@@ -7,6 +7,7 @@
 //
 
 #include "Type.h"
+#include "TypeContext.h"
 #include "Mangling.h"
 #include "util/Format.h"
 #include "util/MapUtils.h"
@@ -23,53 +24,18 @@ using namespace yo::irgen;
 
 #pragma mark - Type
 
-static Type *_voidTy;
-static NumericalType *_boolTy;
-static NumericalType *_int8Ty;
-static NumericalType *_int16Ty;
-static NumericalType *_int32Ty;
-static NumericalType *_int64Ty;
-static NumericalType *_uint8Ty;
-static NumericalType *_uint16Ty;
-static NumericalType *_uint32Ty;
-static NumericalType *_uint64Ty;
-static NumericalType *_float32Ty;
-static NumericalType *_float64Ty;
-
-
-void Type::initPrimitives() {
-    static bool didInitialize = false;
-    if (didInitialize) return;
-    
-    _voidTy    = new Type(TypeID::Void);
-    _boolTy    = new NumericalType(NumericalType::NumericalTypeID::Bool);
-    _int8Ty    = new NumericalType(NumericalType::NumericalTypeID::Int8);
-    _int16Ty   = new NumericalType(NumericalType::NumericalTypeID::Int16);
-    _int32Ty   = new NumericalType(NumericalType::NumericalTypeID::Int32);
-    _int64Ty   = new NumericalType(NumericalType::NumericalTypeID::Int64);
-    _uint8Ty   = new NumericalType(NumericalType::NumericalTypeID::UInt8);
-    _uint16Ty  = new NumericalType(NumericalType::NumericalTypeID::UInt16);
-    _uint32Ty  = new NumericalType(NumericalType::NumericalTypeID::UInt32);
-    _uint64Ty  = new NumericalType(NumericalType::NumericalTypeID::UInt64);
-    _float32Ty = new NumericalType(NumericalType::NumericalTypeID::Float32);
-    _float64Ty = new NumericalType(NumericalType::NumericalTypeID::Float64);
-    
-    didInitialize = true;
-}
-
-
-Type* Type::getVoidType() { return _voidTy; }
-NumericalType* Type::getBoolType() { return _boolTy; }
-NumericalType* Type::getInt8Type() { return _int8Ty; }
-NumericalType* Type::getInt16Type() { return _int16Ty; }
-NumericalType* Type::getInt32Type() { return _int32Ty; }
-NumericalType* Type::getInt64Type() { return _int64Ty; }
-NumericalType* Type::getUInt8Type() { return _uint8Ty; }
-NumericalType* Type::getUInt16Type() { return _uint16Ty; }
-NumericalType* Type::getUInt32Type() { return _uint32Ty; }
-NumericalType* Type::getUInt64Type() { return _uint64Ty; }
-NumericalType* Type::getFloat32Type() { return _float32Ty; }
-NumericalType* Type::getFloat64Type() { return _float64Ty; }
+Type* Type::getVoidType(TypeContext &context) { return context.getVoidType(); }
+NumericalType* Type::getBoolType(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::Bool); }
+NumericalType* Type::getInt8Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::Int8); }
+NumericalType* Type::getInt16Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::Int16); }
+NumericalType* Type::getInt32Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::Int32); }
+NumericalType* Type::getInt64Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::Int64); }
+NumericalType* Type::getUInt8Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::UInt8); }
+NumericalType* Type::getUInt16Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::UInt16); }
+NumericalType* Type::getUInt32Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::UInt32); }
+NumericalType* Type::getUInt64Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::UInt64); }
+NumericalType* Type::getFloat32Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::Float32); }
+NumericalType* Type::getFloat64Type(TypeContext &context) { return NumericalType::get(context, NumericalType::NumericalTypeID::Float64); }
 
 
 
@@ -88,57 +54,32 @@ std::string Type::str_desc() const {
 
 PointerType* Type::getPointerTo() {
     LKAssert(!isReferenceTy() && "pointer to reference is illegal");
-    if (pointerTo) return pointerTo;
-    return pointerTo = new PointerType(this);
+    return context->getPointerType(this);
 }
 
 ReferenceType* Type::getReferenceTo() {
     LKAssert(!isReferenceTy() && "reference to reference is illegal");
-    if (referenceTo) return referenceTo;
-    return referenceTo = new ReferenceType(this);
+    return context->getReferenceType(this);
 }
 
 
 
-Type* Type::createTemporary(const std::string &name, const std::string &canonicalName) {
-    auto ty = StructType::create(name, canonicalName, {}, {});
+Type* Type::createTemporary(TypeContext &context, const std::string &name, const std::string &canonicalName) {
+    auto ty = StructType::create(context, name, canonicalName, {}, {});
     ty->flags.insert(Flags::IsTemporary);
     return ty;
 }
 
-static std::map<std::string, StructType *> templatedTemporaryTypes;
-
-StructType* Type::createTemporary(const std::string &name, const std::string &canonicalName, const std::vector<Type *> &templateArgs) {
-    if (auto type = util::map::get_opt(templatedTemporaryTypes, name)) {
-        return *type;
-    }
-    auto type = StructType::create(name, canonicalName, {}, templateArgs, lex::SourceLocation());
-    type->setFlag(Flags::IsTemporary);
-    templatedTemporaryTypes[name] = type;
-    return type;
+StructType* Type::createTemporary(TypeContext &context, const std::string &name, const std::string &canonicalName, const std::vector<Type *> &templateArgs) {
+    return context.getTemporaryType(name, canonicalName, templateArgs);
 }
 
 
 #pragma mark - NumericalType
 
 
-NumericalType* NumericalType::get(NumericalTypeID id) {
-#define CASE(name) case NumericalTypeID::name: return Type::get##name##Type();
-    switch (id) {
-    CASE(Bool)
-    CASE(Int8)
-    CASE(Int16)
-    CASE(Int32)
-    CASE(Int64)
-    CASE(UInt8)
-    CASE(UInt16)
-    CASE(UInt32)
-    CASE(UInt64)
-    CASE(Float32)
-    CASE(Float64)
-    }
-#undef CASE
-    LKFatalError("unknown type id");
+NumericalType* NumericalType::get(TypeContext &context, NumericalTypeID id) {
+    return context.getNumericalType(id);
 }
 
 
@@ -171,6 +112,11 @@ bool NumericalType::isIntegerTy() const {
 
 
 std::string NumericalType::str_desc() const {
+    return getName(numericalTypeId);
+}
+
+
+const char* NumericalType::getName(NumericalTypeID numericalTypeId) {
     switch (numericalTypeId) {
         case NumericalTypeID::Bool: return "bool";
         case NumericalTypeID::Int8: return "i8";
@@ -253,17 +199,8 @@ std::string ReferenceType::str_desc() const {
 
 #pragma mark - FunctionType
 
-static std::vector<FunctionType *> allFunctionTypes;
-
-FunctionType* FunctionType::get(Type *returnType, std::vector<Type *> parameterTypes, bool isVariadic) {
-    for (auto FT : allFunctionTypes) {
-        if (FT->returnType == returnType && FT->parameterTypes == parameterTypes && FT->_isVariadic == isVariadic) {
-            return FT;
-        }
-    }
-    auto FT = new FunctionType(returnType, parameterTypes, isVariadic);
-    allFunctionTypes.push_back(FT);
-    return FT;
+FunctionType* FunctionType::get(TypeContext &context, Type *returnType, std::vector<Type *> parameterTypes, bool isVariadic) {
+    return context.getFunctionType(returnType, parameterTypes, isVariadic);
 }
 
 std::string FunctionType::str_desc() const {
@@ -282,36 +219,45 @@ std::string FunctionType::str_desc() const {
 
 #pragma mark - StructType
 
+StructType* StructType::create(TypeContext &context, std::string name, std::string canonicalName, MembersT members, lex::SourceLocation sourceLoc) {
+    return context.create<StructType>(name, canonicalName, members, sourceLoc);
+}
+
+StructType* StructType::create(TypeContext &context, std::string name, std::string canonicalName, MembersT members, std::vector<Type *> templateArgs, lex::SourceLocation SL) {
+    return context.create<StructType>(name, canonicalName, members, templateArgs, SL);
+}
+
+
 std::string StructType::str_desc() const {
     return mangling::demangle(name);
 }
 
 
 // TODO add an option to calculate a member's offset
-std::pair<uint64_t, Type *> StructType::getMember(const std::string &name) const {
-    uint64_t index = 0;
-    for (auto& [memName, memType] : members) {
-        if (memName == name) return {index, memType};
-        index += 1;
+void StructType::buildMemberIndices() {
+    memberIndices.reserve(members.size());
+    for (uint64_t index = 0; index < members.size(); index++) {
+        // if there are multiple members w/ the same name, the first one wins
+        memberIndices.try_emplace(util::Symbol(members[index].first), index);
     }
-    return {0, nullptr};
 }
 
 
+std::pair<uint64_t, Type *> StructType::getMember(util::Symbol name) const {
+    auto it = memberIndices.find(name);
+    if (it == memberIndices.end()) {
+        return {0, nullptr};
+    }
+    return {it->second, members[it->second].second};
+}
 
 
-#pragma mark - TupleType
 
-static std::map<std::vector<Type *>, TupleType *> registeredTupleTypes;
 
-TupleType* TupleType::get(const std::vector<Type *> &members) {
-    if (auto TT = util::map::get_opt(registeredTupleTypes, members)) {
-        return *TT;
-    }
+#pragma mark - TupleType
 
-    auto TT = new TupleType(members);
-    registeredTupleTypes[members] = TT;
-    return TT;
+TupleType* TupleType::get(TypeContext &context, const std::vector<Type *> &members) {
+    return context.getTupleType(members);
 }
 
 std::string TupleType::str_desc() const {
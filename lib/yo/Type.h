@@ -12,16 +12,12 @@
 #include "parse/TypeDesc.h"
 #include "util/util.h"
 #include "util/OptionSet.h"
+#include "util/Symbol.h"
 
 #include <vector>
 #include <utility>
 #include <string>
-
-
-namespace llvm {
-    class Type;
-    class DIType;
-}
+#include <unordered_map>
 
 
 namespace yo::irgen {
@@ -34,10 +30,14 @@ class PointerType;
 class ReferenceType;
 class FunctionType;
 class StructType;
+class TypeContext;
 
 
 
+/// Base class of all types. Types are owned by the TypeContext
 class Type {
+    friend class TypeContext;
+    
 public:
     enum class TypeID {
         Void,
@@ -57,8 +57,7 @@ public:
     
 private:
     const TypeID typeId;
-    llvm::Type *llvmType = nullptr;
-    llvm::DIType *llvmDIType = nullptr;
+    TypeContext *context = nullptr; // set by the context when allocating the type
     PointerType *pointerTo = nullptr;
     ReferenceType *referenceTo = nullptr;
     util::OptionSet<Flags> flags;
@@ -79,17 +78,8 @@ public:
     
     TypeID getTypeId() const { return typeId; }
     
-    llvm::Type* getLLVMType() const { return llvmType; }
-    void setLLVMType(llvm::Type *ty) {
-        LKAssert(!llvmType && "can only set llvmType once");
-        llvmType = ty;
-    }
-    
-    llvm::DIType* getLLVMDIType() const { return llvmDIType; }
-    void setLLVMDIType(llvm::DIType *ty) {
-        LKAssert(!llvmDIType && "can only set llvmDIType once");
-        llvmDIType = ty;
-    }
+    /// The context owning this type
+    TypeContext& getContext() const { return *context; }
     
     /// The mangled string representation of the type
     virtual std::string str_mangled() const;
@@ -127,23 +117,21 @@ public:
     ReferenceType* getReferenceTo();
 
     
-    static void initPrimitives();
-    
-    static Type* getVoidType();
-    static NumericalType* getBoolType();
-    static NumericalType* getInt8Type();
-    static NumericalType* getInt16Type();
-    static NumericalType* getInt32Type();
-    static NumericalType* getInt64Type();
-    static NumericalType* getUInt8Type();
-    static NumericalType* getUInt16Type();
-    static NumericalType* getUInt32Type();
-    static NumericalType* getUInt64Type();
-    static NumericalType* getFloat32Type(); // An IEEE 754 binary64 floating point type
-    static NumericalType* getFloat64Type(); // An IEEE 754 binary64 floating point type
+    static Type* getVoidType(TypeContext&);
+    static NumericalType* getBoolType(TypeContext&);
+    static NumericalType* getInt8Type(TypeContext&);
+    static NumericalType* getInt16Type(TypeContext&);
+    static NumericalType* getInt32Type(TypeContext&);
+    static NumericalType* getInt64Type(TypeContext&);
+    static NumericalType* getUInt8Type(TypeContext&);
+    static NumericalType* getUInt16Type(TypeContext&);
+    static NumericalType* getUInt32Type(TypeContext&);
+    static NumericalType* getUInt64Type(TypeContext&);
+    static NumericalType* getFloat32Type(TypeContext&); // An IEEE 754 binary64 floating point type
+    static NumericalType* getFloat64Type(TypeContext&); // An IEEE 754 binary64 floating point type
     
-    static Type* createTemporary(const std::string& name, const std::string &canonicalName);
-    static StructType* createTemporary(const std::string& name, const std::string &canonicalName, const std::vector<Type *> &templateArgs);
+    static Type* createTemporary(TypeContext&, const std::string& name, const std::string &canonicalName);
+    static StructType* createTemporary(TypeContext&, const std::string& name, const std::string &canonicalName, const std::vector<Type *> &templateArgs);
 
     
     static bool classof(const Type *type) {
@@ -157,7 +145,7 @@ inline std::ostream& operator<<(std::ostream &OS, Type *ty) {
 
 
 class NumericalType : public Type {
-    friend class Type;
+    friend class TypeContext;
 public:
     enum class NumericalTypeID {
         Int8, Int16, Int32, Int64,
@@ -190,14 +178,17 @@ public:
         return type->getTypeId() == TypeID::Numerical;
     }
     
-    static NumericalType* get(NumericalTypeID);
+    static NumericalType* get(TypeContext&, NumericalTypeID);
+    
+    /// The name of the numerical type w/ this id (eg `i64`)
+    static const char* getName(NumericalTypeID);
 };
 
 
 
 
 class PointerType : public Type {
-    friend class Type;
+    friend class TypeContext;
     
     Type *pointee;
     
@@ -218,7 +209,7 @@ public:
 
 
 class ReferenceType : public Type {
-    friend class Type;
+    friend class TypeContext;
     Type *pointee;
     
     // Use `Type::getReferenceTo` to create a reference type
@@ -238,7 +229,7 @@ public:
 
 
 class FunctionType : public Type {
-    friend class Type;
+    friend class TypeContext;
     
     Type *returnType;
     std::vector<Type *> parameterTypes;
@@ -266,7 +257,7 @@ public:
     
     std::string str_desc() const override;
     
-    static FunctionType* get(Type *returnType, std::vector<Type *> parameterTypes, bool isVariadic);
+    static FunctionType* get(TypeContext&, Type *returnType, std::vector<Type *> parameterTypes, bool isVariadic);
     
     static bool classof(const Type *type) {
         return type->getTypeId() == TypeID::Function;
@@ -278,7 +269,7 @@ public:
 
 
 class StructType : public Type {
-    friend class Type;
+    friend class TypeContext;
 public:
     using MembersT = std::vector<std::pair<std::string, Type *>>;
 
@@ -286,14 +277,21 @@ private:
     std::string name;
     std::string canonicalName;
     MembersT members;
+    std::unordered_map<util::Symbol, uint64_t> memberIndices;
     std::vector<Type *> templateArguments;
     lex::SourceLocation sourceLoc;
     
     StructType(std::string name, std::string canonicalName, MembersT members, lex::SourceLocation sourceLoc)
-    : Type(Type::TypeID::Struct), name(name), canonicalName(canonicalName), members(members), sourceLoc(sourceLoc) {}
+    : Type(Type::TypeID::Struct), name(name), canonicalName(canonicalName), members(members), sourceLoc(sourceLoc) {
+        buildMemberIndices();
+    }
     
     StructType(std::string name, std::string canonicalName, MembersT members, std::vector<Type *> templateArgs, lex::SourceLocation SL)
-    : Type(Type::TypeID::Struct), name(name), canonicalName(canonicalName), members(members), templateArguments(templateArgs), sourceLoc(SL) {}
+    : Type(Type::TypeID::Struct), name(name), canonicalName(canonicalName), members(members), templateArguments(templateArgs), sourceLoc(SL) {
+        buildMemberIndices();
+    }
+    
+    void buildMemberIndices();
     
 public:
     const std::string& getName() const {
@@ -310,7 +308,9 @@ public:
     
     std::string str_desc() const override;
     
-    bool hasMember(const std::string &name) const;
+    bool hasMember(util::Symbol name) const {
+        return memberIndices.find(name) != memberIndices.end();
+    }
     
     uint64_t memberCount() const {
         return members.size();
@@ -318,7 +318,7 @@ public:
     
     // Returns a tuple containing the members index and type
     // Returns {0, nullptr} if the struct does not have a member with this name
-    std::pair<uint64_t, Type*> getMember(const std::string &name) const;
+    std::pair<uint64_t, Type*> getMember(util::Symbol name) const;
     
     const MembersT& getMembers() const {
         return members;
@@ -336,13 +336,8 @@ public:
     }
     
     
-    static StructType* create(std::string name, std::string canonicalName, MembersT members, lex::SourceLocation sourceLoc) {
-        return new StructType(name, canonicalName, members, sourceLoc);
-    }
-    
-    static StructType* create(std::string name, std::string canonicalName, MembersT members, std::vector<Type *> templateArgs, lex::SourceLocation SL) {
-        return new StructType(name, canonicalName, members, templateArgs, SL);
-    }
+    static StructType* create(TypeContext&, std::string name, std::string canonicalName, MembersT members, lex::SourceLocation sourceLoc);
+    static StructType* create(TypeContext&, std::string name, std::string canonicalName, MembersT members, std::vector<Type *> templateArgs, lex::SourceLocation SL);
     
     static bool classof(const Type *type) {
         return type->getTypeId() == TypeID::Struct;
@@ -353,13 +348,14 @@ public:
 
 
 class TupleType : public Type {
+    friend class TypeContext;
+    
     std::vector<Type *> members;
-    StructType *underlyingStructType = nullptr;
 
     TupleType(const std::vector<Type *> &M) : Type(Type::TypeID::Tuple), members(M) {}
 
 public:
-    static TupleType* get(const std::vector<Type *>&);
+    static TupleType* get(TypeContext&, const std::vector<Type *>&);
     
     uint64_t memberCount() const {
         return members.size();
@@ -375,15 +371,6 @@ public:
     }
     
     std::string str_desc() const override;
-    
-    StructType* getUnderlyingStructType() const {
-        return underlyingStructType;
-    }
-    
-    void setUnderlyingStructType(StructType *ST) {
-        LKAssert(!underlyingStructType && "cannot overwrite a tuple's underlying struct type");
-        underlyingStructType = ST;
-    }
 
     static bool classof(const Type *type) {
         return type->getTypeId() == TypeID::Tuple;
@@ -0,0 +1,75 @@
+//
+//  TypeContext.cpp
+//  yo
+//
+
+#include "TypeContext.h"
+
+using namespace yo;
+using namespace yo::irgen;
+
+
+TypeContext::TypeContext() {
+    using NTID = NumericalType::NumericalTypeID;
+    
+    voidTy = allocate<Type>(Type::TypeID::Void);
+    for (auto id : { NTID::Int8, NTID::Int16, NTID::Int32, NTID::Int64, NTID::UInt8, NTID::UInt16, NTID::UInt32, NTID::UInt64, NTID::Float32, NTID::Float64, NTID::Bool }) {
+        numericalTypes[static_cast<size_t>(id)] = allocate<NumericalType>(id);
+    }
+}
+
+
+TypeContext::~TypeContext() {
+    for (auto it = types.rbegin(); it != types.rend(); it++) {
+        (*it)->~Type();
+    }
+}
+
+
+PointerType* TypeContext::getPointerType(Type *pointee) {
+    std::lock_guard lock(mutex);
+    if (!pointee->pointerTo) {
+        pointee->pointerTo = allocate<PointerType>(pointee);
+    }
+    return pointee->pointerTo;
+}
+
+
+ReferenceType* TypeContext::getReferenceType(Type *referencedType) {
+    std::lock_guard lock(mutex);
+    if (!referencedType->referenceTo) {
+        referencedType->referenceTo = allocate<ReferenceType>(referencedType);
+    }
+    return referencedType->referenceTo;
+}
+
+
+FunctionType* TypeContext::getFunctionType(Type *returnType, const std::vector<Type *> &parameterTypes, bool isVariadic) {
+    std::lock_guard lock(mutex);
+    auto [it, didInsert] = functionTypes.try_emplace(FunctionTypeKey{ returnType, parameterTypes, isVariadic }, nullptr);
+    if (didInsert) {
+        it->second = allocate<FunctionType>(returnType, parameterTypes, isVariadic);
+    }
+    return it->second;
+}
+
+
+TupleType* TypeContext::getTupleType(const std::vector<Type *> &members) {
+    std::lock_guard lock(mutex);
+    auto [it, didInsert] = tupleTypes.try_emplace(members, nullptr);
+    if (didInsert) {
+        it->second = allocate<TupleType>(members);
+    }
+    return it->second;
+}
+
+
+StructType* TypeContext::getTemporaryType(const std::string &name, const std::string &canonicalName, const std::vector<Type *> &templateArgs) {
+    std::lock_guard lock(mutex);
+    auto [it, didInsert] = temporaryTypes.try_emplace(name, nullptr);
+    if (didInsert) {
+        it->second = allocate<StructType>(name, canonicalName, StructType::MembersT{}, templateArgs, lex::SourceLocation());
+        it->second->setFlag(Type::Flags::IsTemporary);
+    }
+    return it->second;
+}
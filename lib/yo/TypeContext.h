@@ -0,0 +1,100 @@
+//
+//  TypeContext.h
+//  yo
+//
+
+#pragma once
+
+#include "Type.h"
+
+#include "llvm/ADT/Hashing.h"
+#include "llvm/Support/Allocator.h"
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+namespace yo::irgen {
+
+
+/// Owns all types created during a compilation.
+///
+/// Types are bump-allocated and only deallocated (all at once) when the context is destroyed, which means that they can
+/// be referenced via plain pointers. Structural types (pointers, references, functions, tuples and temporary template instances)
+/// are uniqued, meaning that two such types are equal iff they are the same object.
+/// The context is created by the driver and has to outlive everything referencing its types (ie, the AST and irgen).
+class TypeContext {
+    struct TypeListHash {
+        size_t operator()(const std::vector<Type *> &types) const {
+            return llvm::hash_combine_range(types.begin(), types.end());
+        }
+    };
+    
+    struct FunctionTypeKey {
+        Type *returnType;
+        std::vector<Type *> parameterTypes;
+        bool isVariadic;
+        
+        bool operator==(const FunctionTypeKey &other) const {
+            return returnType == other.returnType && parameterTypes == other.parameterTypes && isVariadic == other.isVariadic;
+        }
+        
+        struct Hash {
+            size_t operator()(const FunctionTypeKey &key) const {
+                return llvm::hash_combine(key.returnType, TypeListHash()(key.parameterTypes), key.isVariadic);
+            }
+        };
+    };
+    
+    std::mutex mutex;
+    llvm::BumpPtrAllocator allocator;
+    std::vector<Type *> types; // all types, in allocation order
+    
+    Type *voidTy;
+    std::array<NumericalType *, 11> numericalTypes; // indexed by NumericalTypeID
+    std::unordered_map<FunctionTypeKey, FunctionType *, FunctionTypeKey::Hash> functionTypes;
+    std::unordered_map<std::vector<Type *>, TupleType *, TypeListHash> tupleTypes;
+    std::unordered_map<std::string, StructType *> temporaryTypes;
+    
+    // Callers are expected to hold the lock
+    template <typename T, typename... Args>
+    T* allocate(Args&&... args) {
+        auto type = new (allocator.Allocate<T>()) T(std::forward<Args>(args)...);
+        type->context = this;
+        types.push_back(type);
+        return type;
+    }
+    
+public:
+    TypeContext();
+    TypeContext(const TypeContext&) = delete;
+    TypeContext& operator=(const TypeContext&) = delete;
+    ~TypeContext();
+    
+    /// Allocates a new type in the context. Structural types should be obtained via the respective getter instead
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        std::lock_guard lock(mutex);
+        return allocate<T>(std::forward<Args>(args)...);
+    }
+    
+    Type* getVoidType() const {
+        return voidTy;
+    }
+    
+    NumericalType* getNumericalType(NumericalType::NumericalTypeID id) const {
+        return numericalTypes[static_cast<size_t>(id)];
+    }
+    
+    PointerType* getPointerType(Type *pointee);
+    ReferenceType* getReferenceType(Type *referencedType);
+    FunctionType* getFunctionType(Type *returnType, const std::vector<Type *> &parameterTypes, bool isVariadic);
+    TupleType* getTupleType(const std::vector<Type *> &members);
+    StructType* getTemporaryType(const std::string &name, const std::string &canonicalName, const std::vector<Type *> &templateArgs);
+};
+
+
+} // ns yo::irgen
@@ -0,0 +1,313 @@
+//
+//  driver.cpp
+//  yo
+//
+
+#include "yo/Driver.h"
+#include "util/Format.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/Utils/ModuleUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+using namespace yo;
+
+
+// A program that shows whether its global ctor and dtor ran:
+// The ctor sets a global to 7 and prints "ctor", main prints its first argument and returns the global, and the dtor prints "dtor"
+static std::unique_ptr<llvm::Module> makeTestProgram(llvm::LLVMContext &C) {
+    auto M = std::make_unique<llvm::Module>("test", C);
+    llvm::IRBuilder<> builder(C);
+    
+    auto i32 = builder.getInt32Ty();
+    auto i8Ptr = builder.getInt8PtrTy();
+    auto printf = M->getOrInsertFunction("printf", llvm::FunctionType::get(i32, { i8Ptr }, true));
+    auto value = new llvm::GlobalVariable(*M, i32, false, llvm::GlobalValue::InternalLinkage, builder.getInt32(0), "value");
+    
+    auto makeFunction = [&](const char *name, llvm::FunctionType *type, llvm::GlobalValue::LinkageTypes linkage) {
+        auto F = llvm::Function::Create(type, linkage, name, *M);
+        builder.SetInsertPoint(llvm::BasicBlock::Create(C, "entry", F));
+        return F;
+    };
+    auto voidFnTy = llvm::FunctionType::get(builder.getVoidTy(), false);
+    
+    auto ctor = makeFunction("ctor", voidFnTy, llvm::GlobalValue::InternalLinkage);
+    builder.CreateStore(builder.getInt32(7), value);
+    builder.CreateCall(printf, { builder.CreateGlobalStringPtr("ctor\n") });
+    builder.CreateRetVoid();
+    llvm::appendToGlobalCtors(*M, ctor, 65535);
+    
+    auto dtor = makeFunction("dtor", voidFnTy, llvm::GlobalValue::InternalLinkage);
+    builder.CreateCall(printf, { builder.CreateGlobalStringPtr("dtor\n") });
+    builder.CreateRetVoid();
+    llvm::appendToGlobalDtors(*M, dtor, 65535);
+    
+    auto main = makeFunction("main", llvm::FunctionType::get(i32, { i32, i8Ptr->getPointerTo() }, false), llvm::GlobalValue::ExternalLinkage);
+    auto arg = builder.CreateLoad(i8Ptr, builder.CreateConstGEP1_64(i8Ptr, main->getArg(1), 1));
+    builder.CreateCall(printf, { builder.CreateGlobalStringPtr("%s\n"), arg });
+    builder.CreateRet(builder.CreateLoad(i32, value));
+    
+    return M;
+}
+
+
+static void emitObjectFile(llvm::Module &M, const std::string &triple, const std::string &path) {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+    
+    std::string error;
+    auto target = llvm::TargetRegistry::lookupTarget(triple, error);
+    ASSERT_NE(target, nullptr) << error;
+    // Same as the driver, see `emitModule`
+    llvm::TargetOptions options;
+    options.UseInitArray = true;
+    std::unique_ptr<llvm::TargetMachine> TM(target->createTargetMachine(triple, "generic", "", options, {}));
+    M.setDataLayout(TM->createDataLayout());
+    M.setTargetTriple(triple);
+    
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(path, EC);
+    ASSERT_FALSE(EC) << EC.message();
+    llvm::legacy::PassManager PM;
+    ASSERT_FALSE(TM->addPassesToEmitFile(PM, OS, nullptr, llvm::CodeGenFileType::CGFT_ObjectFile));
+    PM.run(M);
+}
+
+
+
+TEST(driver, linkerArgs) {
+    driver::ELFLinkEnvironment env = { "elf_x86_64", "/lib64/ld-linux-x86-64.so.2", "/usr/lib/x86_64-linux-gnu", "/usr/lib/gcc/x86_64-linux-gnu/12" };
+    auto args = driver::getELFLinkerArgs(env, { "a.o", "b.o" }, "a.out");
+    auto indexOf = [&args](const std::string &arg) {
+        return std::find(args.begin(), args.end(), arg) - args.begin();
+    };
+    
+    // The crt objects have to surround the program's objects and libraries, in this exact order
+    auto crtObjects = {
+        "/usr/lib/x86_64-linux-gnu/crt1.o", "/usr/lib/x86_64-linux-gnu/crti.o", "/usr/lib/gcc/x86_64-linux-gnu/12/crtbegin.o",
+        "a.o", "b.o", "-lgcc", "-lgcc_s", "-lc",
+        "/usr/lib/gcc/x86_64-linux-gnu/12/crtend.o", "/usr/lib/x86_64-linux-gnu/crtn.o"
+    };
+    int64_t previousIndex = -1;
+    for (auto arg : crtObjects) {
+        auto index = indexOf(arg);
+        ASSERT_LT(index, static_cast<int64_t>(args.size())) << arg;
+        EXPECT_GT(index, previousIndex) << arg;
+        previousIndex = index;
+    }
+    
+    EXPECT_EQ(args.at(indexOf("-dynamic-linker") + 1), env.dynamicLinker);
+    EXPECT_EQ(args.at(indexOf("-m") + 1), env.emulation);
+    EXPECT_EQ(args.at(indexOf("-o") + 1), "a.out");
+}
+
+
+TEST(driver, linkerEnvironmentUnsupportedTargets) {
+    EXPECT_FALSE(driver::findELFLinkEnvironment("x86_64-apple-macosx10.15"));
+    EXPECT_FALSE(driver::findELFLinkEnvironment("x86_64-pc-windows-msvc"));
+    EXPECT_FALSE(driver::findELFLinkEnvironment("riscv64-unknown-linux-gnu"));
+}
+
+
+// Links an object file w/ the system's linker, and runs the executable
+TEST(driver, linkDirectly) {
+    auto triple = llvm::sys::getDefaultTargetTriple();
+    if (!driver::findELFLinkEnvironment(triple)) {
+        GTEST_SKIP() << "no ELF link environment for " << triple;
+    }
+    
+    llvm::SmallString<128> directory;
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("yo-test-link", directory));
+    auto objectFilePath = util::fmt::format("{}/test.o", directory.str().str());
+    auto executablePath = util::fmt::format("{}/test", directory.str().str());
+    
+    llvm::LLVMContext C;
+    auto M = makeTestProgram(C);
+    emitObjectFile(*M, triple, objectFilePath);
+    
+    if (!driver::linkDirectly(triple, { objectFilePath }, executablePath)) {
+        GTEST_SKIP() << "no linker installed";
+    }
+    
+    testing::internal::CaptureStdout();
+    auto exitCode = llvm::sys::ExecuteAndWait(executablePath, { executablePath, "hello" });
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "ctor\nhello\ndtor\n");
+    EXPECT_EQ(exitCode, 7);
+    
+    llvm::sys::fs::remove_directories(directory);
+}
+
+
+// A failed link has to be reported to the caller, which then falls back to the compiler driver
+TEST(driver, linkDirectlyFailure) {
+    auto triple = llvm::sys::getDefaultTargetTriple();
+    if (!driver::findELFLinkEnvironment(triple)) {
+        GTEST_SKIP() << "no ELF link environment for " << triple;
+    }
+    
+    llvm::SmallString<128> directory;
+    ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("yo-test-link", directory));
+    auto objectFilePath = util::fmt::format("{}/missing.o", directory.str().str());
+    auto executablePath = util::fmt::format("{}/test", directory.str().str());
+    
+    EXPECT_FALSE(driver::linkDirectly(triple, { objectFilePath }, executablePath));
+    EXPECT_FALSE(llvm::sys::fs::exists(executablePath));
+    
+    llvm::sys::fs::remove_directories(directory);
+}
+
+
+TEST(driver, runModuleInJIT) {
+    driver::Options options{};
+    options.inputFile = "test.yo";
+    options.runArgs = { "hello" };
+    
+    auto C = std::make_unique<llvm::LLVMContext>();
+    auto M = makeTestProgram(*C);
+    
+    int exitCode = -1;
+    testing::internal::CaptureStdout();
+    ASSERT_TRUE(driver::runModuleInJIT(options, std::move(M), std::move(C), exitCode));
+    // The program's output goes through the same stdio buffer as our own
+    fflush(stdout);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "ctor\nhello\ndtor\n");
+    EXPECT_EQ(exitCode, 7);
+}
+
+
+// Compiles the program and runs it in the JIT, w/ the specified arguments. Returns the program's exit code
+static int compileAndRun(const std::string &source, std::vector<std::string> runArgs, std::string &output, unsigned numIRGenThreads = 1) {
+    llvm::SmallString<128> directory;
+    EXPECT_FALSE(llvm::sys::fs::createUniqueDirectory("yo-test-run", directory));
+    auto inputFile = util::fmt::format("{}/main.yo", directory.str().str());
+    {
+        std::error_code EC;
+        llvm::raw_fd_ostream OS(inputFile, EC);
+        EXPECT_FALSE(EC) << EC.message();
+        OS << source;
+    }
+    
+    driver::Options options{};
+    options.inputFile = inputFile;
+    options.runInJIT = true;
+    options.runArgs = std::move(runArgs);
+    options.numIRGenThreads = numIRGenThreads;
+    
+    int exitCode = -1;
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(driver::run(options, &exitCode));
+    fflush(stdout);
+    output = testing::internal::GetCapturedStdout();
+    // Skip the working directory, which the driver prints first
+    output.erase(0, output.find('\n') + 1);
+    
+    llvm::sys::fs::remove_directories(directory);
+    return exitCode;
+}
+
+
+TEST(driver, runProgram) {
+    auto source = R"(
+use ":std/core";
+
+#[startup]
+fn setup() {
+    printf(b"ctor\n");
+}
+
+fn main(argc: i32, argv: **i8) -> i32 {
+    printf(b"%s %s\n", argv[1], argv[2]);
+    let x: i32 = 40;
+    x += argc - 1;
+    return x;
+}
+)";
+    std::string output;
+    EXPECT_EQ(compileAndRun(source, { "hello", "world" }, output), 42);
+    EXPECT_EQ(output, "ctor\nhello world\n");
+}
+
+
+TEST(driver, runProgramWithoutArguments) {
+    auto source = R"(
+use ":std/core";
+
+fn fib(n: i64) -> i64 {
+    if n < 2 {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+
+fn main() -> i32 {
+    printf(b"%lld\n", fib(10));
+    return 3;
+}
+)";
+    std::string output;
+    EXPECT_EQ(compileAndRun(source, { "ignored" }, output), 3);
+    EXPECT_EQ(output, "55\n");
+}
+
+
+TEST(driver, runProgramWithParallelIRGen) {
+    // The functions end up in different partitions, and all of them instantiate `twice<i64>`
+    auto source = R"(
+use ":std/core";
+
+struct Counter {
+    value: i64
+}
+
+fn twice<T>(x: T) -> T {
+    return x + x;
+}
+
+#[startup]
+fn setup() {
+    printf(b"ctor\n");
+}
+
+fn a(x: i64) -> i64 {
+    return twice(x) + 1;
+}
+
+fn b(x: i64) -> i64 {
+    return twice(a(x));
+}
+
+fn c(x: i64) -> i64 {
+    let counter = Counter(twice(x));
+    return counter.value + b(x);
+}
+
+fn main() -> i32 {
+    printf(b"%lld %lld %lld\n", a(1), b(2), c(3));
+    return 5;
+}
+)";
+    for (unsigned numIRGenThreads : { 1, 2, 3, 8 }) {
+        std::string output;
+        EXPECT_EQ(compileAndRun(source, {}, output, numIRGenThreads), 5);
+        EXPECT_EQ(output, "ctor\n3 10 20\n") << numIRGenThreads << " IRGen threads";
+    }
+}
@@ -0,0 +1,99 @@
+//
+//  lexer.cpp
+//  yo
+//
+
+#include "lex/Lexer.h"
+#include "lex/Diagnostics.h"
+#include "lex/SourceManager.h"
+#include "util/util.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <string_view>
+
+
+using namespace yo;
+using namespace yo::lex;
+
+
+// Shared by all tests, the lexed tokens reference the added files' contents
+static SourceManager sourceManager;
+
+static TokenList lexSource(std::string source) {
+    auto fileId = sourceManager.addFile("input.yo", std::move(source));
+    return Lexer(sourceManager, fileId).lex();
+}
+
+
+// Lexes the input, expecting it to emit an error. Returns the error's first line (ie, location and message)
+static std::string lexError(std::string source) {
+    diagnostics::DeferErrorsScope deferErrors;
+    try {
+        lexSource(std::move(source));
+    } catch (const diagnostics::DeferredError &error) {
+        return error.text.substr(0, error.text.find('\n'));
+    }
+    return "";
+}
+
+
+// Value of the first token in the input, which is expected to have the specified kind
+static uint64_t lexNumericValue(std::string source, TokenKind expectedKind) {
+    auto tokens = lexSource(std::move(source));
+    const auto &token = tokens.getTokens().at(0);
+    EXPECT_EQ(token.getKind(), expectedKind);
+    return tokens.getNumericValue(token);
+}
+
+
+
+TEST(lexer, numberLiterals) {
+    EXPECT_EQ(lexNumericValue("0", TokenKind::IntegerLiteral), 0);
+    EXPECT_EQ(lexNumericValue("1234", TokenKind::IntegerLiteral), 1234);
+    EXPECT_EQ(lexNumericValue("0b1011", TokenKind::IntegerLiteral), 0b1011);
+    EXPECT_EQ(lexNumericValue("0o17", TokenKind::IntegerLiteral), 017);
+    EXPECT_EQ(lexNumericValue("0xCafe", TokenKind::IntegerLiteral), 0xcafe);
+    EXPECT_EQ(lexNumericValue("18446744073709551615", TokenKind::IntegerLiteral), UINT64_MAX);
+    EXPECT_EQ(lexNumericValue("0xFFFFFFFFFFFFFFFF", TokenKind::IntegerLiteral), UINT64_MAX);
+    EXPECT_EQ(util::bitcast<double>(lexNumericValue("1.5", TokenKind::DoubleLiteral)), 1.5);
+    EXPECT_EQ(util::bitcast<double>(lexNumericValue("0.25", TokenKind::DoubleLiteral)), 0.25);
+}
+
+
+TEST(lexer, invalidDigitsInNumberLiterals) {
+    EXPECT_EQ(lexError("0b102"), "input.yo:1:5: error: Invalid character in number literal");
+    EXPECT_EQ(lexError("0o78"), "input.yo:1:4: error: Invalid character in number literal");
+    EXPECT_EQ(lexError("12ab"), "input.yo:1:3: error: Invalid character in number literal");
+    EXPECT_EQ(lexError("01"), "input.yo:1:2: error: Invalid character in number literal");
+    EXPECT_EQ(lexError("0x"), "input.yo:1:1: error: Expected digits after base prefix");
+    
+    // Float literals can only contain decimal digits, on either side of the period
+    EXPECT_EQ(lexError("12ab.5"), "input.yo:1:3: error: Invalid character in number literal");
+    EXPECT_EQ(lexError("1e.5"), "input.yo:1:2: error: Invalid character in number literal");
+    EXPECT_EQ(lexError("9f.1"), "input.yo:1:2: error: Invalid character in number literal");
+}
+
+
+TEST(lexer, numberLiteralOverflow) {
+    EXPECT_EQ(lexError("18446744073709551616"), "input.yo:1:1: error: Integer literal is too large");
+    EXPECT_EQ(lexError("0x10000000000000000"), "input.yo:1:1: error: Integer literal is too large");
+    EXPECT_EQ(lexError(std::string(400, '9') + ".0"), "input.yo:1:1: error: Floating point literal is out of range");
+}
+
+
+TEST(lexer, escapeSequences) {
+    EXPECT_EQ(lexNumericValue("'a'", TokenKind::CharLiteral), 'a');
+    EXPECT_EQ(lexNumericValue("'\\n'", TokenKind::CharLiteral), '\n');
+    EXPECT_EQ(lexNumericValue("'\\\\'", TokenKind::CharLiteral), '\\');
+    EXPECT_EQ(lexNumericValue("'\\x41'", TokenKind::CharLiteral), 'A');
+    EXPECT_EQ(lexNumericValue("'\\101'", TokenKind::CharLiteral), 'A');
+    
+    auto tokens = lexSource("\"a\\tb\\x41\\0\"");
+    EXPECT_EQ(tokens.getStringValue(tokens.getTokens().at(0)), std::string("a\tbA\0", 5));
+    
+    EXPECT_EQ(lexError("'\\x4'"), "input.yo:1:2: error: Expected two hex digits in escape sequence");
+    EXPECT_EQ(lexError("'\\777'"), "input.yo:1:2: error: Escape sequence out of range");
+    EXPECT_EQ(lexError("'\\q'"), "input.yo:1:2: error: Invalid escape sequence");
+}
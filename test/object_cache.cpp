@@ -0,0 +1,159 @@
+//
+//  object_cache.cpp
+//  yo
+//
+
+#include "yo/ObjectCache.h"
+#include "util/Format.h"
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Type.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+using namespace yo;
+using namespace yo::driver;
+
+
+// A module w/ a single global variable
+static std::unique_ptr<llvm::Module> makeModule(llvm::LLVMContext &C, const std::string &globalName) {
+    auto M = std::make_unique<llvm::Module>("test", C);
+    auto i32 = llvm::Type::getInt32Ty(C);
+    new llvm::GlobalVariable(*M, i32, false, llvm::GlobalValue::ExternalLinkage, llvm::ConstantInt::get(i32, 0), globalName);
+    return M;
+}
+
+
+static void writeFile(const std::string &path, const std::string &contents) {
+    std::ofstream(path) << contents;
+}
+
+
+static std::string readFile(const std::string &path) {
+    auto buffer = llvm::MemoryBuffer::getFile(path);
+    return buffer ? (*buffer)->getBuffer().str() : "";
+}
+
+
+class ObjectCacheTest : public testing::Test {
+protected:
+    std::string directory; // contains the cache, and the artifacts
+    
+    void SetUp() override {
+        llvm::SmallString<128> path;
+        ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("yo-test-cache", path));
+        directory = path.str().str();
+    }
+    
+    void TearDown() override {
+        llvm::sys::fs::remove_directories(directory);
+    }
+    
+    std::string getCacheDirectory() const {
+        return util::fmt::format("{}/cache", directory);
+    }
+    
+    std::string getArtifactPath(const std::string &name) const {
+        return util::fmt::format("{}/{}", directory, name);
+    }
+};
+
+
+
+TEST_F(ObjectCacheTest, keys) {
+    llvm::LLVMContext C;
+    auto M1 = makeModule(C, "a");
+    auto M2 = makeModule(C, "b");
+    
+    auto key = ObjectCache::computeKey(*M1, "x86_64;O2");
+    EXPECT_EQ(key.size(), 40); // hex-encoded SHA1
+    EXPECT_EQ(key, ObjectCache::computeKey(*M1, "x86_64;O2"));
+    EXPECT_EQ(key, ObjectCache::computeKey(*makeModule(C, "a"), "x86_64;O2"));
+    EXPECT_NE(key, ObjectCache::computeKey(*M1, "x86_64;O3"));
+    EXPECT_NE(key, ObjectCache::computeKey(*M2, "x86_64;O2"));
+}
+
+
+TEST_F(ObjectCacheTest, lookupAfterInsert) {
+    ObjectCache cache(getCacheDirectory(), 0);
+    std::vector<ObjectCache::Artifact> artifacts = {
+        { ".0.o", getArtifactPath("test.0.o") },
+        { ".1.o", getArtifactPath("test.1.o") }
+    };
+    
+    EXPECT_FALSE(cache.lookup("key", artifacts));
+    
+    writeFile(artifacts[0].path, "first object");
+    writeFile(artifacts[1].path, "second object");
+    cache.insert("key", artifacts);
+    llvm::sys::fs::remove(artifacts[0].path);
+    llvm::sys::fs::remove(artifacts[1].path);
+    
+    ASSERT_TRUE(cache.lookup("key", artifacts));
+    EXPECT_EQ(readFile(artifacts[0].path), "first object");
+    EXPECT_EQ(readFile(artifacts[1].path), "second object");
+    
+    // Entries are only hits if all of their artifacts are cached
+    EXPECT_FALSE(cache.lookup("key", { { ".2.o", getArtifactPath("test.2.o") } }));
+    EXPECT_FALSE(cache.lookup("other", artifacts));
+}
+
+
+TEST_F(ObjectCacheTest, pruning) {
+    ObjectCache cache(getCacheDirectory(), 3000);
+    ObjectCache::Artifact first = { ".o", getArtifactPath("first.o") };
+    ObjectCache::Artifact second = { ".o", getArtifactPath("second.o") };
+    
+    writeFile(first.path, std::string(2000, 'a'));
+    cache.insert("first", { first });
+    EXPECT_EQ(cache.getStatistics().totalSize, 2000);
+    
+    // The cache can't hold both entries, so the least recently used one is evicted
+    writeFile(second.path, std::string(1500, 'b'));
+    cache.insert("second", { second });
+    
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.numFiles, 1);
+    EXPECT_EQ(stats.totalSize, 1500);
+    EXPECT_TRUE(cache.lookup("second", { second }));
+    EXPECT_FALSE(cache.lookup("first", { first }));
+}
+
+
+TEST_F(ObjectCacheTest, statistics) {
+    ObjectCache::Artifact artifact = { ".o", getArtifactPath("test.o") };
+    {
+        ObjectCache cache(getCacheDirectory(), 0);
+        auto stats = cache.getStatistics();
+        EXPECT_EQ(stats.hits, 0);
+        EXPECT_EQ(stats.misses, 0);
+        EXPECT_EQ(stats.numFiles, 0);
+        EXPECT_EQ(stats.totalSize, 0);
+        
+        EXPECT_FALSE(cache.lookup("key", { artifact }));
+        writeFile(artifact.path, "object");
+        cache.insert("key", { artifact });
+        EXPECT_TRUE(cache.lookup("key", { artifact }));
+        EXPECT_TRUE(cache.lookup("key", { artifact }));
+    }
+    
+    // The counters are stored in the cache directory, and shared by all compilations using it
+    ObjectCache cache(getCacheDirectory(), 0);
+    auto stats = cache.getStatistics();
+    EXPECT_EQ(stats.hits, 2);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.numFiles, 1);
+    EXPECT_EQ(stats.totalSize, 6);
+}
@@ -3,7 +3,6 @@ import datetime
 import os
 import sys
 import re
-import subprocess
 
 STDLIB_DIRECTORY =  sys.argv[1]
 OUTPUT_FILE_PATH =  sys.argv[2]
@@ -31,9 +30,16 @@ module_symbols = {}
 for filename in glob.iglob(f'{STDLIB_DIRECTORY}/**/*.yo', recursive=True):
      f.write(f"\n\n// File at {filename}\n")
      filename = filename.replace(STDLIB_PARENT + '/', '')
-     module_symbols[filename] = filename_pattern.sub('_', filename)
-     x = subprocess.check_output(['/usr/bin/xxd', '-i', filename], encoding='ascii', cwd=STDLIB_PARENT)
-     f.write(x)
+     symbol = filename_pattern.sub('_', filename)
+     module_symbols[filename] = symbol
+     with open(os.path.join(STDLIB_PARENT, filename), 'rb') as module_file:
+          contents = module_file.read()
+     # The lexer expects its input to be followed by a NUL byte, which is not included in the length
+     data = contents + b'\0'
+     f.write(f'static const unsigned char {symbol}[] = {{\n')
+     for i in range(0, len(data), 12):
+          f.write('  ' + ', '.join(f'0x{b:02x}' for b in data[i:i+12]) + ',\n')
+     f.write(f'}};\nstatic const unsigned int {symbol}_len = {len(contents)};\n')
 
 f.write('static const std::map<std::string_view, std::string_view> stdlibModules = {\n')
 
@@ -17,12 +17,12 @@
 
 #include <string>
 #include <cstdlib>
-#include <unistd.h>
 
 
 
 using namespace yo;
 using yo::driver::OutputFileType;
+using yo::driver::OptimizationLevel;
 
 static int _argc = 0;
 static const char **_argv = nullptr;
@@ -40,15 +40,21 @@ static llvm::cl::opt<type> name(                \
 
 
 
+CLI_OPT(std::string, cacheDir, "cache-dir", "Cache object files and assembly in <path>, and reuse them when compiling an unchanged program", llvm::cl::value_desc("path"))
+CLI_OPT(unsigned, cacheSizeLimit, "cache-size-limit", "Maximum size of the object cache, in megabytes (0: no limit)", llvm::cl::value_desc("MB"), llvm::cl::init(1024))
+CLI_OPT(bool, cacheStats, "cache-stats", "Print the object cache's hit/miss statistics")
 CLI_OPT(bool, dumpLLVM, "dump-llvm", "Dump LLVM IR to stdout")
 CLI_OPT(bool, dumpLLVMPreOpt, "dump-llvm-pre-opt", "Dump LLVM IR to stdout, prior to running optimizations")
 CLI_OPT(bool, dumpAST, "dump-ast", "Print the Abstract Syntax Tree to stdout")
 CLI_OPT(bool, emitDebugMetadata, "g", "Emit debug metadata")
+CLI_OPT(bool, externalLinker, "external-linker", "Link using the system's clang or gcc, instead of invoking the linker directly")
 CLI_OPT(bool, fnoInline, "fno-inline", "Disable all function inlining")
 CLI_OPT(bool, fzeroInitialize, "fzero-initialize", "Allow uninitialized variables and zero-initialize them")
+CLI_OPT(unsigned, numIRGenThreads, "irgen-threads", "Lower function bodies to LLVM IR on <N> threads (0: all cores), and link the resulting modules", llvm::cl::value_desc("N"), llvm::cl::init(1))
+CLI_OPT(unsigned, numCodegenThreads, "j", "Run backend code generation on <N> threads (0: all cores), emitting one object file per thread", llvm::cl::value_desc("N"), llvm::cl::init(1), llvm::cl::Prefix)
 CLI_OPT(bool, int_trapOnFatalError, "int_trap-on-fatal-error", "", llvm::cl::Hidden)
-CLI_OPT(bool, optimize, "O", "Enable optimizations")
-CLI_OPT(bool, run, "run", "Run the generated executable after codegen. Implies `--emit bin`")
+CLI_OPT(bool, optimize, "O", "Enable optimizations. Equivalent to `-O1`")
+CLI_OPT(bool, run, "run", "Run the program in-process (using a JIT) after codegen")
 CLI_OPT(std::string, stdlibRoot, "stdlib-root", "Load stdlib modules from <path>, instead of using the bundled ones", llvm::cl::value_desc("path"))
 
 static llvm::cl::opt<std::string> inputFile(llvm::cl::Positional,
@@ -57,6 +63,16 @@ static llvm::cl::opt<std::string> inputFile(llvm::cl::Positional,
                                             llvm::cl::cat(CLIOptionCategory));
 
 
+static llvm::cl::opt<OptimizationLevel> optimizationLevel(llvm::cl::desc("Optimization level"),
+                                                         llvm::cl::values(clEnumValN(OptimizationLevel::O0, "O0", "No optimizations"),
+                                                                          clEnumValN(OptimizationLevel::O1, "O1", "Optimize quickly without hurting debuggability"),
+                                                                          clEnumValN(OptimizationLevel::O2, "O2", "Optimize for fast execution"),
+                                                                          clEnumValN(OptimizationLevel::O3, "O3", "Optimize for fast execution, as much as possible"),
+                                                                          clEnumValN(OptimizationLevel::Os, "Os", "Optimize for small code size"),
+                                                                          clEnumValN(OptimizationLevel::Oz, "Oz", "Optimize for small code size, as much as possible")),
+                                                         llvm::cl::init(OptimizationLevel::O0),
+                                                         llvm::cl::cat(CLIOptionCategory));
+
 static llvm::cl::list<OutputFileType> outputFileTypes("emit", llvm::cl::desc("Output format(s)"),
                                                       llvm::cl::values(clEnumValN(OutputFileType::Assembly, "asm", "Assembly"),
                                                                        clEnumValN(OutputFileType::LLVM_IR, "llvm-ir", "LLVM IR"),
@@ -66,7 +82,7 @@ static llvm::cl::list<OutputFileType> outputFileTypes("emit", llvm::cl::desc("Ou
                                                       llvm::cl::cat(CLIOptionCategory));
 
 static llvm::cl::list<std::string> runArgs("run-args",
-                                           llvm::cl::desc("Argv to be used when executing the produced binary. Implies `-run`"),
+                                           llvm::cl::desc("Argv to be used when running the program. Implies `-run`"),
                                            llvm::cl::CommaSeparated,
                                            llvm::cl::cat(CLIOptionCategory));
 
@@ -91,7 +107,7 @@ void version_printer(llvm::raw_ostream &OS) {
 
 
 
-int main(int argc, const char * argv[], const char *const *envp) {
+int main(int argc, const char * argv[]) {
     _argc = argc; _argv = argv;
     
     if (hasRawOption("--print-all-options")) {
@@ -110,50 +126,37 @@ int main(int argc, const char * argv[], const char *const *envp) {
     driver::Options options;
     options.inputFile = cl_options::inputFile;
     options.stdlibRoot = cl_options::stdlibRoot;
-    options.optimize = cl_options::optimize;
+    options.optimizationLevel = cl_options::optimizationLevel;
+    if (cl_options::optimize && !cl_options::optimizationLevel.getNumOccurrences()) {
+        options.optimizationLevel = OptimizationLevel::O1;
+    }
     options.fnoInline = cl_options::fnoInline;
     options.fzeroInitialize = cl_options::fzeroInitialize;
+    options.numIRGenThreads = cl_options::numIRGenThreads;
+    options.numCodegenThreads = cl_options::numCodegenThreads;
+    options.useExternalLinker = cl_options::externalLinker;
+    options.cacheDirectory = cl_options::cacheDir;
+    options.cacheSizeLimit = static_cast<uint64_t>(cl_options::cacheSizeLimit) * 1024 * 1024;
+    options.printCacheStatistics = cl_options::cacheStats;
     options.dumpLLVM = cl_options::dumpLLVM;
     options.dumpLLVMPreOpt = cl_options::dumpLLVMPreOpt;
     options.dumpAST = cl_options::dumpAST;
     options.emitDebugMetadata = cl_options::emitDebugMetadata;
     options.int_trapOnFatalError = cl_options::int_trapOnFatalError;
     
-    llvm::SmallString<255> cwd;
-    if (llvm::sys::fs::current_path(cwd)) {
-        LKFatalError("?");
-    }
-    
     for (OutputFileType type : cl_options::outputFileTypes) {
         options.outputFileTypes.insert(type);
     }
     
     LKAssertImplication(!cl_options::runArgs.empty(), cl_options::run);
     
-    if (cl_options::run) {
-        options.outputFileTypes.insert(OutputFileType::Binary);
-    }
+    options.runInJIT = cl_options::run;
+    options.runArgs.assign(cl_options::runArgs.begin(), cl_options::runArgs.end());
     
-    if (!driver::run(options)) {
+    int programExitCode = EXIT_SUCCESS;
+    if (!driver::run(options, &programExitCode)) {
         return EXIT_FAILURE;
     }
-    
-    if (cl_options::run) {
-        auto executablePath = util::fmt::format("{}/a.out", cwd);
-        const auto &runArgs = cl_options::runArgs;
-        
-        int argc = runArgs.size();
-        auto argv = static_cast<char **>(calloc(argc + 2, sizeof(char *))); // +2 bc the first element is the executable path and the array is null terminated
-        argv[0] = strdup(executablePath.c_str());
-
-        for (size_t i = 0; i < argc; i++) {
-            argv[i + 1] = strdup(runArgs[i].c_str());
-        }
-        llvm::llvm_shutdown();
-
-        auto status = execve(argv[0], (char *const *) argv, (char *const *) envp);
-        perror("execve failed");
-        return status;
-    }
+    return programExitCode;
 }
 
@@ -0,0 +1,116 @@
+//
+//  yo-lex-bench.cpp
+//  yo
+//
+
+#include "lex/Lexer.h"
+#include "lex/SourceManager.h"
+#include "util/util.h"
+#include "util/Format.h"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+
+using namespace yo;
+
+// Measures lexer throughput, either on the files passed on the command line or on a synthetic input
+
+static llvm::cl::list<std::string> inputFiles(llvm::cl::Positional,
+                                              llvm::cl::desc("[input files...]"),
+                                              llvm::cl::ZeroOrMore);
+
+static llvm::cl::opt<unsigned> syntheticSize("size",
+                                             llvm::cl::desc("Size (in MB) of the synthetic input, if no input files are specified"),
+                                             llvm::cl::init(32));
+
+static llvm::cl::opt<unsigned> iterations("iterations",
+                                          llvm::cl::desc("Number of times each input is lexed"),
+                                          llvm::cl::init(5));
+
+static llvm::cl::opt<bool> preserveFullInput("preserve-full-input",
+                                             llvm::cl::desc("Also emit tokens for comments and newlines"),
+                                             llvm::cl::init(false));
+
+
+// Somewhat representative mix of declarations, comments and literals. `$N` is replaced w/ a counter
+static const std::string syntheticChunk = R"(
+// Computes a thing
+fn compute_thing_$N<T>(lhs: T, rhs: &T, count: i64) -> T {
+    /* block comments
+       spanning multiple lines */
+    let mut accumulator: T = lhs;
+    for idx in 0..count {
+        if idx % 2 == 0 && accumulator_is_valid(&accumulator) {
+            accumulator = accumulator + *rhs; // trailing comment
+        } else {
+            printf("iteration %lld of %lld: %s\n", idx, count, "some string literal");
+        }
+    }
+    let values = [0x1f, 0b1010, 0o17, 12345, 3.14159, 'c', '\n'];
+    return accumulator;
+}
+
+struct Struct_$N {
+    first_member: i32,
+    second_member: String,
+    third_member: *Struct_$N
+}
+
+)";
+
+
+static std::string makeSyntheticInput(uint64_t size) {
+    std::string input;
+    input.reserve(size + syntheticChunk.size() * 2);
+    for (uint64_t idx = 0; input.size() < size; idx++) {
+        input.append(util::string::replace_all(syntheticChunk, "$N", std::to_string(idx)));
+    }
+    return input;
+}
+
+
+int main(int argc, const char * argv[]) {
+    llvm::cl::ParseCommandLineOptions(argc, argv);
+    
+    lex::SourceManager SM;
+    std::vector<lex::FileID> fileIds;
+    
+    if (inputFiles.empty()) {
+        fileIds.push_back(SM.addFile("<synthetic>", makeSyntheticInput(syntheticSize * 1024 * 1024)));
+    } else {
+        for (const auto &path : inputFiles) {
+            if (auto fileId = SM.loadFile(path)) {
+                fileIds.push_back(*fileId);
+            } else {
+                LKFatalError("unable to read input file '%s'", path.c_str());
+            }
+        }
+    }
+    
+    for (auto fileId : fileIds) {
+        auto size = SM.getContents(fileId).size();
+        std::vector<double> throughputs;
+        uint64_t numTokens = 0;
+        
+        for (unsigned i = 0; i < iterations; i++) {
+            auto start = std::chrono::steady_clock::now();
+            lex::Lexer lexer(SM, fileId);
+            lexer.shouldPreserveFullInput = preserveFullInput;
+            numTokens = lexer.lex().getTokens().size();
+            std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+            throughputs.push_back(size / duration.count() / (1024 * 1024));
+        }
+        
+        std::sort(throughputs.begin(), throughputs.end());
+        util::fmt::print("{}: {} bytes, {} tokens, median {} MB/s (min {}, max {})",
+                         SM.getFilepath(fileId), size, numTokens,
+                         throughputs[throughputs.size() / 2], throughputs.front(), throughputs.back());
+    }
+    
+    return EXIT_SUCCESS;
+}